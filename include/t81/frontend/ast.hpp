@@ -1,6 +1,7 @@
 #ifndef T81_FRONTEND_AST_HPP
 #define T81_FRONTEND_AST_HPP
 
+#include "t81/frontend/ast_arena.hpp"
 #include "t81/frontend/lexer.hpp"
 #include <any>
 #include <memory>
@@ -9,7 +10,9 @@
 #include <utility>
 #include <optional>
 #include <cstdint>
+#include <cstdlib>
 #include <string>
+#include <string_view>
 
 namespace t81 {
 namespace frontend {
@@ -54,14 +57,48 @@ struct EnumDecl;
 
 // --- Base Classes ---
 
+/// Dense per-tree node number, assigned by the parser in creation order.
+/// Expressions and statements share one id space, so side tables keyed by
+/// node can be plain vectors (see `NodeMap` and `FlatAst` in flat_ast.hpp).
+using NodeId = std::uint32_t;
+inline constexpr NodeId kInvalidNodeId = ~NodeId{0};
+
+// Every concrete node records its kind so typed visitors can dispatch with a
+// switch instead of a virtual call that boxes its result in std::any.
+enum class ExprKind : std::uint8_t {
+    Binary, Unary, Literal, Grouping, Variable, Call, Assign, Match,
+    VectorLiteral, FieldAccess, RecordLiteral, EnumLiteral,
+    SimpleType, GenericType
+};
+
+enum class StmtKind : std::uint8_t {
+    Expression, Var, Let, Block, If, While, Loop, Return, Break, Continue,
+    Function, Module, Import, TypeDecl, Record, Enum
+};
+
+// Nodes live in an AstArena and are released with it, never one by one, so
+// the destructors are protected and non-virtual: every node type stays
+// trivially destructible and cannot be deleted through a base pointer.
 struct Expr {
-    virtual ~Expr() = default;
+    const ExprKind kind;
+    NodeId id = kInvalidNodeId;
+
     virtual std::any accept(ExprVisitor& visitor) const = 0;
+
+protected:
+    explicit Expr(ExprKind kind) : kind(kind) {}
+    ~Expr() = default;
 };
 
 struct Stmt {
-    virtual ~Stmt() = default;
+    const StmtKind kind;
+    NodeId id = kInvalidNodeId;
+
     virtual std::any accept(StmtVisitor& visitor) const = 0;
+
+protected:
+    explicit Stmt(StmtKind kind) : kind(kind) {}
+    ~Stmt() = default;
 };
 
 // --- Visitor Interfaces ---
@@ -109,28 +146,28 @@ public:
 // --- Expression Nodes ---
 
 struct BinaryExpr : Expr {
-    BinaryExpr(std::unique_ptr<Expr> left, Token op, std::unique_ptr<Expr> right)
-        : left(std::move(left)), op(op), right(std::move(right)) {}
+    BinaryExpr(AstPtr<Expr> left, Token op, AstPtr<Expr> right)
+        : Expr(ExprKind::Binary), left(std::move(left)), op(op), right(std::move(right)) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
-    const std::unique_ptr<Expr> left;
+    const AstPtr<Expr> left;
     const Token op;
-    const std::unique_ptr<Expr> right;
+    const AstPtr<Expr> right;
 };
 
 struct UnaryExpr : Expr {
-    UnaryExpr(Token op, std::unique_ptr<Expr> right)
-        : op(op), right(std::move(right)) {}
+    UnaryExpr(Token op, AstPtr<Expr> right)
+        : Expr(ExprKind::Unary), op(op), right(std::move(right)) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token op;
-    const std::unique_ptr<Expr> right;
+    const AstPtr<Expr> right;
 };
 
 struct LiteralExpr : Expr {
-    LiteralExpr(Token value) : value(value) {}
+    LiteralExpr(Token value) : Expr(ExprKind::Literal), value(value) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
@@ -138,26 +175,26 @@ struct LiteralExpr : Expr {
 };
 
 struct VectorLiteralExpr : Expr {
-    VectorLiteralExpr(Token token, std::vector<std::unique_ptr<Expr>> elements)
-        : token(token), elements(std::move(elements)) {}
+    VectorLiteralExpr(Token token, AstList<AstPtr<Expr>> elements)
+        : Expr(ExprKind::VectorLiteral), token(token), elements(std::move(elements)) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token token;
-    const std::vector<std::unique_ptr<Expr>> elements;
+    const AstList<AstPtr<Expr>> elements;
 };
 
 struct GroupingExpr : Expr {
-    GroupingExpr(std::unique_ptr<Expr> expression)
-        : expression(std::move(expression)) {}
+    GroupingExpr(AstPtr<Expr> expression)
+        : Expr(ExprKind::Grouping), expression(std::move(expression)) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
-    const std::unique_ptr<Expr> expression;
+    const AstPtr<Expr> expression;
 };
 
 struct VariableExpr : Expr {
-    VariableExpr(Token name) : name(name) {}
+    VariableExpr(Token name) : Expr(ExprKind::Variable), name(name) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
@@ -165,45 +202,45 @@ struct VariableExpr : Expr {
 };
 
 struct CallExpr : Expr {
-    CallExpr(std::unique_ptr<Expr> callee, Token paren, std::vector<std::unique_ptr<Expr>> arguments)
-        : callee(std::move(callee)), paren(paren), arguments(std::move(arguments)) {}
+    CallExpr(AstPtr<Expr> callee, Token paren, AstList<AstPtr<Expr>> arguments)
+        : Expr(ExprKind::Call), callee(std::move(callee)), paren(paren), arguments(std::move(arguments)) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
-    const std::unique_ptr<Expr> callee;
+    const AstPtr<Expr> callee;
     const Token paren;
-    const std::vector<std::unique_ptr<Expr>> arguments;
+    const AstList<AstPtr<Expr>> arguments;
 };
 
 struct FieldAccessExpr : Expr {
-    FieldAccessExpr(std::unique_ptr<Expr> object, Token field)
-        : object(std::move(object)), field(field) {}
+    FieldAccessExpr(AstPtr<Expr> object, Token field)
+        : Expr(ExprKind::FieldAccess), object(std::move(object)), field(field) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
-    const std::unique_ptr<Expr> object;
+    const AstPtr<Expr> object;
     const Token field;
 };
 
 struct RecordLiteralExpr : Expr {
-    RecordLiteralExpr(Token type_name, std::vector<std::pair<Token, std::unique_ptr<Expr>>> fields)
-        : type_name(type_name), fields(std::move(fields)) {}
+    RecordLiteralExpr(Token type_name, AstList<std::pair<Token, AstPtr<Expr>>> fields)
+        : Expr(ExprKind::RecordLiteral), type_name(type_name), fields(std::move(fields)) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token type_name;
-    const std::vector<std::pair<Token, std::unique_ptr<Expr>>> fields;
+    const AstList<std::pair<Token, AstPtr<Expr>>> fields;
 };
 
 struct EnumLiteralExpr : Expr {
-    EnumLiteralExpr(Token enum_name, Token variant, std::unique_ptr<Expr> payload)
-        : enum_name(enum_name), variant(variant), payload(std::move(payload)) {}
+    EnumLiteralExpr(Token enum_name, Token variant, AstPtr<Expr> payload)
+        : Expr(ExprKind::EnumLiteral), enum_name(enum_name), variant(variant), payload(std::move(payload)) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token enum_name;
     const Token variant;
-    const std::unique_ptr<Expr> payload;
+    const AstPtr<Expr> payload;
 };
 
 struct MatchPattern {
@@ -224,62 +261,57 @@ struct MatchPattern {
     Kind kind = Kind::None;
     Token identifier{};
     bool binding_is_wildcard = false;
-    std::vector<Token> tuple_bindings;
-    std::vector<std::pair<Token, Token>> record_bindings;
+    AstList<Token> tuple_bindings;
+    AstList<std::pair<Token, Token>> record_bindings;
     Token variant_name{};
-    std::unique_ptr<MatchPattern> variant_payload;
+    AstPtr<MatchPattern> variant_payload;
 };
 
 struct MatchArm {
     MatchArm(Token keyword,
              MatchPattern pattern,
-             std::unique_ptr<Expr> guard,
-             std::unique_ptr<Expr> expression)
+             AstPtr<Expr> guard,
+             AstPtr<Expr> expression)
         : keyword(keyword),
           pattern(std::move(pattern)),
           guard(std::move(guard)),
           expression(std::move(expression)) {}
 
-    MatchArm(const MatchArm&) = delete;
-    MatchArm& operator=(const MatchArm&) = delete;
-    MatchArm(MatchArm&&) = default;
-    MatchArm& operator=(MatchArm&&) = default;
-
     Token keyword;
     MatchPattern pattern;
-    std::unique_ptr<Expr> guard;
-    std::unique_ptr<Expr> expression;
+    AstPtr<Expr> guard;
+    AstPtr<Expr> expression;
 };
 
 struct MatchExpr : Expr {
-    MatchExpr(std::unique_ptr<Expr> scrutinee, std::vector<MatchArm> arms)
-        : scrutinee(std::move(scrutinee)), arms(std::move(arms)) {}
+    MatchExpr(AstPtr<Expr> scrutinee, AstList<MatchArm> arms)
+        : Expr(ExprKind::Match), scrutinee(std::move(scrutinee)), arms(std::move(arms)) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
-    const std::unique_ptr<Expr> scrutinee;
-    const std::vector<MatchArm> arms;
+    const AstPtr<Expr> scrutinee;
+    const AstList<MatchArm> arms;
 };
 
 struct AssignExpr : Expr {
-    AssignExpr(Token name, std::unique_ptr<Expr> value)
-        : name(name), value(std::move(value)) {}
+    AssignExpr(Token name, AstPtr<Expr> value)
+        : Expr(ExprKind::Assign), name(name), value(std::move(value)) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token name;
-    const std::unique_ptr<Expr> value;
+    const AstPtr<Expr> value;
 };
 
 // --- Statement Nodes ---
 
 struct ExpressionStmt : Stmt {
-    ExpressionStmt(std::unique_ptr<Expr> expression)
-        : expression(std::move(expression)) {}
+    ExpressionStmt(AstPtr<Expr> expression)
+        : Stmt(StmtKind::Expression), expression(std::move(expression)) {}
 
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
 
-    const std::unique_ptr<Expr> expression;
+    const AstPtr<Expr> expression;
 };
 
 // --- Type Expression Nodes ---
@@ -288,11 +320,15 @@ struct ExpressionStmt : Stmt {
 struct TypeExpr : Expr {
     // The accept method will be implemented by subclasses.
     virtual std::any accept(ExprVisitor& visitor) const = 0;
+
+protected:
+    explicit TypeExpr(ExprKind kind) : Expr(kind) {}
+    ~TypeExpr() = default;
 };
 
 // Represents a simple, non-generic type like `T81Int`.
 struct SimpleTypeExpr : TypeExpr {
-    SimpleTypeExpr(Token name) : name(name) {}
+    SimpleTypeExpr(Token name) : TypeExpr(ExprKind::SimpleType), name(name) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
@@ -301,108 +337,110 @@ struct SimpleTypeExpr : TypeExpr {
 
 // Represents a generic type instantiation, e.g., `Vector[T]`.
 struct GenericTypeExpr : TypeExpr {
-    GenericTypeExpr(Token name, std::array<std::unique_ptr<Expr>, 8> params, size_t param_count)
-        : name(name), params(std::move(params)), param_count(param_count) {}
+    GenericTypeExpr(Token name, std::array<AstPtr<Expr>, 8> params, size_t param_count)
+        : TypeExpr(ExprKind::GenericType), name(name), params(std::move(params)), param_count(param_count) {}
 
     std::any accept(ExprVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token name;
-    const std::array<std::unique_ptr<Expr>, 8> params;
+    const std::array<AstPtr<Expr>, 8> params;
     const size_t param_count;
 };
 
 
 struct VarStmt : Stmt {
-    VarStmt(Token name, std::unique_ptr<TypeExpr> type, std::unique_ptr<Expr> initializer)
-        : name(name), type(std::move(type)), initializer(std::move(initializer)) {}
+    VarStmt(Token name, AstPtr<TypeExpr> type, AstPtr<Expr> initializer)
+        : Stmt(StmtKind::Var), name(name), type(std::move(type)), initializer(std::move(initializer)) {}
 
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token name;
-    const std::unique_ptr<TypeExpr> type;
-    const std::unique_ptr<Expr> initializer;
+    const AstPtr<TypeExpr> type;
+    const AstPtr<Expr> initializer;
 };
 
 struct LetStmt : Stmt {
-    LetStmt(Token name, std::unique_ptr<TypeExpr> type, std::unique_ptr<Expr> initializer)
-        : name(name), type(std::move(type)), initializer(std::move(initializer)) {}
+    LetStmt(Token name, AstPtr<TypeExpr> type, AstPtr<Expr> initializer)
+        : Stmt(StmtKind::Let), name(name), type(std::move(type)), initializer(std::move(initializer)) {}
 
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token name;
-    const std::unique_ptr<TypeExpr> type;
-    const std::unique_ptr<Expr> initializer;
+    const AstPtr<TypeExpr> type;
+    const AstPtr<Expr> initializer;
 };
 
 struct BlockStmt : Stmt {
-    BlockStmt(std::vector<std::unique_ptr<Stmt>> statements)
-        : statements(std::move(statements)) {}
+    BlockStmt(AstList<AstPtr<Stmt>> statements)
+        : Stmt(StmtKind::Block), statements(std::move(statements)) {}
 
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
 
-    const std::vector<std::unique_ptr<Stmt>> statements;
+    const AstList<AstPtr<Stmt>> statements;
 };
 
 struct IfStmt : Stmt {
-    IfStmt(std::unique_ptr<Expr> condition, std::unique_ptr<Stmt> then_branch, std::unique_ptr<Stmt> else_branch)
-        : condition(std::move(condition)), then_branch(std::move(then_branch)), else_branch(std::move(else_branch)) {}
+    IfStmt(AstPtr<Expr> condition, AstPtr<Stmt> then_branch, AstPtr<Stmt> else_branch)
+        : Stmt(StmtKind::If), condition(std::move(condition)), then_branch(std::move(then_branch)), else_branch(std::move(else_branch)) {}
 
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
 
-    const std::unique_ptr<Expr> condition;
-    const std::unique_ptr<Stmt> then_branch;
-    const std::unique_ptr<Stmt> else_branch;
+    const AstPtr<Expr> condition;
+    const AstPtr<Stmt> then_branch;
+    const AstPtr<Stmt> else_branch;
 };
 
 struct WhileStmt : Stmt {
-    WhileStmt(std::unique_ptr<Expr> condition, std::unique_ptr<Stmt> body)
-        : condition(std::move(condition)), body(std::move(body)) {}
+    WhileStmt(AstPtr<Expr> condition, AstPtr<Stmt> body)
+        : Stmt(StmtKind::While), condition(std::move(condition)), body(std::move(body)) {}
 
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
 
-    const std::unique_ptr<Expr> condition;
-    const std::unique_ptr<Stmt> body;
+    const AstPtr<Expr> condition;
+    const AstPtr<Stmt> body;
 };
 
 struct ReturnStmt : Stmt {
-    ReturnStmt(Token keyword, std::unique_ptr<Expr> value)
-        : keyword(keyword), value(std::move(value)) {}
+    ReturnStmt(Token keyword, AstPtr<Expr> value)
+        : Stmt(StmtKind::Return), keyword(keyword), value(std::move(value)) {}
 
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token keyword;
-    const std::unique_ptr<Expr> value;
+    const AstPtr<Expr> value;
 };
 
 struct BreakStmt : Stmt {
-    BreakStmt(Token keyword) : keyword(keyword) {}
+    BreakStmt(Token keyword) : Stmt(StmtKind::Break), keyword(keyword) {}
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
     const Token keyword;
 };
 
 struct ContinueStmt : Stmt {
-    ContinueStmt(Token keyword) : keyword(keyword) {}
+    ContinueStmt(Token keyword) : Stmt(StmtKind::Continue), keyword(keyword) {}
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
     const Token keyword;
 };
 
 struct Parameter {
     Token name;
-    std::unique_ptr<TypeExpr> type;
+    AstPtr<TypeExpr> type;
 };
 
 struct FunctionAttributes {
     bool is_effectful = false;
+    bool is_tailrec = false;
     std::optional<std::int64_t> tier;
 };
 
 struct FunctionStmt : Stmt {
     FunctionStmt(Token name,
-                 std::vector<Parameter> params,
-                 std::unique_ptr<TypeExpr> return_type,
-                 std::vector<std::unique_ptr<Stmt>> body,
+                 AstList<Parameter> params,
+                 AstPtr<TypeExpr> return_type,
+                 AstList<AstPtr<Stmt>> body,
                  FunctionAttributes attributes = {})
-        : name(name),
+        : Stmt(StmtKind::Function),
+          name(name),
           params(std::move(params)),
           return_type(std::move(return_type)),
           body(std::move(body)),
@@ -411,54 +449,55 @@ struct FunctionStmt : Stmt {
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token name;
-    const std::vector<Parameter> params;
-    const std::unique_ptr<TypeExpr> return_type;
-    const std::vector<std::unique_ptr<Stmt>> body;
+    const AstList<Parameter> params;
+    const AstPtr<TypeExpr> return_type;
+    const AstList<AstPtr<Stmt>> body;
     const FunctionAttributes attributes;
 };
 
 struct ModuleDecl : Stmt {
-    explicit ModuleDecl(Token keyword, std::string path)
-        : keyword(keyword), path(std::move(path)) {}
+    explicit ModuleDecl(Token keyword, std::string_view path)
+        : Stmt(StmtKind::Module), keyword(keyword), path(std::move(path)) {}
 
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token keyword;
-    const std::string path;
+    const std::string_view path;
 };
 
 struct ImportDecl : Stmt {
-    explicit ImportDecl(Token keyword, std::string path)
-        : keyword(keyword), path(std::move(path)) {}
+    explicit ImportDecl(Token keyword, std::string_view path)
+        : Stmt(StmtKind::Import), keyword(keyword), path(std::move(path)) {}
 
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token keyword;
-    const std::string path;
+    const std::string_view path;
 };
 
 struct TypeDecl : Stmt {
-    TypeDecl(Token name, std::vector<Token> params, std::unique_ptr<TypeExpr> alias)
-        : name(name), params(std::move(params)), alias(std::move(alias)) {}
+    TypeDecl(Token name, AstList<Token> params, AstPtr<TypeExpr> alias)
+        : Stmt(StmtKind::TypeDecl), name(name), params(std::move(params)), alias(std::move(alias)) {}
 
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token name;
-    const std::vector<Token> params;
-    const std::unique_ptr<TypeExpr> alias;
+    const AstList<Token> params;
+    const AstPtr<TypeExpr> alias;
 };
 
 struct RecordDecl : Stmt {
     struct Field {
         Token name;
-        std::unique_ptr<TypeExpr> type;
+        AstPtr<TypeExpr> type;
     };
 
     RecordDecl(Token name,
-               std::vector<Field> fields,
+               AstList<Field> fields,
                std::optional<std::int64_t> schema_version = std::nullopt,
-               std::optional<std::string> module_path = std::nullopt)
-        : name(name),
+               std::optional<std::string_view> module_path = std::nullopt)
+        : Stmt(StmtKind::Record),
+          name(name),
           fields(std::move(fields)),
           schema_version(schema_version),
           module_path(module_path) {}
@@ -466,22 +505,23 @@ struct RecordDecl : Stmt {
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token name;
-    const std::vector<Field> fields;
+    const AstList<Field> fields;
     const std::optional<std::int64_t> schema_version;
-    const std::optional<std::string> module_path;
+    const std::optional<std::string_view> module_path;
 };
 
 struct EnumDecl : Stmt {
     struct Variant {
         Token name;
-        std::unique_ptr<TypeExpr> payload;
+        AstPtr<TypeExpr> payload;
     };
 
     EnumDecl(Token name,
-             std::vector<Variant> variants,
+             AstList<Variant> variants,
              std::optional<std::int64_t> schema_version = std::nullopt,
-             std::optional<std::string> module_path = std::nullopt)
-        : name(name),
+             std::optional<std::string_view> module_path = std::nullopt)
+        : Stmt(StmtKind::Enum),
+          name(name),
           variants(std::move(variants)),
           schema_version(schema_version),
           module_path(module_path) {}
@@ -489,9 +529,9 @@ struct EnumDecl : Stmt {
     std::any accept(StmtVisitor& visitor) const override { return visitor.visit(*this); }
 
     const Token name;
-    const std::vector<Variant> variants;
+    const AstList<Variant> variants;
     const std::optional<std::int64_t> schema_version;
-    const std::optional<std::string> module_path;
+    const std::optional<std::string_view> module_path;
 };
 
 struct LoopStmt : Stmt {
@@ -504,9 +544,10 @@ struct LoopStmt : Stmt {
     };
 
     LoopStmt(Token keyword, BoundKind bound_kind, std::optional<std::int64_t> bound_value,
-             std::unique_ptr<Expr> guard_expression,
-             std::vector<std::unique_ptr<Stmt>> body)
-        : keyword(keyword),
+             AstPtr<Expr> guard_expression,
+             AstList<AstPtr<Stmt>> body)
+        : Stmt(StmtKind::Loop),
+          keyword(keyword),
           bound_kind(bound_kind),
           bound_value(bound_value),
           guard_expression(std::move(guard_expression)),
@@ -517,11 +558,97 @@ struct LoopStmt : Stmt {
     const Token keyword;
     const BoundKind bound_kind;
     const std::optional<std::int64_t> bound_value;
-    const std::unique_ptr<Expr> guard_expression;
-    const std::vector<std::unique_ptr<Stmt>> body;
+    const AstPtr<Expr> guard_expression;
+    const AstList<AstPtr<Stmt>> body;
 };
 
 
+// --- Typed Visitors ---
+
+// Switch-on-kind dispatch with concrete result types. `Derived` implements
+// `R visit(const Node&)` for every node in the family; results are returned
+// directly, with no std::any boxing and no RTTI. The std::any-based
+// ExprVisitor/StmtVisitor interfaces above remain for existing walkers.
+template<class Derived, class R>
+class ExprVisitorT {
+public:
+    R visit_expr(const Expr& expr) {
+        auto& self = static_cast<Derived&>(*this);
+        switch (expr.kind) {
+            case ExprKind::Binary: return self.visit(static_cast<const BinaryExpr&>(expr));
+            case ExprKind::Unary: return self.visit(static_cast<const UnaryExpr&>(expr));
+            case ExprKind::Literal: return self.visit(static_cast<const LiteralExpr&>(expr));
+            case ExprKind::Grouping: return self.visit(static_cast<const GroupingExpr&>(expr));
+            case ExprKind::Variable: return self.visit(static_cast<const VariableExpr&>(expr));
+            case ExprKind::Call: return self.visit(static_cast<const CallExpr&>(expr));
+            case ExprKind::Assign: return self.visit(static_cast<const AssignExpr&>(expr));
+            case ExprKind::Match: return self.visit(static_cast<const MatchExpr&>(expr));
+            case ExprKind::VectorLiteral: return self.visit(static_cast<const VectorLiteralExpr&>(expr));
+            case ExprKind::FieldAccess: return self.visit(static_cast<const FieldAccessExpr&>(expr));
+            case ExprKind::RecordLiteral: return self.visit(static_cast<const RecordLiteralExpr&>(expr));
+            case ExprKind::EnumLiteral: return self.visit(static_cast<const EnumLiteralExpr&>(expr));
+            case ExprKind::SimpleType: return self.visit(static_cast<const SimpleTypeExpr&>(expr));
+            case ExprKind::GenericType: return self.visit(static_cast<const GenericTypeExpr&>(expr));
+        }
+        std::abort();
+    }
+
+protected:
+    ~ExprVisitorT() = default;
+};
+
+template<class Derived, class R>
+class StmtVisitorT {
+public:
+    R visit_stmt(const Stmt& stmt) {
+        auto& self = static_cast<Derived&>(*this);
+        switch (stmt.kind) {
+            case StmtKind::Expression: return self.visit(static_cast<const ExpressionStmt&>(stmt));
+            case StmtKind::Var: return self.visit(static_cast<const VarStmt&>(stmt));
+            case StmtKind::Let: return self.visit(static_cast<const LetStmt&>(stmt));
+            case StmtKind::Block: return self.visit(static_cast<const BlockStmt&>(stmt));
+            case StmtKind::If: return self.visit(static_cast<const IfStmt&>(stmt));
+            case StmtKind::While: return self.visit(static_cast<const WhileStmt&>(stmt));
+            case StmtKind::Loop: return self.visit(static_cast<const LoopStmt&>(stmt));
+            case StmtKind::Return: return self.visit(static_cast<const ReturnStmt&>(stmt));
+            case StmtKind::Break: return self.visit(static_cast<const BreakStmt&>(stmt));
+            case StmtKind::Continue: return self.visit(static_cast<const ContinueStmt&>(stmt));
+            case StmtKind::Function: return self.visit(static_cast<const FunctionStmt&>(stmt));
+            case StmtKind::Module: return self.visit(static_cast<const ModuleDecl&>(stmt));
+            case StmtKind::Import: return self.visit(static_cast<const ImportDecl&>(stmt));
+            case StmtKind::TypeDecl: return self.visit(static_cast<const TypeDecl&>(stmt));
+            case StmtKind::Record: return self.visit(static_cast<const RecordDecl&>(stmt));
+            case StmtKind::Enum: return self.visit(static_cast<const EnumDecl&>(stmt));
+        }
+        std::abort();
+    }
+
+protected:
+    ~StmtVisitorT() = default;
+};
+
+/**
+ * @struct SyntaxTree
+ * @brief The top-level statements of a parsed source plus the arena owning them.
+ *
+ * Behaves as a read-only contiguous range of statements, so it can be handed
+ * directly to `SemanticAnalyzer` and `IRGenerator`. Every node stays valid for
+ * as long as any copy of `arena` is alive. Node ids are dense in
+ * `[0, node_count)`.
+ */
+struct SyntaxTree {
+    std::shared_ptr<AstArena> arena;
+    std::vector<AstPtr<Stmt>> statements;
+    NodeId node_count = 0;
+
+    std::size_t size() const { return statements.size(); }
+    bool empty() const { return statements.empty(); }
+    const AstPtr<Stmt>* data() const { return statements.data(); }
+    const AstPtr<Stmt>* begin() const { return statements.data(); }
+    const AstPtr<Stmt>* end() const { return statements.data() + statements.size(); }
+    const AstPtr<Stmt>& operator[](std::size_t index) const { return statements[index]; }
+};
+
 } // namespace frontend
 } // namespace t81
 
@@ -0,0 +1,168 @@
+/**
+ * @file ast_arena.hpp
+ * @brief Defines AstArena, the bump allocator that owns every AST node, and
+ *        the non-owning AstPtr/AstList handles nodes use to refer to children.
+ */
+
+#ifndef T81_FRONTEND_AST_ARENA_HPP
+#define T81_FRONTEND_AST_ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace t81 {
+namespace frontend {
+
+/**
+ * @class AstPtr
+ * @brief A non-owning pointer to an arena-allocated AST node.
+ *
+ * Mirrors the subset of the `std::unique_ptr` interface the frontend uses
+ * (`get`, `*`, `->`, boolean tests), so walkers are agnostic to ownership.
+ */
+template<class T>
+class AstPtr {
+public:
+    constexpr AstPtr() noexcept = default;
+    constexpr AstPtr(std::nullptr_t) noexcept {}
+    constexpr AstPtr(T* ptr) noexcept : _ptr(ptr) {}
+
+    template<class U, class = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    constexpr AstPtr(AstPtr<U> other) noexcept : _ptr(other.get()) {}
+
+    constexpr T* get() const noexcept { return _ptr; }
+    constexpr T& operator*() const noexcept { return *_ptr; }
+    constexpr T* operator->() const noexcept { return _ptr; }
+    constexpr explicit operator bool() const noexcept { return _ptr != nullptr; }
+
+    friend constexpr bool operator==(AstPtr lhs, std::nullptr_t) noexcept { return lhs._ptr == nullptr; }
+
+private:
+    T* _ptr = nullptr;
+};
+
+/**
+ * @class AstList
+ * @brief A non-owning, immutable span of arena-allocated elements.
+ */
+template<class T>
+class AstList {
+public:
+    constexpr AstList() noexcept = default;
+    constexpr AstList(const T* data, std::size_t size) noexcept : _data(data), _size(size) {}
+
+    constexpr const T* begin() const noexcept { return _data; }
+    constexpr const T* end() const noexcept { return _data + _size; }
+    constexpr const T* data() const noexcept { return _data; }
+    constexpr std::size_t size() const noexcept { return _size; }
+    constexpr bool empty() const noexcept { return _size == 0; }
+    constexpr const T& operator[](std::size_t index) const noexcept { return _data[index]; }
+    constexpr const T& front() const noexcept { return _data[0]; }
+    constexpr const T& back() const noexcept { return _data[_size - 1]; }
+
+private:
+    const T* _data = nullptr;
+    std::size_t _size = 0;
+};
+
+/**
+ * @class AstArena
+ * @brief Bump allocator owning all AST nodes of one compilation unit.
+ *
+ * Nodes are placement-constructed into large chunks and are never destroyed
+ * individually: everything placed in the arena must be trivially
+ * destructible, so releasing the arena frees the whole tree in O(chunks)
+ * with no recursive destructor chain.
+ */
+class AstArena {
+public:
+    static constexpr std::size_t kInitialChunkSize = 4 * 1024;
+    static constexpr std::size_t kDefaultChunkSize = 64 * 1024;
+
+    /// Chunks start small and double up to `chunk_size`, so tiny sources stay tiny.
+    explicit AstArena(std::size_t chunk_size = kDefaultChunkSize)
+        : _chunk_size(chunk_size),
+          _next_chunk_size(chunk_size < kInitialChunkSize ? chunk_size : kInitialChunkSize) {}
+
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+
+    /// Constructs a `T` in the arena; the node lives until the arena is destroyed.
+    template<class T, class... Args>
+    T* make(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "arena objects are never destroyed; they must be trivially destructible");
+        void* memory = allocate(sizeof(T), alignof(T));
+        return ::new (memory) T(std::forward<Args>(args)...);
+    }
+
+    /// Moves `items` into contiguous arena storage.
+    template<class T>
+    AstList<T> make_list(std::vector<T>&& items) {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "arena objects are never destroyed; they must be trivially destructible");
+        if (items.empty()) return {};
+        T* data = static_cast<T*>(allocate(sizeof(T) * items.size(), alignof(T)));
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            ::new (data + i) T(std::move(items[i]));
+        }
+        return AstList<T>(data, items.size());
+    }
+
+    /// Copies `text` into the arena and returns a view of the copy.
+    std::string_view copy_string(std::string_view text) {
+        if (text.empty()) return {};
+        char* data = static_cast<char*>(allocate(text.size(), alignof(char)));
+        std::memcpy(data, text.data(), text.size());
+        return std::string_view(data, text.size());
+    }
+
+    std::size_t bytes_used() const noexcept { return _bytes_used; }
+    std::size_t chunk_count() const noexcept { return _chunks.size(); }
+
+private:
+    void* allocate(std::size_t size, std::size_t align) {
+        auto cursor = reinterpret_cast<std::uintptr_t>(_cursor);
+        std::uintptr_t aligned = (cursor + (align - 1)) & ~static_cast<std::uintptr_t>(align - 1);
+        if (_cursor == nullptr || aligned + size > reinterpret_cast<std::uintptr_t>(_limit)) {
+            // Oversized requests get a dedicated chunk so the current one keeps its tail.
+            const bool oversized = size + align > _next_chunk_size;
+            const std::size_t chunk = oversized ? size + align : _next_chunk_size;
+            _chunks.emplace_back(new std::byte[chunk]);
+            std::byte* base = _chunks.back().get();
+            if (oversized) {
+                _bytes_used += size;
+                auto raw = reinterpret_cast<std::uintptr_t>(base);
+                return reinterpret_cast<void*>((raw + (align - 1)) & ~static_cast<std::uintptr_t>(align - 1));
+            }
+            _cursor = base;
+            _limit = base + chunk;
+            _next_chunk_size = std::min(_next_chunk_size * 2, _chunk_size);
+            cursor = reinterpret_cast<std::uintptr_t>(_cursor);
+            aligned = (cursor + (align - 1)) & ~static_cast<std::uintptr_t>(align - 1);
+        }
+        _cursor = reinterpret_cast<std::byte*>(aligned + size);
+        _bytes_used += size;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    std::size_t _chunk_size;
+    std::size_t _next_chunk_size;
+    std::vector<std::unique_ptr<std::byte[]>> _chunks;
+    std::byte* _cursor = nullptr;
+    std::byte* _limit = nullptr;
+    std::size_t _bytes_used = 0;
+};
+
+} // namespace frontend
+} // namespace t81
+
+#endif // T81_FRONTEND_AST_ARENA_HPP
@@ -3,54 +3,57 @@
 
 #include "t81/frontend/ast.hpp"
 
-#include <any>
+#include <initializer_list>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <variant>
 #include <vector>
 
 namespace t81::frontend {
 
-class CanonicalAstPrinter : public ExprVisitor, public StmtVisitor {
+class CanonicalAstPrinter final : public ExprVisitorT<CanonicalAstPrinter, std::string>,
+                                  public StmtVisitorT<CanonicalAstPrinter, std::string> {
 public:
     std::string print(const Stmt& stmt);
     std::string print(const Expr& expr);
 
-    std::any visit(const ExpressionStmt& stmt) override;
-    std::any visit(const VarStmt& stmt) override;
-    std::any visit(const LetStmt& stmt) override;
-    std::any visit(const BlockStmt& stmt) override;
-    std::any visit(const IfStmt& stmt) override;
-    std::any visit(const WhileStmt& stmt) override;
-    std::any visit(const LoopStmt& stmt) override;
-    std::any visit(const ReturnStmt& stmt) override;
-    std::any visit(const BreakStmt& stmt) override;
-    std::any visit(const ContinueStmt& stmt) override;
-    std::any visit(const FunctionStmt& stmt) override;
-    std::any visit(const ModuleDecl& stmt) override;
-    std::any visit(const ImportDecl& stmt) override;
-    std::any visit(const TypeDecl& stmt) override;
-    std::any visit(const RecordDecl& stmt) override;
-    std::any visit(const EnumDecl& stmt) override;
-
-    std::any visit(const BinaryExpr& expr) override;
-    std::any visit(const UnaryExpr& expr) override;
-    std::any visit(const LiteralExpr& expr) override;
-    std::any visit(const GroupingExpr& expr) override;
-    std::any visit(const VariableExpr& expr) override;
-    std::any visit(const CallExpr& expr) override;
-    std::any visit(const AssignExpr& expr) override;
-    std::any visit(const MatchExpr& expr) override;
-    std::any visit(const VectorLiteralExpr& expr) override;
-    std::any visit(const FieldAccessExpr& expr) override;
-    std::any visit(const RecordLiteralExpr& expr) override;
-    std::any visit(const EnumLiteralExpr& expr) override;
-    std::any visit(const SimpleTypeExpr& expr) override;
-    std::any visit(const GenericTypeExpr& expr) override;
+    std::string visit(const ExpressionStmt& stmt);
+    std::string visit(const VarStmt& stmt);
+    std::string visit(const LetStmt& stmt);
+    std::string visit(const BlockStmt& stmt);
+    std::string visit(const IfStmt& stmt);
+    std::string visit(const WhileStmt& stmt);
+    std::string visit(const LoopStmt& stmt);
+    std::string visit(const ReturnStmt& stmt);
+    std::string visit(const BreakStmt& stmt);
+    std::string visit(const ContinueStmt& stmt);
+    std::string visit(const FunctionStmt& stmt);
+    std::string visit(const ModuleDecl& stmt);
+    std::string visit(const ImportDecl& stmt);
+    std::string visit(const TypeDecl& stmt);
+    std::string visit(const RecordDecl& stmt);
+    std::string visit(const EnumDecl& stmt);
+
+    std::string visit(const BinaryExpr& expr);
+    std::string visit(const UnaryExpr& expr);
+    std::string visit(const LiteralExpr& expr);
+    std::string visit(const GroupingExpr& expr);
+    std::string visit(const VariableExpr& expr);
+    std::string visit(const CallExpr& expr);
+    std::string visit(const AssignExpr& expr);
+    std::string visit(const MatchExpr& expr);
+    std::string visit(const VectorLiteralExpr& expr);
+    std::string visit(const FieldAccessExpr& expr);
+    std::string visit(const RecordLiteralExpr& expr);
+    std::string visit(const EnumLiteralExpr& expr);
+    std::string visit(const SimpleTypeExpr& expr);
+    std::string visit(const GenericTypeExpr& expr);
 
 private:
     std::string parenthesize(std::string_view name, const std::vector<const Expr*>& exprs);
-    std::string parenthesize(std::string_view name, const std::vector<std::any>& parts);
+    using Part = std::variant<const Expr*, const Stmt*>;
+    std::string parenthesize(std::string_view name, std::initializer_list<Part> parts);
 };
 
 } // namespace t81::frontend
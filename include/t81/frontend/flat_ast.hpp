@@ -0,0 +1,107 @@
+/**
+ * @file flat_ast.hpp
+ * @brief Defines FlatAst, an index-based struct-of-arrays encoding of a parsed
+ *        tree, and NodeMap, the dense side table keyed by NodeId.
+ */
+
+#ifndef T81_FRONTEND_FLAT_AST_HPP
+#define T81_FRONTEND_FLAT_AST_HPP
+
+#include "t81/frontend/ast.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace t81 {
+namespace frontend {
+
+/**
+ * @class NodeMap
+ * @brief A per-node side table stored as a dense vector indexed by NodeId.
+ *
+ * Replaces pointer-keyed hash maps for analysis results: lookups are a bounds
+ * check and an index, and storage grows geometrically on first write to a
+ * new id. Ids must come from the parser (`kInvalidNodeId` is never stored).
+ */
+template<class T>
+class NodeMap {
+public:
+    void reserve(std::size_t node_count) {
+        if (node_count > _values.size()) {
+            _values.resize(node_count);
+            _present.resize(node_count, 0);
+        }
+    }
+
+    /// Returns the slot for `id`, default-constructing it on first access.
+    T& operator[](NodeId id) {
+        if (id >= _values.size()) {
+            reserve(std::max<std::size_t>(static_cast<std::size_t>(id) + 1, _values.size() * 2));
+        }
+        _present[id] = 1;
+        return _values[id];
+    }
+
+    const T* find(NodeId id) const {
+        if (id >= _values.size() || !_present[id]) return nullptr;
+        return &_values[id];
+    }
+
+    bool contains(NodeId id) const { return find(id) != nullptr; }
+
+    /// Moves every entry of `other` into this table, replacing existing ones.
+    void merge(NodeMap&& other) {
+        for (std::size_t id = 0; id < other._values.size(); ++id) {
+            if (other._present[id]) (*this)[static_cast<NodeId>(id)] = std::move(other._values[id]);
+        }
+    }
+
+private:
+    std::vector<T> _values;
+    std::vector<std::uint8_t> _present;
+};
+
+/// Which kind enum a FlatAst slot's `kinds` entry belongs to. Ids the parser
+/// allocated but that are unreachable from the roots stay `None`.
+enum class NodeFamily : std::uint8_t { None, Expr, Stmt };
+
+/**
+ * @struct FlatAst
+ * @brief The tree of a SyntaxTree lowered into parallel arrays.
+ *
+ * Index `id` addresses the same node in every per-node array, and ids are the
+ * parser-assigned `NodeId`s, so FlatAst slots line up with NodeMap tables
+ * built over the pointer tree. Each node's direct children are the contiguous
+ * range `children[child_begin[id], child_begin[id] + child_count[id])`, in
+ * source order. `lines`/`columns` give the node's anchoring token (operator,
+ * name or keyword), or 0 for nodes without one (groups, blocks, `if`).
+ */
+struct FlatAst {
+    std::vector<NodeFamily> families;
+    std::vector<std::uint8_t> kinds;
+    std::vector<NodeId> parents;
+    std::vector<std::uint32_t> child_begin;
+    std::vector<std::uint32_t> child_count;
+    std::vector<std::int32_t> lines;
+    std::vector<std::int32_t> columns;
+    std::vector<NodeId> children;
+    std::vector<NodeId> roots;
+
+    /// Lowers `tree`; slots are sized to `tree.node_count`.
+    static FlatAst lower(const SyntaxTree& tree);
+
+    std::size_t size() const { return families.size(); }
+    ExprKind expr_kind(NodeId id) const { return static_cast<ExprKind>(kinds[id]); }
+    StmtKind stmt_kind(NodeId id) const { return static_cast<StmtKind>(kinds[id]); }
+    std::span<const NodeId> children_of(NodeId id) const {
+        return std::span<const NodeId>(children).subspan(child_begin[id], child_count[id]);
+    }
+};
+
+} // namespace frontend
+} // namespace t81
+
+#endif // T81_FRONTEND_FLAT_AST_HPP
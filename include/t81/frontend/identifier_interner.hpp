@@ -0,0 +1,62 @@
+/**
+ * @file identifier_interner.hpp
+ * @brief Defines SymbolId and the IdentifierInterner that maps identifier
+ *        spellings to them.
+ */
+
+#ifndef T81_FRONTEND_IDENTIFIER_INTERNER_HPP
+#define T81_FRONTEND_IDENTIFIER_INTERNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace t81 {
+namespace frontend {
+
+/// Dense, process-wide number of an identifier spelling. Equal spellings
+/// always get equal ids, so scopes can be keyed by integer.
+using SymbolId = std::uint32_t;
+
+/// The id of the empty spelling; also what a value-initialized Token carries.
+inline constexpr SymbolId kEmptySymbol = 0;
+
+/**
+ * @class IdentifierInterner
+ * @brief Process-wide table of identifier spellings.
+ *
+ * The lexer interns every identifier as it is scanned. Spellings are copied
+ * into stable storage, so ids and the views returned by `spelling` outlive
+ * the source buffer. Lookups take a shared lock and inserts an exclusive
+ * one, so lexing may run on several threads.
+ */
+class IdentifierInterner {
+public:
+    static IdentifierInterner& global();
+
+    SymbolId intern(std::string_view text);
+    /// Returns the id of `text` without inserting it.
+    std::optional<SymbolId> find(std::string_view text) const;
+    std::string_view spelling(SymbolId id) const;
+    std::size_t size() const;
+
+    IdentifierInterner(const IdentifierInterner&) = delete;
+    IdentifierInterner& operator=(const IdentifierInterner&) = delete;
+
+private:
+    IdentifierInterner();
+
+    mutable std::shared_mutex _mutex;
+    std::deque<std::string> _spellings;
+    std::unordered_map<std::string_view, SymbolId> _ids;
+};
+
+} // namespace frontend
+} // namespace t81
+
+#endif // T81_FRONTEND_IDENTIFIER_INTERNER_HPP
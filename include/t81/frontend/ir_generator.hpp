@@ -7,16 +7,19 @@
 #include "t81/frontend/semantic_analyzer.hpp"
 #include "t81/frontend/symbol_table.hpp"
 #include "t81/tensor.hpp"
+#include "t81/tisc/calling_convention.hpp"
 #include "t81/tisc/ir.hpp"
-#include <any>
+#include <algorithm>
 #include <iostream>
 #include <optional>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <typeinfo>
 #include <unordered_map>
+#include <vector>
 
 namespace t81::frontend {
 
@@ -76,7 +79,132 @@ inline std::string escape_metadata_string(std::string_view input) {
     return out;
 }
 
-class IRGenerator : public ExprVisitor, public StmtVisitor {
+// Calls the generator lowers to dedicated instructions rather than CALL.
+inline bool is_builtin_call(std::string_view name) {
+    return name == "Some" || name == "None" || name == "Ok" || name == "Err" || name == "print" ||
+           name == "weights.load";
+}
+
+// The call `stmt` returns when it calls `function` directly: a self tail
+// call, which can restart the body instead of recursing.
+inline const CallExpr* self_tail_call(const ReturnStmt& stmt, std::string_view function) {
+    const auto* call = dynamic_cast<const CallExpr*>(stmt.value.get());
+    if (!call) return nullptr;
+    const auto* callee = dynamic_cast<const VariableExpr*>(call->callee.get());
+    return callee && callee->name.lexeme == function ? call : nullptr;
+}
+
+/**
+ * @class InlineCost
+ * @brief What the inliner needs to know about a function body: its size in
+ *        AST nodes, whether it calls other user functions, whether it
+ *        assigns to any variable, and its `return` statements. Self tail
+ *        calls are counted apart and do not make the body call anything.
+ */
+class InlineCost final : public ExprVisitorT<InlineCost, void>, public StmtVisitorT<InlineCost, void> {
+public:
+    static InlineCost of(const FunctionStmt& function) {
+        InlineCost cost;
+        cost._function = function.name.lexeme;
+        for (const auto& stmt : function.body) cost.count(stmt.get());
+        return cost;
+    }
+
+    int nodes = 0;
+    bool calls_functions = false;
+    bool assigns = false;
+    int returns = 0;
+    int self_tail_calls = 0;
+
+    void visit(const ExpressionStmt& stmt) { count(stmt.expression.get()); }
+    void visit(const VarStmt& stmt) { count(stmt.initializer.get()); }
+    void visit(const LetStmt& stmt) { count(stmt.initializer.get()); }
+    void visit(const BlockStmt& stmt) { count(stmt.statements); }
+    void visit(const IfStmt& stmt) {
+        count(stmt.condition.get());
+        count(stmt.then_branch.get());
+        count(stmt.else_branch.get());
+    }
+    void visit(const WhileStmt& stmt) {
+        count(stmt.condition.get());
+        count(stmt.body.get());
+    }
+    void visit(const LoopStmt& stmt) {
+        count(stmt.guard_expression.get());
+        count(stmt.body);
+    }
+    void visit(const ReturnStmt& stmt) {
+        ++returns;
+        if (const CallExpr* call = self_tail_call(stmt, _function)) {
+            ++self_tail_calls;
+            ++nodes;
+            count(call->arguments);
+            return;
+        }
+        count(stmt.value.get());
+    }
+    void visit(const BreakStmt&) { ++nodes; }
+    void visit(const ContinueStmt&) { ++nodes; }
+    void visit(const FunctionStmt&) { ++nodes; }
+    void visit(const ModuleDecl&) {}
+    void visit(const ImportDecl&) {}
+    void visit(const TypeDecl&) {}
+    void visit(const RecordDecl&) {}
+    void visit(const EnumDecl&) {}
+
+    void visit(const BinaryExpr& expr) {
+        count(expr.left.get());
+        count(expr.right.get());
+    }
+    void visit(const UnaryExpr& expr) { count(expr.right.get()); }
+    void visit(const LiteralExpr&) {}
+    void visit(const GroupingExpr& expr) { count(expr.expression.get()); }
+    void visit(const VariableExpr&) {}
+    void visit(const CallExpr& expr) {
+        const auto* callee = dynamic_cast<const VariableExpr*>(expr.callee.get());
+        if (!callee || !is_builtin_call(callee->name.lexeme)) calls_functions = true;
+        count(expr.arguments);
+    }
+    void visit(const AssignExpr& expr) {
+        assigns = true;
+        count(expr.value.get());
+    }
+    void visit(const MatchExpr& expr) {
+        count(expr.scrutinee.get());
+        for (const auto& arm : expr.arms) {
+            count(arm.guard.get());
+            count(arm.expression.get());
+        }
+    }
+    void visit(const VectorLiteralExpr& expr) { count(expr.elements); }
+    void visit(const FieldAccessExpr& expr) { count(expr.object.get()); }
+    void visit(const RecordLiteralExpr& expr) {
+        for (const auto& field : expr.fields) count(field.second.get());
+    }
+    void visit(const EnumLiteralExpr& expr) { count(expr.payload.get()); }
+    void visit(const SimpleTypeExpr&) {}
+    void visit(const GenericTypeExpr&) {}
+
+private:
+    std::string_view _function;
+
+    void count(const Expr* expr) {
+        if (!expr) return;
+        ++nodes;
+        visit_expr(*expr);
+    }
+    void count(const Stmt* stmt) {
+        if (!stmt) return;
+        ++nodes;
+        visit_stmt(*stmt);
+    }
+    template<class Node>
+    void count(const AstList<AstPtr<Node>>& nodes_list) {
+        for (const auto& node : nodes_list) count(node.get());
+    }
+};
+
+class IRGenerator final : public ExprVisitorT<IRGenerator, void>, public StmtVisitorT<IRGenerator, void> {
 public:
     struct LoopInfo {
         int id = -1;
@@ -86,60 +214,89 @@ public:
         bool annotated = false;
     };
 
-    tisc::ir::IntermediateProgram generate(const std::vector<std::unique_ptr<Stmt>>& statements) {
+    /// One inlining decision at a call site of a user function.
+    struct InlineRemark {
+        int line = 0;
+        int column = 0;
+        std::string callee;
+        std::string caller;
+        bool inlined = false;
+        /// A self tail call in an inlined body, turned into a jump back to
+        /// the top of that body.
+        bool tail_call = false;
+        std::string reason;
+    };
+
+    /// Body size, in AST nodes, up to which a call is inlined.
+    static constexpr int kDefaultInlineThreshold = 40;
+
+    tisc::ir::IntermediateProgram generate(std::span<const AstPtr<Stmt>> statements) {
+        for (const auto& stmt : statements) {
+            if (stmt->kind == StmtKind::Function) {
+                const auto& function = static_cast<const FunctionStmt&>(*stmt);
+                _functions.emplace(std::string(function.name.lexeme), &function);
+            }
+        }
         for (const auto& stmt : statements) {
-            stmt->accept(*this);
+            visit_stmt(*stmt);
         }
         return std::move(_program);
     }
 
     const std::vector<LoopInfo>& loop_infos() const { return _loop_infos; }
 
+    /**
+     * Calls to functions of this module that are not `@effect` and whose
+     * body is at most `threshold` AST nodes are expanded in place instead
+     * of lowered to CALL. Inside inlined code only leaf functions, which
+     * call nothing themselves, are inlined further. Needs an attached
+     * semantic analyzer, which rejects pure functions that call effectful
+     * ones; 0 (the default) disables inlining. Calls to `@tailrec`
+     * functions are expanded whatever the threshold.
+     */
+    void set_inline_threshold(int threshold) { _inline_threshold = threshold; }
+    const std::vector<InlineRemark>& inline_remarks() const { return _inline_remarks; }
+
     void attach_semantic_analyzer(const SemanticAnalyzer* analyzer) {
         _semantic = analyzer;
     }
 
     // Statements
-    std::any visit(const ExpressionStmt& stmt) override {
-        stmt.expression->accept(*this);
-        return {};
+    void visit(const ExpressionStmt& stmt) {
+        visit_expr(*stmt.expression);
     }
 
-    std::any visit(const BlockStmt& stmt) override {
-        for (const auto& s : stmt.statements) s->accept(*this);
-        return {};
+    void visit(const BlockStmt& stmt) {
+        for (const auto& s : stmt.statements) visit_stmt(*s);
     }
 
-    std::any visit(const VarStmt& stmt) override {
+    void visit(const VarStmt& stmt) {
         bind_variable_from_initializer(stmt.name, stmt.initializer.get());
-        return {};
     }
-    std::any visit(const LetStmt& stmt) override {
+    void visit(const LetStmt& stmt) {
         bind_variable_from_initializer(stmt.name, stmt.initializer.get());
-        return {};
     }
-    std::any visit(const IfStmt& stmt) override {
+    void visit(const IfStmt& stmt) {
         auto end_label = new_label();
 
-        stmt.condition->accept(*this);
+        visit_expr(*stmt.condition);
         auto cond = ensure_expr_result(stmt.condition.get());
 
         if (stmt.else_branch) {
             auto else_label = new_label();
             emit_jump_if_zero(else_label, cond);
-            stmt.then_branch->accept(*this);
+            visit_stmt(*stmt.then_branch);
             emit_jump(end_label);
             emit_label(else_label);
-            stmt.else_branch->accept(*this);
+            visit_stmt(*stmt.else_branch);
         } else {
             emit_jump_if_zero(end_label, cond);
-            stmt.then_branch->accept(*this);
+            visit_stmt(*stmt.then_branch);
         }
         emit_label(end_label);
-        return {};
     }
 
-    std::any visit(const WhileStmt& stmt) override {
+    void visit(const WhileStmt& stmt) {
         auto cond_label = new_label();
         auto end_label = new_label();
 
@@ -149,18 +306,17 @@ public:
         _loop_stack.push_back(info);
 
         emit_label(cond_label);
-        stmt.condition->accept(*this);
+        visit_expr(*stmt.condition);
         auto cond = ensure_expr_result(stmt.condition.get());
         emit_jump_if_zero(end_label, cond);
 
-        stmt.body->accept(*this);
+        visit_stmt(*stmt.body);
         emit_jump(cond_label);
 
         emit_label(end_label);
         _loop_stack.pop_back();
-        return {};
     }
-    std::any visit(const LoopStmt& stmt) override {
+    void visit(const LoopStmt& stmt) {
         auto entry_label = new_label();
         auto exit_label = new_label();
         auto guard_label = entry_label;
@@ -173,7 +329,7 @@ public:
             guard_label = new_label();
             info.entry_label = guard_label; // continue should go to guard
             emit_label(guard_label);
-            stmt.guard_expression->accept(*this);
+            visit_expr(*stmt.guard_expression);
             auto guard_value = ensure_expr_result(stmt.guard_expression.get());
             emit_jump_if_zero(exit_label, guard_value);
             emit_label(entry_label);
@@ -183,7 +339,7 @@ public:
 
         _loop_stack.push_back(info);
         for (const auto& statement : stmt.body) {
-            statement->accept(*this);
+            visit_stmt(*statement);
         }
         emit_jump(guard_label);
         emit_label(exit_label);
@@ -197,55 +353,66 @@ public:
         }
         _loop_infos.push_back(info);
         _loop_stack.pop_back();
-        return {};
     }
-    std::any visit(const ReturnStmt& stmt) override {
+    void visit(const ReturnStmt& stmt) {
+        if (!_inline_frames.empty()) {
+            // Evaluating the value may inline further calls and grow the
+            // frame stack, so the frame is looked up by index afterwards.
+            const size_t depth = _inline_frames.size() - 1;
+            if (stmt.value) {
+                const CallExpr* call = self_tail_call(stmt, _inline_frames[depth].callee);
+                if (call && call->arguments.size() == _inline_frames[depth].params.size()) {
+                    emit_self_tail_call(*call, depth);
+                    return;
+                }
+                auto value = evaluate_expr(stmt.value.get());
+                copy_to_dest(value, _inline_frames[depth].result);
+            }
+            emit_jump(_inline_frames[depth].exit);
+            return;
+        }
         if (stmt.value) {
             auto value = evaluate_expr(stmt.value.get());
             copy_to_dest(value, {tisc::ir::Register{0}, value.primitive});
         }
         emit_simple(tisc::ir::Opcode::HALT);
-        return {};
     }
-    std::any visit(const BreakStmt&) override {
+    void visit(const BreakStmt&) {
         if (!_loop_stack.empty()) {
             emit_jump(_loop_stack.back().exit_label);
         }
-        return {};
     }
-    std::any visit(const ContinueStmt&) override {
+    void visit(const ContinueStmt&) {
         if (!_loop_stack.empty()) {
             emit_jump(_loop_stack.back().entry_label);
         }
-        return {};
     }
-    std::any visit(const FunctionStmt& stmt) override {
+    void visit(const FunctionStmt& stmt) {
         tisc::ir::FunctionMetadata function_meta;
         function_meta.name = std::string(stmt.name.lexeme);
         function_meta.is_effectful = stmt.attributes.is_effectful;
+        function_meta.is_total = _semantic && _semantic->is_total(stmt.name.lexeme);
         function_meta.tier = stmt.attributes.tier;
         _program.add_function_metadata(std::move(function_meta));
 
         if (std::string_view(stmt.name.lexeme) != "main") {
-            return {};
+            return;
         }
+        _current_function = std::string(stmt.name.lexeme);
         for (const auto& statement : stmt.body) {
-            statement->accept(*this);
+            visit_stmt(*statement);
         }
-        return {};
     }
-    std::any visit(const ModuleDecl&) override {
-        return {};
+    void visit(const ModuleDecl&) {
     }
-    std::any visit(const ImportDecl&) override {
-        return {};
+    void visit(const ImportDecl&) {
     }
-    std::any visit(const TypeDecl& stmt) override {
-        if (!_semantic) return {};
+    void visit(const TypeDecl& stmt) {
+        if (!_semantic) return;
         std::string name{stmt.name.lexeme};
         auto aliases = _semantic->type_aliases();
         auto it = aliases.find(name);
-        if (it == aliases.end()) return {};
+        if (it == aliases.end()) return;
         tisc::ir::TypeAliasMetadata meta;
         meta.name = name;
         for (const auto& param : stmt.params) {
@@ -255,13 +422,12 @@ public:
             meta.alias = _semantic->type_expr_to_string(*it->second.alias);
         }
         _program.add_type_alias(std::move(meta));
-        return {};
     }
-    std::any visit(const RecordDecl& stmt) override {
-        if (!_semantic) return {};
+    void visit(const RecordDecl& stmt) {
+        if (!_semantic) return;
         std::string name{stmt.name.lexeme};
         auto record_it = _semantic->record_definitions().find(name);
-        if (record_it == _semantic->record_definitions().end()) return {};
+        if (record_it == _semantic->record_definitions().end()) return;
         tisc::ir::TypeAliasMetadata meta;
         meta.name = name;
         meta.kind = t81::tisc::StructuralKind::Record;
@@ -274,14 +440,13 @@ public:
             meta.fields.push_back(std::move(info));
         }
         _program.add_type_alias(std::move(meta));
-        return {};
     }
 
-    std::any visit(const EnumDecl& stmt) override {
-        if (!_semantic) return {};
+    void visit(const EnumDecl& stmt) {
+        if (!_semantic) return;
         std::string name{stmt.name.lexeme};
         auto enum_it = _semantic->enum_definitions().find(name);
-        if (enum_it == _semantic->enum_definitions().end()) return {};
+        if (enum_it == _semantic->enum_definitions().end()) return;
         tisc::ir::TypeAliasMetadata meta;
         meta.name = name;
         meta.kind = t81::tisc::StructuralKind::Enum;
@@ -297,11 +462,10 @@ public:
             meta.variants.push_back(std::move(info));
         }
         _program.add_type_alias(std::move(meta));
-        return {};
     }
 
     // Expressions
-    std::any visit(const BinaryExpr& expr) override {
+    void visit(const BinaryExpr& expr) {
         if (expr.op.type == TokenType::AmpAmp || expr.op.type == TokenType::PipePipe) {
             auto end_label = new_label();
             auto eval_right = new_label();
@@ -309,7 +473,7 @@ public:
             auto true_label = new_label();
             auto dest = allocate_typed_register(tisc::ir::PrimitiveKind::Boolean);
 
-            expr.left->accept(*this);
+            visit_expr(*expr.left);
             auto left = ensure_expr_result(expr.left.get());
 
             if (expr.op.type == TokenType::AmpAmp) {
@@ -321,7 +485,7 @@ public:
             }
 
             emit_label(eval_right);
-            expr.right->accept(*this);
+            visit_expr(*expr.right);
             auto right = ensure_expr_result(expr.right.get());
             emit_jump_if_zero(false_label, right);
             emit_jump(true_label);
@@ -346,12 +510,12 @@ public:
             }
             emit_label(end_label);
             record_result(&expr, dest);
-            return {};
+            return;
         }
 
         auto left = evaluate_expr(expr.left.get());
         auto right = evaluate_expr(expr.right.get());
-        const Type* result_type = typed_expr(&expr);
+        const std::optional<Type> result_type = typed_expr(&expr);
         NumericCategory kind = categorize(result_type);
         tisc::ir::PrimitiveKind primitive_kind = categorize_primitive(result_type);
         if (primitive_kind == tisc::ir::PrimitiveKind::Unknown) {
@@ -360,9 +524,9 @@ public:
 
         tisc::ir::ComparisonRelation relation = relation_from_token(expr.op.type);
         if (relation != tisc::ir::ComparisonRelation::None) {
-            const Type* left_type = typed_expr(expr.left.get());
-            const Type* right_type = typed_expr(expr.right.get());
-            bool both_bool = left_type && right_type && left_type->kind == Type::Kind::Bool && right_type->kind == Type::Kind::Bool;
+            const std::optional<Type> left_type = typed_expr(expr.left.get());
+            const std::optional<Type> right_type = typed_expr(expr.right.get());
+            bool both_bool = left_type && right_type && left_type->kind() == Type::Kind::Bool && right_type->kind() == Type::Kind::Bool;
 
             NumericCategory left_cat = categorize(left_type);
             NumericCategory right_cat = categorize(right_type);
@@ -406,7 +570,7 @@ public:
             instr.relation = relation;
             emit(instr);
             record_result(&expr, dest);
-            return {};
+            return;
         }
 
         if (expr.op.type == TokenType::Percent && primitive_kind != tisc::ir::PrimitiveKind::Integer) {
@@ -442,10 +606,9 @@ public:
         instr.primitive = primitive_kind;
         emit(instr);
         record_result(&expr, dest);
-        return {};
     }
 
-    std::any visit(const LiteralExpr& expr) override {
+    void visit(const LiteralExpr& expr) {
         if (expr.value.type == TokenType::True || expr.value.type == TokenType::False) {
             auto dest = allocate_typed_register(tisc::ir::PrimitiveKind::Boolean);
             auto instr = tisc::ir::Instruction{
@@ -455,7 +618,7 @@ public:
             instr.primitive = tisc::ir::PrimitiveKind::Boolean;
             emit(instr);
             record_result(&expr, dest);
-            return {};
+            return;
         }
         if (expr.value.type == TokenType::String) {
             std::string contents = decode_string_literal(expr.value);
@@ -468,7 +631,7 @@ public:
             instr.primitive = tisc::ir::PrimitiveKind::Integer;
             emit(instr);
             record_result(&expr, dest);
-            return {};
+            return;
         }
         std::string_view lexeme = expr.value.lexeme;
         int64_t value = std::stoll(std::string{lexeme});
@@ -481,16 +644,14 @@ public:
         instr.primitive = tisc::ir::PrimitiveKind::Integer;
         emit(instr);
         record_result(&expr, dest);
-        return {};
     }
 
-    std::any visit(const GroupingExpr& expr) override {
+    void visit(const GroupingExpr& expr) {
         auto value = evaluate_expr(expr.expression.get());
         record_result(&expr, value);
-        return {};
     }
 
-    std::any visit(const UnaryExpr& expr) override {
+    void visit(const UnaryExpr& expr) {
         auto right = evaluate_expr(expr.right.get());
         auto dest = allocate_typed_register(right.primitive);
         tisc::ir::Opcode opcode;
@@ -503,13 +664,12 @@ public:
         instr.primitive = right.primitive;
         emit(instr);
         record_result(&expr, dest);
-        return {};
     }
-    std::any visit(const VariableExpr& expr) override {
+    void visit(const VariableExpr& expr) {
         auto found = lookup_variable(expr.name.lexeme);
         if (found.has_value()) {
             record_result(&expr, *found);
-            return {};
+            return;
         }
 
         std::string_view name = expr.name.lexeme;
@@ -520,7 +680,7 @@ public:
             if (base_reg.has_value()) {
                 // Current IR models records opaquely; field reads reuse the base value.
                 record_result(&expr, *base_reg);
-                return {};
+                return;
             }
         }
         if (name == "None") {
@@ -528,49 +688,48 @@ public:
             emit_make_option_none(dest);
             record_result(&expr, dest);
         }
-        return {};
     }
-    std::any visit(const CallExpr& expr) override {
+    void visit(const CallExpr& expr) {
         if (auto var_expr = dynamic_cast<const VariableExpr*>(expr.callee.get())) {
             std::string func_name{var_expr->name.lexeme};
             if (func_name == "Some") {
                 if (expr.arguments.empty()) {
                     throw std::runtime_error("Some() requires a payload");
                 }
-                expr.arguments[0]->accept(*this);
+                visit_expr(*expr.arguments[0]);
                 auto payload = ensure_expr_result(expr.arguments[0].get());
                 auto dest = allocate_typed_register(tisc::ir::PrimitiveKind::Integer);
                 emit_make_option_some(dest, payload);
                 record_result(&expr, dest);
-                return {};
+                return;
             }
             if (func_name == "None") {
                 auto dest = allocate_typed_register(tisc::ir::PrimitiveKind::Integer);
                 emit_make_option_none(dest);
                 record_result(&expr, dest);
-                return {};
+                return;
             }
             if (func_name == "Ok") {
                 if (expr.arguments.empty()) {
                     throw std::runtime_error("Ok() requires a payload");
                 }
-                expr.arguments[0]->accept(*this);
+                visit_expr(*expr.arguments[0]);
                 auto payload = ensure_expr_result(expr.arguments[0].get());
                 auto dest = allocate_typed_register(tisc::ir::PrimitiveKind::Integer);
                 emit_make_result_ok(dest, payload);
                 record_result(&expr, dest);
-                return {};
+                return;
             }
             if (func_name == "Err") {
                 if (expr.arguments.empty()) {
                     throw std::runtime_error("Err() requires a payload");
                 }
-                expr.arguments[0]->accept(*this);
+                visit_expr(*expr.arguments[0]);
                 auto payload = ensure_expr_result(expr.arguments[0].get());
                 auto dest = allocate_typed_register(tisc::ir::PrimitiveKind::Integer);
                 emit_make_result_err(dest, payload);
                 record_result(&expr, dest);
-                return {};
+                return;
             }
             if (func_name == "weights.load") {
                 if (expr.arguments.size() != 1) {
@@ -589,13 +748,13 @@ public:
                 instr.text_literal = std::move(name);
                 emit(instr);
                 record_result(&expr, dest);
-                return {};
+                return;
             }
             if (func_name == "print") {
                 if (expr.arguments.size() != 1) {
                     throw std::runtime_error("print expects a single argument.");
                 }
-                expr.arguments[0]->accept(*this);
+                visit_expr(*expr.arguments[0]);
                 auto payload = ensure_expr_result(expr.arguments[0].get());
 
                 tisc::ir::Instruction note;
@@ -611,23 +770,28 @@ public:
                 zero.operands = {dest.reg, tisc::ir::Immediate{0}};
                 emit(zero);
                 record_result(&expr, dest);
-                return {};
+                return;
             }
 
-            // Minimal user-function call lowering for compile stability.
-            // We emit a symbolic CALL with a deterministic id and model the
-            // return value as r0 copied into a fresh typed register.
+            if (try_inline(expr, *var_expr)) {
+                return;
+            }
+
+            // User calls name every argument register; "lower-calls" later
+            // moves them where the calling convention passes them. The
+            // return value comes back in r0 and is copied into a fresh
+            // typed register.
             std::vector<TypedRegister> args;
             args.reserve(expr.arguments.size());
             for (const auto& arg : expr.arguments) {
-                arg->accept(*this);
+                visit_expr(*arg);
                 args.push_back(ensure_expr_result(arg.get()));
             }
 
             int function_id = 0;
             auto id_it = _function_ids.find(func_name);
             if (id_it == _function_ids.end()) {
-                function_id = static_cast<int>(_function_ids.size()) + 1;
+                function_id = _program.add_call_target(func_name);
                 _function_ids.emplace(func_name, function_id);
             } else {
                 function_id = id_it->second;
@@ -636,18 +800,18 @@ public:
             tisc::ir::Instruction call_instr;
             call_instr.opcode = tisc::ir::Opcode::CALL;
             call_instr.operands.push_back(tisc::ir::Immediate{function_id});
-            for (size_t i = 0; i < args.size() && i < 2; ++i) {
-                call_instr.operands.push_back(args[i].reg);
+            for (const auto& arg : args) {
+                call_instr.operands.push_back(arg.reg);
             }
             emit(call_instr);
 
             auto ret = allocate_typed_register(tisc::ir::PrimitiveKind::Integer);
             emit(tisc::ir::Instruction{tisc::ir::Opcode::MOV, {ret.reg, tisc::ir::Register{0}}});
             record_result(&expr, ret);
-            return {};
+            return;
         }
         for (const auto& arg : expr.arguments) {
-            arg->accept(*this);
+            visit_expr(*arg);
         }
         // Fallback for non-variable callees keeps IR generation total.
         auto ret = allocate_typed_register(tisc::ir::PrimitiveKind::Integer);
@@ -656,10 +820,9 @@ public:
         instr.operands = {ret.reg, tisc::ir::Immediate{0}};
         emit(instr);
         record_result(&expr, ret);
-        return {};
     }
-    std::any visit(const AssignExpr& expr) override {
-        expr.value->accept(*this);
+    void visit(const AssignExpr& expr) {
+        visit_expr(*expr.value);
         auto value = ensure_expr_result(expr.value.get());
         auto found = lookup_variable(expr.name.lexeme);
         if (found.has_value()) {
@@ -669,16 +832,15 @@ public:
             bind_variable(std::string(expr.name.lexeme), value);
             record_result(&expr, value);
         }
-        return {};
     }
-    std::any visit(const SimpleTypeExpr&) override   { return {}; }
-    std::any visit(const GenericTypeExpr&) override  { return {}; }
-    std::any visit(const MatchExpr& expr) override {
-        expr.scrutinee->accept(*this);
+    void visit(const SimpleTypeExpr&) {}
+    void visit(const GenericTypeExpr&) {}
+    void visit(const MatchExpr& expr) {
+        visit_expr(*expr.scrutinee);
         auto scrutinee_reg = ensure_expr_result(expr.scrutinee.get());
 
         const SemanticAnalyzer::MatchMetadata* metadata = _semantic ? _semantic->match_metadata_for(expr) : nullptr;
-        const Type* result_type = typed_expr(&expr);
+        const std::optional<Type> result_type = typed_expr(&expr);
         auto primitive = categorize_primitive(result_type);
         if (primitive == tisc::ir::PrimitiveKind::Unknown) {
             primitive = tisc::ir::PrimitiveKind::Integer;
@@ -703,94 +865,27 @@ public:
         auto flag_reg = allocate_typed_register(tisc::ir::PrimitiveKind::Boolean);
         auto payload_reg = allocate_typed_register(tisc::ir::PrimitiveKind::Integer);
 
+        // Every variant is covered, so once the others are ruled out the
+        // last one needs no test of its own.
+        const bool exhaustive = match_covers_all_variants(metadata, variants.size());
+
         for (size_t v_idx = 0; v_idx < variants.size(); ++v_idx) {
             const std::string& v_name = variants[v_idx];
             const auto& arm_indices = arms_by_variant[v_name];
-            auto next_variant_label = (v_idx + 1 < variants.size()) ? new_label() : trap_label;
-
-            // Emit check for this variant
-            if (v_name == "Some") {
-                emit_option_is_some(flag_reg, scrutinee_reg);
-                emit_jump_if_zero(next_variant_label, flag_reg);
-            } else if (v_name == "None") {
-                emit_option_is_some(flag_reg, scrutinee_reg);
-                emit_jump_if_not_zero(next_variant_label, flag_reg);
-            } else if (v_name == "Ok") {
-                emit_result_is_ok(flag_reg, scrutinee_reg);
-                emit_jump_if_zero(next_variant_label, flag_reg);
-            } else if (v_name == "Err") {
-                emit_result_is_ok(flag_reg, scrutinee_reg);
-                emit_jump_if_not_zero(next_variant_label, flag_reg);
-            } else if (metadata && metadata->kind == SemanticAnalyzer::MatchMetadata::Kind::Enum) {
-                int variant_id = -1;
-                for (size_t idx : arm_indices) {
-                    if (metadata->arms[idx].variant_id >= 0) {
-                        variant_id = metadata->arms[idx].variant_id;
-                        if (auto encoded = global_variant_id_for(metadata->arms[idx])) {
-                            variant_id = *encoded;
-                        }
-                        break;
-                    }
-                }
-                if (variant_id >= 0) {
-                    emit_enum_is_variant(flag_reg, scrutinee_reg, variant_id);
-                    emit_jump_if_zero(next_variant_label, flag_reg);
-                } else {
-                    emit_jump(next_variant_label);
-                }
-            } else {
-                emit_jump(next_variant_label);
-            }
+            const bool last = v_idx + 1 == variants.size();
+            auto next_variant_label = last ? trap_label : new_label();
 
-            // If we reached here, the variant matches. Now check arms sequentially.
-            for (size_t a_idx = 0; a_idx < arm_indices.size(); ++a_idx) {
-                size_t arm_idx = arm_indices[a_idx];
-                const auto& arm = expr.arms[arm_idx];
-                auto next_arm_label = (a_idx + 1 < arm_indices.size()) ? new_label() : next_variant_label;
-
-                enter_pattern_scope();
-
-                bool has_payload = false;
-                if (v_name == "Some") {
-                    emit_option_unwrap(payload_reg, scrutinee_reg);
-                    has_payload = true;
-                } else if (v_name == "Ok") {
-                    emit_result_unwrap_ok(payload_reg, scrutinee_reg);
-                    has_payload = true;
-                } else if (v_name == "Err") {
-                    emit_result_unwrap_err(payload_reg, scrutinee_reg);
-                    has_payload = true;
-                } else if (metadata && metadata->kind == SemanticAnalyzer::MatchMetadata::Kind::Enum) {
-                    if (metadata->arms[arm_idx].payload_type.kind != Type::Kind::Unknown) {
-                        emit_enum_unwrap_payload(payload_reg, scrutinee_reg);
-                        has_payload = true;
-                    }
-                }
-
-                if (has_payload) {
-                    bind_variant_payload(arm, payload_reg);
-                }
-
-                if (arm.guard && metadata) {
-                    const auto& arm_meta = metadata->arms[arm_idx];
-                    emit_guard_metadata(&arm_meta, arm_meta.variant_id >= 0 ? std::optional<int>(arm_meta.variant_id) : std::nullopt);
-                    arm.guard->accept(*this);
-                    auto guard_value = ensure_expr_result(arm.guard.get());
-                    emit_jump_if_zero(next_arm_label, guard_value);
-                }
-
-                arm.expression->accept(*this);
-                auto value = ensure_expr_result(arm.expression.get());
-                copy_to_dest(value, dest);
-                emit_jump(end_label);
-
-                if (a_idx + 1 < arm_indices.size()) {
-                    emit_label(next_arm_label);
-                }
-                exit_pattern_scope();
+            if (!last || !exhaustive) {
+                emit_variant_test(v_name, arm_indices, metadata, flag_reg, scrutinee_reg, next_variant_label);
             }
+            const bool has_payload = emit_variant_unwrap(v_name, arm_indices, metadata, payload_reg, scrutinee_reg);
 
-            if (v_idx + 1 < variants.size()) {
+            // Variants are disjoint: if no arm for this one matches, no
+            // other arm can, so a failed guard or nested pattern traps.
+            emit_variant_arms(expr, metadata, arm_indices, has_payload ? &payload_reg : nullptr, dest, end_label,
+                              trap_label);
+
+            if (!last) {
                 emit_label(next_variant_label);
             }
         }
@@ -799,18 +894,16 @@ public:
         emit_simple(tisc::ir::Opcode::TRAP);
         emit_label(end_label);
         emit_simple(tisc::ir::Opcode::NOP);
-        return {};
     }
 
-    std::any visit(const FieldAccessExpr& expr) override {
+    void visit(const FieldAccessExpr& expr) {
         auto value = evaluate_expr(expr.object.get());
         record_result(&expr, value);
-        return {};
     }
 
-    std::any visit(const RecordLiteralExpr& expr) override {
+    void visit(const RecordLiteralExpr& expr) {
         for (const auto& field : expr.fields) {
-            field.second->accept(*this);
+            visit_expr(*field.second);
         }
         tisc::ir::PrimitiveKind primitive = tisc::ir::PrimitiveKind::Integer;
         if (auto kind = categorize_primitive(typed_expr(&expr)); kind != tisc::ir::PrimitiveKind::Unknown) {
@@ -818,15 +911,14 @@ public:
         }
         auto dest = allocate_typed_register(primitive);
         record_result(&expr, dest);
-        return {};
     }
 
-    std::any visit(const EnumLiteralExpr& expr) override {
+    void visit(const EnumLiteralExpr& expr) {
         std::string enum_name(expr.enum_name.lexeme);
         std::string variant_name(expr.variant.lexeme);
         std::optional<int> variant_id = resolve_variant_index(enum_name, variant_name);
         if (expr.payload) {
-            expr.payload->accept(*this);
+            visit_expr(*expr.payload);
         }
         tisc::ir::PrimitiveKind primitive = tisc::ir::PrimitiveKind::Integer;
         if (auto kind = categorize_primitive(typed_expr(&expr)); kind != tisc::ir::PrimitiveKind::Unknown) {
@@ -851,11 +943,10 @@ public:
             emit_simple(tisc::ir::Opcode::TRAP);
         }
         record_result(&expr, dest);
-        return {};
     }
 
-    std::any visit(const VectorLiteralExpr& expr) override {
-        if (!_semantic) return {};
+    void visit(const VectorLiteralExpr& expr) {
+        if (!_semantic) return;
         const auto* data = _semantic->vector_literal_data(&expr);
         if (!data) {
             throw std::runtime_error("Vector literal data missing during IR generation.");
@@ -869,7 +960,6 @@ public:
         instr.literal_kind = tisc::LiteralKind::TensorHandle;
         emit(instr);
         record_result(&expr, dest);
-        return {};
     }
 
 private:
@@ -897,9 +987,9 @@ private:
         }
     }
 
-    NumericCategory categorize(const Type* type) const {
+    NumericCategory categorize(const std::optional<Type>& type) const {
         if (!type) return NumericCategory::Integer;
-        switch (type->kind) {
+        switch (type->kind()) {
             case Type::Kind::I2:
             case Type::Kind::I8:
             case Type::Kind::I16:
@@ -915,9 +1005,9 @@ private:
         }
     }
 
-    tisc::ir::PrimitiveKind categorize_primitive(const Type* type) const {
+    tisc::ir::PrimitiveKind categorize_primitive(const std::optional<Type>& type) const {
         if (!type) return tisc::ir::PrimitiveKind::Integer;
-        switch (type->kind) {
+        switch (type->kind()) {
             case Type::Kind::I2:
             case Type::Kind::I8:
             case Type::Kind::I16:
@@ -946,8 +1036,8 @@ private:
         }
     }
 
-    const Type* typed_expr(const Expr* expr) const {
-        return _semantic ? _semantic->type_of(expr) : nullptr;
+    std::optional<Type> typed_expr(const Expr* expr) const {
+        return _semantic ? _semantic->type_of(expr) : std::nullopt;
     }
 
     void emit(tisc::ir::Instruction instr) {
@@ -1051,7 +1141,7 @@ private:
     }
 
     TypedRegister evaluate_expr(const Expr* expr) {
-        expr->accept(*this);
+        visit_expr(*expr);
         auto it = _expr_registers.find(expr);
         if (it == _expr_registers.end()) {
             std::string info = typeid(*expr).name();
@@ -1138,7 +1228,7 @@ private:
     void bind_variable_from_initializer(const Token& name_token, const Expr* initializer) {
         TypedRegister reg{};
         if (initializer) {
-            initializer->accept(*this);
+            visit_expr(*initializer);
             reg = ensure_expr_result(initializer);
         } else {
             reg = allocate_typed_register(tisc::ir::PrimitiveKind::Integer);
@@ -1192,6 +1282,360 @@ private:
         bind_pattern_payload(arm.pattern, reg);
     }
 
+    struct InlineFrame {
+        std::string callee;
+        TypedRegister result;
+        tisc::ir::Label exit;
+        // Where a self tail call restarts the body, and the registers that
+        // hold its parameters.
+        tisc::ir::Label entry;
+        std::vector<TypedRegister> params;
+    };
+
+    // Inlines the call when the callee qualifies, recording a remark for
+    // every call considered either way. A call to a @tailrec function is
+    // expanded at every level and whether or not it is @effect, because its
+    // loop only exists in the expanded body; when that cannot happen the
+    // call is an error rather than a CALL.
+    bool try_inline(const CallExpr& expr, const VariableExpr& callee) {
+        const std::string name{callee.name.lexeme};
+        auto it = _functions.find(name);
+        const bool tailrec = it != _functions.end() && it->second->attributes.is_tailrec;
+        if (!tailrec && (_inline_threshold <= 0 || !_semantic)) {
+            return false;
+        }
+        const std::string caller = _inline_frames.empty() ? _current_function : _inline_frames.back().callee;
+        auto remark = [&](bool inlined, std::string reason) {
+            _inline_remarks.push_back(
+                InlineRemark{callee.name.line, callee.name.column, name, caller, inlined, false, std::move(reason)});
+            return inlined;
+        };
+        auto refuse = [&](std::string reason) {
+            if (tailrec) {
+                throw std::runtime_error("line " + std::to_string(callee.name.line) + ", column " +
+                                         std::to_string(callee.name.column) + ": cannot turn the call to @tailrec '" +
+                                         name + "' into a loop: " + reason);
+            }
+            return remark(false, std::move(reason));
+        };
+
+        if (it == _functions.end()) {
+            return remark(false, "not defined in this module");
+        }
+        if (!_semantic) {
+            return refuse("no semantic analyzer attached");
+        }
+        const FunctionStmt& function = *it->second;
+        if (function.attributes.is_effectful && !tailrec) {
+            return remark(false, "marked @effect");
+        }
+        const bool recursive = name == _current_function ||
+                               std::any_of(_inline_frames.begin(), _inline_frames.end(),
+                                           [&](const InlineFrame& frame) { return frame.callee == name; });
+        if (recursive) {
+            return refuse("recursive");
+        }
+        if (function.params.size() != expr.arguments.size()) {
+            return refuse("argument count differs from the declaration");
+        }
+        const InlineCost cost = InlineCost::of(function);
+        if (!_inline_frames.empty() && cost.calls_functions && !tailrec) {
+            return remark(false, "not a leaf function, inside inlined code");
+        }
+        const std::string budget =
+            "cost " + std::to_string(cost.nodes) + ", threshold " + std::to_string(_inline_threshold);
+        if (cost.nodes > _inline_threshold && !tailrec) {
+            return remark(false, budget);
+        }
+        remark(true, tailrec ? budget + ", marked @tailrec" : budget);
+        emit_inlined_call(expr, function, cost);
+        return true;
+    }
+
+    void emit_inlined_call(const CallExpr& expr, const FunctionStmt& function, const InlineCost& cost) {
+        std::vector<TypedRegister> args;
+        args.reserve(expr.arguments.size());
+        for (const auto& arg : expr.arguments) {
+            args.push_back(evaluate_expr(arg.get()));
+        }
+
+        // The body sees only its parameters. They get their own registers
+        // when it assigns anything, since an assignment writes through to
+        // whatever register the name is bound to, and when a self tail call
+        // rebinds them.
+        auto caller_variables = std::move(_variable_registers);
+        auto caller_loops = std::move(_loop_stack);
+        _variable_registers.clear();
+        _loop_stack.clear();
+        std::vector<TypedRegister> params;
+        params.reserve(args.size());
+        for (size_t i = 0; i < args.size(); ++i) {
+            TypedRegister param = args[i];
+            if (cost.assigns || cost.self_tail_calls > 0) {
+                param = allocate_typed_register(args[i].primitive);
+                copy_to_dest(args[i], param);
+            }
+            bind_variable(std::string(function.params[i].name.lexeme), param);
+            params.push_back(param);
+        }
+
+        auto primitive = categorize_primitive(typed_expr(&expr));
+        if (primitive == tisc::ir::PrimitiveKind::Unknown) {
+            primitive = tisc::ir::PrimitiveKind::Integer;
+        }
+        const auto& body = function.body;
+        const bool tail_return_only = cost.returns == 1 && cost.self_tail_calls == 0 && !body.empty() &&
+                                      body.back()->kind == StmtKind::Return &&
+                                      static_cast<const ReturnStmt&>(*body.back()).value;
+        _inline_frames.push_back(InlineFrame{std::string(function.name.lexeme), allocate_typed_register(primitive),
+                                             new_label(), new_label(), std::move(params)});
+        TypedRegister result = _inline_frames.back().result;
+        if (tail_return_only) {
+            // A body whose only return is its last statement needs neither
+            // the result copy nor the jump to the exit.
+            for (size_t i = 0; i + 1 < body.size(); ++i) {
+                visit_stmt(*body[i]);
+            }
+            auto value = evaluate_expr(static_cast<const ReturnStmt&>(*body.back()).value.get());
+            const bool is_argument = std::any_of(args.begin(), args.end(), [&](const TypedRegister& arg) {
+                return arg.reg.index == value.reg.index;
+            });
+            if (is_argument) {
+                copy_to_dest(value, result);
+            } else {
+                result = value;
+            }
+        } else {
+            if (!function.return_type) {
+                tisc::ir::Instruction zero;
+                zero.opcode = tisc::ir::Opcode::LOADI;
+                zero.operands = {result.reg, tisc::ir::Immediate{0}};
+                emit(zero);
+            }
+            if (cost.self_tail_calls > 0) {
+                emit_label(_inline_frames.back().entry);
+            }
+            for (const auto& statement : body) {
+                visit_stmt(*statement);
+            }
+            emit_label(_inline_frames.back().exit);
+        }
+        _inline_frames.pop_back();
+
+        _variable_registers = std::move(caller_variables);
+        _loop_stack = std::move(caller_loops);
+        record_result(&expr, result);
+    }
+
+    // Restarts the inlined body of frame `depth` with the call's arguments
+    // as its parameters. Every argument is read before any parameter is
+    // written, so one that is another parameter goes through a copy.
+    void emit_self_tail_call(const CallExpr& call, size_t depth) {
+        const auto& callee = static_cast<const VariableExpr&>(*call.callee);
+        _inline_remarks.push_back(InlineRemark{callee.name.line, callee.name.column, _inline_frames[depth].callee,
+                                               _inline_frames[depth].callee, false, true, "turned into a loop"});
+        std::vector<TypedRegister> args;
+        args.reserve(call.arguments.size());
+        for (const auto& arg : call.arguments) {
+            args.push_back(evaluate_expr(arg.get()));
+        }
+        const InlineFrame& frame = _inline_frames[depth];
+        for (size_t i = 0; i < args.size(); ++i) {
+            const bool other_param = std::any_of(frame.params.begin(), frame.params.end(), [&](const TypedRegister& p) {
+                return p.reg.index == args[i].reg.index && p.reg.index != frame.params[i].reg.index;
+            });
+            if (other_param) {
+                TypedRegister copy = allocate_typed_register(args[i].primitive);
+                copy_to_dest(args[i], copy);
+                args[i] = copy;
+            }
+        }
+        for (size_t i = 0; i < args.size(); ++i) {
+            if (args[i].reg.index != frame.params[i].reg.index) {
+                copy_to_dest(args[i], frame.params[i]);
+            }
+        }
+        emit_jump(frame.entry);
+    }
+
+    bool match_covers_all_variants(const SemanticAnalyzer::MatchMetadata* metadata, size_t variant_count) const {
+        if (!metadata || metadata->arms.empty()) {
+            return false;
+        }
+        switch (metadata->kind) {
+            case SemanticAnalyzer::MatchMetadata::Kind::Option:
+                return metadata->has_some && metadata->has_none;
+            case SemanticAnalyzer::MatchMetadata::Kind::Result:
+                return metadata->has_ok && metadata->has_err;
+            case SemanticAnalyzer::MatchMetadata::Kind::Enum: {
+                const auto* info = enum_info_for_name(metadata->arms.front().enum_name);
+                return info && info->variant_order.size() == variant_count;
+            }
+            default:
+                return false;
+        }
+    }
+
+    // Branches to `mismatch` unless the scrutinee holds variant `v_name`.
+    void emit_variant_test(const std::string& v_name,
+                           const std::vector<size_t>& arm_indices,
+                           const SemanticAnalyzer::MatchMetadata* metadata,
+                           const TypedRegister& flag_reg,
+                           const TypedRegister& scrutinee_reg,
+                           tisc::ir::Label mismatch) {
+        if (v_name == "Some") {
+            emit_option_is_some(flag_reg, scrutinee_reg);
+            emit_jump_if_zero(mismatch, flag_reg);
+        } else if (v_name == "None") {
+            emit_option_is_some(flag_reg, scrutinee_reg);
+            emit_jump_if_not_zero(mismatch, flag_reg);
+        } else if (v_name == "Ok") {
+            emit_result_is_ok(flag_reg, scrutinee_reg);
+            emit_jump_if_zero(mismatch, flag_reg);
+        } else if (v_name == "Err") {
+            emit_result_is_ok(flag_reg, scrutinee_reg);
+            emit_jump_if_not_zero(mismatch, flag_reg);
+        } else if (metadata && metadata->kind == SemanticAnalyzer::MatchMetadata::Kind::Enum) {
+            int variant_id = -1;
+            for (size_t idx : arm_indices) {
+                if (metadata->arms[idx].variant_id >= 0) {
+                    variant_id = metadata->arms[idx].variant_id;
+                    if (auto encoded = global_variant_id_for(metadata->arms[idx])) {
+                        variant_id = *encoded;
+                    }
+                    break;
+                }
+            }
+            if (variant_id >= 0) {
+                emit_enum_is_variant(flag_reg, scrutinee_reg, variant_id);
+                emit_jump_if_zero(mismatch, flag_reg);
+            } else {
+                emit_jump(mismatch);
+            }
+        } else {
+            emit_jump(mismatch);
+        }
+    }
+
+    // Unwraps the payload of variant `v_name` once for all of its arms.
+    bool emit_variant_unwrap(const std::string& v_name,
+                             const std::vector<size_t>& arm_indices,
+                             const SemanticAnalyzer::MatchMetadata* metadata,
+                             const TypedRegister& payload_reg,
+                             const TypedRegister& scrutinee_reg) {
+        if (v_name == "Some") {
+            emit_option_unwrap(payload_reg, scrutinee_reg);
+            return true;
+        }
+        if (v_name == "Ok") {
+            emit_result_unwrap_ok(payload_reg, scrutinee_reg);
+            return true;
+        }
+        if (v_name == "Err") {
+            emit_result_unwrap_err(payload_reg, scrutinee_reg);
+            return true;
+        }
+        if (metadata && metadata->kind == SemanticAnalyzer::MatchMetadata::Kind::Enum &&
+            metadata->arms[arm_indices.front()].payload_type.kind() != Type::Kind::Unknown) {
+            emit_enum_unwrap_payload(payload_reg, scrutinee_reg);
+            return true;
+        }
+        return false;
+    }
+
+    // The encoded id of the payload variant a nested pattern such as
+    // `Some(Circle(r))` names, or -1 when it cannot be resolved.
+    int nested_variant_id(const MatchPattern& pattern, const SemanticAnalyzer::MatchMetadata::ArmInfo* info) const {
+        if (!info || info->payload_type.kind() != Type::Kind::Custom) {
+            return -1;
+        }
+        const std::string& enum_name = info->payload_type.custom_name();
+        auto index = resolve_variant_index(enum_name, pattern.variant_name.lexeme);
+        if (!index) {
+            return -1;
+        }
+        return global_variant_id_for(enum_name, *index).value_or(-1);
+    }
+
+    /**
+     * Emits the arms of one variant in source order, as a decision tree over
+     * the payload: an arm with a nested variant pattern tests the payload's
+     * variant, each payload variant is tested at most once, and a failed
+     * test skips the run of following arms that need the same variant.
+     */
+    void emit_variant_arms(const MatchExpr& expr,
+                           const SemanticAnalyzer::MatchMetadata* metadata,
+                           const std::vector<size_t>& arm_indices,
+                           const TypedRegister* payload_reg,
+                           const TypedRegister& dest,
+                           tisc::ir::Label end_label,
+                           tisc::ir::Label fail_label) {
+        const size_t count = arm_indices.size();
+        std::vector<std::optional<int>> nested(count);
+        std::vector<tisc::ir::Label> entries(count);
+        for (size_t a_idx = 0; a_idx < count; ++a_idx) {
+            const auto& pattern = expr.arms[arm_indices[a_idx]].pattern;
+            if (payload_reg && pattern.kind == MatchPattern::Kind::Variant) {
+                nested[a_idx] = nested_variant_id(pattern, metadata ? &metadata->arms[arm_indices[a_idx]] : nullptr);
+            }
+            if (a_idx > 0) {
+                entries[a_idx] = new_label();
+            }
+        }
+        auto entry = [&](size_t a_idx) { return a_idx < count ? entries[a_idx] : fail_label; };
+
+        std::unordered_map<int, TypedRegister> nested_flags;
+        for (size_t a_idx = 0; a_idx < count; ++a_idx) {
+            size_t arm_idx = arm_indices[a_idx];
+            const auto& arm = expr.arms[arm_idx];
+            if (a_idx > 0) {
+                emit_label(entries[a_idx]);
+            }
+
+            enter_pattern_scope();
+
+            if (nested[a_idx]) {
+                size_t skip = a_idx + 1;
+                while (skip < count && nested[skip] == nested[a_idx]) {
+                    ++skip;
+                }
+                const int variant_id = *nested[a_idx];
+                if (variant_id < 0) {
+                    emit_jump(entry(skip));
+                } else {
+                    auto flag = nested_flags.find(variant_id);
+                    if (flag == nested_flags.end()) {
+                        flag = nested_flags.emplace(variant_id, allocate_typed_register(tisc::ir::PrimitiveKind::Boolean)).first;
+                        emit_enum_is_variant(flag->second, *payload_reg, variant_id);
+                    }
+                    emit_jump_if_zero(entry(skip), flag->second);
+                    if (arm.pattern.variant_payload) {
+                        auto inner = allocate_typed_register(tisc::ir::PrimitiveKind::Integer);
+                        emit_enum_unwrap_payload(inner, *payload_reg);
+                        bind_pattern_payload(*arm.pattern.variant_payload, inner);
+                    }
+                }
+            } else if (payload_reg) {
+                bind_variant_payload(arm, *payload_reg);
+            }
+
+            if (arm.guard && metadata) {
+                const auto& arm_meta = metadata->arms[arm_idx];
+                emit_guard_metadata(&arm_meta, arm_meta.variant_id >= 0 ? std::optional<int>(arm_meta.variant_id) : std::nullopt);
+                visit_expr(*arm.guard);
+                auto guard_value = ensure_expr_result(arm.guard.get());
+                emit_jump_if_zero(entry(a_idx + 1), guard_value);
+            }
+
+            visit_expr(*arm.expression);
+            auto value = ensure_expr_result(arm.expression.get());
+            copy_to_dest(value, dest);
+            emit_jump(end_label);
+
+            exit_pattern_scope();
+        }
+    }
+
     std::string guard_metadata_reason(const SemanticAnalyzer::MatchMetadata::ArmInfo& info,
                                       std::optional<int> variant_id) const {
         std::ostringstream oss;
@@ -1203,7 +1647,7 @@ private:
         if (variant_id.has_value()) {
             oss << " variant-id=" << *variant_id;
         }
-        if (_semantic && info.payload_type.kind != Type::Kind::Unknown) {
+        if (_semantic && info.payload_type.kind() != Type::Kind::Unknown) {
             oss << " payload=" << _semantic->type_name(info.payload_type);
         }
         return oss.str();
@@ -1271,11 +1715,16 @@ private:
     tisc::ir::IntermediateProgram _program;
     SymbolTable _symbols;
     const SemanticAnalyzer* _semantic = nullptr;
-    int _register_count = 0;
+    int _register_count = tisc::ir::kFirstVirtualRegister;
     int _label_count = 0;
     std::unordered_map<const Expr*, TypedRegister> _expr_registers;
     std::unordered_map<std::string, TypedRegister> _variable_registers;
     std::unordered_map<std::string, int> _function_ids;
+    std::unordered_map<std::string, const FunctionStmt*> _functions;
+    std::string _current_function;
+    int _inline_threshold = 0;
+    std::vector<InlineFrame> _inline_frames;
+    std::vector<InlineRemark> _inline_remarks;
     std::vector<std::vector<std::pair<std::string, std::optional<TypedRegister>>>> _pattern_scopes;
     std::vector<LoopInfo> _loop_infos;
     std::vector<LoopInfo> _loop_stack;
@@ -6,6 +6,11 @@
 #ifndef T81_FRONTEND_LEXER_HPP
 #define T81_FRONTEND_LEXER_HPP
 
+#include "t81/frontend/identifier_interner.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -69,11 +74,45 @@ enum class TokenType {
  */
 struct Token {
     TokenType type;             ///< The type of the token.
+    SymbolId symbol;            ///< Interned spelling of identifiers; kEmptySymbol otherwise.
     std::string_view lexeme;    ///< The substring from the source code.
     int line;                   ///< The line number where the token appears.
     int column;                 ///< The column number where the token begins.
 };
 
+/**
+ * @struct TokenStream
+ * @brief A whole source file tokenized up front, stored as parallel arrays.
+ *
+ * Each token is scanned exactly once. Index `i` addresses the same token in
+ * every array, and the final entry is always `TokenType::Eof`. Source tokens
+ * store their byte offset and length into `source`. `TokenType::Illegal`
+ * tokens carry a diagnostic message instead of a source slice, so for them
+ * `offsets[i]` indexes `messages`. `symbols[i]` is the interned id of an
+ * identifier token.
+ */
+struct TokenStream {
+    std::string_view source;
+    std::vector<TokenType> types;
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> lengths;
+    std::vector<std::int32_t> lines;
+    std::vector<std::int32_t> columns;
+    std::vector<SymbolId> symbols;
+    std::vector<std::string_view> messages;
+
+    /**
+     * @brief Tokenizes all of `source` into a new stream.
+     * @param source The source text; it must outlive the stream.
+     */
+    static TokenStream tokenize(std::string_view source);
+
+    std::size_t size() const { return types.size(); }
+
+    /// Reassembles the token at `index`; indices past the end yield the Eof token.
+    Token token(std::size_t index) const;
+};
+
 /**
  * @class Lexer
  * @brief A lexical analyzer for the T81Lang language.
@@ -106,7 +145,20 @@ public:
      */
     Token peek_next_token();
 
+    /**
+     * @brief Peeks `distance` tokens past the next one without consuming any.
+     *
+     * Peeked tokens are held in a bounded ring buffer and handed out by
+     * `next_token()`, so each token is scanned exactly once.
+     * @param distance Zero for the next token; must be below kMaxLookahead.
+     * @return The peeked Token.
+     */
+    Token peek_token(std::size_t distance = 0);
+
+    static constexpr std::size_t kMaxLookahead = 4;
+
 private:
+    Token scan_token();
     char advance();
     char peek() const;
     char peek_next() const;
@@ -121,11 +173,21 @@ private:
     void skip_whitespace_and_comments();
     bool match(char expected);
 
+    // Raw-pointer views of the cursor for the vectorized run scanners.
+    const char* cursor_ptr() const;
+    const char* end_ptr() const;
+    void seek(const char* position);
+    void track_newlines(const char* begin, const char* end);
+
     std::string_view _source;
     std::string_view::iterator _current;
     std::string_view::iterator _line_start;
     std::string_view::iterator _token_start;
     int _line;
+
+    std::array<Token, kMaxLookahead> _lookahead{};
+    std::size_t _lookahead_head = 0;
+    std::size_t _lookahead_count = 0;
 };
 
 } // namespace frontend
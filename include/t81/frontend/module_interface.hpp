@@ -0,0 +1,175 @@
+/**
+ * @file module_interface.hpp
+ * @brief Defines ModuleInterface, the exported surface of a checked module,
+ *        and its compact binary encoding (.t81i).
+ */
+
+#ifndef T81_FRONTEND_MODULE_INTERFACE_HPP
+#define T81_FRONTEND_MODULE_INTERFACE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "t81/frontend/ast.hpp"
+
+namespace t81 {
+namespace frontend {
+
+class SemanticAnalyzer;
+
+/**
+ * @struct ModuleInterface
+ * @brief Everything an importer may rely on from a module that passed
+ *        semantic analysis: its top-level function signatures (with
+ *        `@effect` and `@tier`), records, enums and type aliases, plus the
+ *        provenance needed to tell whether the interface is still current.
+ *
+ * Types are kept in their source spelling (`Option[i32]`), exactly as the
+ * analyzer prints them, so an interface never depends on interner state.
+ */
+struct ModuleInterface {
+    struct Param {
+        std::string name;
+        std::string type;
+        bool operator==(const Param&) const = default;
+    };
+    struct Function {
+        std::string name;
+        std::vector<Param> params;
+        std::string return_type;  // Empty when the function declares none.
+        bool is_effectful = false;
+        std::optional<std::int64_t> tier;
+        bool operator==(const Function&) const = default;
+    };
+    struct Record {
+        std::string name;
+        std::vector<Param> fields;
+        std::uint32_t schema_version = 1;
+        std::string module_path;
+        bool operator==(const Record&) const = default;
+    };
+    struct Variant {
+        std::string name;
+        std::optional<std::string> payload;
+        int id = -1;
+        bool operator==(const Variant&) const = default;
+    };
+    struct Enum {
+        std::string name;
+        std::vector<Variant> variants;
+        std::uint32_t schema_version = 1;
+        std::string module_path;
+        int id = -1;
+        bool operator==(const Enum&) const = default;
+    };
+    struct Alias {
+        std::string name;
+        std::vector<std::string> params;
+        std::string target;
+        bool operator==(const Alias&) const = default;
+    };
+    /// An import and the exports hash of the dependency's interface at the
+    /// time this module was checked.
+    struct Import {
+        std::string path;
+        std::string interface_hash;
+        bool operator==(const Import&) const = default;
+    };
+
+    std::string compiler_stamp;
+    std::string source_hash;  // SHA-256 of the source text, hex.
+    std::uint64_t source_size = 0;
+    std::int64_t source_mtime = 0;
+    std::string module_path;  // Empty when the module has no declaration.
+
+    std::vector<Import> imports;
+    std::vector<Function> functions;
+    std::vector<Record> records;
+    std::vector<Enum> enums;
+    std::vector<Alias> aliases;
+
+    /// Collects the top-level declarations of a module `analyzer` has
+    /// checked without errors. Provenance fields are left for the caller.
+    static ModuleInterface build(const SemanticAnalyzer& analyzer,
+                                 std::span<const AstPtr<Stmt>> statements);
+
+    /// Hash of the exported declarations only: editing a function body
+    /// leaves it unchanged, so importers need not be rechecked.
+    std::string exports_hash() const;
+
+    /// Encodes the interface in the .t81i layout described in
+    /// module_interface.cpp.
+    std::string serialize() const;
+
+    bool operator==(const ModuleInterface&) const = default;
+};
+
+/**
+ * @class ModuleInterfaceView
+ * @brief Read-only accessor over an encoded interface, typically a mapped
+ *        .t81i file. Nothing is copied: strings are views into the buffer,
+ *        which must outlive the view.
+ *
+ * `open` validates every offset up front, so the accessors never read out
+ * of bounds. `materialize` decodes the full ModuleInterface when a caller
+ * needs the declarations themselves rather than the header.
+ */
+class ModuleInterfaceView {
+public:
+    static std::optional<ModuleInterfaceView> open(std::span<const std::byte> bytes);
+
+    std::string_view compiler_stamp() const;
+    std::string_view source_hash() const;
+    std::string_view exports_hash() const;
+    std::string_view module_path() const;
+    std::uint64_t source_size() const;
+    std::int64_t source_mtime() const;
+
+    std::size_t import_count() const;
+    std::string_view import_path(std::size_t index) const;
+    std::string_view import_interface_hash(std::size_t index) const;
+
+    ModuleInterface materialize() const;
+
+    enum class Section : std::uint32_t {
+        Imports = 1,
+        Functions,
+        Params,
+        Records,
+        Fields,
+        Enums,
+        Variants,
+        Aliases,
+        AliasParams,
+    };
+    static constexpr std::size_t kSectionCount = 9;
+
+private:
+    struct SectionInfo {
+        std::uint32_t offset = 0;
+        std::uint32_t count = 0;
+        std::uint32_t stride = 0;
+    };
+
+    explicit ModuleInterfaceView(std::span<const std::byte> bytes) : _bytes(bytes) {}
+    bool validate();
+    const std::byte* record(Section section, std::size_t index) const;
+    std::string_view str(const std::byte* field) const;
+    bool str_ok(const std::byte* field) const;
+
+    std::span<const std::byte> _bytes;
+    std::array<SectionInfo, kSectionCount> _sections{};
+    std::uint32_t _strings_offset = 0;
+    std::uint32_t _strings_size = 0;
+};
+
+} // namespace frontend
+} // namespace t81
+
+#endif // T81_FRONTEND_MODULE_INTERFACE_HPP
@@ -3,11 +3,15 @@
 
 #include "t81/frontend/ast.hpp"
 #include "t81/frontend/lexer.hpp"
+#include "t81/frontend/token_set.hpp"
 #include <vector>
 #include <memory>
 #include <optional>
 #include <cstdint>
+#include <iosfwd>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 namespace t81 {
 namespace frontend {
@@ -21,10 +25,14 @@ struct StructuralAttributes {
 class Parser {
 public:
     Parser(Lexer& lexer, std::string source_name = {});
+    /// Parses a pre-tokenized stream by index; `tokens` must outlive the parser.
+    Parser(const TokenStream& tokens, std::string source_name = {});
 
-    std::vector<std::unique_ptr<Stmt>> parse();
+    SyntaxTree parse();
 
     bool had_error() const { return _had_error; }
+    /// Redirects diagnostics (std::cerr by default); `os` must outlive the parser.
+    void set_error_stream(std::ostream& os) { _errors = &os; }
 
 private:
     struct FunctionAttributesParse {
@@ -33,60 +41,79 @@ private:
     };
 
     // Grammar rule methods
-    std::unique_ptr<Stmt> declaration();
-    std::unique_ptr<Stmt> module_declaration(Token keyword);
-    std::unique_ptr<Stmt> import_declaration(Token keyword);
-    std::unique_ptr<Stmt> loop_statement();
-    std::unique_ptr<Stmt> function(const std::string& kind, FunctionAttributes attributes = {});
-    std::unique_ptr<Stmt> type_declaration();
-    std::unique_ptr<Stmt> record_declaration(std::optional<StructuralAttributes> attributes = std::nullopt);
-    std::unique_ptr<Stmt> enum_declaration(std::optional<StructuralAttributes> attributes = std::nullopt);
-    std::unique_ptr<Stmt> statement();
-    std::unique_ptr<Stmt> var_declaration();
-    std::unique_ptr<Stmt> let_declaration();
-    std::unique_ptr<Stmt> expression_statement();
-    std::vector<std::unique_ptr<Stmt>> block();
+    AstPtr<Stmt> declaration();
+    AstPtr<Stmt> module_declaration(Token keyword);
+    AstPtr<Stmt> import_declaration(Token keyword);
+    AstPtr<Stmt> loop_statement();
+    AstPtr<Stmt> function(const std::string& kind, FunctionAttributes attributes = {});
+    AstPtr<Stmt> type_declaration();
+    AstPtr<Stmt> record_declaration(std::optional<StructuralAttributes> attributes = std::nullopt);
+    AstPtr<Stmt> enum_declaration(std::optional<StructuralAttributes> attributes = std::nullopt);
+    AstPtr<Stmt> statement();
+    AstPtr<Stmt> var_declaration();
+    AstPtr<Stmt> let_declaration();
+    AstPtr<Stmt> expression_statement();
+    AstList<AstPtr<Stmt>> block();
 
-    std::unique_ptr<Expr> expression();
-    std::unique_ptr<Expr> assignment();
-    std::unique_ptr<Expr> logical_or();
-    std::unique_ptr<Expr> logical_and();
-    std::unique_ptr<Expr> equality();
-    std::unique_ptr<Expr> comparison();
-    std::unique_ptr<Expr> term();
-    std::unique_ptr<Expr> factor();
-    std::unique_ptr<Expr> unary();
-    std::unique_ptr<Expr> primary();
-    std::unique_ptr<Expr> match_expression();
+    AstPtr<Expr> expression();
+    AstPtr<Expr> assignment();
+    AstPtr<Expr> logical_or();
+    AstPtr<Expr> logical_and();
+    AstPtr<Expr> equality();
+    AstPtr<Expr> comparison();
+    AstPtr<Expr> term();
+    AstPtr<Expr> factor();
+    AstPtr<Expr> unary();
+    AstPtr<Expr> primary();
+    AstPtr<Expr> match_expression();
     MatchArm match_arm();
     MatchPattern parse_match_pattern();
-    std::unique_ptr<Expr> record_literal(Token type_name);
-    std::unique_ptr<TypeExpr> type();
+    AstPtr<Expr> record_literal(Token type_name);
+    AstPtr<TypeExpr> type();
     bool is_type_start();
     bool parse_loop_annotation(LoopStmt::BoundKind& bound_kind,
                                std::optional<std::int64_t>& bound_value,
                                Token& attr_token,
-                               std::unique_ptr<Expr>& guard_expr);
-    std::unique_ptr<GenericTypeExpr> parse_generic_type(Token name);
+                               AstPtr<Expr>& guard_expr);
+    AstPtr<GenericTypeExpr> parse_generic_type(Token name);
     std::optional<StructuralAttributes> parse_structural_attributes();
     std::optional<FunctionAttributesParse> parse_function_attributes();
 
     // Helper methods
-    bool match(const std::vector<TokenType>& types);
+    bool match(TokenType type);
+    bool match(TokenSet types);
     bool check(TokenType type);
     Token advance();
     bool is_at_end();
     Token peek();
     Token previous();
     Token consume(TokenType type, const char* message);
+    Token next_token();
+    Token peek_next_token();
+
+    template<class T, class... Args>
+    T* make(Args&&... args) {
+        T* node = _arena->make<T>(std::forward<Args>(args)...);
+        if constexpr (std::is_base_of_v<Expr, T> || std::is_base_of_v<Stmt, T>) {
+            node->id = _next_node_id++;
+        }
+        return node;
+    }
+    template<class T>
+    AstList<T> list(std::vector<T>&& items) { return _arena->make_list(std::move(items)); }
     void synchronize();
     bool try_parse_enum_literal(const Token& token, Token& enum_name, Token& variant_name) const;
 
-    Lexer& _lexer;
+    Lexer* _lexer = nullptr;
+    const TokenStream* _tokens = nullptr;
+    std::size_t _token_index = 0;
+    std::shared_ptr<AstArena> _arena = std::make_shared<AstArena>();
+    NodeId _next_node_id = 0;
     Token _current;
     Token _previous;
     bool _had_error = false;
     std::string _source_name;
+    std::ostream* _errors;
     void report_error(const Token& token, const std::string& message);
 };
 
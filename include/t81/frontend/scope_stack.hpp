@@ -0,0 +1,96 @@
+/**
+ * @file scope_stack.hpp
+ * @brief Defines ScopeStack, the SymbolId-keyed scope chain shared by the
+ *        semantic analyzer and SymbolTable.
+ */
+
+#ifndef T81_FRONTEND_SCOPE_STACK_HPP
+#define T81_FRONTEND_SCOPE_STACK_HPP
+
+#include "t81/frontend/identifier_interner.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace t81 {
+namespace frontend {
+
+/**
+ * @class ScopeStack
+ * @brief Lexically scoped bindings keyed by SymbolId.
+ *
+ * Instead of one hash map per scope, every binding is pushed onto a single
+ * stack and `_innermost` maps a SymbolId directly to its visible binding.
+ * A binding remembers the one it shadows, so `exit_scope` restores outer
+ * bindings by unwinding the stack. Lookup is one array index and never
+ * allocates; pointers returned by `lookup` stay valid until their scope
+ * exits.
+ */
+template <typename T>
+class ScopeStack {
+public:
+    void enter_scope() { _scope_marks.push_back(_bindings.size()); }
+
+    void exit_scope() {
+        if (_scope_marks.empty()) return;
+        const std::size_t mark = _scope_marks.back();
+        _scope_marks.pop_back();
+        while (_bindings.size() > mark) {
+            const Binding& binding = _bindings.back();
+            _innermost[binding.id] = binding.shadowed;
+            _bindings.pop_back();
+        }
+    }
+
+    /// Binds `id` in the innermost scope, replacing an existing binding of
+    /// `id` in that scope. Does nothing when no scope is open.
+    T* define(SymbolId id, T value) {
+        if (_scope_marks.empty()) return nullptr;
+        if (id >= _innermost.size()) _innermost.resize(std::max<std::size_t>(id + 1, _innermost.size() * 2), kUnbound);
+        if (defined_in_current_scope(id)) {
+            T& slot = _bindings[_innermost[id]].value;
+            slot = std::move(value);
+            return &slot;
+        }
+        _bindings.push_back(Binding{id, _innermost[id], std::move(value)});
+        _innermost[id] = static_cast<std::uint32_t>(_bindings.size() - 1);
+        return &_bindings.back().value;
+    }
+
+    T* lookup(SymbolId id) {
+        if (id >= _innermost.size() || _innermost[id] == kUnbound) return nullptr;
+        return &_bindings[_innermost[id]].value;
+    }
+    const T* lookup(SymbolId id) const {
+        return const_cast<ScopeStack*>(this)->lookup(id);
+    }
+
+    bool defined_in_current_scope(SymbolId id) const {
+        if (_scope_marks.empty() || id >= _innermost.size() || _innermost[id] == kUnbound) return false;
+        return _innermost[id] >= _scope_marks.back();
+    }
+
+    std::size_t depth() const { return _scope_marks.size(); }
+
+private:
+    static constexpr std::uint32_t kUnbound = ~std::uint32_t{0};
+
+    struct Binding {
+        SymbolId id;
+        std::uint32_t shadowed;
+        T value;
+    };
+
+    std::deque<Binding> _bindings;
+    std::vector<std::uint32_t> _innermost;
+    std::vector<std::size_t> _scope_marks;
+};
+
+} // namespace frontend
+} // namespace t81
+
+#endif // T81_FRONTEND_SCOPE_STACK_HPP
@@ -7,54 +7,24 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <optional>
+#include <span>
+#include <string_view>
 #include <utility>
 #include <cstdint>
 #include "t81/frontend/ast.hpp"
+#include "t81/frontend/flat_ast.hpp"
 #include "t81/frontend/lexer.hpp"
+#include "t81/frontend/scope_stack.hpp"
+#include "t81/frontend/type_interner.hpp"
 
 namespace t81 {
-namespace frontend {
-
-class IRGenerator;
-
-// Simple type system representation for semantic analysis
-struct Type {
-    enum class Kind {
-        Void,
-        Bool,
-        I2,
-        I8,
-        I16,
-        I32,
-        BigInt,
-        Float,
-        Fraction,
-        Vector,
-        Matrix,
-        Tensor,
-        Graph,
-        Option,
-        Result,
-        String,
-        Constant,
-        Custom,
-        Unknown,
-        Error
-    };
 
-    Kind kind = Kind::Unknown;
-    std::vector<Type> params;
-    std::string custom_name;
+class WorkStealingPool;
 
-    explicit Type(Kind kind_ = Kind::Unknown,
-                  std::vector<Type> params_ = {},
-                  std::string custom_name_ = {})
-        : kind(kind_), params(std::move(params_)), custom_name(std::move(custom_name_)) {}
-    [[nodiscard]] static Type constant(std::string repr);
+namespace frontend {
 
-    [[nodiscard]] bool operator==(const Type& other) const;
-    [[nodiscard]] bool operator!=(const Type& other) const { return !(*this == other); }
-};
+class IRGenerator;
+struct ModuleInterface;
 
 // Simple symbol information for semantic analysis
 enum class SymbolKind {
@@ -105,49 +75,55 @@ struct EnumInfo {
     int id = -1;
 };
 
-class SemanticAnalyzer : public StmtVisitor, public ExprVisitor {
+class SemanticAnalyzer final : public StmtVisitorT<SemanticAnalyzer, void>,
+                               public ExprVisitorT<SemanticAnalyzer, Type> {
     friend class IRGenerator;
+    friend struct ModuleInterface;
 public:
-    explicit SemanticAnalyzer(const std::vector<std::unique_ptr<Stmt>>& statements,
+    explicit SemanticAnalyzer(std::span<const AstPtr<Stmt>> statements,
                               std::string source_name = {});
     void analyze();
+    /// Checks independent function bodies on `pool`; null (the default)
+    /// analyzes serially. Results are identical either way. analyze() must
+    /// not be called from one of the pool's own workers.
+    void set_thread_pool(WorkStealingPool* pool) { _pool = pool; }
     bool had_error() const { return _had_error; }
     const std::vector<Diagnostic>& diagnostics() const { return _diagnostics; }
     const std::string& source_name() const { return _source_name; }
 
     // Visitor methods for statements
-    std::any visit(const ExpressionStmt& stmt) override;
-    std::any visit(const VarStmt& stmt) override;
-    std::any visit(const LetStmt& stmt) override;
-    std::any visit(const BlockStmt& stmt) override;
-    std::any visit(const IfStmt& stmt) override;
-    std::any visit(const WhileStmt& stmt) override;
-    std::any visit(const LoopStmt& stmt) override;
-    std::any visit(const ReturnStmt& stmt) override;
-    std::any visit(const BreakStmt& stmt) override;
-    std::any visit(const ContinueStmt& stmt) override;
-    std::any visit(const FunctionStmt& stmt) override;
-    std::any visit(const ModuleDecl& stmt) override;
-    std::any visit(const ImportDecl& stmt) override;
-    std::any visit(const TypeDecl& stmt) override;
-    std::any visit(const RecordDecl& stmt) override;
-    std::any visit(const EnumDecl& stmt) override;
+    void visit(const ExpressionStmt& stmt);
+    void visit(const VarStmt& stmt);
+    void visit(const LetStmt& stmt);
+    void visit(const BlockStmt& stmt);
+    void visit(const IfStmt& stmt);
+    void visit(const WhileStmt& stmt);
+    void visit(const LoopStmt& stmt);
+    void visit(const ReturnStmt& stmt);
+    void visit(const BreakStmt& stmt);
+    void visit(const ContinueStmt& stmt);
+    void visit(const FunctionStmt& stmt);
+    void visit(const ModuleDecl& stmt);
+    void visit(const ImportDecl& stmt);
+    void visit(const TypeDecl& stmt);
+    void visit(const RecordDecl& stmt);
+    void visit(const EnumDecl& stmt);
 
     // Visitor methods for expressions
-    std::any visit(const FieldAccessExpr& expr) override;
-    std::any visit(const RecordLiteralExpr& expr) override;
-    std::any visit(const EnumLiteralExpr& expr) override;
-    std::any visit(const AssignExpr& expr) override;
-    std::any visit(const BinaryExpr& expr) override;
-    std::any visit(const CallExpr& expr) override;
-    std::any visit(const GroupingExpr& expr) override;
-    std::any visit(const LiteralExpr& expr) override;
-    std::any visit(const UnaryExpr& expr) override;
-    std::any visit(const VariableExpr& expr) override;
-    std::any visit(const MatchExpr& expr) override;
-    std::any visit(const VectorLiteralExpr& expr) override;
-    std::any visit(const SimpleTypeExpr& expr) override;
-    std::any visit(const GenericTypeExpr& expr) override;
+    Type visit(const FieldAccessExpr& expr);
+    Type visit(const RecordLiteralExpr& expr);
+    Type visit(const EnumLiteralExpr& expr);
+    Type visit(const AssignExpr& expr);
+    Type visit(const BinaryExpr& expr);
+    Type visit(const CallExpr& expr);
+    Type visit(const GroupingExpr& expr);
+    Type visit(const LiteralExpr& expr);
+    Type visit(const UnaryExpr& expr);
+    Type visit(const VariableExpr& expr);
+    Type visit(const MatchExpr& expr);
+    Type visit(const VectorLiteralExpr& expr);
+    Type visit(const SimpleTypeExpr& expr);
+    Type visit(const GenericTypeExpr& expr);
 
 struct MatchMetadata {
         const MatchExpr* expr = nullptr;
@@ -199,28 +175,51 @@ struct MatchMetadata {
     const std::vector<MatchMetadata>& match_metadata() const { return _match_metadata; }
     [[nodiscard]] std::string type_name(const Type& type) const { return type_to_string(type); }
     const std::unordered_map<std::string, EnumInfo>& enum_definitions() const { return _enum_definitions; }
+    /// Whether every call to the function `name` of this module returns:
+    /// its body divides by nothing, matches nothing (a match traps when no
+    /// arm fits), has no loop, is not recursive and calls only such
+    /// functions. Only a call to a total function may be dropped when its
+    /// result is unused. False for functions defined elsewhere.
+    bool is_total(std::string_view name) const;
 
 private:
-    const std::vector<std::unique_ptr<Stmt>>& _statements;
+    struct WorkerTag {};
+    // A body-checking worker: copies the parent's declaration tables and
+    // global scope but starts with empty diagnostics and side tables.
+    SemanticAnalyzer(const SemanticAnalyzer& parent, WorkerTag);
+
+    std::span<const AstPtr<Stmt>> _statements;
     bool _had_error = false;
     std::vector<Type> _function_return_stack;
     std::vector<bool> _function_effect_stack;
+    // The enclosing @tailrec function, or null, per function being checked,
+    // and the call a `return` of it is about to check, which is in tail
+    // position.
+    std::vector<const FunctionStmt*> _tailrec_stack;
+    const CallExpr* _tail_call = nullptr;
+    // What is_total() needs from each checked body: whether the body alone
+    // may trap or not return, and the module functions it calls.
+    struct BodyFacts {
+        bool partial = false;
+        std::vector<std::string> callees;
+    };
+    std::unordered_map<std::string, BodyFacts> _body_facts;
+    BodyFacts* _current_body = nullptr;
     std::vector<Diagnostic> _diagnostics;
     std::string _source_name;
 
     std::vector<LoopMetadata> _loop_metadata;
-    std::unordered_map<const LoopStmt*, size_t> _loop_index;
+    NodeMap<size_t> _loop_index;
     std::vector<const LoopStmt*> _loop_stack;
     int _next_loop_id = 0;
     std::vector<MatchMetadata> _match_metadata;
-    std::unordered_map<const MatchExpr*, size_t> _match_index;
+    NodeMap<size_t> _match_index;
     int _next_enum_id = 0;
 
-    // Scoped symbol table
-    using Scope = std::unordered_map<std::string, SemanticSymbol>;
-    std::vector<Scope> _scopes;
+    // Scoped symbol table, keyed by the lexer's interned SymbolIds
+    ScopeStack<SemanticSymbol> _scopes;
     std::vector<const Type*> _expected_type_stack;
-    std::unordered_map<const Expr*, Type> _expr_type_cache;
+    NodeMap<Type> _expr_type_cache;
     std::unordered_map<std::string, size_t> _generic_arities;
     std::unordered_set<std::string> _defined_generics;
     struct AliasInfo {
@@ -228,15 +227,18 @@ private:
         const TypeExpr* alias = nullptr;
     };
     std::unordered_map<std::string, AliasInfo> _type_aliases;
-    std::unordered_map<const VectorLiteralExpr*, std::vector<float>> _vector_literal_data;
+    NodeMap<std::vector<float>> _vector_literal_data;
     std::unordered_map<std::string, RecordInfo> _record_definitions;
     std::unordered_map<std::string, EnumInfo> _enum_definitions;
     std::optional<std::string> _declared_module;
     std::unordered_set<std::string> _imports;
     const std::unordered_map<std::string, Type>* _current_type_env = nullptr;
+    WorkStealingPool* _pool = nullptr;
+    // When set, enforce_generic_arity logs every arity it registers here.
+    std::vector<std::pair<std::string, size_t>>* _arity_log = nullptr;
 
     void analyze(const Stmt& stmt);
-    std::any analyze(const Expr& expr);
+    Type analyze(const Expr& expr);
 
     void error(const Token& token, const std::string& message);
     void error_at(const Token& token, const std::string& message);
@@ -246,7 +248,8 @@ private:
     void exit_scope();
     void define_symbol(const Token& name, SymbolKind kind);
     SemanticSymbol* resolve_symbol(const Token& name);
-    bool is_defined_in_current_scope(const std::string& name) const;
+    bool is_defined_in_current_scope(const Token& name) const;
+    static SymbolId symbol_of(const Token& name);
 
     // Type helpers
     Type make_error_type();
@@ -261,9 +264,11 @@ private:
     Type evaluate_expression(const Expr& expr, const Type* expected = nullptr);
     const Type* current_expected_type() const;
     void register_function_signatures();
+    void check_function_bodies(std::span<const FunctionStmt* const> functions);
+    static bool body_is_independent(const FunctionStmt& func);
     Token extract_token(const Expr& expr) const;
     std::optional<Type> constant_type_from_expr(const Expr& expr);
-    const Type* type_of(const Expr* expr) const;
+    std::optional<Type> type_of(const Expr* expr) const;
     const std::unordered_map<std::string, AliasInfo>& type_aliases() const { return _type_aliases; }
     const std::unordered_map<std::string, RecordInfo>& record_definitions() const { return _record_definitions; }
     std::string type_expr_to_string(const TypeExpr& expr) const;
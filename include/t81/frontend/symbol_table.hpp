@@ -1,11 +1,11 @@
 #ifndef T81_FRONTEND_SYMBOL_TABLE_HPP
 #define T81_FRONTEND_SYMBOL_TABLE_HPP
 
+#include "t81/frontend/identifier_interner.hpp"
+#include "t81/frontend/scope_stack.hpp"
 #include "t81/tisc/ir.hpp"
 #include <string>
 #include <string_view>
-#include <vector>
-#include <unordered_map>
 #include <optional>
 #include <variant>
 
@@ -26,11 +26,12 @@ public:
     void exit_scope();
 
     void define(std::string_view name, Symbol symbol);
+    void define(SymbolId name, Symbol symbol);
     std::optional<Symbol> lookup(std::string_view name) const;
+    std::optional<Symbol> lookup(SymbolId name) const;
 
 private:
-    using Scope = std::unordered_map<std::string, Symbol>;
-    std::vector<Scope> _scopes;
+    ScopeStack<Symbol> _scopes;
 };
 
 } // namespace frontend
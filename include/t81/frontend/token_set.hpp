@@ -0,0 +1,67 @@
+/**
+ * @file token_set.hpp
+ * @brief Defines TokenSet, a constexpr bitset of TokenType values.
+ */
+
+#ifndef T81_FRONTEND_TOKEN_SET_HPP
+#define T81_FRONTEND_TOKEN_SET_HPP
+
+#include "t81/frontend/lexer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace t81 {
+namespace frontend {
+
+/**
+ * @class TokenSet
+ * @brief A fixed-size set of token types, usable in constant expressions.
+ *
+ * Membership is a shift and a mask over two machine words, so grammar probes
+ * such as `match(kTermOps)` never touch the heap.
+ */
+class TokenSet {
+public:
+    static constexpr std::size_t kCapacity = 128;
+
+    constexpr TokenSet() = default;
+
+    constexpr TokenSet(std::initializer_list<TokenType> types) {
+        for (TokenType type : types) insert(type);
+    }
+
+    constexpr void insert(TokenType type) {
+        const auto bit = index(type);
+        _words[bit / 64] |= std::uint64_t{1} << (bit % 64);
+    }
+
+    constexpr bool contains(TokenType type) const {
+        const auto bit = index(type);
+        return (_words[bit / 64] >> (bit % 64)) & 1u;
+    }
+
+    constexpr bool empty() const { return (_words[0] | _words[1]) == 0; }
+
+    friend constexpr TokenSet operator|(TokenSet lhs, TokenSet rhs) {
+        lhs._words[0] |= rhs._words[0];
+        lhs._words[1] |= rhs._words[1];
+        return lhs;
+    }
+
+private:
+    static constexpr std::size_t index(TokenType type) {
+        return static_cast<std::size_t>(type);
+    }
+
+    std::uint64_t _words[2] = {0, 0};
+};
+
+static_assert(static_cast<std::size_t>(TokenType::Illegal) < TokenSet::kCapacity,
+              "TokenSet capacity must cover every TokenType");
+
+} // namespace frontend
+} // namespace t81
+
+#endif // T81_FRONTEND_TOKEN_SET_HPP
@@ -0,0 +1,149 @@
+/**
+ * @file type_interner.hpp
+ * @brief Defines the semantic `Type` handle and the TypeInterner that owns
+ *        one node per distinct type.
+ */
+
+#ifndef T81_FRONTEND_TYPE_INTERNER_HPP
+#define T81_FRONTEND_TYPE_INTERNER_HPP
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace t81 {
+namespace frontend {
+
+struct TypeNode;
+
+/**
+ * @class Type
+ * @brief A handle to an interned semantic type.
+ *
+ * A `Type` is one pointer: copies never allocate and `operator==` is a
+ * pointer compare. Constructing a `Type` interns its kind, parameters and
+ * name, so structurally identical types always share a node. Types are
+ * immutable; use `with_params` to derive a variant.
+ */
+class Type {
+public:
+    enum class Kind {
+        Void,
+        Bool,
+        I2,
+        I8,
+        I16,
+        I32,
+        BigInt,
+        Float,
+        Fraction,
+        Vector,
+        Matrix,
+        Tensor,
+        Graph,
+        Option,
+        Result,
+        String,
+        Constant,
+        Custom,
+        Unknown,
+        Error
+    };
+    static constexpr std::size_t kKindCount = static_cast<std::size_t>(Kind::Error) + 1;
+
+    Type();
+    explicit Type(Kind kind_,
+                  std::vector<Type> params_ = {},
+                  std::string custom_name_ = {});
+    [[nodiscard]] static Type constant(std::string repr);
+
+    [[nodiscard]] Kind kind() const noexcept;
+    [[nodiscard]] const std::vector<Type>& params() const noexcept;
+    [[nodiscard]] const std::string& custom_name() const noexcept;
+
+    /// Returns this type with its parameter list replaced by `params_`.
+    [[nodiscard]] Type with_params(std::vector<Type> params_) const;
+
+    /// Semantic equality: `Custom`/`Constant` types compare by name, all
+    /// others by kind and parameters. Resolved through each node's
+    /// precomputed equivalence class, so this never recurses.
+    [[nodiscard]] bool operator==(const Type& other) const noexcept;
+    [[nodiscard]] bool operator!=(const Type& other) const noexcept { return !(*this == other); }
+
+    /// The interned node; equal for structurally identical types.
+    [[nodiscard]] const TypeNode* node() const noexcept { return _node; }
+
+private:
+    friend class TypeInterner;
+    explicit Type(const TypeNode* node) noexcept : _node(node) {}
+
+    const TypeNode* _node;
+};
+
+/// One distinct type. Nodes are owned by the interner and never move.
+struct TypeNode {
+    Type::Kind kind;
+    std::vector<Type> params;
+    std::string custom_name;
+    std::size_t hash;
+    /// Representative of this node's `operator==` equivalence class.
+    const TypeNode* equivalence;
+};
+
+/**
+ * @class TypeInterner
+ * @brief Process-wide table of interned types.
+ *
+ * Parameterless, unnamed types are preallocated and returned without
+ * locking; composite types are looked up under a shared lock and inserted
+ * under an exclusive one, so handles can be created and compared from any
+ * thread.
+ */
+class TypeInterner {
+public:
+    static TypeInterner& global();
+
+    const TypeNode* intern(Type::Kind kind, std::vector<Type> params, std::string custom_name);
+    const TypeNode* primitive(Type::Kind kind) const noexcept {
+        return _primitives[static_cast<std::size_t>(kind)];
+    }
+    std::size_t size() const;
+
+    TypeInterner(const TypeInterner&) = delete;
+    TypeInterner& operator=(const TypeInterner&) = delete;
+
+private:
+    TypeInterner();
+
+    struct NodeHash {
+        std::size_t operator()(const TypeNode* node) const noexcept { return node->hash; }
+    };
+    struct NodeEqual {
+        bool operator()(const TypeNode* lhs, const TypeNode* rhs) const noexcept;
+    };
+
+    const TypeNode* intern_locked(TypeNode&& probe);
+
+    mutable std::shared_mutex _mutex;
+    std::deque<TypeNode> _nodes;
+    std::unordered_set<const TypeNode*, NodeHash, NodeEqual> _index;
+    std::array<const TypeNode*, Type::kKindCount> _primitives{};
+};
+
+inline Type::Type() : _node(TypeInterner::global().primitive(Kind::Unknown)) {}
+
+inline Type::Kind Type::kind() const noexcept { return _node->kind; }
+inline const std::vector<Type>& Type::params() const noexcept { return _node->params; }
+inline const std::string& Type::custom_name() const noexcept { return _node->custom_name; }
+inline bool Type::operator==(const Type& other) const noexcept {
+    return _node->equivalence == other._node->equivalence;
+}
+
+} // namespace frontend
+} // namespace t81
+
+#endif // T81_FRONTEND_TYPE_INTERNER_HPP
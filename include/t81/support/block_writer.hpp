@@ -0,0 +1,58 @@
+/**
+ * @file block_writer.hpp
+ * @brief Defines BlockWriter, a buffered file writer that formats integers
+ *        in place and flushes in large blocks.
+ */
+
+#ifndef T81_SUPPORT_BLOCK_WRITER_HPP
+#define T81_SUPPORT_BLOCK_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+namespace t81 {
+
+/**
+ * @class BlockWriter
+ * @brief Streams text to a file through one fixed-size buffer.
+ *
+ * Output accumulates in a `kBlockSize` buffer that is handed to the file
+ * descriptor whenever it fills, so memory use does not grow with the
+ * amount written. Integers are formatted with `std::to_chars` straight
+ * into the buffer. Errors are sticky: once a write fails the rest are
+ * dropped and `close` reports failure.
+ */
+class BlockWriter {
+public:
+    static constexpr std::size_t kBlockSize = 64 * 1024;
+
+    /// Creates or truncates `path`; check `is_open` before writing.
+    explicit BlockWriter(const std::filesystem::path& path);
+    BlockWriter(const BlockWriter&) = delete;
+    BlockWriter& operator=(const BlockWriter&) = delete;
+    ~BlockWriter();
+
+    bool is_open() const { return _fd >= 0; }
+
+    BlockWriter& write(std::string_view text);
+    BlockWriter& write(std::int64_t value);
+
+    /// Flushes what is buffered and closes the file. Returns false if any
+    /// write, the flush or the close failed.
+    bool close();
+
+private:
+    void flush();
+
+    std::intptr_t _fd = -1;
+    std::unique_ptr<char[]> _buffer;
+    std::size_t _used = 0;
+    bool _failed = false;
+};
+
+} // namespace t81
+
+#endif // T81_SUPPORT_BLOCK_WRITER_HPP
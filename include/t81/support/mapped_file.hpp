@@ -0,0 +1,51 @@
+/**
+ * @file mapped_file.hpp
+ * @brief Defines MappedFile, a read-only view of a whole file that is
+ *        memory-mapped where the platform allows it.
+ */
+
+#ifndef T81_SUPPORT_MAPPED_FILE_HPP
+#define T81_SUPPORT_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace t81 {
+
+/**
+ * @class MappedFile
+ * @brief Owns a read-only mapping of a file's bytes.
+ *
+ * On POSIX systems the file is mmap'd, so opening a large artifact costs
+ * no copy and pages are faulted in only as they are read. Elsewhere the
+ * bytes are read into an owned buffer. Either way `bytes` stays valid for
+ * the lifetime of the object.
+ */
+class MappedFile {
+public:
+    static std::optional<MappedFile> open(const std::filesystem::path& path);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    std::span<const std::byte> bytes() const { return {_data, _size}; }
+
+private:
+    MappedFile() = default;
+    void release();
+
+    const std::byte* _data = nullptr;
+    std::size_t _size = 0;
+    bool _mapped = false;
+    std::vector<std::byte> _owned;
+};
+
+} // namespace t81
+
+#endif // T81_SUPPORT_MAPPED_FILE_HPP
@@ -0,0 +1,49 @@
+/**
+ * @file sha256.hpp
+ * @brief Defines Sha256, a streaming SHA-256 digest used to content-address
+ *        build artifacts.
+ */
+
+#ifndef T81_SUPPORT_SHA256_HPP
+#define T81_SUPPORT_SHA256_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace t81 {
+
+/**
+ * @class Sha256
+ * @brief Incremental SHA-256 (FIPS 180-4).
+ *
+ * Feed bytes with `update`, then call `finish` once. `hex` is a one-shot
+ * helper returning the lowercase hexadecimal digest of a buffer.
+ */
+class Sha256 {
+public:
+    using Digest = std::array<std::uint8_t, 32>;
+
+    Sha256();
+
+    Sha256& update(const void* data, std::size_t size);
+    Sha256& update(std::string_view data) { return update(data.data(), data.size()); }
+    Digest finish();
+
+    static std::string to_hex(const Digest& digest);
+    static std::string hex(std::string_view data);
+
+private:
+    void compress(const std::uint8_t* block);
+
+    std::array<std::uint32_t, 8> _state;
+    std::array<std::uint8_t, 64> _buffer{};
+    std::size_t _buffered = 0;
+    std::uint64_t _length = 0;
+};
+
+} // namespace t81
+
+#endif // T81_SUPPORT_SHA256_HPP
@@ -0,0 +1,80 @@
+/**
+ * @file work_stealing_pool.hpp
+ * @brief Defines WorkStealingPool, a fixed-size thread pool with one task
+ *        deque per worker.
+ */
+
+#ifndef T81_SUPPORT_WORK_STEALING_POOL_HPP
+#define T81_SUPPORT_WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace t81 {
+
+/**
+ * @class WorkStealingPool
+ * @brief Runs submitted tasks on a fixed set of worker threads.
+ *
+ * Each worker owns a deque. Tasks submitted from a worker go to the back of
+ * its own deque and are popped LIFO, so a task's follow-up work stays on the
+ * same thread; idle workers steal from the front of other deques. Tasks
+ * submitted from outside the pool are spread round-robin.
+ *
+ * `wait` blocks until every task, including tasks submitted by other tasks,
+ * has finished, and rethrows the first exception any task threw.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(std::size_t threads = default_concurrency());
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(Task task);
+    void wait();
+
+    std::size_t size() const { return _workers.size(); }
+
+    /// Hardware concurrency, or 1 when the platform cannot report it.
+    static std::size_t default_concurrency();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void worker_loop(std::size_t index);
+    Task take(std::size_t index);
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _workers;
+    std::atomic<std::size_t> _next_queue{0};
+
+    // Guards the counters below. `_queued` counts tasks sitting in deques
+    // that no worker has claimed yet; `_unfinished` counts tasks that have
+    // been submitted but have not returned.
+    std::mutex _mutex;
+    std::condition_variable _work_cv;
+    std::condition_variable _idle_cv;
+    std::size_t _queued = 0;
+    std::size_t _unfinished = 0;
+    bool _stopping = false;
+    std::exception_ptr _error;
+};
+
+} // namespace t81
+
+#endif // T81_SUPPORT_WORK_STEALING_POOL_HPP
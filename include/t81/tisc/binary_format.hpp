@@ -0,0 +1,108 @@
+/**
+ * @file binary_format.hpp
+ * @brief tisc-bin-v1: a compact binary encoding of t81::tisc::Program that
+ *        loads by mapping the file instead of parsing it.
+ */
+
+#ifndef T81_TISC_BINARY_FORMAT_HPP
+#define T81_TISC_BINARY_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "t81/support/mapped_file.hpp"
+#include "t81/tisc/program.hpp"
+
+namespace t81::tisc {
+
+inline constexpr std::string_view kBinaryFormatVersion = "tisc-bin-v1";
+
+/// Encodes `program` as tisc-bin-v1. `policy_text` is carried alongside,
+/// as the JSON format's `axion_policy_text` is.
+std::string encode_binary(const Program& program, std::string_view policy_text = {});
+
+/**
+ * @class ProgramView
+ * @brief Read-only view of an encoded tisc-bin-v1 buffer.
+ *
+ * Instruction records are stored exactly as `Insn` is laid out in memory,
+ * so on little-endian hosts `insns()` points straight into the buffer and
+ * nothing is decoded until a pool entry is asked for. The buffer must
+ * outlive the view.
+ *
+ * `open` checks the header, section table and every pool entry's bounds;
+ * `content_hash_matches` additionally re-hashes the payload, which touches
+ * every page and is left to callers that need it.
+ */
+class ProgramView {
+public:
+    static std::optional<ProgramView> open(std::span<const std::byte> bytes);
+
+    std::span<const Insn> insns() const { return _insns; }
+
+    std::size_t float_count() const { return _floats.count; }
+    double float_at(std::size_t index) const;
+    std::size_t symbol_count() const { return _symbols.size(); }
+    std::string_view symbol(std::size_t index) const;
+    std::size_t tensor_count() const { return _tensors.size(); }
+    T729Tensor tensor(std::size_t index) const;
+    std::size_t shape_count() const { return _shapes.size(); }
+    std::vector<int> shape(std::size_t index) const;
+    std::string_view policy_text() const { return _policy; }
+
+    /// Lowercase hex SHA-256 of everything after the header.
+    std::string content_hash() const;
+    bool content_hash_matches() const;
+
+    /// Copies the whole program out of the buffer.
+    Program materialize() const;
+
+private:
+    struct PoolIndex {
+        std::size_t offset = 0;
+        std::size_t count = 0;
+    };
+
+    explicit ProgramView(std::span<const std::byte> bytes) : _bytes(bytes) {}
+    bool validate();
+
+    std::span<const std::byte> _bytes;
+    std::span<const Insn> _insns;
+    // Only used when the host cannot alias the stored records directly.
+    std::shared_ptr<const std::vector<Insn>> _decoded_insns;
+    PoolIndex _floats;
+    // Offsets of each variable-length pool entry, built once by open().
+    std::vector<std::size_t> _symbols;
+    std::vector<std::size_t> _tensors;
+    std::vector<std::size_t> _shapes;
+    std::vector<std::size_t> _aliases;
+    std::string_view _policy;
+};
+
+/**
+ * @class MappedProgram
+ * @brief Maps a tisc-bin-v1 file and keeps the mapping alive for its view.
+ */
+class MappedProgram {
+public:
+    static std::optional<MappedProgram> open(const std::filesystem::path& path);
+
+    const ProgramView& view() const { return _view; }
+
+private:
+    MappedProgram(MappedFile file, ProgramView view) : _file(std::move(file)), _view(std::move(view)) {}
+
+    MappedFile _file;
+    ProgramView _view;
+};
+
+} // namespace t81::tisc
+
+#endif // T81_TISC_BINARY_FORMAT_HPP
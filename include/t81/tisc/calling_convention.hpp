@@ -0,0 +1,131 @@
+/**
+ * @file calling_convention.hpp
+ * @brief The register and stack contract between a CALL and its callee.
+ *
+ * The generator emits `CALL #callee, a0, ..., an-1` naming every argument
+ * register, and the passes treat those as ordinary reads. "lower-calls",
+ * the last pass at every level, then puts the arguments where the callee
+ * expects them:
+ *   1. Arguments 6 .. n-1 are PUSHed last first, so argument 6 ends up on
+ *      top of the stack.
+ *   2. Arguments 0 .. 5 are moved into r1 .. r6.
+ *   3. `CALL #callee, r1, ..., rk` with k = min(n, 6) names the argument
+ *      registers it reads and records the n - k pushed ones in
+ *      `stack_arguments`. tisc-bin-v1 encodes the callee and n. tisc-json-v1
+ *      encodes the callee and the first two registers and nothing that
+ *      gives the count, so it rejects calls with more arguments until the
+ *      runtime contract carries one.
+ *   4. The result comes back in r0. r0 .. r12 are caller-saved: the callee
+ *      may overwrite any of them, so register allocation keeps values
+ *      that live across a call in r13 and up, or in memory.
+ *
+ *   5. After the CALL the caller POPs the stack arguments into r7, which
+ *      the call has already overwritten, so the stack is back where it was.
+ *
+ * The callee, in turn:
+ *   1. Reads its stack arguments in place, below its frame, without
+ *      popping them.
+ *   2. PUSHes every callee-saved register its body writes.
+ *   3. Reserves its frame, locals and spill slots, with StackAlloc.
+ *      `LOAD r, #k` and `STORE #k, r` address cell k of the innermost
+ *      frame, not a fixed memory address, so every activation has slots
+ *      of its own.
+ *   4. Before RET: puts the result in r0, releases the frame with
+ *      StackFree, then POPs the saved registers in reverse order.
+ *
+ * lower_call() emits the caller side and lower_frame() the callee side
+ * of a body whose registers are allocated. The generator lowers only the
+ * entry function, so register allocation calls lower_frame() only for the
+ * entry's spill slots and no callee body reaches it yet. The generator numbers
+ * its values from r13, so code that skips register allocation (-O0) keeps
+ * every value in a callee-saved register too and a call overwrites none
+ * of them.
+ */
+
+#ifndef T81_TISC_CALLING_CONVENTION_HPP
+#define T81_TISC_CALLING_CONVENTION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "t81/tisc/ir.hpp"
+
+namespace t81::tisc::ir {
+
+/// The register that carries a function's result out through HALT and RET
+/// and back from CALL.
+inline constexpr int kReturnRegister = 0;
+
+/// Arguments 0-5 travel in r1-r6.
+inline constexpr int kFirstArgumentRegister = 1;
+inline constexpr int kArgumentRegisterCount = 6;
+
+/// Physical registers below this one are caller-saved; the rest are
+/// callee-saved.
+inline constexpr int kFirstCalleeSavedRegister = 13;
+
+/// r7-r12 are caller-saved and never carry an argument; lower-calls breaks
+/// argument-move cycles through one of them and pops spent stack arguments
+/// into r7.
+inline constexpr int kFirstCallScratchRegister = kFirstArgumentRegister + kArgumentRegisterCount;
+
+/// The generator numbers its registers from here, so unallocated code
+/// holds nothing in a register a call may overwrite.
+inline constexpr int kFirstVirtualRegister = kFirstCalleeSavedRegister;
+
+constexpr bool is_caller_saved(int reg) {
+    return reg < kFirstCalleeSavedRegister;
+}
+
+/// The register argument `index` travels in; only for index < 6.
+constexpr int argument_register(std::size_t index) {
+    return kFirstArgumentRegister + static_cast<int>(index);
+}
+
+/// How many of `arguments` go on the stack.
+constexpr std::size_t stack_argument_count(std::size_t arguments) {
+    constexpr auto in_registers = static_cast<std::size_t>(kArgumentRegisterCount);
+    return arguments > in_registers ? arguments - in_registers : 0;
+}
+
+/// Where an argument is when its call is lowered: in `reg`, or in spill
+/// slot `slot` when register allocation put it in memory.
+struct CallArgument {
+    int reg = 0;
+    std::optional<std::int64_t> slot;
+    PrimitiveKind kind = PrimitiveKind::Unknown;
+};
+
+struct LoweredCall {
+    std::int64_t stack_arguments = 0;
+    std::int64_t moves = 0;
+    std::int64_t reloads = 0;
+};
+
+/// Appends the caller side of `call` to `out`: the pushes, the argument
+/// moves and reloads, the CALL naming r1-rk, and the pops after it.
+/// Spilled stack arguments are reloaded through `scratch`, which must hold
+/// nothing live at the call; spilled register arguments are loaded straight
+/// into their argument registers.
+LoweredCall lower_call(Instruction call, const std::vector<CallArgument>& args, int scratch,
+                       std::vector<Instruction>& out);
+
+struct LoweredFrame {
+    std::int64_t saved_registers = 0;
+    std::int64_t slots = 0;
+};
+
+/// Adds the callee side to `body`, a function whose registers are
+/// allocated. On entry it PUSHes the callee-saved registers the body writes
+/// and reserves `slots` frame cells with STACK_ALLOC; before each RET it
+/// frees them with STACK_FREE and POPs the saved registers in reverse.
+/// The entry function ends in HALT and returns to the runtime, which keeps
+/// nothing in registers, so with `entry` only the frame is set up, and
+/// freed before each HALT.
+LoweredFrame lower_frame(std::vector<Instruction>& body, std::int64_t slots, bool entry);
+
+} // namespace t81::tisc::ir
+
+#endif // T81_TISC_CALLING_CONVENTION_HPP
@@ -0,0 +1,139 @@
+/**
+ * @file cfg.hpp
+ * @brief Control-flow graph and register liveness over an IR instruction
+ *        stream, shared by the optimization passes.
+ */
+
+#ifndef T81_TISC_CFG_HPP
+#define T81_TISC_CFG_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "t81/tisc/calling_convention.hpp"
+#include "t81/tisc/ir.hpp"
+
+namespace t81::tisc::ir {
+
+/// Registers one instruction reads and the one it writes, if any.
+struct RegisterEffects {
+    std::vector<int> uses;
+    std::optional<int> def;
+};
+
+RegisterEffects register_effects(const Instruction& instr);
+
+/// JZ, JNZ, JN and JP: jump to their label or fall through.
+bool is_conditional_jump(Opcode opcode);
+
+/// Instructions after which control never falls through: JMP, HALT, RET
+/// and TRAP.
+bool ends_control_flow(Opcode opcode);
+
+/// The label a jump targets.
+std::optional<int> jump_target(const Instruction& instr);
+
+/**
+ * @class RegisterSet
+ * @brief Dense bit set of register indices.
+ */
+class RegisterSet {
+public:
+    void insert(int reg);
+    void erase(int reg);
+    bool contains(int reg) const;
+    /// Adds every member of `other`; returns whether anything was added.
+    bool merge(const RegisterSet& other);
+    bool operator==(const RegisterSet& other) const;
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (std::size_t word = 0; word < _words.size(); ++word) {
+            for (std::uint64_t bits = _words[word]; bits != 0; bits &= bits - 1) {
+                fn(static_cast<int>(word * 64 + static_cast<std::size_t>(std::countr_zero(bits))));
+            }
+        }
+    }
+
+private:
+    std::vector<std::uint64_t> _words;
+};
+
+struct BasicBlock {
+    std::size_t begin = 0; ///< First instruction index.
+    std::size_t end = 0;   ///< One past the last instruction index.
+    std::vector<std::size_t> successors;
+    std::vector<std::size_t> predecessors;
+};
+
+/**
+ * @class ControlFlowGraph
+ * @brief Basic blocks of one instruction stream, in program order.
+ *
+ * A block starts at the first instruction, at every LABEL and after every
+ * jump or control-flow end. Block 0 is the entry. The graph holds indices
+ * into the instruction vector it was built from and is invalidated by any
+ * change to that vector.
+ */
+class ControlFlowGraph {
+public:
+    static ControlFlowGraph build(const std::vector<Instruction>& instrs);
+
+    const std::vector<BasicBlock>& blocks() const { return _blocks; }
+
+    /// Blocks reachable from the entry, indexed like `blocks()`.
+    std::vector<bool> reachable() const;
+
+private:
+    std::vector<BasicBlock> _blocks;
+};
+
+/**
+ * @class Liveness
+ * @brief Registers live into and out of each basic block.
+ *
+ * A register is live where some path reaches a read of it before any
+ * write. HALT and RET read the return register, as does falling off the
+ * end of the stream.
+ */
+class Liveness {
+public:
+    static Liveness compute(const std::vector<Instruction>& instrs, const ControlFlowGraph& cfg);
+
+    const RegisterSet& live_in(std::size_t block) const { return _live_in[block]; }
+    const RegisterSet& live_out(std::size_t block) const { return _live_out[block]; }
+
+private:
+    std::vector<RegisterSet> _live_in;
+    std::vector<RegisterSet> _live_out;
+};
+
+/**
+ * @struct LiveInterval
+ * @brief The span of the linearized stream over which a register is live.
+ *
+ * Instruction `i` reads its registers at position `2 * i` and writes its
+ * result at `2 * i + 1`, so a register whose last read is at `i` does not
+ * overlap the one `i` writes. The interval is the hull of every position
+ * the register is live at; holes are not tracked.
+ */
+struct LiveInterval {
+    int reg = 0;
+    /// Kind of the first instruction in the stream that writes `reg`;
+    /// Boolean for comparison results, Unknown if nothing writes it.
+    PrimitiveKind kind = PrimitiveKind::Unknown;
+    std::size_t start = 0;
+    std::size_t end = 0;
+};
+
+/// One interval per register that appears in `instrs`, ordered by start
+/// and then register index.
+std::vector<LiveInterval> live_intervals(const std::vector<Instruction>& instrs, const ControlFlowGraph& cfg,
+                                         const Liveness& liveness);
+
+} // namespace t81::tisc::ir
+
+#endif // T81_TISC_CFG_HPP
@@ -0,0 +1,73 @@
+/**
+ * @file constant.hpp
+ * @brief Compile-time evaluation of IR instructions over known register
+ *        values, shared by the constant folding passes.
+ */
+
+#ifndef T81_TISC_CONSTANT_HPP
+#define T81_TISC_CONSTANT_HPP
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "t81/tisc/ir.hpp"
+
+namespace t81::tisc::ir {
+
+/**
+ * @struct Constant
+ * @brief A register's value when a pass can prove it.
+ *
+ * Integers and booleans are held in `integer`; fractions are kept
+ * normalized with a positive denominator. Only integers and booleans can be
+ * written back as LOADI: TISC has no float or fraction immediates, so those
+ * values only feed further folds (comparisons, exact conversions back to
+ * integers).
+ */
+struct Constant {
+    PrimitiveKind kind = PrimitiveKind::Integer;
+    std::int64_t integer = 0;
+    double real = 0.0;
+    std::int64_t num = 0;
+    std::int64_t den = 1;
+
+    bool is_integral() const { return kind == PrimitiveKind::Integer || kind == PrimitiveKind::Boolean; }
+
+    bool operator==(const Constant& other) const;
+
+    static Constant of_integer(std::int64_t value, PrimitiveKind kind = PrimitiveKind::Integer) {
+        Constant c;
+        c.kind = kind;
+        c.integer = value;
+        return c;
+    }
+
+    static Constant of_float(double value) {
+        Constant c;
+        c.kind = PrimitiveKind::Float;
+        c.real = value;
+        return c;
+    }
+
+    static std::optional<Constant> of_fraction(std::int64_t num, std::int64_t den);
+};
+
+/// An integer LOADI with a plain immediate, as opposed to a literal-pool
+/// handle load.
+bool is_integer_load(const Instruction& instr);
+
+/// The value `instr` writes to its first operand. `operands[i]` is the
+/// known value of operand `i`, or null when it is unknown or not a
+/// register. Each instruction is evaluated with its own PrimitiveKind's
+/// semantics; overflow, division by zero and inexact conversions are left
+/// to the runtime and yield nullopt.
+std::optional<Constant> fold_instruction(const Instruction& instr, std::span<const Constant* const> operands);
+
+/// Whether a conditional jump on `condition` is taken, if that can be
+/// decided.
+std::optional<bool> fold_branch_condition(Opcode opcode, const Constant& condition);
+
+} // namespace t81::tisc::ir
+
+#endif // T81_TISC_CONSTANT_HPP
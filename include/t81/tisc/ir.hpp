@@ -2,6 +2,7 @@
 #define T81_TISC_IR_HPP
 
 #include <optional>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <utility>
@@ -41,6 +42,7 @@ enum class Opcode {
   LOAD, STORE, PUSH, POP,
   JMP, JZ, JNZ, JN, JP,
   CALL, RET,
+  STACK_ALLOC, STACK_FREE,
   I2F, F2I, I2FRAC, FRAC2I,
   MAKE_OPTION_SOME, MAKE_OPTION_NONE,
   MAKE_RESULT_OK, MAKE_RESULT_ERR,
@@ -76,6 +78,8 @@ struct Instruction {
   ComparisonRelation relation = ComparisonRelation::None;
   tisc::LiteralKind literal_kind = tisc::LiteralKind::Int;
   std::optional<std::string> text_literal;
+  // A lowered CALL's arguments past the registers it names, PUSHed before it.
+  std::size_t stack_arguments = 0;
 
   Instruction(Opcode opcode_ = Opcode::NOP, std::vector<Operand> operands_ = {})
       : opcode(opcode_), operands(std::move(operands_)) {}
@@ -85,6 +89,8 @@ struct FunctionMetadata {
   std::string name;
   bool is_effectful = false;
   std::optional<std::int64_t> tier;
+  // Every call returns: the function cannot trap or run forever.
+  bool is_total = false;
 };
 
 class IntermediateProgram {
@@ -97,6 +103,10 @@ public:
     return instructions_;
   }
 
+  std::vector<Instruction>& mutable_instructions() {
+    return instructions_;
+  }
+
   void add_type_alias(TypeAliasMetadata meta) {
     type_aliases_.push_back(std::move(meta));
   }
@@ -113,6 +123,21 @@ public:
     return function_metadata_;
   }
 
+  // CALL's first operand is the 1-based index of the callee's name here.
+  int add_call_target(const std::string& name) {
+    for (std::size_t i = 0; i < call_targets_.size(); ++i) {
+      if (call_targets_[i] == name) {
+        return static_cast<int>(i + 1);
+      }
+    }
+    call_targets_.push_back(name);
+    return static_cast<int>(call_targets_.size());
+  }
+
+  const std::vector<std::string>& call_targets() const {
+    return call_targets_;
+  }
+
   int add_tensor(t81::T729Tensor tensor) {
     tensor_pool_.push_back(std::move(tensor));
     return static_cast<int>(tensor_pool_.size());
@@ -127,6 +152,7 @@ private:
   std::vector<TypeAliasMetadata> type_aliases_;
   std::vector<FunctionMetadata> function_metadata_;
   std::vector<t81::T729Tensor> tensor_pool_;
+  std::vector<std::string> call_targets_;
 };
 
 using TypeAliasMetadata = t81::tisc::TypeAliasMetadata;
@@ -0,0 +1,113 @@
+/**
+ * @file pass_manager.hpp
+ * @brief Optimization levels, the IR pass interface and the pass manager
+ *        that runs the built-in pipeline over an IntermediateProgram.
+ */
+
+#ifndef T81_TISC_PASS_MANAGER_HPP
+#define T81_TISC_PASS_MANAGER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "t81/tisc/ir.hpp"
+
+namespace t81::tisc::ir {
+
+enum class OptLevel { O0, O1, O2 };
+
+/// Parses "-O0", "-O1" or "-O2".
+std::optional<OptLevel> parse_opt_level(std::string_view flag);
+std::string_view opt_level_name(OptLevel level);
+
+/**
+ * @class PassContext
+ * @brief Per-run scratch a pass reports through.
+ *
+ * Counters are free-form `name=value` pairs (for example how many
+ * instructions were folded) and are printed next to the pass's timing.
+ */
+class PassContext {
+public:
+    void count(std::string_view counter, std::int64_t value);
+
+    const std::vector<std::pair<std::string, std::int64_t>>& counters() const { return _counters; }
+
+private:
+    std::vector<std::pair<std::string, std::int64_t>> _counters;
+};
+
+/**
+ * @class Pass
+ * @brief One transformation over a whole program.
+ *
+ * A pass must be deterministic: the same input program always produces
+ * the same output, since emitted bytecode is cached by content.
+ */
+class Pass {
+public:
+    virtual ~Pass() = default;
+
+    virtual std::string_view name() const = 0;
+
+    /// Rewrites `program` in place and returns whether anything changed.
+    virtual bool run(IntermediateProgram& program, PassContext& context) = 0;
+};
+
+struct PassTiming {
+    std::string name;
+    double wall_ms = 0.0;
+    std::size_t instructions_before = 0;
+    std::size_t instructions_after = 0;
+    bool changed = false;
+    std::vector<std::pair<std::string, std::int64_t>> counters;
+};
+
+/**
+ * @class PassManager
+ * @brief Runs a fixed, ordered list of passes and records what each did.
+ *
+ * `for_level` builds the built-in pipeline: every registered pass whose
+ * minimum level is at or below `level`, always in registration order, so
+ * a given level produces the same program on every run. -O0 runs nothing.
+ */
+class PassManager {
+public:
+    PassManager() = default;
+
+    static PassManager for_level(OptLevel level);
+
+    /// Names of the built-in passes in pipeline order, at any level.
+    static std::vector<std::string_view> pass_names();
+
+    void add_pass(std::unique_ptr<Pass> pass);
+
+    /// Prints the program to `out` after each run of the pass named `name`.
+    void print_after(std::string name, std::ostream& out);
+
+    void run(IntermediateProgram& program);
+
+    const std::vector<PassTiming>& timings() const { return _timings; }
+
+    /// Writes one line per pass run, then a total.
+    void write_timing_report(std::ostream& out) const;
+
+private:
+    std::vector<std::unique_ptr<Pass>> _passes;
+    std::vector<PassTiming> _timings;
+    std::size_t _instructions_in = 0;
+    std::size_t _instructions_out = 0;
+    std::string _print_after;
+    std::ostream* _print_out = nullptr;
+};
+
+} // namespace t81::tisc::ir
+
+#endif // T81_TISC_PASS_MANAGER_HPP
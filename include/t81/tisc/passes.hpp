@@ -0,0 +1,60 @@
+/**
+ * @file passes.hpp
+ * @brief Factories for the built-in IR optimization passes. PassManager
+ *        wires them into its pipeline; they are exposed for tests.
+ */
+
+#ifndef T81_TISC_PASSES_HPP
+#define T81_TISC_PASSES_HPP
+
+#include <memory>
+
+#include "t81/tisc/pass_manager.hpp"
+
+namespace t81::tisc::ir {
+
+/// "constant-fold": folds arithmetic, comparisons and branches over known
+/// constants, respecting each instruction's PrimitiveKind.
+std::unique_ptr<Pass> make_constant_fold_pass();
+
+/// "unreachable-code": removes basic blocks the entry cannot reach.
+std::unique_ptr<Pass> make_unreachable_code_pass();
+
+/// "sccp": sparse conditional constant propagation over SSA form.
+std::unique_ptr<Pass> make_sccp_pass();
+
+/// "gvn": dominator-based global value numbering and copy propagation over
+/// SSA form.
+std::unique_ptr<Pass> make_gvn_pass();
+
+/// "coalesce-copies": a round trip through SSA form whose lowering merges
+/// registers joined by copies and phis wherever their values never overlap.
+std::unique_ptr<Pass> make_coalesce_copies_pass();
+
+/// "dead-registers": removes side-effect-free instructions whose result
+/// register is dead.
+std::unique_ptr<Pass> make_dead_registers_pass();
+
+/// "simplify-jumps": drops jumps whose target label follows them directly,
+/// then labels no jump refers to.
+std::unique_ptr<Pass> make_simplify_jumps_pass();
+
+/// Physical registers "register-allocation" maps onto by default,
+/// including the return register.
+inline constexpr int kDefaultPhysicalRegisters = 27;
+
+/// "register-allocation": maps virtual registers onto a bounded physical
+/// register file with linear scan, spilling what does not fit to memory
+/// slots through LOAD and STORE. Values live across a CALL only get
+/// callee-saved registers. Runs after every pass that creates or deletes
+/// registers.
+std::unique_ptr<Pass> make_register_allocation_pass();
+std::unique_ptr<Pass> make_register_allocation_pass(int physical_registers);
+
+/// "lower-calls": passes CALL arguments the way calling_convention.hpp
+/// lays down, in r1-r6 and then on the stack. Runs last, at every level.
+std::unique_ptr<Pass> make_lower_calls_pass();
+
+} // namespace t81::tisc::ir
+
+#endif // T81_TISC_PASSES_HPP
@@ -0,0 +1,128 @@
+/**
+ * @file ssa.hpp
+ * @brief Static single assignment form over an IR instruction stream:
+ *        dominators, phi placement at LABEL join points, and lowering back
+ *        to plain MOVs with copy coalescing.
+ */
+
+#ifndef T81_TISC_SSA_HPP
+#define T81_TISC_SSA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "t81/tisc/ir.hpp"
+
+namespace t81::tisc::ir {
+
+/**
+ * @class DominatorTree
+ * @brief Immediate dominators of a flow graph rooted at block 0, computed
+ *        with the Cooper-Harvey-Kennedy iteration over reverse postorder.
+ */
+class DominatorTree {
+public:
+    static constexpr std::size_t kNone = std::numeric_limits<std::size_t>::max();
+
+    /// `successors[b]` lists the blocks `b` can branch to.
+    static DominatorTree build(const std::vector<std::vector<std::size_t>>& successors);
+
+    /// The entry's immediate dominator is itself; unreachable blocks have
+    /// kNone.
+    std::size_t idom(std::size_t block) const { return _idom[block]; }
+    const std::vector<std::size_t>& children(std::size_t block) const { return _children[block]; }
+    bool reachable(std::size_t block) const { return _idom[block] != kNone; }
+    bool dominates(std::size_t a, std::size_t b) const;
+    /// Reachable blocks, each before every block it dominates.
+    const std::vector<std::size_t>& reverse_postorder() const { return _order; }
+
+private:
+    std::vector<std::size_t> _idom;
+    std::vector<std::vector<std::size_t>> _children;
+    std::vector<std::size_t> _order;
+};
+
+/// `dest = phi(args...)`, one argument per predecessor of its block, in
+/// the order of SsaBlock::predecessors.
+struct Phi {
+    int dest = 0;
+    std::vector<int> args;
+    PrimitiveKind primitive = PrimitiveKind::Unknown;
+};
+
+struct SsaBlock {
+    std::vector<Phi> phis;
+    /// Register operands name SSA values, except r0: the return register is
+    /// written implicitly by CALL and read by HALT, so it stays a single
+    /// machine register outside SSA.
+    std::vector<Instruction> instrs;
+    std::vector<std::size_t> successors;
+    std::vector<std::size_t> predecessors;
+    /// Cleared for blocks a pass has proven dead; they are not lowered.
+    bool live = true;
+};
+
+struct SsaLoweringStats {
+    std::int64_t copies_coalesced = 0; ///< MOVs and phi moves that vanished.
+    std::int64_t copies_inserted = 0;  ///< Phi moves that had to stay.
+    std::int64_t edges_split = 0;
+};
+
+/**
+ * @class SsaForm
+ * @brief One instruction stream in pruned SSA form.
+ *
+ * Blocks are the ControlFlowGraph's blocks, in program order, so a block
+ * still falls through to the one after it. Every value other than r0 is
+ * written exactly once, and phis sit at the top of LABEL blocks that more
+ * than one path reaches and where the register is live.
+ */
+class SsaForm {
+public:
+    /// Fails when a register other than r0 can be read before any write,
+    /// since such a read sees whatever the runtime left in it.
+    static std::optional<SsaForm> build(const std::vector<Instruction>& instrs);
+
+    std::vector<SsaBlock>& blocks() { return _blocks; }
+    const std::vector<SsaBlock>& blocks() const { return _blocks; }
+
+    /// Values are numbered from 1; 0 is r0.
+    int value_count() const { return _value_count; }
+
+    /// The block a jump in this form targets.
+    std::optional<std::size_t> target_block(const Instruction& jump) const;
+
+    /// The block `block` falls through to, if its last instruction can
+    /// fall through.
+    std::optional<std::size_t> fall_through(std::size_t block) const;
+
+    /// Drops the edge and the matching argument of every phi in `to`.
+    void remove_edge(std::size_t from, std::size_t to);
+
+    /// Rewrites every read of a value through `replacement`, following
+    /// chains, in instructions and phi arguments.
+    void replace_uses(const std::unordered_map<int, int>& replacement);
+
+    /**
+     * Leaves SSA. Values connected by a phi or a MOV share a register
+     * whenever their live ranges do not interfere, which makes that copy
+     * vanish. The phi moves that remain become parallel copies on the
+     * incoming edges, splitting edges out of conditional jumps. Registers
+     * are renumbered densely from 1 in order of first appearance.
+     */
+    std::vector<Instruction> lower(SsaLoweringStats* stats = nullptr) const;
+
+private:
+    std::vector<SsaBlock> _blocks;
+    std::unordered_map<int, std::size_t> _label_block;
+    int _value_count = 0;
+    int _next_label = 0;
+};
+
+} // namespace t81::tisc::ir
+
+#endif // T81_TISC_SSA_HPP
@@ -8,14 +8,43 @@ mkdir -p "${OUT_DIR}"
 CXX="${CXX:-c++}"
 CXXFLAGS="${CXXFLAGS:--std=c++20 -O2 -Wall -Wextra -Wpedantic -I${ROOT}/include}"
 
-"${CXX}" ${CXXFLAGS} \
+# The compiler stamps cache keys and interfaces with a hash of its own
+# sources rather than its build time, so builds are reproducible.
+if command -v sha256sum >/dev/null 2>&1; then
+  SHA256=(sha256sum)
+else
+  SHA256=(shasum -a 256)
+fi
+SOURCE_HASH="$(cd "${ROOT}" && find include src -type f | LC_ALL=C sort | xargs cat | "${SHA256[@]}" | cut -c1-16)"
+
+"${CXX}" ${CXXFLAGS} "-DT81_LANG_SOURCE_HASH=\"${SOURCE_HASH}\"" \
   "${ROOT}/src/cli/t81_lang_main.cpp" \
+  "${ROOT}/src/frontend/identifier_interner.cpp" \
   "${ROOT}/src/frontend/lexer.cpp" \
   "${ROOT}/src/frontend/parser.cpp" \
   "${ROOT}/src/frontend/ast_printer.cpp" \
+  "${ROOT}/src/frontend/flat_ast.cpp" \
   "${ROOT}/src/frontend/symbol_table.cpp" \
+  "${ROOT}/src/frontend/type_interner.cpp" \
   "${ROOT}/src/frontend/semantic_analyzer.cpp" \
+  "${ROOT}/src/frontend/module_interface.cpp" \
+  "${ROOT}/src/support/block_writer.cpp" \
+  "${ROOT}/src/support/mapped_file.cpp" \
+  "${ROOT}/src/support/sha256.cpp" \
+  "${ROOT}/src/support/work_stealing_pool.cpp" \
+  "${ROOT}/src/tisc/binary_format.cpp" \
+  "${ROOT}/src/tisc/cfg.cpp" \
+  "${ROOT}/src/tisc/constant.cpp" \
+  "${ROOT}/src/tisc/pass_manager.cpp" \
+  "${ROOT}/src/tisc/passes/constant_fold.cpp" \
+  "${ROOT}/src/tisc/passes/dead_code.cpp" \
+  "${ROOT}/src/tisc/passes/gvn.cpp" \
+  "${ROOT}/src/tisc/passes/lower_calls.cpp" \
+  "${ROOT}/src/tisc/passes/register_allocation.cpp" \
+  "${ROOT}/src/tisc/passes/sccp.cpp" \
+  "${ROOT}/src/tisc/passes/simplify_jumps.cpp" \
   "${ROOT}/src/tisc/pretty_printer.cpp" \
+  "${ROOT}/src/tisc/ssa.cpp" \
   -o "${OUT_DIR}/t81-lang"
 
 echo "${OUT_DIR}/t81-lang"
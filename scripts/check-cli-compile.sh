@@ -30,4 +30,281 @@ for artifact in "${OUT_DIR}/hello.tisc.json" "${OUT_DIR}/hello.build.tisc.json";
   fi
 done
 
+# `build` goes through the incremental cache: a warm rebuild must reproduce
+# the cold artifact byte for byte, and editing an import must invalidate
+# every module above it.
+CACHE_DIR="${OUT_DIR}/cache"
+GRAPH_DIR="${OUT_DIR}/cache-graph"
+rm -rf "${CACHE_DIR}" "${GRAPH_DIR}"
+cp -R "${ROOT}/tests/harness/module_graph/diamond" "${GRAPH_DIR}"
+T81_CACHE_DIR="${CACHE_DIR}" "${CLI_PATH}" build "${GRAPH_DIR}/app/main.t81" -o "${OUT_DIR}/cold.tisc.json" >/dev/null
+T81_CACHE_DIR="${CACHE_DIR}" "${CLI_PATH}" build "${GRAPH_DIR}/app/main.t81" -o "${OUT_DIR}/warm.tisc.json" >/dev/null
+if ! cmp -s "${OUT_DIR}/cold.tisc.json" "${OUT_DIR}/warm.tisc.json"; then
+  echo "cached build differs from cold build" >&2
+  exit 1
+fi
+"${CLI_PATH}" emit-bytecode "${GRAPH_DIR}/app/main.t81" -o "${OUT_DIR}/uncached.tisc.json" >/dev/null
+if ! cmp -s "${OUT_DIR}/cold.tisc.json" "${OUT_DIR}/uncached.tisc.json"; then
+  echo "cached build differs from emit-bytecode" >&2
+  exit 1
+fi
+checks_before="$(find "${CACHE_DIR}" -name '*.check' | wc -l)"
+echo "// edited" >> "${GRAPH_DIR}/app/base.t81"
+T81_CACHE_DIR="${CACHE_DIR}" "${CLI_PATH}" build "${GRAPH_DIR}/app/main.t81" -o "${OUT_DIR}/edited.tisc.json" >/dev/null
+checks_after="$(find "${CACHE_DIR}" -name '*.check' | wc -l)"
+if (( checks_after - checks_before != 4 )); then
+  echo "editing a leaf import should invalidate 4 modules, got $((checks_after - checks_before))" >&2
+  exit 1
+fi
+# Without T81_CACHE_DIR and T81_INTERFACE_DIR the cache and interfaces sit
+# next to the artifact, and nothing lands in the working directory.
+DEFAULT_CACHE_OUT="${OUT_DIR}/default-cache"
+DEFAULT_CACHE_CWD="${OUT_DIR}/default-cache-cwd"
+rm -rf "${DEFAULT_CACHE_OUT}" "${DEFAULT_CACHE_CWD}"
+mkdir -p "${DEFAULT_CACHE_OUT}" "${DEFAULT_CACHE_CWD}"
+(cd "${DEFAULT_CACHE_CWD}" && env -u T81_CACHE_DIR -u T81_INTERFACE_DIR "${CLI_PATH}" build "${GRAPH_DIR}/app/main.t81" \
+  -o "${DEFAULT_CACHE_OUT}/main.tisc.json" >/dev/null)
+if [[ ! -d "${DEFAULT_CACHE_OUT}/.t81cache" || ! -d "${DEFAULT_CACHE_OUT}/.t81i" \
+  || -n "$(ls -A "${DEFAULT_CACHE_CWD}")" ]]; then
+  echo "build should cache next to its artifact, not in the working directory" >&2
+  exit 1
+fi
+
+# --format=bin writes tisc-bin-v1: the same instruction stream as the JSON
+# artifact, in fixed-width records, with a content hash over the payload.
+BIN_SRC="${ROOT}/examples/07_records_enums.t81"
+"${CLI_PATH}" emit-bytecode "${BIN_SRC}" -o "${OUT_DIR}/records.tisc.json" >/dev/null
+"${CLI_PATH}" emit-bytecode "${BIN_SRC}" -o "${OUT_DIR}/records.tisc.bin" --format=bin >/dev/null
+T81_CACHE_DIR="${CACHE_DIR}" "${CLI_PATH}" build "${BIN_SRC}" --format=bin -o "${OUT_DIR}/records.cold.tisc.bin" >/dev/null
+T81_CACHE_DIR="${CACHE_DIR}" "${CLI_PATH}" build "${BIN_SRC}" --format=bin -o "${OUT_DIR}/records.warm.tisc.bin" >/dev/null
+for artifact in "${OUT_DIR}/records.cold.tisc.bin" "${OUT_DIR}/records.warm.tisc.bin"; do
+  if ! cmp -s "${OUT_DIR}/records.tisc.bin" "${artifact}"; then
+    echo "build --format=bin differs from emit-bytecode: ${artifact}" >&2
+    exit 1
+  fi
+done
+python3 - "${OUT_DIR}/records.tisc.json" "${OUT_DIR}/records.tisc.bin" <<'PY'
+import hashlib, json, struct, sys
+
+insns = json.load(open(sys.argv[1]))["insns"]
+data = open(sys.argv[2], "rb").read()
+magic, version, section_count, _, size = struct.unpack_from("<4sIIIQ", data, 0)
+assert magic == b"TISC" and version == 1 and size == len(data), "bad tisc-bin-v1 header"
+assert data[24:56] == hashlib.sha256(data[64:]).digest(), "content hash mismatch"
+sections = {}
+for i in range(section_count):
+    kind, _, offset, length = struct.unpack_from("<IIQQ", data, 64 + 24 * i)
+    sections[kind] = offset
+count = struct.unpack_from("<I", data, sections[1])[0]
+assert count == len(insns), f"{count} binary insns, {len(insns)} in JSON"
+for i, insn in enumerate(insns):
+    _, a, b, c, literal_kind = struct.unpack_from("<B3xiqiB3x", data, sections[1] + 8 + 24 * i)
+    if insn["opcode"] == "Call":
+        # The binary record carries the argument count in b.
+        assert a == insn["a"] and c == 0, f"insn {i} call differs"
+        continue
+    assert (a, c) == (insn["a"], insn["c"]), f"insn {i} operands differ"
+    assert literal_kind == 3 or b == insn["b"], f"insn {i} operand b differs"
+PY
+
+# Optimization levels: -O0 is the unoptimized default, -O1 is cached under
+# its own kind, and --time-passes reports on stderr without touching stdout.
+OPT_SRC="${ROOT}/examples/04_logical_short_circuit.t81"
+"${CLI_PATH}" emit-bytecode "${OPT_SRC}" -o "${OUT_DIR}/opt-default.tisc.json" >/dev/null
+"${CLI_PATH}" emit-bytecode "${OPT_SRC}" -O0 -o "${OUT_DIR}/opt-O0.tisc.json" >/dev/null
+if ! cmp -s "${OUT_DIR}/opt-default.tisc.json" "${OUT_DIR}/opt-O0.tisc.json"; then
+  echo "-O0 differs from the default level" >&2
+  exit 1
+fi
+for pass_run in cold warm; do
+  T81_CACHE_DIR="${CACHE_DIR}" "${CLI_PATH}" build "${OPT_SRC}" -O1 -o "${OUT_DIR}/opt-O1-${pass_run}.tisc.json" >/dev/null
+done
+"${CLI_PATH}" emit-bytecode "${OPT_SRC}" -O1 -o "${OUT_DIR}/opt-O1.tisc.json" >/dev/null
+if ! cmp -s "${OUT_DIR}/opt-O1.tisc.json" "${OUT_DIR}/opt-O1-warm.tisc.json"; then
+  echo "cached -O1 build differs from emit-bytecode -O1" >&2
+  exit 1
+fi
+if cmp -s "${OUT_DIR}/opt-O1.tisc.json" "${OUT_DIR}/opt-O0.tisc.json"; then
+  echo "-O1 did not change ${OPT_SRC}" >&2
+  exit 1
+fi
+"${CLI_PATH}" emit-ir "${OPT_SRC}" -O1 --time-passes --print-after=simplify-jumps \
+  >"${OUT_DIR}/opt.ir" 2>"${OUT_DIR}/opt.passes"
+if ! rg -q '^pass timing:' "${OUT_DIR}/opt.passes" || ! rg -q '^  simplify-jumps .* insns [0-9]+ -> [0-9]+' "${OUT_DIR}/opt.passes" \
+  || ! rg -q '^; IR after simplify-jumps' "${OUT_DIR}/opt.passes"; then
+  echo "missing pass report for -O1 --time-passes --print-after" >&2
+  exit 1
+fi
+if rg -q 'pass timing' "${OUT_DIR}/opt.ir"; then
+  echo "pass report leaked into stdout" >&2
+  exit 1
+fi
+"${CLI_PATH}" emit-ir "${OPT_SRC}" -O2 --time-passes -o "${OUT_DIR}/opt-O2.ir" 2>"${OUT_DIR}/opt-O2.passes" >/dev/null
+for ssa_pass in sccp gvn coalesce-copies; do
+  if ! rg -q "^  ${ssa_pass} " "${OUT_DIR}/opt-O2.passes"; then
+    echo "-O2 did not run ${ssa_pass}" >&2
+    exit 1
+  fi
+done
+# -O2 inlines small pure functions; --remarks reports each decision.
+INLINE_SRC="${ROOT}/examples/option_result_match.t81"
+"${CLI_PATH}" emit-ir "${INLINE_SRC}" -O2 --remarks -o "${OUT_DIR}/inline-O2.ir" 2>"${OUT_DIR}/inline.remarks" >/dev/null
+if ! rg -q "remark: inlined 'option_match' into 'main'" "${OUT_DIR}/inline.remarks" || rg -q 'CALL' "${OUT_DIR}/inline-O2.ir"; then
+  echo "-O2 did not inline ${INLINE_SRC}" >&2
+  exit 1
+fi
+"${CLI_PATH}" emit-ir "${INLINE_SRC}" -O1 --remarks -o "${OUT_DIR}/inline-O1.ir" 2>"${OUT_DIR}/inline-O1.remarks" >/dev/null
+if [[ -s "${OUT_DIR}/inline-O1.remarks" ]]; then
+  echo "-O1 should not inline" >&2
+  exit 1
+fi
+# tisc-json-v1 carries two call arguments; more are rejected, not dropped.
+# tisc-bin-v1 carries the count, so every argument reaches the callee.
+cat >"${OUT_DIR}/three-args.t81" <<'T81'
+fn pick(a: i32, b: i32, c: i32) -> i32 {
+    return c;
+}
+
+fn main() -> i32 {
+    return pick(1, 2, 3);
+}
+T81
+cat >"${OUT_DIR}/seven-args.t81" <<'T81'
+fn pick(a: i32, b: i32, c: i32, d: i32, e: i32, f: i32, g: i32) -> i32 {
+    return g;
+}
+
+fn main() -> i32 {
+    return pick(1, 2, 3, 4, 5, 6, 7);
+}
+T81
+"${CLI_PATH}" emit-ir "${OUT_DIR}/three-args.t81" -o "${OUT_DIR}/three-args.ir" >/dev/null
+if "${CLI_PATH}" emit-bytecode "${OUT_DIR}/three-args.t81" -o "${OUT_DIR}/three-args.tisc.json" 2>"${OUT_DIR}/three-args.err" >/dev/null \
+  || ! rg -q "more than 2 arguments" "${OUT_DIR}/three-args.err"; then
+  echo "a call with three arguments should not be encodable in tisc-json-v1" >&2
+  exit 1
+fi
+for args in three seven; do
+  for level in -O0 -O1; do
+    "${CLI_PATH}" emit-bytecode "${OUT_DIR}/${args}-args.t81" ${level} --format=bin \
+      -o "${OUT_DIR}/${args}-args${level}.tisc.bin" >/dev/null
+  done
+done
+python3 - "${OUT_DIR}" <<'PY'
+import struct, sys
+
+for name, count in (("three", 3), ("seven", 7)):
+    for level in ("-O0", "-O1"):
+        data = open(f"{sys.argv[1]}/{name}-args{level}.tisc.bin", "rb").read()
+        section_count = struct.unpack_from("<I", data, 8)[0]
+        sections = {}
+        for i in range(section_count):
+            kind, _, offset, _ = struct.unpack_from("<IIQQ", data, 64 + 24 * i)
+            sections[kind] = offset
+        records = [struct.unpack_from("<B3xiqiB3x", data, sections[1] + 8 + 24 * i)
+                   for i in range(struct.unpack_from("<I", data, sections[1])[0])]
+        # Call is opcode 26 in t81::tisc::Opcode.
+        calls = [r for r in records if r[0] == 26]
+        assert len(calls) == 1 and calls[0][2] == count, f"{name}{level}: call records {calls}"
+PY
+# Every level turns the tail calls of a @tailrec function into a loop, @effect
+# or not; @tailrec rejects recursion that is not one, and a call it cannot
+# expand.
+TAILREC_SRC="${ROOT}/examples/21_tail_recursion.t81"
+for level in -O0 -O1 -O2; do
+  "${CLI_PATH}" emit-ir "${TAILREC_SRC}" "${level}" --remarks -o "${OUT_DIR}/tailrec${level}.ir" 2>"${OUT_DIR}/tailrec.remarks" >/dev/null
+  if ! rg -q "remark: turned tail call to 'sum_to' into a loop" "${OUT_DIR}/tailrec.remarks" || rg -q 'CALL' "${OUT_DIR}/tailrec${level}.ir"; then
+    echo "${level} did not turn the tail call in ${TAILREC_SRC} into a loop" >&2
+    exit 1
+  fi
+done
+cat >"${OUT_DIR}/tailrec-effect.t81" <<'T81'
+@effect
+@tailrec
+fn count(n: i32, acc: i32) -> i32 {
+    if (n == 0) {
+        return acc;
+    }
+    return count(n - 1, acc + 1);
+}
+
+@effect
+fn main() -> i32 {
+    return count(50, 0);
+}
+T81
+"${CLI_PATH}" emit-ir "${OUT_DIR}/tailrec-effect.t81" -O2 -o "${OUT_DIR}/tailrec-effect.ir" >/dev/null
+if rg -q 'CALL' "${OUT_DIR}/tailrec-effect.ir"; then
+  echo "an @effect @tailrec function stayed a CALL" >&2
+  exit 1
+fi
+cat >"${OUT_DIR}/tailrec-mutual.t81" <<'T81'
+@tailrec
+fn ping(n: i32) -> i32 {
+    if (n < 1) {
+        return 0;
+    }
+    return pong(n - 1);
+}
+
+@tailrec
+fn pong(n: i32) -> i32 {
+    if (n < 1) {
+        return 1;
+    }
+    return ping(n - 1);
+}
+
+fn main() -> i32 {
+    return ping(7);
+}
+T81
+if "${CLI_PATH}" emit-ir "${OUT_DIR}/tailrec-mutual.t81" -o "${OUT_DIR}/tailrec-mutual.ir" 2>"${OUT_DIR}/tailrec-mutual.err" >/dev/null \
+  || ! rg -q "cannot turn the call to @tailrec 'ping' into a loop" "${OUT_DIR}/tailrec-mutual.err"; then
+  echo "a @tailrec call that cannot be expanded was accepted" >&2
+  exit 1
+fi
+cat >"${OUT_DIR}/tailrec-bad.t81" <<'T81'
+@tailrec
+fn fact(n: i32) -> i32 {
+    if (n < 2) {
+        return 1;
+    }
+    return n * fact(n - 1);
+}
+
+fn main() -> i32 {
+    return fact(5);
+}
+T81
+if "${CLI_PATH}" check "${OUT_DIR}/tailrec-bad.t81" 2>"${OUT_DIR}/tailrec-bad.err" >/dev/null \
+  || ! rg -q "not in tail position" "${OUT_DIR}/tailrec-bad.err"; then
+  echo "@tailrec accepted a call that is not in tail position" >&2
+  exit 1
+fi
+# More live values than registers: the spill slots live in a frame the
+# program reserves first and frees right before it halts.
+python3 - "${OUT_DIR}/spill.t81" <<'PY'
+import sys
+values = [f"v{k}" for k in range(32)]
+lines = ["fn main() -> i32 {", "    var t: i32 = 0;", "    var i: i32 = 0;", "    while (i < 3) {"]
+lines += [f"        let {v}: i32 = i * {k + 3};" for k, v in enumerate(values)]
+lines += [f"        t = t + {' + '.join(values)} + {' * '.join(values)};", "        i = i + 1;", "    }", "    return t;", "}"]
+open(sys.argv[1], "w").write("\n".join(lines) + "\n")
+PY
+"${CLI_PATH}" emit-bytecode "${OUT_DIR}/spill.t81" -O1 -o "${OUT_DIR}/spill.tisc.json" >/dev/null
+python3 - "${OUT_DIR}/spill.tisc.json" <<'PY'
+import json, sys
+insns = json.load(open(sys.argv[1]))["insns"]
+cells = insns[0]["a"]
+assert insns[0]["opcode"] == "StackAlloc" and cells > 0, insns[0]
+assert [i["opcode"] for i in insns[-2:]] == ["StackFree", "Halt"] and insns[-2]["a"] == cells, insns[-2:]
+slots = [i["a"] for i in insns if i["opcode"] == "Store"] + [i["b"] for i in insns if i["opcode"] == "Load"]
+assert slots and all(0 <= slot < cells for slot in slots), slots
+PY
+if "${CLI_PATH}" emit-ir "${OPT_SRC}" --print-after=no-such-pass >/dev/null 2>&1; then
+  echo "unknown --print-after pass should be rejected" >&2
+  exit 1
+fi
+
 echo "cli compile checks: ok"
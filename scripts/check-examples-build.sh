@@ -28,6 +28,7 @@ SINGLE_FILE_EXAMPLES=(
   "examples/18_collections_flow_mvp.t81"
   "examples/19_maybe_result_promise_flow.t81"
   "examples/20_runtime_handles_flow_mvp.t81"
+  "examples/21_tail_recursion.t81"
   "examples/string_demo.t81"
   "examples/option_result_match.t81"
 )
@@ -58,4 +59,25 @@ for artifact in "${OUT_DIR}"/*.tisc.json; do
   fi
 done
 
+# -O1 must never grow a program and must shrink the curriculum overall.
+OPT_DIR="${OUT_DIR}/O1"
+mkdir -p "${OPT_DIR}"
+for rel in "${SINGLE_FILE_EXAMPLES[@]}"; do
+  base="$(basename "${rel}" .t81)"
+  "${CLI_PATH}" build "${ROOT}/${rel}" -O1 -o "${OPT_DIR}/${base}.tisc.json" >/dev/null
+done
+python3 - "${OUT_DIR}" "${OPT_DIR}" <<'PY'
+import json, pathlib, sys
+
+plain_dir, opt_dir = map(pathlib.Path, sys.argv[1:])
+plain_total = opt_total = 0
+for opt in sorted(opt_dir.glob("*.tisc.json")):
+    plain = len(json.loads((plain_dir / opt.name).read_text())["insns"])
+    optimized = len(json.loads(opt.read_text())["insns"])
+    assert optimized <= plain, f"{opt.name}: -O1 grew the program ({plain} -> {optimized})"
+    plain_total += plain
+    opt_total += optimized
+assert opt_total < plain_total, f"-O1 did not shrink the examples ({plain_total} -> {opt_total})"
+PY
+
 echo "examples build checks: ok"
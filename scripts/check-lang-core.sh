@@ -9,12 +9,32 @@ CXX="${CXX:-c++}"
 CXXFLAGS="${CXXFLAGS:--std=c++20 -O2 -Wall -Wextra -Wpedantic -I${ROOT}/include}"
 
 COMMON_SRCS=(
+  "${ROOT}/src/frontend/identifier_interner.cpp"
   "${ROOT}/src/frontend/lexer.cpp"
   "${ROOT}/src/frontend/parser.cpp"
   "${ROOT}/src/frontend/ast_printer.cpp"
+  "${ROOT}/src/frontend/flat_ast.cpp"
   "${ROOT}/src/frontend/symbol_table.cpp"
+  "${ROOT}/src/frontend/type_interner.cpp"
   "${ROOT}/src/frontend/semantic_analyzer.cpp"
+  "${ROOT}/src/frontend/module_interface.cpp"
+  "${ROOT}/src/support/block_writer.cpp"
+  "${ROOT}/src/support/mapped_file.cpp"
+  "${ROOT}/src/support/sha256.cpp"
+  "${ROOT}/src/support/work_stealing_pool.cpp"
+  "${ROOT}/src/tisc/binary_format.cpp"
+  "${ROOT}/src/tisc/cfg.cpp"
+  "${ROOT}/src/tisc/constant.cpp"
+  "${ROOT}/src/tisc/pass_manager.cpp"
+  "${ROOT}/src/tisc/passes/constant_fold.cpp"
+  "${ROOT}/src/tisc/passes/dead_code.cpp"
+  "${ROOT}/src/tisc/passes/gvn.cpp"
+  "${ROOT}/src/tisc/passes/lower_calls.cpp"
+  "${ROOT}/src/tisc/passes/register_allocation.cpp"
+  "${ROOT}/src/tisc/passes/sccp.cpp"
+  "${ROOT}/src/tisc/passes/simplify_jumps.cpp"
   "${ROOT}/src/tisc/pretty_printer.cpp"
+  "${ROOT}/src/tisc/ssa.cpp"
 )
 
 run_test() {
@@ -30,8 +50,14 @@ run_test "${ROOT}/tests/syntax/frontend_parser_test.cpp" "${BUILD_DIR}/frontend_
 run_test "${ROOT}/tests/syntax/frontend_parser_generics_test.cpp" "${BUILD_DIR}/frontend_parser_generics_test"
 run_test "${ROOT}/tests/syntax/frontend_parser_legacy_rejection_test.cpp" "${BUILD_DIR}/frontend_parser_legacy_rejection_test"
 run_test "${ROOT}/tests/syntax/frontend_parser_module_import_effect_test.cpp" "${BUILD_DIR}/frontend_parser_module_import_effect_test"
+run_test "${ROOT}/tests/syntax/frontend_parser_tailrec_test.cpp" "${BUILD_DIR}/frontend_parser_tailrec_test"
 run_test "${ROOT}/tests/syntax/frontend_fuzz_test.cpp" "${BUILD_DIR}/frontend_fuzz_test"
 run_test "${ROOT}/tests/syntax/frontend_lexer_test.cpp" "${BUILD_DIR}/frontend_lexer_test"
+run_test "${ROOT}/tests/syntax/frontend_token_set_test.cpp" "${BUILD_DIR}/frontend_token_set_test"
+run_test "${ROOT}/tests/syntax/frontend_ast_arena_test.cpp" "${BUILD_DIR}/frontend_ast_arena_test"
+run_test "${ROOT}/tests/syntax/frontend_typed_visitor_test.cpp" "${BUILD_DIR}/frontend_typed_visitor_test"
+run_test "${ROOT}/tests/syntax/frontend_flat_ast_test.cpp" "${BUILD_DIR}/frontend_flat_ast_test"
+run_test "${ROOT}/tests/syntax/frontend_identifier_interner_test.cpp" "${BUILD_DIR}/frontend_identifier_interner_test"
 run_test "${ROOT}/tests/semantics/semantic_analyzer_equality_test.cpp" "${BUILD_DIR}/semantic_analyzer_equality_test"
 run_test "${ROOT}/tests/semantics/semantic_analyzer_generic_test.cpp" "${BUILD_DIR}/semantic_analyzer_generic_test"
 run_test "${ROOT}/tests/semantics/semantic_analyzer_loop_test.cpp" "${BUILD_DIR}/semantic_analyzer_loop_test"
@@ -41,7 +67,21 @@ run_test "${ROOT}/tests/semantics/semantic_analyzer_numeric_test.cpp" "${BUILD_D
 run_test "${ROOT}/tests/semantics/semantic_analyzer_option_result_test.cpp" "${BUILD_DIR}/semantic_analyzer_option_result_test"
 run_test "${ROOT}/tests/semantics/semantic_analyzer_record_enum_test.cpp" "${BUILD_DIR}/semantic_analyzer_record_enum_test"
 run_test "${ROOT}/tests/semantics/semantic_analyzer_vector_literal_test.cpp" "${BUILD_DIR}/semantic_analyzer_vector_literal_test"
+run_test "${ROOT}/tests/semantics/semantic_type_interner_test.cpp" "${BUILD_DIR}/semantic_type_interner_test"
+run_test "${ROOT}/tests/semantics/semantic_analyzer_parallel_test.cpp" "${BUILD_DIR}/semantic_analyzer_parallel_test"
+run_test "${ROOT}/tests/semantics/module_interface_test.cpp" "${BUILD_DIR}/module_interface_test"
+run_test "${ROOT}/tests/roundtrip/tisc_binary_format_test.cpp" "${BUILD_DIR}/tisc_binary_format_test"
+run_test "${ROOT}/tests/roundtrip/block_writer_test.cpp" "${BUILD_DIR}/block_writer_test"
+run_test "${ROOT}/tests/roundtrip/tisc_pass_manager_test.cpp" "${BUILD_DIR}/tisc_pass_manager_test"
+run_test "${ROOT}/tests/roundtrip/tisc_constant_fold_test.cpp" "${BUILD_DIR}/tisc_constant_fold_test"
+run_test "${ROOT}/tests/roundtrip/tisc_dead_code_test.cpp" "${BUILD_DIR}/tisc_dead_code_test"
+run_test "${ROOT}/tests/roundtrip/tisc_register_allocation_test.cpp" "${BUILD_DIR}/tisc_register_allocation_test"
+run_test "${ROOT}/tests/roundtrip/tisc_calling_convention_test.cpp" "${BUILD_DIR}/tisc_calling_convention_test"
+run_test "${ROOT}/tests/roundtrip/tisc_differential_test.cpp" "${BUILD_DIR}/tisc_differential_test"
+run_test "${ROOT}/tests/roundtrip/tisc_ssa_test.cpp" "${BUILD_DIR}/tisc_ssa_test"
 run_test "${ROOT}/tests/roundtrip/lang_literal_pool_test.cpp" "${BUILD_DIR}/lang_literal_pool_test"
 run_test "${ROOT}/tests/roundtrip/frontend_ir_generator_logical_short_circuit_test.cpp" "${BUILD_DIR}/frontend_ir_generator_logical_short_circuit_test"
+run_test "${ROOT}/tests/roundtrip/frontend_ir_match_lowering_test.cpp" "${BUILD_DIR}/frontend_ir_match_lowering_test"
+run_test "${ROOT}/tests/roundtrip/frontend_ir_inline_test.cpp" "${BUILD_DIR}/frontend_ir_inline_test"
 
 echo "lang core checks: ok"
@@ -27,10 +27,62 @@ run_expect_failure() {
   fi
 }
 
+# Modules are parsed in parallel; diagnostics must still come out in the
+# same order on every run.
+run_expect_stable_diagnostics() {
+  local file="$1"
+  local runs=8
+  "${CLI_PATH}" check "${file}" >/dev/null 2>"${ROOT}/build/module-graph.err" || true
+  for ((i = 1; i < runs; ++i)); do
+    "${CLI_PATH}" check "${file}" >/dev/null 2>"${ROOT}/build/module-graph.rerun.err" || true
+    if ! cmp -s "${ROOT}/build/module-graph.err" "${ROOT}/build/module-graph.rerun.err"; then
+      echo "module graph diagnostics differ between runs for ${file}" >&2
+      diff "${ROOT}/build/module-graph.err" "${ROOT}/build/module-graph.rerun.err" >&2 || true
+      exit 1
+    fi
+  done
+}
+
 mkdir -p "${ROOT}/build"
 
 run_expect_success "${ROOT}/tests/harness/module_graph/ok/app/main.t81"
+run_expect_success "${ROOT}/tests/harness/module_graph/diamond/app/main.t81"
 run_expect_failure "${ROOT}/tests/harness/module_graph/missing/app/main.t81" "missing import"
 run_expect_failure "${ROOT}/tests/harness/module_graph/cycle/app/a.t81" "import cycle detected"
+run_expect_failure "${ROOT}/tests/harness/module_graph/multi_error/app/main.t81" "missing import 'app.also_absent'"
+run_expect_stable_diagnostics "${ROOT}/tests/harness/module_graph/multi_error/app/main.t81"
+run_expect_stable_diagnostics "${ROOT}/tests/harness/module_graph/cycle/app/a.t81"
+
+# Precompiled interfaces: once the diamond checks cleanly, its dependencies
+# load from .t81i files and are not parsed again. A source whose size and
+# mtime still match its interface is trusted as is, so restoring them after
+# an edit proves the dependency was skipped; any real edit is rechecked.
+IFACE_WORK="${ROOT}/build/module-graph/interfaces"
+rm -rf "${IFACE_WORK}"
+mkdir -p "${IFACE_WORK}"
+cp -R "${ROOT}/tests/harness/module_graph/diamond" "${IFACE_WORK}/diamond"
+export T81_INTERFACE_DIR="${IFACE_WORK}/t81i"
+IFACE_MAIN="${IFACE_WORK}/diamond/app/main.t81"
+IFACE_BASE="${IFACE_WORK}/diamond/app/base.t81"
+run_expect_success "${IFACE_MAIN}"
+if [[ "$(find "${T81_INTERFACE_DIR}" -name '*.t81i' | wc -l | tr -d ' ')" != "4" ]]; then
+  echo "expected one interface per diamond module" >&2
+  exit 1
+fi
+base_mtime="$(date -r "${IFACE_BASE}" '+%Y-%m-%d %H:%M:%S.%N')"
+sed 's/return 0;/return x;/' "${IFACE_BASE}" > "${IFACE_BASE}.tmp"
+mv "${IFACE_BASE}.tmp" "${IFACE_BASE}"
+touch -d "${base_mtime}" "${IFACE_BASE}"
+run_expect_success "${IFACE_MAIN}"
+touch "${IFACE_BASE}"
+run_expect_failure "${IFACE_MAIN}" "Undefined variable 'x'"
+unset T81_INTERFACE_DIR
+
+# Without T81_INTERFACE_DIR only `build` writes interfaces.
+(cd "${IFACE_WORK}" && "${CLI_PATH}" check "${ROOT}/tests/harness/module_graph/diamond/app/main.t81" >/dev/null)
+if [[ -n "$(find "${IFACE_WORK}" "${ROOT}/tests/harness/module_graph/diamond" -name '.t81i')" ]]; then
+  echo "check wrote interfaces without T81_INTERFACE_DIR" >&2
+  exit 1
+fi
 
 echo "module graph checks: ok"
@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ROOT="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="${ROOT}/build/bench"
+mkdir -p "${BUILD_DIR}"
+
+CXX="${CXX:-c++}"
+CXXFLAGS="${CXXFLAGS:--std=c++20 -O2 -Wall -Wextra -Wpedantic -I${ROOT}/include}"
+CORPUS="${BENCH_CORPUS:-${ROOT}/examples}"
+
+run_bench() {
+  local bench_src="$1"
+  local out_bin="$2"
+  shift 2
+  echo "[bench] building $(basename "$bench_src")"
+  "${CXX}" ${CXXFLAGS} "${bench_src}" "$@" -o "${out_bin}"
+  echo "[bench] running $(basename "$out_bin")"
+  "${out_bin}" "${CORPUS}" ${BENCH_ITERATIONS:-}
+}
+
+run_bench "${ROOT}/tests/bench/lexer_throughput_bench.cpp" "${BUILD_DIR}/lexer_throughput_bench" \
+  "${ROOT}/src/frontend/identifier_interner.cpp" "${ROOT}/src/frontend/lexer.cpp"
+
+run_bench "${ROOT}/tests/bench/parser_throughput_bench.cpp" "${BUILD_DIR}/parser_throughput_bench" \
+  "${ROOT}/src/frontend/identifier_interner.cpp" "${ROOT}/src/frontend/lexer.cpp" "${ROOT}/src/frontend/parser.cpp"
+
+run_bench "${ROOT}/tests/bench/check_throughput_bench.cpp" "${BUILD_DIR}/check_throughput_bench" \
+  "${ROOT}/src/frontend/identifier_interner.cpp" "${ROOT}/src/frontend/lexer.cpp" "${ROOT}/src/frontend/parser.cpp" \
+  "${ROOT}/src/frontend/symbol_table.cpp" "${ROOT}/src/frontend/type_interner.cpp" \
+  "${ROOT}/src/frontend/semantic_analyzer.cpp" "${ROOT}/src/support/work_stealing_pool.cpp"
@@ -1,20 +1,33 @@
 #include "t81/frontend/ast_printer.hpp"
 #include "t81/frontend/ir_generator.hpp"
 #include "t81/frontend/lexer.hpp"
+#include "t81/frontend/module_interface.hpp"
 #include "t81/frontend/parser.hpp"
 #include "t81/frontend/semantic_analyzer.hpp"
+#include "t81/support/block_writer.hpp"
+#include "t81/support/mapped_file.hpp"
+#include "t81/support/sha256.hpp"
+#include "t81/support/work_stealing_pool.hpp"
+#include "t81/tisc/binary_format.hpp"
+#include "t81/tisc/pass_manager.hpp"
 #include "t81/tisc/pretty_printer.hpp"
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -23,17 +36,33 @@ namespace {
 
 constexpr int kUsageExitCode = 64;
 
+#ifndef T81_LANG_SOURCE_HASH
+#define T81_LANG_SOURCE_HASH "unhashed"
+#endif
+
+// Names this compiler in build-cache keys and interface stamps. The hash of
+// its sources comes from scripts/build-t81-lang-cli.sh, so rebuilding the
+// same tree keeps every artifact valid and a changed compiler never reuses
+// one an older compiler wrote.
+constexpr std::string_view kCompilerStamp = "t81-lang " T81_LANG_SOURCE_HASH;
+
 void print_usage(std::ostream& os) {
     os << "Usage:\n"
        << "  t81-lang parse <file.t81>\n"
        << "  t81-lang check <file.t81>\n"
-       << "  t81-lang emit-ir <file.t81> [-o out.ir]\n"
-       << "  t81-lang emit-bytecode <file.t81> [-o out.tisc.json]\n"
-       << "  t81-lang build <file.t81> [-o out.tisc.json]\n";
+       << "  t81-lang emit-ir <file.t81> [-o out.ir] [optimization options]\n"
+       << "  t81-lang emit-bytecode <file.t81> [-o out.tisc.json] [--format=json|bin] [optimization options]\n"
+       << "  t81-lang build <file.t81> [-o out.tisc.json] [--format=json|bin] [optimization options]\n"
+       << "\n"
+       << "Optimization options:\n"
+       << "  -O0|-O1|-O2           IR optimization level (default -O0)\n"
+       << "  --time-passes         Report per-pass wall time and instruction counts on stderr\n"
+       << "  --print-after=<pass>  Print the IR to stderr after <pass> runs\n"
+       << "  --remarks             Report inlining and tail-call decisions on stderr\n";
 }
 
 std::optional<std::string> read_file(const std::string& path) {
-    std::ifstream in(path);
+    std::ifstream in(path, std::ios::binary);
     if (!in) {
         return std::nullopt;
     }
@@ -43,7 +72,7 @@ std::optional<std::string> read_file(const std::string& path) {
 }
 
 bool write_file(const std::filesystem::path& path, const std::string& content) {
-    std::ofstream out(path);
+    std::ofstream out(path, std::ios::binary);
     if (!out) {
         return false;
     }
@@ -51,6 +80,23 @@ bool write_file(const std::filesystem::path& path, const std::string& content) {
     return out.good();
 }
 
+// Writes through a temporary file renamed into place, so concurrent
+// readers see either the old content or the new, never a partial file.
+void write_file_atomically(const std::filesystem::path& path, const std::string& content) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+    if (ec) return;
+    fs::path tmp = path;
+    tmp += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    if (!write_file(tmp, content)) {
+        fs::remove(tmp, ec);
+        return;
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) fs::remove(tmp, ec);
+}
+
 int run_parse(const std::string& path) {
     const auto source = read_file(path);
     if (!source.has_value()) {
@@ -58,8 +104,8 @@ int run_parse(const std::string& path) {
         return 1;
     }
 
-    t81::frontend::Lexer lexer(*source);
-    t81::frontend::Parser parser(lexer, path);
+    const auto tokens = t81::frontend::TokenStream::tokenize(*source);
+    t81::frontend::Parser parser(tokens, path);
     auto statements = parser.parse();
     if (parser.had_error()) {
         return 1;
@@ -77,15 +123,46 @@ int run_parse(const std::string& path) {
     return 0;
 }
 
-std::optional<std::string> parse_optional_output_path(int argc, char** argv, int start_index) {
-    const int remaining = argc - start_index;
-    if (remaining == 0) {
-        return std::nullopt;
+// Options shared by every command that lowers to IR.
+struct CodegenOptions {
+    t81::tisc::ir::OptLevel level = t81::tisc::ir::OptLevel::O0;
+    bool time_passes = false;
+    std::optional<std::string> print_after;
+    bool remarks = false;
+
+    // Reports that only exist when code generation actually runs, so a
+    // cached artifact cannot stand in for them.
+    bool wants_pass_output() const { return time_passes || print_after.has_value() || remarks; }
+};
+
+// Consumes `arg` if it is an optimization option. An unknown pass name in
+// --print-after is reported here and leaves `ok` false.
+bool parse_codegen_option(std::string_view arg, CodegenOptions& options, bool& ok) {
+    ok = true;
+    if (auto level = t81::tisc::ir::parse_opt_level(arg)) {
+        options.level = *level;
+        return true;
+    }
+    if (arg == "--time-passes") {
+        options.time_passes = true;
+        return true;
     }
-    if (remaining == 2 && std::string_view(argv[start_index]) == "-o") {
-        return std::string(argv[start_index + 1]);
+    if (arg == "--remarks") {
+        options.remarks = true;
+        return true;
     }
-    return std::string();
+    constexpr std::string_view kPrintAfter = "--print-after=";
+    if (arg.substr(0, kPrintAfter.size()) == kPrintAfter) {
+        const std::string_view name = arg.substr(kPrintAfter.size());
+        const auto names = t81::tisc::ir::PassManager::pass_names();
+        if (std::find(names.begin(), names.end(), name) == names.end()) {
+            std::cerr << "error: unknown pass: " << name << "\n";
+            ok = false;
+        }
+        options.print_after = std::string(name);
+        return true;
+    }
+    return false;
 }
 
 struct ModuleUnit {
@@ -93,41 +170,302 @@ struct ModuleUnit {
     std::shared_ptr<std::string> source;
     std::optional<std::string> module_decl;
     std::vector<std::string> imports;
-    std::vector<std::unique_ptr<t81::frontend::Stmt>> statements;
+    t81::frontend::SyntaxTree statements;
+    // False when the imports came from the build cache and the source has
+    // not been lexed or parsed yet; see ensure_parsed.
+    bool parsed = false;
+    // Content hash of `source`, and the build-cache key: the source hash
+    // plus the keys of every import, so any change below invalidates it.
+    std::string source_hash;
+    std::string cache_key;
+    // Modification time of the source, taken before it was read.
+    std::int64_t source_mtime = 0;
+    // Set when the module was loaded from a current .t81i interface: it is
+    // neither parsed nor analyzed unless an import's interface changed.
+    bool from_interface = false;
+    // Exports hash of this module's interface; empty until one is loaded
+    // or written. `import_hashes` are the values recorded for each import.
+    std::string interface_hash;
+    std::vector<std::string> import_hashes;
+    std::vector<std::string> dep_keys;
+    // Kept alive after analysis: IR generation reads its side tables.
+    // Null when the module's check result came from the build cache.
+    std::unique_ptr<t81::frontend::SemanticAnalyzer> analyzer;
 };
 
-std::optional<ModuleUnit> parse_unit(const std::filesystem::path& path) {
-    auto source = read_file(path.string());
-    if (!source.has_value()) {
-        std::cerr << "error: unable to read source file: " << path << "\n";
-        return std::nullopt;
+struct CompilationSession;
+
+// Content-addressed store for `t81-lang build`, rooted at $T81_CACHE_DIR or
+// .t81cache in the directory the artifact is written to, whatever the
+// working directory. Entries are named by key and kind:
+//   <source hash>.imports   module declaration and imports of a source file
+//   <module key>.check      the module passed semantic analysis
+//   <module key>.tisc.json  bytecode of the module built as an entry
+// Only successes are stored, so failing builds always rerun and report.
+class BuildCache {
+public:
+    explicit BuildCache(std::filesystem::path root) : _root(std::move(root)) {}
+
+    static BuildCache from_environment(const std::filesystem::path& artifact_dir) {
+        const char* dir = std::getenv("T81_CACHE_DIR");
+        return BuildCache(dir && *dir ? std::filesystem::path(dir) : artifact_dir / ".t81cache");
     }
 
-    ModuleUnit unit;
-    unit.path = path;
-    unit.source = std::make_shared<std::string>(std::move(*source));
+    // Every key mixes in the compiler stamp, so a changed compiler never
+    // reuses artifacts produced by an older one.
+    static std::string key_of(std::string_view kind, std::string_view content) {
+        t81::Sha256 hash;
+        hash.update(kCompilerStamp).update("\0", 1).update(kind).update("\0", 1).update(content);
+        return t81::Sha256::to_hex(hash.finish());
+    }
+
+    std::optional<std::string> read(const std::string& key, std::string_view kind) const {
+        return read_file(entry_path(key, kind).string());
+    }
+
+    bool contains(const std::string& key, std::string_view kind) const {
+        std::error_code ec;
+        return std::filesystem::exists(entry_path(key, kind), ec);
+    }
+
+    void write(const std::string& key, std::string_view kind, const std::string& content) const {
+        write_file_atomically(entry_path(key, kind), content);
+    }
+
+    // Copies an entry to `dest`; false on a miss.
+    bool copy_out(const std::string& key, std::string_view kind, const std::filesystem::path& dest) const {
+        std::error_code ec;
+        return std::filesystem::copy_file(entry_path(key, kind), dest,
+                                          std::filesystem::copy_options::overwrite_existing, ec) && !ec;
+    }
+
+    // Stores a copy of the file at `source` as an entry.
+    void copy_in(const std::string& key, std::string_view kind, const std::filesystem::path& source) const {
+        namespace fs = std::filesystem;
+        const fs::path path = entry_path(key, kind);
+        std::error_code ec;
+        fs::create_directories(path.parent_path(), ec);
+        fs::path tmp = path;
+        tmp += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        if (ec || !fs::copy_file(source, tmp, fs::copy_options::overwrite_existing, ec)) {
+            fs::remove(tmp, ec);
+            return;
+        }
+        fs::rename(tmp, path, ec);
+        if (ec) fs::remove(tmp, ec);
+    }
+
+private:
+    std::filesystem::path entry_path(const std::string& key, std::string_view kind) const {
+        return _root / key.substr(0, 2) / (key.substr(2) + "." + std::string(kind));
+    }
+
+    std::filesystem::path _root;
+};
+
+// Precompiled module interfaces, rooted at $T81_INTERFACE_DIR or, for
+// `build`, .t81i next to the artifact, one <hash of canonical path>.t81i
+// file per module. A module
+// that checks cleanly gets an interface; an importer then loads the
+// interface (a single mmap) instead of lexing, parsing and analyzing the
+// dependency. An interface is current when it was written by this compiler
+// for the same source: matching size and mtime, or failing that a
+// matching content hash.
+class InterfaceStore {
+public:
+    explicit InterfaceStore(std::filesystem::path root) : _root(std::move(root)) {}
+
+    // Other commands use interfaces only when $T81_INTERFACE_DIR asks for
+    // them, so checking or emitting never writes into the working tree.
+    static std::optional<InterfaceStore> from_environment(const std::optional<std::filesystem::path>& build_dir) {
+        const char* dir = std::getenv("T81_INTERFACE_DIR");
+        if (dir && *dir) return InterfaceStore(std::filesystem::path(dir));
+        if (!build_dir) return std::nullopt;
+        return InterfaceStore(*build_dir / ".t81i");
+    }
+
+    std::filesystem::path path_for(const std::filesystem::path& source) const {
+        return _root / (t81::Sha256::hex(source.string()) + ".t81i");
+    }
+
+    // Loads the interface of `source` into `unit` if it is current.
+    bool load(const std::filesystem::path& source, std::uint64_t size, std::int64_t mtime, ModuleUnit& unit) const {
+        auto file = t81::MappedFile::open(path_for(source));
+        if (!file) return false;
+        auto view = t81::frontend::ModuleInterfaceView::open(file->bytes());
+        if (!view || view->compiler_stamp() != kCompilerStamp) return false;
+        if (view->source_size() != size || view->source_mtime() != mtime) {
+            auto text = read_file(source.string());
+            if (!text || t81::Sha256::hex(*text) != view->source_hash()) return false;
+            unit.source = std::make_shared<std::string>(std::move(*text));
+        }
+        if (!view->module_path().empty()) unit.module_decl = std::string(view->module_path());
+        for (std::size_t i = 0; i < view->import_count(); ++i) {
+            unit.imports.emplace_back(view->import_path(i));
+            unit.import_hashes.emplace_back(view->import_interface_hash(i));
+        }
+        unit.interface_hash = view->exports_hash();
+        unit.from_interface = true;
+        return true;
+    }
+
+    // Records the interface of a module that just passed analysis.
+    void store(const CompilationSession& session, const std::string& key, ModuleUnit& unit) const;
+
+    static std::int64_t mtime_of(const std::filesystem::path& path) {
+        std::error_code ec;
+        const auto time = std::filesystem::last_write_time(path, ec);
+        return ec ? 0 : static_cast<std::int64_t>(time.time_since_epoch().count());
+    }
+
+private:
+    std::filesystem::path _root;
+};
+
+// One driver invocation. Every module in the entry's import graph is read,
+// lexed, parsed and analyzed exactly once; later phases (IR, bytecode)
+// reuse the units instead of recompiling the entry file.
+struct CompilationSession {
+    std::filesystem::path entry;
+    std::string entry_key;
+    std::unordered_map<std::string, ModuleUnit> units;
+    // Canonical paths in load order (dependencies before importers).
+    std::vector<std::string> order;
+    // Shared by module parsing and per-function semantic analysis.
+    std::unique_ptr<t81::WorkStealingPool> pool;
+    // Set for `build`; other commands always run every phase.
+    std::optional<BuildCache> cache;
+    // Set for `build`, or for any command when $T81_INTERFACE_DIR is set.
+    std::optional<InterfaceStore> interfaces;
+
+    const ModuleUnit& entry_unit() const { return units.at(entry_key); }
+};
+
+void InterfaceStore::store(const CompilationSession& session, const std::string& key, ModuleUnit& unit) const {
+    auto iface = t81::frontend::ModuleInterface::build(*unit.analyzer, unit.statements);
+    iface.compiler_stamp = kCompilerStamp;
+    iface.source_hash = t81::Sha256::hex(*unit.source);
+    iface.source_size = unit.source->size();
+    iface.source_mtime = unit.source_mtime;
+    for (std::size_t i = 0; i < iface.imports.size() && i < unit.dep_keys.size(); ++i) {
+        iface.imports[i].interface_hash = session.units.at(unit.dep_keys[i]).interface_hash;
+    }
+    unit.interface_hash = iface.exports_hash();
+    write_file_atomically(path_for(key), iface.serialize());
+}
 
-    t81::frontend::Lexer lexer(*unit.source);
-    t81::frontend::Parser parser(lexer, path.string());
+// Lexes and parses `unit.source`, filling in its AST, module declaration
+// and imports. Parse errors go to `diag`.
+bool parse_source(ModuleUnit& unit, std::ostream& diag) {
+    const auto tokens = t81::frontend::TokenStream::tokenize(*unit.source);
+    t81::frontend::Parser parser(tokens, unit.path.string());
+    parser.set_error_stream(diag);
     auto statements = parser.parse();
     if (parser.had_error()) {
-        return std::nullopt;
+        return false;
     }
 
+    unit.module_decl.reset();
+    unit.imports.clear();
     for (const auto& stmt : statements) {
         if (!stmt) {
             continue;
         }
         if (auto* module = dynamic_cast<const t81::frontend::ModuleDecl*>(stmt.get())) {
-            unit.module_decl = module->path;
+            unit.module_decl = std::string(module->path);
         } else if (auto* import_stmt = dynamic_cast<const t81::frontend::ImportDecl*>(stmt.get())) {
-            unit.imports.push_back(import_stmt->path);
+            unit.imports.emplace_back(import_stmt->path);
         }
     }
     unit.statements = std::move(statements);
+    unit.parsed = true;
+    return true;
+}
+
+std::string render_imports_entry(const ModuleUnit& unit) {
+    std::string out;
+    if (unit.module_decl.has_value()) {
+        out += "module " + *unit.module_decl + "\n";
+    }
+    for (const auto& imp : unit.imports) {
+        out += "import " + imp + "\n";
+    }
+    return out;
+}
+
+void apply_imports_entry(ModuleUnit& unit, const std::string& entry) {
+    std::istringstream in(entry);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("module ", 0) == 0) {
+            unit.module_decl = line.substr(7);
+        } else if (line.rfind("import ", 0) == 0) {
+            unit.imports.push_back(line.substr(7));
+        }
+    }
+}
+
+// Reads a module and discovers its imports. A dependency with a current
+// interface is not parsed here; nor, with a cache, is a source file seen
+// before: its imports come from the cache.
+std::optional<ModuleUnit> parse_unit(const std::filesystem::path& path, std::ostream& diag,
+                                     const BuildCache* cache, const InterfaceStore* interfaces) {
+    ModuleUnit unit;
+    unit.path = path;
+    unit.source_mtime = InterfaceStore::mtime_of(path);
+    if (interfaces) {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path, ec);
+        if (!ec && interfaces->load(path, size, unit.source_mtime, unit) && !cache) {
+            return unit;
+        }
+    }
+
+    if (!unit.source) {
+        auto source = read_file(path.string());
+        if (!source.has_value()) {
+            diag << "error: unable to read source file: " << path << "\n";
+            return std::nullopt;
+        }
+        unit.source = std::make_shared<std::string>(std::move(*source));
+    }
+    if (!cache) {
+        if (!parse_source(unit, diag)) {
+            return std::nullopt;
+        }
+        return unit;
+    }
+
+    unit.source_hash = BuildCache::key_of("source", *unit.source);
+    if (unit.from_interface) {
+        return unit;
+    }
+    if (auto entry = cache->read(unit.source_hash, "imports")) {
+        apply_imports_entry(unit, *entry);
+        return unit;
+    }
+    if (!parse_source(unit, diag)) {
+        return std::nullopt;
+    }
+    cache->write(unit.source_hash, "imports", render_imports_entry(unit));
     return unit;
 }
 
+bool ensure_parsed(ModuleUnit& unit) {
+    if (unit.parsed) {
+        return true;
+    }
+    if (!unit.source) {
+        auto source = read_file(unit.path.string());
+        if (!source.has_value()) {
+            std::cerr << "error: unable to read source file: " << unit.path << "\n";
+            return false;
+        }
+        unit.source = std::make_shared<std::string>(std::move(*source));
+    }
+    return parse_source(unit, std::cerr);
+}
+
 std::vector<std::string> split_segments(const std::string& value, char sep) {
     std::vector<std::string> out;
     std::string current;
@@ -175,17 +513,70 @@ std::filesystem::path resolve_import_path(const std::filesystem::path& importer,
     return direct;
 }
 
-int run_check(const std::string& entry_file) {
+// A module read, lexed and parsed by a pool worker. Diagnostics are
+// buffered so load_module_graph can replay them in traversal order.
+struct ParsedModule {
+    std::optional<ModuleUnit> unit;
+    std::string diagnostics;
+    // One entry per import, in source order; empty when the import
+    // resolves to a file that does not exist.
+    std::vector<std::optional<std::filesystem::path>> deps;
+};
+
+// Reads, lexes and parses every module reachable from the entry
+// concurrently. Each module is scheduled once, when it is first imported.
+std::unordered_map<std::string, ParsedModule> parse_module_graph(const std::filesystem::path& entry,
+                                                                 t81::WorkStealingPool& pool,
+                                                                 const BuildCache* cache,
+                                                                 const InterfaceStore* interfaces) {
     namespace fs = std::filesystem;
-    const fs::path entry = fs::absolute(fs::path(entry_file));
-    if (!fs::exists(entry)) {
-        std::cerr << "error: entry file does not exist: " << entry << "\n";
-        return 1;
-    }
+    std::unordered_map<std::string, ParsedModule> parsed;
+    std::mutex parsed_mutex;
 
+    std::function<void(const fs::path&, std::string)> schedule = [&](const fs::path& path, std::string key) {
+        {
+            std::lock_guard lock(parsed_mutex);
+            if (!parsed.try_emplace(key).second) {
+                return;
+            }
+        }
+        pool.submit([&, path, key = std::move(key)] {
+            ParsedModule result;
+            std::ostringstream diag;
+            // The entry is always compiled from source.
+            result.unit = parse_unit(path, diag, cache, path == entry ? nullptr : interfaces);
+            result.diagnostics = diag.str();
+            if (result.unit.has_value()) {
+                for (const auto& imp : result.unit->imports) {
+                    fs::path dep = fs::weakly_canonical(resolve_import_path(path, result.unit->module_decl, imp));
+                    if (!fs::exists(dep)) {
+                        result.deps.emplace_back(std::nullopt);
+                        continue;
+                    }
+                    schedule(dep, dep.string());
+                    result.deps.emplace_back(std::move(dep));
+                }
+            }
+            std::lock_guard lock(parsed_mutex);
+            parsed[key] = std::move(result);
+        });
+    };
+
+    schedule(entry, fs::weakly_canonical(entry).string());
+    pool.wait();
+    return parsed;
+}
+
+bool load_module_graph(CompilationSession& session) {
+    namespace fs = std::filesystem;
+    const BuildCache* cache = session.cache ? &*session.cache : nullptr;
+    const InterfaceStore* interfaces = session.interfaces ? &*session.interfaces : nullptr;
+    auto parsed = parse_module_graph(session.entry, *session.pool, cache, interfaces);
+
+    // Walk the parsed graph depth-first, exactly as a serial loader would,
+    // so cycle reports and diagnostics come out in a deterministic order.
     enum class VisitState { Unseen, Visiting, Done };
     std::unordered_map<std::string, VisitState> state;
-    std::unordered_map<std::string, ModuleUnit> units;
     std::vector<std::string> stack;
     bool graph_error = false;
 
@@ -211,141 +602,309 @@ int run_check(const std::string& entry_file) {
         state[key] = VisitState::Visiting;
         stack.push_back(key);
 
-        auto unit = parse_unit(current);
-        if (!unit.has_value()) {
+        auto& module = parsed.at(key);
+        std::cerr << module.diagnostics;
+        if (!module.unit.has_value()) {
             graph_error = true;
             stack.pop_back();
             state[key] = VisitState::Done;
             return;
         }
 
-        for (const auto& imp : unit->imports) {
-            fs::path dep = fs::weakly_canonical(resolve_import_path(current, unit->module_decl, imp));
-            if (!fs::exists(dep)) {
+        auto& unit = *module.unit;
+        for (size_t i = 0; i < unit.imports.size(); ++i) {
+            if (!module.deps[i].has_value()) {
                 graph_error = true;
-                std::cerr << "error: missing import '" << imp << "' referenced from " << current << "\n";
+                std::cerr << "error: missing import '" << unit.imports[i] << "' referenced from " << current << "\n";
                 continue;
             }
-            load_module(dep);
+            load_module(*module.deps[i]);
+            unit.dep_keys.push_back(module.deps[i]->string());
         }
 
-        units.emplace(key, std::move(*unit));
+        if (cache) {
+            std::string key_input = unit.source_hash;
+            for (const auto& dep : module.deps) {
+                auto dep_unit = dep ? session.units.find(dep->string()) : session.units.end();
+                key_input += "\n";
+                key_input += dep_unit != session.units.end() ? dep_unit->second.cache_key : "-";
+            }
+            unit.cache_key = BuildCache::key_of("module", key_input);
+        }
+
+        session.units.emplace(key, std::move(unit));
+        session.order.push_back(key);
         stack.pop_back();
         state[key] = VisitState::Done;
     };
 
-    load_module(entry);
-    if (graph_error) {
-        return 1;
+    load_module(session.entry);
+    return !graph_error;
+}
+
+bool analyze_module(const CompilationSession& session, const std::string& path, ModuleUnit& unit) {
+    if (!ensure_parsed(unit)) {
+        return false;
+    }
+    unit.analyzer = std::make_unique<t81::frontend::SemanticAnalyzer>(unit.statements, path);
+    unit.analyzer->set_thread_pool(session.pool.get());
+    unit.analyzer->analyze();
+    if (unit.analyzer->had_error()) {
+        for (const auto& diag : unit.analyzer->diagnostics()) {
+            std::cerr << diag.file << ":" << diag.line << ":" << diag.column
+                      << ": error: " << diag.message << "\n";
+        }
+        return false;
+    }
+    if (session.cache) {
+        session.cache->write(unit.cache_key, "check", "ok\n");
+    }
+    if (session.interfaces) {
+        session.interfaces->store(session, path, unit);
     }
+    return true;
+}
+
+// True when `unit` came from an interface and every import still exports
+// exactly what it did when the interface was written.
+bool interface_is_current(const CompilationSession& session, const ModuleUnit& unit) {
+    if (!unit.from_interface || unit.import_hashes.size() != unit.dep_keys.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < unit.dep_keys.size(); ++i) {
+        const std::string& hash = session.units.at(unit.dep_keys[i]).interface_hash;
+        if (hash.empty() || hash != unit.import_hashes[i]) {
+            return false;
+        }
+    }
+    return true;
+}
 
+bool analyze_modules(CompilationSession& session) {
     bool semantic_error = false;
-    for (auto& [path, unit] : units) {
-        t81::frontend::SemanticAnalyzer analyzer(unit.statements, path);
-        analyzer.analyze();
-        if (analyzer.had_error()) {
-            semantic_error = true;
-            for (const auto& diag : analyzer.diagnostics()) {
-                std::cerr << diag.file << ":" << diag.line << ":" << diag.column
-                          << ": error: " << diag.message << "\n";
+    for (const auto& path : session.order) {
+        auto& unit = session.units.at(path);
+        if (session.cache && session.cache->contains(unit.cache_key, "check")) {
+            continue;
+        }
+        if (interface_is_current(session, unit)) {
+            if (session.cache) {
+                session.cache->write(unit.cache_key, "check", "ok\n");
             }
+            continue;
+        }
+        if (!analyze_module(session, path, unit)) {
+            semantic_error = true;
         }
     }
-
-    return semantic_error ? 1 : 0;
+    return !semantic_error;
 }
 
-std::optional<t81::tisc::ir::IntermediateProgram> compile_entry_to_ir(const std::string& path) {
-    const auto source = read_file(path);
-    if (!source.has_value()) {
-        std::cerr << "error: unable to read source file: " << path << "\n";
+// Loads and analyzes the entry's module graph; reports errors and returns
+// nullopt if any module fails to read, parse or type-check. `build_dir`,
+// set only for `build`, is the directory the artifact goes to; it turns
+// the cache and interfaces on and holds them by default.
+std::optional<CompilationSession> run_frontend(const std::string& entry_file,
+                                               const std::optional<std::filesystem::path>& build_dir = std::nullopt) {
+    namespace fs = std::filesystem;
+    CompilationSession session;
+    session.entry = fs::absolute(fs::path(entry_file));
+    if (!fs::exists(session.entry)) {
+        std::cerr << "error: entry file does not exist: " << session.entry << "\n";
         return std::nullopt;
     }
+    session.entry_key = fs::weakly_canonical(session.entry).string();
+    session.pool = std::make_unique<t81::WorkStealingPool>();
+    if (build_dir) {
+        session.cache = BuildCache::from_environment(*build_dir);
+    }
+    session.interfaces = InterfaceStore::from_environment(build_dir);
 
-    t81::frontend::Lexer lexer(*source);
-    t81::frontend::Parser parser(lexer, path);
-    auto statements = parser.parse();
-    if (parser.had_error()) {
+    if (!load_module_graph(session) || !analyze_modules(session)) {
         return std::nullopt;
     }
+    return session;
+}
 
-    t81::frontend::SemanticAnalyzer analyzer(statements, path);
-    analyzer.analyze();
-    if (analyzer.had_error()) {
-        for (const auto& diag : analyzer.diagnostics()) {
-            std::cerr << diag.file << ":" << diag.line << ":" << diag.column
-                      << ": error: " << diag.message << "\n";
+int run_check(const std::string& entry_file) {
+    return run_frontend(entry_file).has_value() ? 0 : 1;
+}
+
+t81::tisc::ir::IntermediateProgram lower_entry_to_ir(const CompilationSession& session,
+                                                     const CodegenOptions& options) {
+    const ModuleUnit& unit = session.entry_unit();
+    t81::frontend::IRGenerator generator;
+    generator.attach_semantic_analyzer(unit.analyzer.get());
+    generator.set_inline_threshold(options.level == t81::tisc::ir::OptLevel::O2
+                                       ? t81::frontend::IRGenerator::kDefaultInlineThreshold
+                                       : 0);
+    auto program = generator.generate(unit.statements);
+    if (options.remarks) {
+        for (const auto& remark : generator.inline_remarks()) {
+            std::cerr << unit.path.string() << ":" << remark.line << ":" << remark.column << ": remark: ";
+            if (remark.tail_call) {
+                std::cerr << "turned tail call to '" << remark.callee << "' into a loop\n";
+                continue;
+            }
+            std::cerr << (remark.inlined ? "inlined '" : "not inlined '") << remark.callee << "' into '"
+                      << remark.caller << (remark.inlined ? "' (" + remark.reason + ")" : "': " + remark.reason)
+                      << "\n";
         }
-        return std::nullopt;
     }
 
-    t81::frontend::IRGenerator generator;
-    generator.attach_semantic_analyzer(&analyzer);
-    return generator.generate(statements);
+    auto passes = t81::tisc::ir::PassManager::for_level(options.level);
+    if (options.print_after.has_value()) {
+        passes.print_after(*options.print_after, std::cerr);
+    }
+    passes.run(program);
+    if (options.time_passes) {
+        passes.write_timing_report(std::cerr);
+    }
+    return program;
 }
 
-std::optional<std::string> map_opcode_name(t81::tisc::ir::Opcode opcode) {
+// IR generation and the passes throw std::runtime_error on input they
+// cannot lower, such as a register file too small for a call; that is
+// reported like any other compile error.
+std::optional<t81::tisc::ir::IntermediateProgram> compile_entry_to_ir(const CompilationSession& session,
+                                                                      const CodegenOptions& options) {
+    try {
+        return lower_entry_to_ir(session, options);
+    } catch (const std::runtime_error& error) {
+        std::cerr << "error: " << error.what() << "\n";
+        return std::nullopt;
+    }
+}
+
+std::optional<t81::tisc::Opcode> map_opcode(t81::tisc::ir::Opcode opcode) {
     using t81::tisc::ir::Opcode;
+    using Tisc = t81::tisc::Opcode;
     switch (opcode) {
-        case Opcode::ADD: return "Add";
-        case Opcode::SUB: return "Sub";
-        case Opcode::MUL: return "Mul";
-        case Opcode::DIV: return "Div";
-        case Opcode::MOD: return "Mod";
-        case Opcode::NEG: return "Neg";
-        case Opcode::FADD: return "FAdd";
-        case Opcode::FSUB: return "FSub";
-        case Opcode::FMUL: return "FMul";
-        case Opcode::FDIV: return "FDiv";
-        case Opcode::FRACADD: return "FracAdd";
-        case Opcode::FRACSUB: return "FracSub";
-        case Opcode::FRACMUL: return "FracMul";
-        case Opcode::FRACDIV: return "FracDiv";
-        case Opcode::CMP: return "Cmp";
-        case Opcode::MOV: return "Mov";
-        case Opcode::LOADI: return "LoadImm";
-        case Opcode::LOAD: return "Load";
-        case Opcode::STORE: return "Store";
-        case Opcode::PUSH: return "Push";
-        case Opcode::POP: return "Pop";
-        case Opcode::JMP: return "Jump";
-        case Opcode::JZ: return "JumpIfZero";
-        case Opcode::JNZ: return "JumpIfNotZero";
-        case Opcode::JN: return "JumpIfNegative";
-        case Opcode::JP: return "JumpIfPositive";
-        case Opcode::CALL: return "Call";
-        case Opcode::RET: return "Ret";
-        case Opcode::I2F: return "I2F";
-        case Opcode::F2I: return "F2I";
-        case Opcode::I2FRAC: return "I2Frac";
-        case Opcode::FRAC2I: return "Frac2I";
-        case Opcode::MAKE_OPTION_SOME: return "MakeOptionSome";
-        case Opcode::MAKE_OPTION_NONE: return "MakeOptionNone";
-        case Opcode::MAKE_RESULT_OK: return "MakeResultOk";
-        case Opcode::MAKE_RESULT_ERR: return "MakeResultErr";
-        case Opcode::OPTION_IS_SOME: return "OptionIsSome";
-        case Opcode::OPTION_UNWRAP: return "OptionUnwrap";
-        case Opcode::RESULT_IS_OK: return "ResultIsOk";
-        case Opcode::RESULT_UNWRAP_OK: return "ResultUnwrapOk";
-        case Opcode::RESULT_UNWRAP_ERR: return "ResultUnwrapErr";
-        case Opcode::MAKE_ENUM_VARIANT: return "MakeEnumVariant";
-        case Opcode::MAKE_ENUM_VARIANT_PAYLOAD: return "MakeEnumVariantPayload";
-        case Opcode::ENUM_IS_VARIANT: return "EnumIsVariant";
-        case Opcode::ENUM_UNWRAP_PAYLOAD: return "EnumUnwrapPayload";
-        case Opcode::NOP: return "Nop";
-        case Opcode::HALT: return "Halt";
-        case Opcode::TRAP: return "Trap";
-        case Opcode::WEIGHTS_LOAD: return "WeightsLoad";
+        case Opcode::ADD: return Tisc::Add;
+        case Opcode::SUB: return Tisc::Sub;
+        case Opcode::MUL: return Tisc::Mul;
+        case Opcode::DIV: return Tisc::Div;
+        case Opcode::MOD: return Tisc::Mod;
+        case Opcode::NEG: return Tisc::Neg;
+        case Opcode::FADD: return Tisc::FAdd;
+        case Opcode::FSUB: return Tisc::FSub;
+        case Opcode::FMUL: return Tisc::FMul;
+        case Opcode::FDIV: return Tisc::FDiv;
+        case Opcode::FRACADD: return Tisc::FracAdd;
+        case Opcode::FRACSUB: return Tisc::FracSub;
+        case Opcode::FRACMUL: return Tisc::FracMul;
+        case Opcode::FRACDIV: return Tisc::FracDiv;
+        case Opcode::CMP: return Tisc::Cmp;
+        case Opcode::MOV: return Tisc::Mov;
+        case Opcode::LOADI: return Tisc::LoadImm;
+        case Opcode::LOAD: return Tisc::Load;
+        case Opcode::STORE: return Tisc::Store;
+        case Opcode::PUSH: return Tisc::Push;
+        case Opcode::POP: return Tisc::Pop;
+        case Opcode::JMP: return Tisc::Jump;
+        case Opcode::JZ: return Tisc::JumpIfZero;
+        case Opcode::JNZ: return Tisc::JumpIfNotZero;
+        case Opcode::JN: return Tisc::JumpIfNegative;
+        case Opcode::JP: return Tisc::JumpIfPositive;
+        case Opcode::CALL: return Tisc::Call;
+        case Opcode::RET: return Tisc::Ret;
+        case Opcode::STACK_ALLOC: return Tisc::StackAlloc;
+        case Opcode::STACK_FREE: return Tisc::StackFree;
+        case Opcode::I2F: return Tisc::I2F;
+        case Opcode::F2I: return Tisc::F2I;
+        case Opcode::I2FRAC: return Tisc::I2Frac;
+        case Opcode::FRAC2I: return Tisc::Frac2I;
+        case Opcode::MAKE_OPTION_SOME: return Tisc::MakeOptionSome;
+        case Opcode::MAKE_OPTION_NONE: return Tisc::MakeOptionNone;
+        case Opcode::MAKE_RESULT_OK: return Tisc::MakeResultOk;
+        case Opcode::MAKE_RESULT_ERR: return Tisc::MakeResultErr;
+        case Opcode::OPTION_IS_SOME: return Tisc::OptionIsSome;
+        case Opcode::OPTION_UNWRAP: return Tisc::OptionUnwrap;
+        case Opcode::RESULT_IS_OK: return Tisc::ResultIsOk;
+        case Opcode::RESULT_UNWRAP_OK: return Tisc::ResultUnwrapOk;
+        case Opcode::RESULT_UNWRAP_ERR: return Tisc::ResultUnwrapErr;
+        case Opcode::MAKE_ENUM_VARIANT: return Tisc::MakeEnumVariant;
+        case Opcode::MAKE_ENUM_VARIANT_PAYLOAD: return Tisc::MakeEnumVariantPayload;
+        case Opcode::ENUM_IS_VARIANT: return Tisc::EnumIsVariant;
+        case Opcode::ENUM_UNWRAP_PAYLOAD: return Tisc::EnumUnwrapPayload;
+        case Opcode::NOP: return Tisc::Nop;
+        case Opcode::HALT: return Tisc::Halt;
+        case Opcode::TRAP: return Tisc::Trap;
+        case Opcode::WEIGHTS_LOAD: return Tisc::WeightsLoad;
         case Opcode::LABEL: return std::nullopt;
     }
     return std::nullopt;
 }
 
+std::string_view opcode_name(t81::tisc::Opcode opcode) {
+    using t81::tisc::Opcode;
+    switch (opcode) {
+        case Opcode::Add: return "Add";
+        case Opcode::Sub: return "Sub";
+        case Opcode::Mul: return "Mul";
+        case Opcode::Div: return "Div";
+        case Opcode::Mod: return "Mod";
+        case Opcode::Neg: return "Neg";
+        case Opcode::FAdd: return "FAdd";
+        case Opcode::FSub: return "FSub";
+        case Opcode::FMul: return "FMul";
+        case Opcode::FDiv: return "FDiv";
+        case Opcode::FracAdd: return "FracAdd";
+        case Opcode::FracSub: return "FracSub";
+        case Opcode::FracMul: return "FracMul";
+        case Opcode::FracDiv: return "FracDiv";
+        case Opcode::Cmp: return "Cmp";
+        case Opcode::Mov: return "Mov";
+        case Opcode::LoadImm: return "LoadImm";
+        case Opcode::Load: return "Load";
+        case Opcode::Store: return "Store";
+        case Opcode::Push: return "Push";
+        case Opcode::Pop: return "Pop";
+        case Opcode::Jump: return "Jump";
+        case Opcode::JumpIfZero: return "JumpIfZero";
+        case Opcode::JumpIfNotZero: return "JumpIfNotZero";
+        case Opcode::JumpIfNegative: return "JumpIfNegative";
+        case Opcode::JumpIfPositive: return "JumpIfPositive";
+        case Opcode::Call: return "Call";
+        case Opcode::Ret: return "Ret";
+        case Opcode::StackAlloc: return "StackAlloc";
+        case Opcode::StackFree: return "StackFree";
+        case Opcode::I2F: return "I2F";
+        case Opcode::F2I: return "F2I";
+        case Opcode::I2Frac: return "I2Frac";
+        case Opcode::Frac2I: return "Frac2I";
+        case Opcode::MakeOptionSome: return "MakeOptionSome";
+        case Opcode::MakeOptionNone: return "MakeOptionNone";
+        case Opcode::MakeResultOk: return "MakeResultOk";
+        case Opcode::MakeResultErr: return "MakeResultErr";
+        case Opcode::OptionIsSome: return "OptionIsSome";
+        case Opcode::OptionUnwrap: return "OptionUnwrap";
+        case Opcode::ResultIsOk: return "ResultIsOk";
+        case Opcode::ResultUnwrapOk: return "ResultUnwrapOk";
+        case Opcode::ResultUnwrapErr: return "ResultUnwrapErr";
+        case Opcode::MakeEnumVariant: return "MakeEnumVariant";
+        case Opcode::MakeEnumVariantPayload: return "MakeEnumVariantPayload";
+        case Opcode::EnumIsVariant: return "EnumIsVariant";
+        case Opcode::EnumUnwrapPayload: return "EnumUnwrapPayload";
+        case Opcode::Nop: return "Nop";
+        case Opcode::Halt: return "Halt";
+        case Opcode::Trap: return "Trap";
+        case Opcode::WeightsLoad: return "WeightsLoad";
+        default: break;
+    }
+    return {};
+}
+
 struct EncodedInstruction {
-    std::string opcode;
+    t81::tisc::Opcode opcode = t81::tisc::Opcode::Nop;
     std::int64_t a = 0;
     std::int64_t b = 0;
     std::int64_t c = 0;
+    // Carried into tisc-bin-v1 only; tisc-json-v1 has no literal pools and
+    // no argument count.
+    t81::tisc::LiteralKind literal_kind = t81::tisc::LiteralKind::Int;
+    const std::string* text_literal = nullptr;
+    std::int64_t call_arguments = 0;
 };
 
 std::optional<std::vector<EncodedInstruction>> encode_program(const t81::tisc::ir::IntermediateProgram& program) {
@@ -397,18 +956,28 @@ std::optional<std::vector<EncodedInstruction>> encode_program(const t81::tisc::i
         if (instr.opcode == Opcode::LABEL) {
             continue;
         }
-        if (instr.operands.size() > 3) {
+        // A lowered CALL names up to six argument registers; the encoded
+        // record keeps the callee and the first two, plus the count.
+        if (instr.opcode != Opcode::CALL && instr.operands.size() > 3) {
             std::cerr << "error: opcode carries more than 3 operands; not encodable in tisc-json-v1\n";
             return std::nullopt;
         }
-        auto opcode_name = map_opcode_name(instr.opcode);
-        if (!opcode_name.has_value()) {
+        auto opcode = map_opcode(instr.opcode);
+        if (!opcode.has_value()) {
             std::cerr << "error: unsupported opcode in bytecode emitter\n";
             return std::nullopt;
         }
 
         EncodedInstruction encoded;
-        encoded.opcode = *opcode_name;
+        encoded.opcode = *opcode;
+        encoded.literal_kind = instr.literal_kind;
+        if (instr.text_literal.has_value()) {
+            encoded.text_literal = &*instr.text_literal;
+        }
+        if (instr.opcode == Opcode::CALL) {
+            encoded.call_arguments =
+                static_cast<std::int64_t>(instr.operands.size() - 1 + instr.stack_arguments);
+        }
 
         if ((instr.opcode == Opcode::JZ ||
              instr.opcode == Opcode::JNZ ||
@@ -443,37 +1012,114 @@ std::optional<std::vector<EncodedInstruction>> encode_program(const t81::tisc::i
     }
 
     if (out.empty()) {
-        out.push_back({"Halt", 0, 0, 0});
+        out.push_back({t81::tisc::Opcode::Halt, 0, 0, 0});
     }
 
     return out;
 }
 
-std::string render_tisc_json(const std::vector<EncodedInstruction>& instructions) {
-    std::ostringstream out;
-    out << "{\n";
-    out << "  \"format_version\": \"tisc-json-v1\",\n";
-    out << "  \"axion_policy_text\": \"(policy (tier 1))\",\n";
-    out << "  \"insns\": [\n";
+constexpr std::string_view kAxionPolicyText = "(policy (tier 1))";
+
+// runtime-contract-v0.5 reads a Call's arguments from b and c only, so
+// tisc-json-v1 cannot pass more than two; tisc-bin-v1 carries the count.
+bool fits_tisc_json(const std::vector<EncodedInstruction>& instructions) {
+    for (const auto& insn : instructions) {
+        if (insn.opcode == t81::tisc::Opcode::Call && insn.call_arguments > 2) {
+            std::cerr << "error: call passes more than 2 arguments; tisc-json-v1 (runtime-contract-v0.5) "
+                         "encodes at most 2, use --format=bin\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Streams tisc-json-v1 to `path` through a fixed-size buffer, so memory use
+// does not depend on the number of instructions.
+bool write_tisc_json(const std::vector<EncodedInstruction>& instructions, const std::filesystem::path& path) {
+    t81::BlockWriter out(path);
+    if (!out.is_open()) {
+        return false;
+    }
+    out.write("{\n");
+    out.write("  \"format_version\": \"tisc-json-v1\",\n");
+    out.write("  \"axion_policy_text\": \"").write(kAxionPolicyText).write("\",\n");
+    out.write("  \"insns\": [\n");
     for (size_t i = 0; i < instructions.size(); ++i) {
         const auto& insn = instructions[i];
-        out << "    {\"opcode\": \"" << insn.opcode << "\", \"a\": " << insn.a
-            << ", \"b\": " << insn.b << ", \"c\": " << insn.c << "}";
+        out.write("    {\"opcode\": \"").write(opcode_name(insn.opcode)).write("\", \"a\": ").write(insn.a)
+            .write(", \"b\": ").write(insn.b).write(", \"c\": ").write(insn.c).write("}");
         if (i + 1 != instructions.size()) {
-            out << ",";
+            out.write(",");
+        }
+        out.write("\n");
+    }
+    out.write("  ]\n");
+    out.write("}\n");
+    return out.close();
+}
+
+// Renders tisc-bin-v1. Unlike the JSON form it keeps the literal pools:
+// text literals are interned into the symbol pool, and an instruction that
+// carries one gets its 1-based handle in `b`, as tensor handles already do.
+// A Call keeps the callee in `a` and gets its argument count in `b`.
+std::optional<std::string> render_tisc_bin(const std::vector<EncodedInstruction>& instructions,
+                                           const t81::tisc::ir::IntermediateProgram& ir) {
+    t81::tisc::Program program;
+    program.insns.reserve(instructions.size());
+    std::unordered_map<std::string_view, std::int64_t> symbol_handles;
+    for (const auto& encoded : instructions) {
+        const auto fits = [](std::int64_t value) {
+            return value >= std::numeric_limits<std::int32_t>::min() &&
+                   value <= std::numeric_limits<std::int32_t>::max();
+        };
+        if (!fits(encoded.a) || !fits(encoded.c)) {
+            std::cerr << "error: operand does not fit a 32-bit tisc-bin-v1 field\n";
+            return std::nullopt;
+        }
+        t81::tisc::Insn insn;
+        insn.opcode = encoded.opcode;
+        insn.a = static_cast<std::int32_t>(encoded.a);
+        insn.b = encoded.b;
+        insn.c = static_cast<std::int32_t>(encoded.c);
+        insn.literal_kind = encoded.literal_kind;
+        if (encoded.opcode == t81::tisc::Opcode::Call) {
+            insn.b = encoded.call_arguments;
+            insn.c = 0;
         }
-        out << "\n";
+        if (encoded.text_literal) {
+            auto [it, inserted] = symbol_handles.try_emplace(*encoded.text_literal, 0);
+            if (inserted) {
+                program.symbol_pool.push_back(*encoded.text_literal);
+                it->second = static_cast<std::int64_t>(program.symbol_pool.size());
+            }
+            insn.b = it->second;
+        }
+        program.insns.push_back(insn);
+    }
+    program.tensor_pool = ir.tensor_pool();
+    program.type_aliases = ir.type_aliases();
+    return t81::tisc::encode_binary(program, kAxionPolicyText);
+}
+
+enum class BytecodeFormat { Json, Binary };
+
+// Optimized artifacts are cached next to the -O0 one under their own kind;
+// -O0 keeps the plain kind so existing cache entries stay valid.
+std::string cache_kind(BytecodeFormat format, t81::tisc::ir::OptLevel level) {
+    std::string kind = format == BytecodeFormat::Json ? "tisc.json" : "tisc.bin";
+    if (level != t81::tisc::ir::OptLevel::O0) {
+        kind.insert(0, std::string(t81::tisc::ir::opt_level_name(level)) + ".");
     }
-    out << "  ]\n";
-    out << "}\n";
-    return out.str();
+    return kind;
 }
 
-int run_emit_ir(const std::string& path, const std::optional<std::string>& output_path) {
-    if (run_check(path) != 0) {
+int run_emit_ir(const std::string& path, const std::optional<std::string>& output_path,
+                const CodegenOptions& options) {
+    const auto session = run_frontend(path);
+    if (!session.has_value()) {
         return 1;
     }
-    auto program = compile_entry_to_ir(path);
+    const auto program = compile_entry_to_ir(*session, options);
     if (!program.has_value()) {
         return 1;
     }
@@ -493,22 +1139,61 @@ int run_emit_ir(const std::string& path, const std::optional<std::string>& outpu
     return 0;
 }
 
-int run_emit_bytecode(const std::string& path, const std::string& output_path) {
-    if (run_check(path) != 0) {
-        return 1;
+// Lowers the entry and writes its bytecode to `output_path`. The artifact
+// goes straight to disk; with a cache it is then copied into the cache, and
+// a cache hit is copied back out, so it is never held in memory whole.
+bool emit_entry(CompilationSession& session, BytecodeFormat format, const CodegenOptions& options,
+                const std::string& output_path) {
+    ModuleUnit& entry = session.units.at(session.entry_key);
+    const std::string kind = cache_kind(format, options.level);
+    if (session.cache) {
+        if (!options.wants_pass_output() && session.cache->copy_out(entry.cache_key, kind, output_path)) {
+            return true;
+        }
+        // The check result was cached but the bytecode was not: analyze the
+        // entry now, since IR generation needs the analyzer's side tables.
+        if (!entry.analyzer && !analyze_module(session, session.entry_key, entry)) {
+            return false;
+        }
     }
-    auto program = compile_entry_to_ir(path);
+
+    const auto program = compile_entry_to_ir(session, options);
     if (!program.has_value()) {
-        return 1;
+        return false;
     }
-
     auto encoded = encode_program(*program);
     if (!encoded.has_value()) {
-        return 1;
+        return false;
+    }
+    bool written = false;
+    if (format == BytecodeFormat::Json) {
+        if (!fits_tisc_json(*encoded)) {
+            return false;
+        }
+        written = write_tisc_json(*encoded, output_path);
+    } else {
+        auto bytecode = render_tisc_bin(*encoded, *program);
+        if (!bytecode.has_value()) {
+            return false;
+        }
+        written = write_file(output_path, *bytecode);
     }
-    const std::string json = render_tisc_json(*encoded);
-    if (!write_file(output_path, json)) {
+    if (!written) {
         std::cerr << "error: unable to write output file: " << output_path << "\n";
+        return false;
+    }
+    if (session.cache) {
+        session.cache->copy_in(entry.cache_key, kind, output_path);
+    }
+    return true;
+}
+
+int run_emit_bytecode(const std::string& path, const std::string& output_path, BytecodeFormat format,
+                      const CodegenOptions& options, bool use_cache) {
+    std::optional<std::filesystem::path> build_dir;
+    if (use_cache) build_dir = std::filesystem::absolute(output_path).parent_path();
+    auto session = run_frontend(path, build_dir);
+    if (!session.has_value() || !emit_entry(*session, format, options, output_path)) {
         return 1;
     }
     std::cout << output_path << "\n";
@@ -538,37 +1223,41 @@ int main(int argc, char** argv) {
         }
         return run_check(argv[2]);
     }
-    if (command == "emit-ir") {
-        if (argc != 3 && argc != 5) {
-            print_usage(std::cerr);
-            return kUsageExitCode;
-        }
-        auto output_path = parse_optional_output_path(argc, argv, 3);
-        if (argc == 5 && (!output_path.has_value() || output_path->empty())) {
+    if (command == "emit-ir" || command == "emit-bytecode" || command == "build") {
+        if (argc < 3) {
             print_usage(std::cerr);
             return kUsageExitCode;
         }
-        return run_emit_ir(argv[2], output_path);
-    }
-    if (command == "emit-bytecode" || command == "build") {
-        if (argc != 3 && argc != 5) {
-            print_usage(std::cerr);
-            return kUsageExitCode;
+        const bool emits_bytecode = command != "emit-ir";
+        std::optional<std::string> output_path;
+        BytecodeFormat format = BytecodeFormat::Json;
+        CodegenOptions options;
+        for (int i = 3; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            bool option_ok = true;
+            if (arg == "-o" && i + 1 < argc && !output_path.has_value() && *argv[i + 1] != '\0') {
+                output_path = argv[++i];
+            } else if (emits_bytecode && arg == "--format=json") {
+                format = BytecodeFormat::Json;
+            } else if (emits_bytecode && arg == "--format=bin") {
+                format = BytecodeFormat::Binary;
+            } else if (!parse_codegen_option(arg, options, option_ok) || !option_ok) {
+                print_usage(std::cerr);
+                return kUsageExitCode;
+            }
         }
-        auto output_path = parse_optional_output_path(argc, argv, 3);
-        if (argc == 5 && (!output_path.has_value() || output_path->empty())) {
-            print_usage(std::cerr);
-            return kUsageExitCode;
+        if (!emits_bytecode) {
+            return run_emit_ir(argv[2], output_path, options);
         }
 
         std::filesystem::path out;
-        if (output_path.has_value() && !output_path->empty()) {
+        if (output_path.has_value()) {
             out = *output_path;
         } else {
             out = std::filesystem::path(argv[2]);
-            out.replace_extension(".tisc.json");
+            out.replace_extension(format == BytecodeFormat::Json ? ".tisc.json" : ".tisc.bin");
         }
-        return run_emit_bytecode(argv[2], out.string());
+        return run_emit_bytecode(argv[2], out.string(), format, options, command == "build");
     }
 
     std::cerr << "error: unknown command: " << command << "\n";
@@ -3,38 +3,38 @@
 namespace t81::frontend {
 
 std::string CanonicalAstPrinter::print(const Stmt& stmt) {
-    return std::any_cast<std::string>(stmt.accept(*this));
+    return visit_stmt(stmt);
 }
 
 std::string CanonicalAstPrinter::print(const Expr& expr) {
-    return std::any_cast<std::string>(expr.accept(*this));
+    return visit_expr(expr);
 }
 
-std::any CanonicalAstPrinter::visit(const ExpressionStmt& stmt) {
-    return parenthesize(";", {&stmt.expression});
+std::string CanonicalAstPrinter::visit(const ExpressionStmt& stmt) {
+    return parenthesize(";", {stmt.expression.get()});
 }
 
-std::any CanonicalAstPrinter::visit(const VarStmt& stmt) {
+std::string CanonicalAstPrinter::visit(const VarStmt& stmt) {
     std::string name = "var " + std::string(stmt.name.lexeme);
     if (stmt.type) {
         name += ": " + print(*stmt.type);
     }
     if (stmt.initializer) {
-        return parenthesize(name, {&stmt.initializer});
+        return parenthesize(name, {stmt.initializer.get()});
     }
     return std::string("(" + name + ")");
 }
 
-std::any CanonicalAstPrinter::visit(const LetStmt& stmt) {
+std::string CanonicalAstPrinter::visit(const LetStmt& stmt) {
     std::string name = "let " + std::string(stmt.name.lexeme);
     if (stmt.type) {
         name += ": " + print(*stmt.type);
     }
     name += " =";
-    return parenthesize(name, {&stmt.initializer});
+    return parenthesize(name, {stmt.initializer.get()});
 }
 
-std::any CanonicalAstPrinter::visit(const BlockStmt& stmt) {
+std::string CanonicalAstPrinter::visit(const BlockStmt& stmt) {
     std::stringstream ss;
     ss << "(block";
     for (const auto& statement : stmt.statements) {
@@ -44,18 +44,18 @@ std::any CanonicalAstPrinter::visit(const BlockStmt& stmt) {
     return ss.str();
 }
 
-std::any CanonicalAstPrinter::visit(const IfStmt& stmt) {
+std::string CanonicalAstPrinter::visit(const IfStmt& stmt) {
     if (stmt.else_branch) {
-        return parenthesize("if-else", {&stmt.condition, &stmt.then_branch, &stmt.else_branch});
+        return parenthesize("if-else", {stmt.condition.get(), stmt.then_branch.get(), stmt.else_branch.get()});
     }
-    return parenthesize("if", {&stmt.condition, &stmt.then_branch});
+    return parenthesize("if", {stmt.condition.get(), stmt.then_branch.get()});
 }
 
-std::any CanonicalAstPrinter::visit(const WhileStmt& stmt) {
-    return parenthesize("while", {&stmt.condition, &stmt.body});
+std::string CanonicalAstPrinter::visit(const WhileStmt& stmt) {
+    return parenthesize("while", {stmt.condition.get(), stmt.body.get()});
 }
 
-std::any CanonicalAstPrinter::visit(const LoopStmt& stmt) {
+std::string CanonicalAstPrinter::visit(const LoopStmt& stmt) {
     std::stringstream ss;
     ss << "(loop";
     if (stmt.bound_kind == LoopStmt::BoundKind::Infinite) {
@@ -71,27 +71,30 @@ std::any CanonicalAstPrinter::visit(const LoopStmt& stmt) {
     return ss.str();
 }
 
-std::any CanonicalAstPrinter::visit(const ReturnStmt& stmt) {
+std::string CanonicalAstPrinter::visit(const ReturnStmt& stmt) {
     if (stmt.value) {
-        return parenthesize("return", {&stmt.value});
+        return parenthesize("return", {stmt.value.get()});
     }
     return std::string("(return)");
 }
 
-std::any CanonicalAstPrinter::visit(const BreakStmt&) {
+std::string CanonicalAstPrinter::visit(const BreakStmt&) {
     return std::string("(break)");
 }
 
-std::any CanonicalAstPrinter::visit(const ContinueStmt&) {
+std::string CanonicalAstPrinter::visit(const ContinueStmt&) {
     return std::string("(continue)");
 }
 
-std::any CanonicalAstPrinter::visit(const FunctionStmt& stmt) {
+std::string CanonicalAstPrinter::visit(const FunctionStmt& stmt) {
     std::stringstream ss;
     ss << "(fn";
     if (stmt.attributes.is_effectful) {
         ss << " @effect";
     }
+    if (stmt.attributes.is_tailrec) {
+        ss << " @tailrec";
+    }
     if (stmt.attributes.tier.has_value()) {
         ss << " @tier(" << *stmt.attributes.tier << ")";
     }
@@ -117,15 +120,15 @@ std::any CanonicalAstPrinter::visit(const FunctionStmt& stmt) {
     return ss.str();
 }
 
-std::any CanonicalAstPrinter::visit(const ModuleDecl& stmt) {
-    return std::string("(module " + stmt.path + ")");
+std::string CanonicalAstPrinter::visit(const ModuleDecl& stmt) {
+    return "(module " + std::string(stmt.path) + ")";
 }
 
-std::any CanonicalAstPrinter::visit(const ImportDecl& stmt) {
-    return std::string("(import " + stmt.path + ")");
+std::string CanonicalAstPrinter::visit(const ImportDecl& stmt) {
+    return "(import " + std::string(stmt.path) + ")";
 }
 
-std::any CanonicalAstPrinter::visit(const TypeDecl& stmt) {
+std::string CanonicalAstPrinter::visit(const TypeDecl& stmt) {
     std::stringstream ss;
     ss << "(type " << stmt.name.lexeme << " [";
     for (size_t i = 0; i < stmt.params.size(); ++i) {
@@ -139,7 +142,7 @@ std::any CanonicalAstPrinter::visit(const TypeDecl& stmt) {
     return ss.str();
 }
 
-std::any CanonicalAstPrinter::visit(const RecordDecl& stmt) {
+std::string CanonicalAstPrinter::visit(const RecordDecl& stmt) {
     std::stringstream ss;
     ss << "(record " << stmt.name.lexeme;
     for (const auto& field : stmt.fields) {
@@ -154,7 +157,7 @@ std::any CanonicalAstPrinter::visit(const RecordDecl& stmt) {
     return ss.str();
 }
 
-std::any CanonicalAstPrinter::visit(const EnumDecl& stmt) {
+std::string CanonicalAstPrinter::visit(const EnumDecl& stmt) {
     std::stringstream ss;
     ss << "(enum " << stmt.name.lexeme;
     for (const auto& variant : stmt.variants) {
@@ -167,40 +170,40 @@ std::any CanonicalAstPrinter::visit(const EnumDecl& stmt) {
     return ss.str();
 }
 
-std::any CanonicalAstPrinter::visit(const BinaryExpr& expr) {
-    return parenthesize(expr.op.lexeme, {std::any(&expr.left), std::any(&expr.right)});
+std::string CanonicalAstPrinter::visit(const BinaryExpr& expr) {
+    return parenthesize(expr.op.lexeme, {expr.left.get(), expr.right.get()});
 }
 
-std::any CanonicalAstPrinter::visit(const UnaryExpr& expr) {
-    return parenthesize(expr.op.lexeme, {&expr.right});
+std::string CanonicalAstPrinter::visit(const UnaryExpr& expr) {
+    return parenthesize(expr.op.lexeme, {expr.right.get()});
 }
 
-std::any CanonicalAstPrinter::visit(const LiteralExpr& expr) {
+std::string CanonicalAstPrinter::visit(const LiteralExpr& expr) {
     return std::string(expr.value.lexeme);
 }
 
-std::any CanonicalAstPrinter::visit(const GroupingExpr& expr) {
-    return parenthesize("group", {&expr.expression});
+std::string CanonicalAstPrinter::visit(const GroupingExpr& expr) {
+    return parenthesize("group", {expr.expression.get()});
 }
 
-std::any CanonicalAstPrinter::visit(const VariableExpr& expr) {
+std::string CanonicalAstPrinter::visit(const VariableExpr& expr) {
     return std::string(expr.name.lexeme);
 }
 
-std::any CanonicalAstPrinter::visit(const CallExpr& expr) {
-    std::vector<std::any> parts;
-    parts.push_back(&expr.callee);
+std::string CanonicalAstPrinter::visit(const CallExpr& expr) {
+    std::vector<const Expr*> parts;
+    parts.push_back(expr.callee.get());
     for (const auto& arg : expr.arguments) {
-        parts.push_back(&arg);
+        parts.push_back(arg.get());
     }
     return parenthesize("call", parts);
 }
 
-std::any CanonicalAstPrinter::visit(const AssignExpr& expr) {
-    return parenthesize("= " + std::string(expr.name.lexeme), {&expr.value});
+std::string CanonicalAstPrinter::visit(const AssignExpr& expr) {
+    return parenthesize("= " + std::string(expr.name.lexeme), {expr.value.get()});
 }
 
-std::any CanonicalAstPrinter::visit(const MatchExpr& expr) {
+std::string CanonicalAstPrinter::visit(const MatchExpr& expr) {
     std::stringstream ss;
     ss << "(match " << print(*expr.scrutinee);
     for (const auto& arm : expr.arms) {
@@ -240,7 +243,7 @@ std::any CanonicalAstPrinter::visit(const MatchExpr& expr) {
     return ss.str();
 }
 
-std::any CanonicalAstPrinter::visit(const VectorLiteralExpr& expr) {
+std::string CanonicalAstPrinter::visit(const VectorLiteralExpr& expr) {
     std::stringstream ss;
     ss << "[";
     for (size_t i = 0; i < expr.elements.size(); ++i) {
@@ -253,12 +256,12 @@ std::any CanonicalAstPrinter::visit(const VectorLiteralExpr& expr) {
     return ss.str();
 }
 
-std::any CanonicalAstPrinter::visit(const FieldAccessExpr& expr) {
+std::string CanonicalAstPrinter::visit(const FieldAccessExpr& expr) {
     return parenthesize("field " + std::string(expr.field.lexeme),
                         std::vector<const Expr*>{expr.object.get()});
 }
 
-std::any CanonicalAstPrinter::visit(const RecordLiteralExpr& expr) {
+std::string CanonicalAstPrinter::visit(const RecordLiteralExpr& expr) {
     std::stringstream ss;
     ss << "(recordlit " << expr.type_name.lexeme;
     for (const auto& field : expr.fields) {
@@ -271,7 +274,7 @@ std::any CanonicalAstPrinter::visit(const RecordLiteralExpr& expr) {
     return ss.str();
 }
 
-std::any CanonicalAstPrinter::visit(const EnumLiteralExpr& expr) {
+std::string CanonicalAstPrinter::visit(const EnumLiteralExpr& expr) {
     std::stringstream ss;
     ss << "(enumlit " << expr.enum_name.lexeme << "." << expr.variant.lexeme;
     if (expr.payload) {
@@ -281,11 +284,11 @@ std::any CanonicalAstPrinter::visit(const EnumLiteralExpr& expr) {
     return ss.str();
 }
 
-std::any CanonicalAstPrinter::visit(const SimpleTypeExpr& expr) {
+std::string CanonicalAstPrinter::visit(const SimpleTypeExpr& expr) {
     return std::string(expr.name.lexeme);
 }
 
-std::any CanonicalAstPrinter::visit(const GenericTypeExpr& expr) {
+std::string CanonicalAstPrinter::visit(const GenericTypeExpr& expr) {
     std::vector<const Expr*> params;
     for (size_t i = 0; i < expr.param_count; ++i) {
         params.push_back(expr.params[i].get());
@@ -303,15 +306,15 @@ std::string CanonicalAstPrinter::parenthesize(std::string_view name, const std::
     return ss.str();
 }
 
-std::string CanonicalAstPrinter::parenthesize(std::string_view name, const std::vector<std::any>& parts) {
+std::string CanonicalAstPrinter::parenthesize(std::string_view name, std::initializer_list<Part> parts) {
     std::stringstream ss;
     ss << "(" << name;
     for (const auto& part : parts) {
         ss << " ";
-        if (part.type() == typeid(const std::unique_ptr<Expr>*)) {
-            ss << print(**std::any_cast<const std::unique_ptr<Expr>*>(part));
-        } else if (part.type() == typeid(const std::unique_ptr<Stmt>*)) {
-            ss << print(**std::any_cast<const std::unique_ptr<Stmt>*>(part));
+        if (const auto* expr = std::get_if<const Expr*>(&part)) {
+            ss << print(**expr);
+        } else {
+            ss << print(*std::get<const Stmt*>(part));
         }
     }
     ss << ")";
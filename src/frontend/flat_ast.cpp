@@ -0,0 +1,262 @@
+#include "t81/frontend/flat_ast.hpp"
+
+#include <variant>
+
+namespace t81::frontend {
+
+namespace {
+
+// Walks the pointer tree once, recording each node and the contiguous id
+// range of its direct children before descending into them.
+class FlatAstLowering final : public ExprVisitorT<FlatAstLowering, void>,
+                              public StmtVisitorT<FlatAstLowering, void> {
+public:
+    explicit FlatAstLowering(FlatAst& out) : _out(out) {}
+
+    void root(const Stmt& stmt) {
+        _out.roots.push_back(stmt.id);
+        record(stmt.id, NodeFamily::Stmt, static_cast<std::uint8_t>(stmt.kind), kInvalidNodeId);
+        visit_stmt(stmt);
+    }
+
+    void visit(const BinaryExpr& expr) {
+        const std::size_t mark = open();
+        child(expr.left.get());
+        child(expr.right.get());
+        close(expr.id, mark, &expr.op);
+    }
+
+    void visit(const UnaryExpr& expr) {
+        const std::size_t mark = open();
+        child(expr.right.get());
+        close(expr.id, mark, &expr.op);
+    }
+
+    void visit(const LiteralExpr& expr) { close(expr.id, open(), &expr.value); }
+
+    void visit(const GroupingExpr& expr) {
+        const std::size_t mark = open();
+        child(expr.expression.get());
+        close(expr.id, mark);
+    }
+
+    void visit(const VariableExpr& expr) { close(expr.id, open(), &expr.name); }
+
+    void visit(const CallExpr& expr) {
+        const std::size_t mark = open();
+        child(expr.callee.get());
+        for (const auto& argument : expr.arguments) child(argument.get());
+        close(expr.id, mark, &expr.paren);
+    }
+
+    void visit(const AssignExpr& expr) {
+        const std::size_t mark = open();
+        child(expr.value.get());
+        close(expr.id, mark, &expr.name);
+    }
+
+    void visit(const MatchExpr& expr) {
+        const std::size_t mark = open();
+        child(expr.scrutinee.get());
+        for (const auto& arm : expr.arms) {
+            child(arm.guard.get());
+            child(arm.expression.get());
+        }
+        close(expr.id, mark);
+    }
+
+    void visit(const VectorLiteralExpr& expr) {
+        const std::size_t mark = open();
+        for (const auto& element : expr.elements) child(element.get());
+        close(expr.id, mark, &expr.token);
+    }
+
+    void visit(const FieldAccessExpr& expr) {
+        const std::size_t mark = open();
+        child(expr.object.get());
+        close(expr.id, mark, &expr.field);
+    }
+
+    void visit(const RecordLiteralExpr& expr) {
+        const std::size_t mark = open();
+        for (const auto& field : expr.fields) child(field.second.get());
+        close(expr.id, mark, &expr.type_name);
+    }
+
+    void visit(const EnumLiteralExpr& expr) {
+        const std::size_t mark = open();
+        child(expr.payload.get());
+        close(expr.id, mark, &expr.variant);
+    }
+
+    void visit(const SimpleTypeExpr& expr) { close(expr.id, open(), &expr.name); }
+
+    void visit(const GenericTypeExpr& expr) {
+        const std::size_t mark = open();
+        for (std::size_t i = 0; i < expr.param_count; ++i) child(expr.params[i].get());
+        close(expr.id, mark, &expr.name);
+    }
+
+    void visit(const ExpressionStmt& stmt) {
+        const std::size_t mark = open();
+        child(stmt.expression.get());
+        close(stmt.id, mark);
+    }
+
+    void visit(const VarStmt& stmt) {
+        const std::size_t mark = open();
+        child(stmt.type.get());
+        child(stmt.initializer.get());
+        close(stmt.id, mark, &stmt.name);
+    }
+
+    void visit(const LetStmt& stmt) {
+        const std::size_t mark = open();
+        child(stmt.type.get());
+        child(stmt.initializer.get());
+        close(stmt.id, mark, &stmt.name);
+    }
+
+    void visit(const BlockStmt& stmt) {
+        const std::size_t mark = open();
+        for (const auto& statement : stmt.statements) child(statement.get());
+        close(stmt.id, mark);
+    }
+
+    void visit(const IfStmt& stmt) {
+        const std::size_t mark = open();
+        child(stmt.condition.get());
+        child(stmt.then_branch.get());
+        child(stmt.else_branch.get());
+        close(stmt.id, mark);
+    }
+
+    void visit(const WhileStmt& stmt) {
+        const std::size_t mark = open();
+        child(stmt.condition.get());
+        child(stmt.body.get());
+        close(stmt.id, mark);
+    }
+
+    void visit(const LoopStmt& stmt) {
+        const std::size_t mark = open();
+        child(stmt.guard_expression.get());
+        for (const auto& statement : stmt.body) child(statement.get());
+        close(stmt.id, mark, &stmt.keyword);
+    }
+
+    void visit(const ReturnStmt& stmt) {
+        const std::size_t mark = open();
+        child(stmt.value.get());
+        close(stmt.id, mark, &stmt.keyword);
+    }
+
+    void visit(const BreakStmt& stmt) { close(stmt.id, open(), &stmt.keyword); }
+    void visit(const ContinueStmt& stmt) { close(stmt.id, open(), &stmt.keyword); }
+
+    void visit(const FunctionStmt& stmt) {
+        const std::size_t mark = open();
+        for (const auto& param : stmt.params) child(param.type.get());
+        child(stmt.return_type.get());
+        for (const auto& statement : stmt.body) child(statement.get());
+        close(stmt.id, mark, &stmt.name);
+    }
+
+    void visit(const ModuleDecl& stmt) { close(stmt.id, open(), &stmt.keyword); }
+    void visit(const ImportDecl& stmt) { close(stmt.id, open(), &stmt.keyword); }
+
+    void visit(const TypeDecl& stmt) {
+        const std::size_t mark = open();
+        child(stmt.alias.get());
+        close(stmt.id, mark, &stmt.name);
+    }
+
+    void visit(const RecordDecl& stmt) {
+        const std::size_t mark = open();
+        for (const auto& field : stmt.fields) child(field.type.get());
+        close(stmt.id, mark, &stmt.name);
+    }
+
+    void visit(const EnumDecl& stmt) {
+        const std::size_t mark = open();
+        for (const auto& variant : stmt.variants) child(variant.payload.get());
+        close(stmt.id, mark, &stmt.name);
+    }
+
+private:
+    using Child = std::variant<const Expr*, const Stmt*>;
+
+    // The node being visited was already recorded by its parent; `open`
+    // marks where its children start in the shared scratch stack.
+    std::size_t open() const { return _scratch.size(); }
+
+    void child(const Expr* expr) {
+        if (expr) _scratch.push_back(expr);
+    }
+
+    void child(const Stmt* stmt) {
+        if (stmt) _scratch.push_back(stmt);
+    }
+
+    // Emits the children collected since `mark` as one contiguous range,
+    // then descends into each of them in order.
+    void close(NodeId id, std::size_t mark, const Token* anchor = nullptr) {
+        if (anchor) {
+            _out.lines[id] = anchor->line;
+            _out.columns[id] = anchor->column;
+        }
+        _out.child_begin[id] = static_cast<std::uint32_t>(_out.children.size());
+        _out.child_count[id] = static_cast<std::uint32_t>(_scratch.size() - mark);
+        for (std::size_t i = mark; i < _scratch.size(); ++i) {
+            if (const auto* expr = std::get_if<const Expr*>(&_scratch[i])) {
+                _out.children.push_back((*expr)->id);
+                record((*expr)->id, NodeFamily::Expr, static_cast<std::uint8_t>((*expr)->kind), id);
+            } else {
+                const Stmt* stmt = std::get<const Stmt*>(_scratch[i]);
+                _out.children.push_back(stmt->id);
+                record(stmt->id, NodeFamily::Stmt, static_cast<std::uint8_t>(stmt->kind), id);
+            }
+        }
+        for (std::size_t i = mark; i < _scratch.size(); ++i) {
+            const Child next = _scratch[i];
+            if (const auto* expr = std::get_if<const Expr*>(&next)) {
+                visit_expr(**expr);
+            } else {
+                visit_stmt(*std::get<const Stmt*>(next));
+            }
+        }
+        _scratch.resize(mark);
+    }
+
+    void record(NodeId id, NodeFamily family, std::uint8_t kind, NodeId parent) {
+        _out.families[id] = family;
+        _out.kinds[id] = kind;
+        _out.parents[id] = parent;
+    }
+
+    FlatAst& _out;
+    std::vector<Child> _scratch;
+};
+
+} // namespace
+
+FlatAst FlatAst::lower(const SyntaxTree& tree) {
+    FlatAst flat;
+    const std::size_t count = tree.node_count;
+    flat.families.assign(count, NodeFamily::None);
+    flat.kinds.assign(count, 0);
+    flat.parents.assign(count, kInvalidNodeId);
+    flat.child_begin.assign(count, 0);
+    flat.child_count.assign(count, 0);
+    flat.lines.assign(count, 0);
+    flat.columns.assign(count, 0);
+    flat.children.reserve(count);
+
+    FlatAstLowering lowering(flat);
+    for (const auto& stmt : tree) {
+        if (stmt) lowering.root(*stmt);
+    }
+    return flat;
+}
+
+} // namespace t81::frontend
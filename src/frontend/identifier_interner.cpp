@@ -0,0 +1,46 @@
+#include "t81/frontend/identifier_interner.hpp"
+
+#include <mutex>
+
+namespace t81::frontend {
+
+IdentifierInterner& IdentifierInterner::global() {
+    static IdentifierInterner interner;
+    return interner;
+}
+
+IdentifierInterner::IdentifierInterner() {
+    _spellings.emplace_back();
+    _ids.emplace(std::string_view(_spellings.back()), kEmptySymbol);
+}
+
+SymbolId IdentifierInterner::intern(std::string_view text) {
+    {
+        std::shared_lock lock(_mutex);
+        if (auto it = _ids.find(text); it != _ids.end()) return it->second;
+    }
+    std::unique_lock lock(_mutex);
+    if (auto it = _ids.find(text); it != _ids.end()) return it->second;
+    const auto id = static_cast<SymbolId>(_spellings.size());
+    _spellings.emplace_back(text);
+    _ids.emplace(std::string_view(_spellings.back()), id);
+    return id;
+}
+
+std::optional<SymbolId> IdentifierInterner::find(std::string_view text) const {
+    std::shared_lock lock(_mutex);
+    if (auto it = _ids.find(text); it != _ids.end()) return it->second;
+    return std::nullopt;
+}
+
+std::string_view IdentifierInterner::spelling(SymbolId id) const {
+    std::shared_lock lock(_mutex);
+    return id < _spellings.size() ? std::string_view(_spellings[id]) : std::string_view{};
+}
+
+std::size_t IdentifierInterner::size() const {
+    std::shared_lock lock(_mutex);
+    return _spellings.size();
+}
+
+} // namespace t81::frontend
@@ -3,7 +3,19 @@
  * @brief Implements the Lexer for the T81Lang frontend.
  */
 #include "t81/frontend/lexer.hpp"
-#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define T81_LEXER_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define T81_LEXER_SIMD_SSE2 1
+#endif
 
 namespace t81 {
 namespace frontend {
@@ -24,7 +36,12 @@ inline std::string_view make_sv(It b, It e) noexcept {
 // Keywords
 // ─────────────────────────────────────────────────────────────────────────────
 namespace {
-const std::unordered_map<std::string_view, TokenType> KEYWORDS = {
+struct KeywordEntry {
+    std::string_view text;
+    TokenType type;
+};
+
+constexpr std::array<KeywordEntry, 39> KEYWORDS = {{
     {"module", TokenType::Module}, {"import", TokenType::Import}, {"type", TokenType::Type},
     {"const", TokenType::Const},
     {"export", TokenType::Export}, {"fn", TokenType::Fn},         {"let", TokenType::Let},
@@ -43,15 +60,182 @@ const std::unordered_map<std::string_view, TokenType> KEYWORDS = {
     {"T81Tensor", TokenType::Tensor}, {"T81Graph", TokenType::Graph},
     {"vector", TokenType::Vector}, {"matrix", TokenType::Matrix},
     {"tensor", TokenType::Tensor}, {"graph", TokenType::Graph},
-};
+}};
+
+// Perfect hash over KEYWORDS: FNV-1a with a seed chosen so that the top
+// KEYWORD_HASH_BITS bits are distinct for every keyword. If a keyword is
+// added and the static_assert below fires, search for a new seed.
+constexpr std::uint32_t KEYWORD_HASH_SEED = 2166136601u;
+constexpr unsigned KEYWORD_HASH_BITS = 7;
+constexpr std::size_t KEYWORD_SLOTS = std::size_t{1} << KEYWORD_HASH_BITS;
+constexpr std::uint8_t KEYWORD_EMPTY = 0xFF;
+
+constexpr std::size_t keyword_hash(std::string_view text) noexcept {
+    std::uint32_t h = KEYWORD_HASH_SEED;
+    for (char c : text) {
+        h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return h >> (32 - KEYWORD_HASH_BITS);
+}
+
+constexpr std::size_t keyword_max_length() noexcept {
+    std::size_t max_len = 0;
+    for (const auto& kw : KEYWORDS) max_len = std::max(max_len, kw.text.size());
+    return max_len;
+}
+
+constexpr std::size_t KEYWORD_MAX_LENGTH = keyword_max_length();
+
+constexpr std::array<std::uint8_t, KEYWORD_SLOTS> build_keyword_slots() noexcept {
+    std::array<std::uint8_t, KEYWORD_SLOTS> slots{};
+    for (auto& slot : slots) slot = KEYWORD_EMPTY;
+    for (std::size_t i = 0; i < KEYWORDS.size(); ++i) {
+        slots[keyword_hash(KEYWORDS[i].text)] = static_cast<std::uint8_t>(i);
+    }
+    return slots;
+}
+
+constexpr std::array<std::uint8_t, KEYWORD_SLOTS> KEYWORD_SLOT_TABLE = build_keyword_slots();
 
-bool is_alpha(char c) {
+constexpr bool keyword_hash_is_perfect() noexcept {
+    for (std::size_t i = 0; i < KEYWORDS.size(); ++i) {
+        if (KEYWORD_SLOT_TABLE[keyword_hash(KEYWORDS[i].text)] != i) return false;
+    }
+    return true;
+}
+
+static_assert(KEYWORDS.size() < KEYWORD_EMPTY, "keyword index must fit in a slot byte");
+static_assert(keyword_hash_is_perfect(), "keyword hash collides; pick a new KEYWORD_HASH_SEED");
+
+constexpr bool lookup_keyword(std::string_view text, TokenType& out) noexcept {
+    if (text.size() < 2 || text.size() > KEYWORD_MAX_LENGTH) return false;
+    const std::uint8_t index = KEYWORD_SLOT_TABLE[keyword_hash(text)];
+    if (index == KEYWORD_EMPTY || KEYWORDS[index].text != text) return false;
+    out = KEYWORDS[index].type;
+    return true;
+}
+
+static_assert([] {
+    TokenType t{};
+    return lookup_keyword("T81Tensor", t) && t == TokenType::Tensor &&
+           !lookup_keyword("T81Tensors", t) && !lookup_keyword("x", t);
+}());
+
+constexpr bool is_alpha(char c) {
     return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
 }
 
-bool is_digit(char c) {
+constexpr bool is_digit(char c) {
     return c >= '0' && c <= '9';
 }
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Run scanning
+//
+// Whitespace runs, comment bodies and identifier/digit runs are located a
+// whole vector at a time (32 bytes with AVX2, 16 with SSE2). Each vector is
+// reduced to a bitmask of bytes in the class, and the first clear bit marks
+// where the run ends. Any tail shorter than a vector falls back to the
+// scalar loop. Bytes >= 0x80 compare as negative under the signed compares,
+// so they never join an ASCII class.
+// ─────────────────────────────────────────────────────────────────────────────
+enum class CharClass { Blank, Ident, Digit };
+
+template<CharClass C>
+constexpr bool in_class(char c) noexcept {
+    if constexpr (C == CharClass::Blank) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    } else if constexpr (C == CharClass::Ident) {
+        return is_alpha(c) || is_digit(c);
+    } else {
+        return is_digit(c);
+    }
+}
+
+#if defined(T81_LEXER_SIMD_AVX2)
+struct SimdOps {
+    using Vec = __m256i;
+    static constexpr std::ptrdiff_t width = 32;
+    static constexpr std::uint32_t all_set = 0xFFFFFFFFu;
+    static Vec load(const char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static Vec splat(char c) { return _mm256_set1_epi8(c); }
+    static Vec eq(Vec a, Vec b) { return _mm256_cmpeq_epi8(a, b); }
+    static Vec gt(Vec a, Vec b) { return _mm256_cmpgt_epi8(a, b); }
+    static Vec bit_or(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+    static Vec bit_and(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+    static std::uint32_t mask(Vec v) { return static_cast<std::uint32_t>(_mm256_movemask_epi8(v)); }
+};
+#elif defined(T81_LEXER_SIMD_SSE2)
+struct SimdOps {
+    using Vec = __m128i;
+    static constexpr std::ptrdiff_t width = 16;
+    static constexpr std::uint32_t all_set = 0xFFFFu;
+    static Vec load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static Vec splat(char c) { return _mm_set1_epi8(c); }
+    static Vec eq(Vec a, Vec b) { return _mm_cmpeq_epi8(a, b); }
+    static Vec gt(Vec a, Vec b) { return _mm_cmpgt_epi8(a, b); }
+    static Vec bit_or(Vec a, Vec b) { return _mm_or_si128(a, b); }
+    static Vec bit_and(Vec a, Vec b) { return _mm_and_si128(a, b); }
+    static std::uint32_t mask(Vec v) { return static_cast<std::uint32_t>(_mm_movemask_epi8(v)); }
+};
+#endif
+
+#if defined(T81_LEXER_SIMD_AVX2) || defined(T81_LEXER_SIMD_SSE2)
+// lo <= v <= hi for ASCII bounds, using signed byte compares.
+inline SimdOps::Vec in_range(SimdOps::Vec v, char lo, char hi) {
+    return SimdOps::bit_and(SimdOps::gt(v, SimdOps::splat(static_cast<char>(lo - 1))),
+                            SimdOps::gt(SimdOps::splat(static_cast<char>(hi + 1)), v));
+}
+
+template<CharClass C>
+inline std::uint32_t class_mask(const char* p) {
+    const SimdOps::Vec v = SimdOps::load(p);
+    if constexpr (C == CharClass::Blank) {
+        return SimdOps::mask(SimdOps::bit_or(
+            SimdOps::bit_or(SimdOps::eq(v, SimdOps::splat(' ')), SimdOps::eq(v, SimdOps::splat('\t'))),
+            SimdOps::bit_or(SimdOps::eq(v, SimdOps::splat('\r')), SimdOps::eq(v, SimdOps::splat('\n')))));
+    } else if constexpr (C == CharClass::Ident) {
+        // Folding 0x20 maps A-Z onto a-z without pulling '@', '[' or '`' into range.
+        const SimdOps::Vec folded = SimdOps::bit_or(v, SimdOps::splat(0x20));
+        return SimdOps::mask(SimdOps::bit_or(
+            SimdOps::bit_or(in_range(folded, 'a', 'z'), in_range(v, '0', '9')),
+            SimdOps::eq(v, SimdOps::splat('_'))));
+    } else {
+        return SimdOps::mask(in_range(v, '0', '9'));
+    }
+}
+#endif
+
+/// Returns the first position in [p, end) whose byte is not in class C.
+template<CharClass C>
+inline const char* skip_run(const char* p, const char* end) noexcept {
+    // Most runs in real sources are one or two bytes; settle those without a vector load.
+    if (p == end || !in_class<C>(*p)) return p;
+    if (++p == end || !in_class<C>(*p)) return p;
+#if defined(T81_LEXER_SIMD_AVX2) || defined(T81_LEXER_SIMD_SSE2)
+    while (end - p >= SimdOps::width) {
+        const std::uint32_t m = class_mask<C>(p);
+        if (m != SimdOps::all_set) return p + std::countr_one(m);
+        p += SimdOps::width;
+    }
+#endif
+    while (p < end && in_class<C>(*p)) ++p;
+    return p;
+}
+
+/// Returns the first position in [p, end) holding `target`, or `end`.
+inline const char* find_byte(const char* p, const char* end, char target) noexcept {
+#if defined(T81_LEXER_SIMD_AVX2) || defined(T81_LEXER_SIMD_SSE2)
+    const SimdOps::Vec needle = SimdOps::splat(target);
+    while (end - p >= SimdOps::width) {
+        const std::uint32_t m = SimdOps::mask(SimdOps::eq(SimdOps::load(p), needle));
+        if (m != 0) return p + std::countr_zero(m);
+        p += SimdOps::width;
+    }
+#endif
+    while (p < end && *p != target) ++p;
+    return p;
+}
 } // anonymous namespace
 // ─────────────────────────────────────────────────────────────────────────────
 
@@ -63,6 +247,29 @@ Lexer::Lexer(std::string_view source)
       _line(1) {}
 
 Token Lexer::next_token() {
+    if (_lookahead_count > 0) {
+        Token token = _lookahead[_lookahead_head];
+        _lookahead_head = (_lookahead_head + 1) % kMaxLookahead;
+        --_lookahead_count;
+        return token;
+    }
+    return scan_token();
+}
+
+Token Lexer::peek_token(std::size_t distance) {
+    assert(distance < kMaxLookahead && "lookahead distance exceeds the ring buffer");
+    while (_lookahead_count <= distance) {
+        _lookahead[(_lookahead_head + _lookahead_count) % kMaxLookahead] = scan_token();
+        ++_lookahead_count;
+    }
+    return _lookahead[(_lookahead_head + distance) % kMaxLookahead];
+}
+
+Token Lexer::peek_next_token() {
+    return peek_token(0);
+}
+
+Token Lexer::scan_token() {
     skip_whitespace_and_comments();
     _token_start = _current;
 
@@ -135,12 +342,12 @@ bool Lexer::is_at_end() const {
 Token Lexer::make_token(TokenType type) {
     std::string_view lexeme = make_sv(_token_start, _current);
     int column = static_cast<int>(_token_start - _line_start) + 1;
-    return Token{type, lexeme, _line, column};
+    return Token{type, kEmptySymbol, lexeme, _line, column};
 }
 
 Token Lexer::error_token(const char* message) {
     int column = static_cast<int>(_token_start - _line_start) + 1;
-    return Token{TokenType::Illegal, message, _line, column};
+    return Token{TokenType::Illegal, kEmptySymbol, message, _line, column};
 }
 
 Token Lexer::string() {
@@ -159,11 +366,11 @@ Token Lexer::string() {
 }
 
 Token Lexer::number() {
-    while (is_digit(peek())) advance();
+    seek(skip_run<CharClass::Digit>(cursor_ptr(), end_ptr()));
 
     if (peek() == '.' && is_digit(peek_next())) {
         advance();
-        while (is_digit(peek())) advance();
+        seek(skip_run<CharClass::Digit>(cursor_ptr(), end_ptr()));
         return make_token(TokenType::Float);
     }
 
@@ -177,70 +384,75 @@ Token Lexer::number() {
 }
 
 Token Lexer::identifier() {
-    while (true) {
-        char next = peek();
-        if (is_alpha(next) || is_digit(next)) {
-            advance();
-            continue;
-        }
-        if (next == '.' && peek_next() != '.' && peek_next() != '\0' &&
-            (is_alpha(peek_next()) || is_digit(peek_next()))) {
-            advance();
+    const char* const end = end_ptr();
+    const char* p = cursor_ptr();
+    for (;;) {
+        p = skip_run<CharClass::Ident>(p, end);
+        // Dotted paths such as `Flag.On` lex as a single identifier.
+        if (end - p >= 2 && p[0] == '.' && in_class<CharClass::Ident>(p[1])) {
+            ++p;
             continue;
         }
         break;
     }
+    seek(p);
 
     std::string_view text = make_sv(_token_start, _current);
 
-    if (auto it = KEYWORDS.find(text); it != KEYWORDS.end()) {
-        return make_token(it->second);
+    if (TokenType keyword{}; lookup_keyword(text, keyword)) {
+        return make_token(keyword);
     }
-    return make_token(TokenType::Identifier);
+    Token token = make_token(TokenType::Identifier);
+    token.symbol = IdentifierInterner::global().intern(text);
+    return token;
 }
 
 void Lexer::skip_whitespace_and_comments() {
+    const char* const end = end_ptr();
+    const char* p = cursor_ptr();
     for (;;) {
-        char c = peek();
-        switch (c) {
-            case ' ': case '\r': case '\t':
-                advance(); break;
-            case '\n':
-                _line++;
-                advance();
-                _line_start = _current;
-                break;
-            case '/':
-                if (peek_next() == '/') {
-                    while (peek() != '\n' && !is_at_end()) advance();
-                } else if (peek_next() == '*') {
-                    advance(); advance();
-                    while (!(peek() == '*' && peek_next() == '/') && !is_at_end()) {
-                        if (advance() == '\n') { _line++; _line_start = _current; }
-                    }
-                    if (!is_at_end()) advance();
-                    if (!is_at_end()) advance();
-                } else {
-                    return;
-                }
-                break;
-        default:
-            return;
+        const char* run_end = skip_run<CharClass::Blank>(p, end);
+        track_newlines(p, run_end);
+        p = run_end;
+
+        if (end - p < 2 || p[0] != '/') break;
+        if (p[1] == '/') {
+            // The terminating newline is consumed by the next blank run.
+            p = find_byte(p + 2, end, '\n');
+        } else if (p[1] == '*') {
+            const char* body = p + 2;
+            const char* close = body;
+            for (;;) {
+                close = find_byte(close, end, '*');
+                if (close == end || (end - close >= 2 && close[1] == '/')) break;
+                ++close;
+            }
+            track_newlines(body, close);
+            p = (close == end) ? end : close + 2;
+        } else {
+            break;
         }
     }
+    seek(p);
 }
 
-Token Lexer::peek_next_token() {
-    auto saved_current = _current;
-    auto saved_line = _line;
-    auto saved_line_start = _line_start;
-    auto saved_token_start = _token_start;
-    Token token = next_token();
-    _current = saved_current;
-    _line = saved_line;
-    _line_start = saved_line_start;
-    _token_start = saved_token_start;
-    return token;
+void Lexer::track_newlines(const char* begin, const char* end) {
+    for (const char* nl = find_byte(begin, end, '\n'); nl != end; nl = find_byte(nl + 1, end, '\n')) {
+        _line++;
+        _line_start = _source.begin() + (nl + 1 - _source.data());
+    }
+}
+
+const char* Lexer::cursor_ptr() const {
+    return _source.data() + (_current - _source.begin());
+}
+
+const char* Lexer::end_ptr() const {
+    return _source.data() + _source.size();
+}
+
+void Lexer::seek(const char* position) {
+    _current = _source.begin() + (position - _source.data());
 }
 
 bool Lexer::match(char expected) {
@@ -249,5 +461,48 @@ bool Lexer::match(char expected) {
     return true;
 }
 
+// ─────────────────────────────────────────────────────────────────────────────
+// TokenStream
+// ─────────────────────────────────────────────────────────────────────────────
+TokenStream TokenStream::tokenize(std::string_view source) {
+    TokenStream stream;
+    stream.source = source;
+    // Real sources average a little over four bytes per token.
+    const std::size_t estimate = source.size() / 4 + 1;
+    stream.types.reserve(estimate);
+    stream.offsets.reserve(estimate);
+    stream.lengths.reserve(estimate);
+    stream.lines.reserve(estimate);
+    stream.columns.reserve(estimate);
+    stream.symbols.reserve(estimate);
+
+    Lexer lexer(source);
+    for (;;) {
+        const Token token = lexer.next_token();
+        stream.types.push_back(token.type);
+        if (token.type == TokenType::Illegal) {
+            stream.offsets.push_back(static_cast<std::uint32_t>(stream.messages.size()));
+            stream.messages.push_back(token.lexeme);
+        } else {
+            stream.offsets.push_back(static_cast<std::uint32_t>(token.lexeme.data() - source.data()));
+        }
+        stream.lengths.push_back(static_cast<std::uint32_t>(token.lexeme.size()));
+        stream.lines.push_back(token.line);
+        stream.columns.push_back(token.column);
+        stream.symbols.push_back(token.symbol);
+        if (token.type == TokenType::Eof) break;
+    }
+    return stream;
+}
+
+Token TokenStream::token(std::size_t index) const {
+    if (index >= types.size()) index = types.size() - 1;
+    const TokenType type = types[index];
+    const std::string_view lexeme = type == TokenType::Illegal
+                                        ? messages[offsets[index]]
+                                        : source.substr(offsets[index], lengths[index]);
+    return Token{type, symbols[index], lexeme, lines[index], columns[index]};
+}
+
 } // namespace frontend
 } // namespace t81
@@ -0,0 +1,519 @@
+#include "t81/frontend/module_interface.hpp"
+
+#include "t81/frontend/semantic_analyzer.hpp"
+#include "t81/support/sha256.hpp"
+
+#include <cstring>
+#include <unordered_map>
+
+// .t81i layout, version 1. All integers are little-endian; every record
+// is a fixed-width struct, so a reader indexes sections directly in the
+// mapped file. A Str is {u32 offset, u32 length} into the string table.
+//
+//   header (72 bytes)
+//     0  "T81I"          4  u32 version       8  u32 section_count
+//     12 u32 flags       16 u32 strings_off   20 u32 strings_size
+//     24 u64 source_size 32 i64 source_mtime
+//     40 Str compiler_stamp  48 Str source_hash
+//     56 Str exports_hash    64 Str module_path
+//   section table: section_count x {u32 kind, u32 offset, u32 count, u32 stride}
+//   sections, in Section order:
+//     Imports     {Str path, Str interface_hash}                          16
+//     Functions   {Str name, Str return_type, u32 first_param,
+//                  u32 param_count, u32 flags, u32 0, i64 tier}           40
+//     Params      {Str name, Str type}                                    16
+//     Records     {Str name, Str module_path, u32 schema_version,
+//                  u32 first_field, u32 field_count, u32 0}               32
+//     Fields      {Str name, Str type}                                    16
+//     Enums       {Str name, Str module_path, u32 schema_version,
+//                  i32 id, u32 first_variant, u32 variant_count}          32
+//     Variants    {Str name, Str payload, i32 id, u32 flags}              24
+//     Aliases     {Str name, Str target, u32 first_param, u32 param_count} 24
+//     AliasParams {Str name}                                              8
+//   string table
+//
+// Readers accept strides larger than the ones above, so later versions can
+// append fields to a record without breaking older tools.
+
+namespace t81 {
+namespace frontend {
+
+namespace {
+
+constexpr char kMagic[4] = {'T', '8', '1', 'I'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kHeaderSize = 72;
+constexpr std::size_t kSectionEntrySize = 16;
+
+constexpr std::uint32_t kFunctionEffectful = 1u << 0;
+constexpr std::uint32_t kFunctionHasTier = 1u << 1;
+constexpr std::uint32_t kVariantHasPayload = 1u << 0;
+
+using Section = ModuleInterfaceView::Section;
+
+constexpr std::array<std::uint32_t, ModuleInterfaceView::kSectionCount> kStrides = {
+    16, 40, 16, 32, 16, 32, 24, 24, 8,
+};
+
+std::size_t section_index(Section section) {
+    return static_cast<std::size_t>(section) - 1;
+}
+
+void put_u32(std::string& out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+void put_u64(std::string& out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+void patch_u32(std::string& out, std::size_t at, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) out[at + i] = static_cast<char>(value >> (8 * i));
+}
+
+std::uint32_t get_u32(const std::byte* p) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) value |= std::uint32_t{std::to_integer<std::uint8_t>(p[i])} << (8 * i);
+    return value;
+}
+
+std::uint64_t get_u64(const std::byte* p) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value |= std::uint64_t{std::to_integer<std::uint8_t>(p[i])} << (8 * i);
+    return value;
+}
+
+// Accumulates the string table, storing each distinct string once.
+class StringTable {
+public:
+    void put(std::string& out, std::string_view value) {
+        auto [it, inserted] = _offsets.try_emplace(std::string(value), static_cast<std::uint32_t>(_data.size()));
+        if (inserted) _data.append(value);
+        put_u32(out, it->second);
+        put_u32(out, static_cast<std::uint32_t>(value.size()));
+    }
+    const std::string& data() const { return _data; }
+
+private:
+    std::string _data;
+    std::unordered_map<std::string, std::uint32_t> _offsets;
+};
+
+} // namespace
+
+ModuleInterface ModuleInterface::build(const SemanticAnalyzer& analyzer,
+                                       std::span<const AstPtr<Stmt>> statements) {
+    ModuleInterface out;
+    out.module_path = analyzer._declared_module.value_or("");
+    const auto type_text = [&](const AstPtr<TypeExpr>& type) {
+        return type ? analyzer.type_expr_to_string(*type) : std::string();
+    };
+
+    for (const auto& stmt : statements) {
+        if (!stmt) continue;
+        switch (stmt->kind) {
+            case StmtKind::Function: {
+                const auto& func = static_cast<const FunctionStmt&>(*stmt);
+                Function entry;
+                entry.name = std::string(func.name.lexeme);
+                for (const auto& param : func.params) {
+                    entry.params.push_back({std::string(param.name.lexeme), type_text(param.type)});
+                }
+                entry.return_type = type_text(func.return_type);
+                entry.is_effectful = func.attributes.is_effectful;
+                entry.tier = func.attributes.tier;
+                out.functions.push_back(std::move(entry));
+                break;
+            }
+            case StmtKind::Record: {
+                const auto& decl = static_cast<const RecordDecl&>(*stmt);
+                Record entry;
+                entry.name = std::string(decl.name.lexeme);
+                for (const auto& field : decl.fields) {
+                    entry.fields.push_back({std::string(field.name.lexeme), type_text(field.type)});
+                }
+                if (auto it = analyzer._record_definitions.find(entry.name); it != analyzer._record_definitions.end()) {
+                    entry.schema_version = it->second.schema_version;
+                    entry.module_path = it->second.module_path;
+                }
+                out.records.push_back(std::move(entry));
+                break;
+            }
+            case StmtKind::Enum: {
+                const auto& decl = static_cast<const EnumDecl&>(*stmt);
+                Enum entry;
+                entry.name = std::string(decl.name.lexeme);
+                const auto info = analyzer._enum_definitions.find(entry.name);
+                for (const auto& variant : decl.variants) {
+                    Variant v;
+                    v.name = std::string(variant.name.lexeme);
+                    if (variant.payload) v.payload = type_text(variant.payload);
+                    if (info != analyzer._enum_definitions.end()) {
+                        if (auto vit = info->second.variants.find(v.name); vit != info->second.variants.end()) {
+                            v.id = vit->second.id;
+                        }
+                    }
+                    entry.variants.push_back(std::move(v));
+                }
+                if (info != analyzer._enum_definitions.end()) {
+                    entry.schema_version = info->second.schema_version;
+                    entry.module_path = info->second.module_path;
+                    entry.id = info->second.id;
+                }
+                out.enums.push_back(std::move(entry));
+                break;
+            }
+            case StmtKind::TypeDecl: {
+                const auto& decl = static_cast<const TypeDecl&>(*stmt);
+                Alias entry;
+                entry.name = std::string(decl.name.lexeme);
+                for (const auto& param : decl.params) {
+                    entry.params.emplace_back(param.lexeme);
+                }
+                entry.target = type_text(decl.alias);
+                out.aliases.push_back(std::move(entry));
+                break;
+            }
+            case StmtKind::Import:
+                out.imports.push_back({std::string(static_cast<const ImportDecl&>(*stmt).path), {}});
+                break;
+            default:
+                break;
+        }
+    }
+    return out;
+}
+
+std::string ModuleInterface::exports_hash() const {
+    // Length-prefix every field so distinct declarations never collide.
+    Sha256 hash;
+    const auto field = [&](std::string_view value) {
+        const std::uint64_t size = value.size();
+        hash.update(&size, sizeof(size)).update(value);
+    };
+    const auto number = [&](std::int64_t value) { field(std::to_string(value)); };
+
+    field(module_path);
+    for (const auto& func : functions) {
+        field("fn");
+        field(func.name);
+        number(static_cast<std::int64_t>(func.params.size()));
+        for (const auto& param : func.params) {
+            field(param.name);
+            field(param.type);
+        }
+        field(func.return_type);
+        number(func.is_effectful);
+        field(func.tier ? std::to_string(*func.tier) : "-");
+    }
+    for (const auto& record : records) {
+        field("record");
+        field(record.name);
+        number(static_cast<std::int64_t>(record.fields.size()));
+        for (const auto& f : record.fields) {
+            field(f.name);
+            field(f.type);
+        }
+        number(record.schema_version);
+        field(record.module_path);
+    }
+    for (const auto& e : enums) {
+        field("enum");
+        field(e.name);
+        number(static_cast<std::int64_t>(e.variants.size()));
+        for (const auto& v : e.variants) {
+            field(v.name);
+            field(v.payload ? "+" + *v.payload : "-");
+            number(v.id);
+        }
+        number(e.schema_version);
+        field(e.module_path);
+        number(e.id);
+    }
+    for (const auto& alias : aliases) {
+        field("type");
+        field(alias.name);
+        number(static_cast<std::int64_t>(alias.params.size()));
+        for (const auto& param : alias.params) field(param);
+        field(alias.target);
+    }
+    return Sha256::to_hex(hash.finish());
+}
+
+std::string ModuleInterface::serialize() const {
+    StringTable strings;
+    std::array<std::string, ModuleInterfaceView::kSectionCount> sections;
+    std::array<std::uint32_t, ModuleInterfaceView::kSectionCount> counts{};
+    const auto section = [&](Section s) -> std::string& {
+        ++counts[section_index(s)];
+        return sections[section_index(s)];
+    };
+
+    for (const auto& imp : imports) {
+        auto& out = section(Section::Imports);
+        strings.put(out, imp.path);
+        strings.put(out, imp.interface_hash);
+    }
+    for (const auto& func : functions) {
+        auto& out = section(Section::Functions);
+        strings.put(out, func.name);
+        strings.put(out, func.return_type);
+        put_u32(out, counts[section_index(Section::Params)]);
+        put_u32(out, static_cast<std::uint32_t>(func.params.size()));
+        put_u32(out, (func.is_effectful ? kFunctionEffectful : 0) | (func.tier ? kFunctionHasTier : 0));
+        put_u32(out, 0);
+        put_u64(out, static_cast<std::uint64_t>(func.tier.value_or(0)));
+        for (const auto& param : func.params) {
+            auto& params = section(Section::Params);
+            strings.put(params, param.name);
+            strings.put(params, param.type);
+        }
+    }
+    for (const auto& record : records) {
+        auto& out = section(Section::Records);
+        strings.put(out, record.name);
+        strings.put(out, record.module_path);
+        put_u32(out, record.schema_version);
+        put_u32(out, counts[section_index(Section::Fields)]);
+        put_u32(out, static_cast<std::uint32_t>(record.fields.size()));
+        put_u32(out, 0);
+        for (const auto& field : record.fields) {
+            auto& fields = section(Section::Fields);
+            strings.put(fields, field.name);
+            strings.put(fields, field.type);
+        }
+    }
+    for (const auto& e : enums) {
+        auto& out = section(Section::Enums);
+        strings.put(out, e.name);
+        strings.put(out, e.module_path);
+        put_u32(out, e.schema_version);
+        put_u32(out, static_cast<std::uint32_t>(e.id));
+        put_u32(out, counts[section_index(Section::Variants)]);
+        put_u32(out, static_cast<std::uint32_t>(e.variants.size()));
+        for (const auto& v : e.variants) {
+            auto& variants = section(Section::Variants);
+            strings.put(variants, v.name);
+            strings.put(variants, v.payload.value_or(""));
+            put_u32(variants, static_cast<std::uint32_t>(v.id));
+            put_u32(variants, v.payload ? kVariantHasPayload : 0);
+        }
+    }
+    for (const auto& alias : aliases) {
+        auto& out = section(Section::Aliases);
+        strings.put(out, alias.name);
+        strings.put(out, alias.target);
+        put_u32(out, counts[section_index(Section::AliasParams)]);
+        put_u32(out, static_cast<std::uint32_t>(alias.params.size()));
+        for (const auto& param : alias.params) {
+            strings.put(section(Section::AliasParams), param);
+        }
+    }
+
+    std::string out;
+    out.append(kMagic, sizeof(kMagic));
+    put_u32(out, kVersion);
+    put_u32(out, ModuleInterfaceView::kSectionCount);
+    put_u32(out, 0);
+    put_u32(out, 0);  // strings offset, patched below
+    put_u32(out, 0);  // strings size, patched below
+    put_u64(out, source_size);
+    put_u64(out, static_cast<std::uint64_t>(source_mtime));
+    strings.put(out, compiler_stamp);
+    strings.put(out, source_hash);
+    strings.put(out, exports_hash());
+    strings.put(out, module_path);
+
+    std::size_t offset = kHeaderSize + ModuleInterfaceView::kSectionCount * kSectionEntrySize;
+    for (std::size_t i = 0; i < sections.size(); ++i) {
+        put_u32(out, static_cast<std::uint32_t>(i + 1));
+        put_u32(out, static_cast<std::uint32_t>(offset));
+        put_u32(out, counts[i]);
+        put_u32(out, kStrides[i]);
+        offset += sections[i].size();
+    }
+    for (const auto& bytes : sections) {
+        out += bytes;
+    }
+    patch_u32(out, 16, static_cast<std::uint32_t>(out.size()));
+    patch_u32(out, 20, static_cast<std::uint32_t>(strings.data().size()));
+    out += strings.data();
+    return out;
+}
+
+std::optional<ModuleInterfaceView> ModuleInterfaceView::open(std::span<const std::byte> bytes) {
+    ModuleInterfaceView view(bytes);
+    if (!view.validate()) {
+        return std::nullopt;
+    }
+    return view;
+}
+
+bool ModuleInterfaceView::validate() {
+    const std::size_t size = _bytes.size();
+    if (size < kHeaderSize || std::memcmp(_bytes.data(), kMagic, sizeof(kMagic)) != 0 ||
+        get_u32(_bytes.data() + 4) != kVersion) {
+        return false;
+    }
+    const std::uint32_t section_count = get_u32(_bytes.data() + 8);
+    _strings_offset = get_u32(_bytes.data() + 16);
+    _strings_size = get_u32(_bytes.data() + 20);
+    if (std::uint64_t{_strings_offset} + _strings_size > size ||
+        kHeaderSize + std::uint64_t{section_count} * kSectionEntrySize > size) {
+        return false;
+    }
+    for (std::size_t field = 40; field < kHeaderSize; field += 8) {
+        if (!str_ok(_bytes.data() + field)) return false;
+    }
+
+    for (std::uint32_t i = 0; i < section_count; ++i) {
+        const std::byte* entry = _bytes.data() + kHeaderSize + i * kSectionEntrySize;
+        const std::uint32_t kind = get_u32(entry);
+        if (kind == 0 || kind > kSectionCount) {
+            continue;  // A section this version does not know about.
+        }
+        SectionInfo info{get_u32(entry + 4), get_u32(entry + 8), get_u32(entry + 12)};
+        if (info.stride < kStrides[kind - 1] ||
+            info.offset + std::uint64_t{info.count} * info.stride > size) {
+            return false;
+        }
+        _sections[kind - 1] = info;
+    }
+
+    // Every string and every child range must resolve inside the buffer.
+    const auto strs_ok = [&](Section s, std::size_t str_count) {
+        for (std::size_t i = 0; i < _sections[section_index(s)].count; ++i) {
+            const std::byte* rec = record(s, i);
+            for (std::size_t f = 0; f < str_count; ++f) {
+                if (!str_ok(rec + f * 8)) return false;
+            }
+        }
+        return true;
+    };
+    const auto children_ok = [&](Section s, std::size_t at, Section child) {
+        const std::uint64_t limit = _sections[section_index(child)].count;
+        for (std::size_t i = 0; i < _sections[section_index(s)].count; ++i) {
+            const std::byte* rec = record(s, i);
+            if (std::uint64_t{get_u32(rec + at)} + get_u32(rec + at + 4) > limit) return false;
+        }
+        return true;
+    };
+    return strs_ok(Section::Imports, 2) && strs_ok(Section::Functions, 2) && strs_ok(Section::Params, 2) &&
+           strs_ok(Section::Records, 2) && strs_ok(Section::Fields, 2) && strs_ok(Section::Enums, 2) &&
+           strs_ok(Section::Variants, 2) && strs_ok(Section::Aliases, 2) && strs_ok(Section::AliasParams, 1) &&
+           children_ok(Section::Functions, 16, Section::Params) &&
+           children_ok(Section::Records, 20, Section::Fields) &&
+           children_ok(Section::Enums, 24, Section::Variants) &&
+           children_ok(Section::Aliases, 16, Section::AliasParams);
+}
+
+const std::byte* ModuleInterfaceView::record(Section section, std::size_t index) const {
+    const SectionInfo& info = _sections[section_index(section)];
+    return _bytes.data() + info.offset + index * info.stride;
+}
+
+bool ModuleInterfaceView::str_ok(const std::byte* field) const {
+    return std::uint64_t{get_u32(field)} + get_u32(field + 4) <= _strings_size;
+}
+
+std::string_view ModuleInterfaceView::str(const std::byte* field) const {
+    const auto* base = reinterpret_cast<const char*>(_bytes.data()) + _strings_offset;
+    return {base + get_u32(field), get_u32(field + 4)};
+}
+
+std::string_view ModuleInterfaceView::compiler_stamp() const { return str(_bytes.data() + 40); }
+std::string_view ModuleInterfaceView::source_hash() const { return str(_bytes.data() + 48); }
+std::string_view ModuleInterfaceView::exports_hash() const { return str(_bytes.data() + 56); }
+std::string_view ModuleInterfaceView::module_path() const { return str(_bytes.data() + 64); }
+std::uint64_t ModuleInterfaceView::source_size() const { return get_u64(_bytes.data() + 24); }
+std::int64_t ModuleInterfaceView::source_mtime() const {
+    return static_cast<std::int64_t>(get_u64(_bytes.data() + 32));
+}
+
+std::size_t ModuleInterfaceView::import_count() const {
+    return _sections[section_index(Section::Imports)].count;
+}
+
+std::string_view ModuleInterfaceView::import_path(std::size_t index) const {
+    return str(record(Section::Imports, index));
+}
+
+std::string_view ModuleInterfaceView::import_interface_hash(std::size_t index) const {
+    return str(record(Section::Imports, index) + 8);
+}
+
+ModuleInterface ModuleInterfaceView::materialize() const {
+    ModuleInterface out;
+    out.compiler_stamp = compiler_stamp();
+    out.source_hash = source_hash();
+    out.source_size = source_size();
+    out.source_mtime = source_mtime();
+    out.module_path = module_path();
+
+    for (std::size_t i = 0; i < import_count(); ++i) {
+        out.imports.push_back({std::string(import_path(i)), std::string(import_interface_hash(i))});
+    }
+    const auto pairs = [&](Section child, const std::byte* rec, std::size_t at) {
+        std::vector<ModuleInterface::Param> items;
+        const std::uint32_t first = get_u32(rec + at);
+        const std::uint32_t count = get_u32(rec + at + 4);
+        for (std::uint32_t i = first; i < first + count; ++i) {
+            const std::byte* item = record(child, i);
+            items.push_back({std::string(str(item)), std::string(str(item + 8))});
+        }
+        return items;
+    };
+    for (std::size_t i = 0; i < _sections[section_index(Section::Functions)].count; ++i) {
+        const std::byte* rec = record(Section::Functions, i);
+        ModuleInterface::Function func;
+        func.name = str(rec);
+        func.return_type = str(rec + 8);
+        func.params = pairs(Section::Params, rec, 16);
+        const std::uint32_t flags = get_u32(rec + 24);
+        func.is_effectful = (flags & kFunctionEffectful) != 0;
+        if (flags & kFunctionHasTier) func.tier = static_cast<std::int64_t>(get_u64(rec + 32));
+        out.functions.push_back(std::move(func));
+    }
+    for (std::size_t i = 0; i < _sections[section_index(Section::Records)].count; ++i) {
+        const std::byte* rec = record(Section::Records, i);
+        ModuleInterface::Record record_entry;
+        record_entry.name = str(rec);
+        record_entry.module_path = str(rec + 8);
+        record_entry.schema_version = get_u32(rec + 16);
+        record_entry.fields = pairs(Section::Fields, rec, 20);
+        out.records.push_back(std::move(record_entry));
+    }
+    for (std::size_t i = 0; i < _sections[section_index(Section::Enums)].count; ++i) {
+        const std::byte* rec = record(Section::Enums, i);
+        ModuleInterface::Enum e;
+        e.name = str(rec);
+        e.module_path = str(rec + 8);
+        e.schema_version = get_u32(rec + 16);
+        e.id = static_cast<int>(get_u32(rec + 20));
+        const std::uint32_t first = get_u32(rec + 24);
+        for (std::uint32_t v = first; v < first + get_u32(rec + 28); ++v) {
+            const std::byte* item = record(Section::Variants, v);
+            ModuleInterface::Variant variant;
+            variant.name = str(item);
+            if (get_u32(item + 20) & kVariantHasPayload) variant.payload = std::string(str(item + 8));
+            variant.id = static_cast<int>(get_u32(item + 16));
+            e.variants.push_back(std::move(variant));
+        }
+        out.enums.push_back(std::move(e));
+    }
+    for (std::size_t i = 0; i < _sections[section_index(Section::Aliases)].count; ++i) {
+        const std::byte* rec = record(Section::Aliases, i);
+        ModuleInterface::Alias alias;
+        alias.name = str(rec);
+        alias.target = str(rec + 8);
+        const std::uint32_t first = get_u32(rec + 16);
+        for (std::uint32_t p = first; p < first + get_u32(rec + 20); ++p) {
+            alias.params.emplace_back(str(record(Section::AliasParams, p)));
+        }
+        out.aliases.push_back(std::move(alias));
+    }
+    return out;
+}
+
+} // namespace frontend
+} // namespace t81
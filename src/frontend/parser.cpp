@@ -15,20 +15,51 @@
 namespace t81 {
 namespace frontend {
 
+namespace {
+// Token sets probed by the grammar rules. These are compile-time bitsets, so a
+// `match(...)` costs a mask test rather than building a list per call.
+constexpr TokenSet kEqualityOps{TokenType::BangEqual, TokenType::EqualEqual};
+constexpr TokenSet kComparisonOps{TokenType::Greater, TokenType::GreaterEqual,
+                                  TokenType::Less, TokenType::LessEqual};
+constexpr TokenSet kTermOps{TokenType::Minus, TokenType::Plus};
+constexpr TokenSet kFactorOps{TokenType::Slash, TokenType::Star, TokenType::Percent};
+constexpr TokenSet kUnaryOps{TokenType::Bang, TokenType::Minus};
+constexpr TokenSet kLiteralTokens{TokenType::False, TokenType::True, TokenType::Integer,
+                                  TokenType::Float, TokenType::String};
+constexpr TokenSet kListSeparators{TokenType::Comma, TokenType::Semicolon};
+constexpr TokenSet kLoopBoundArgTokens{TokenType::Identifier, TokenType::Loop};
+constexpr TokenSet kTypeStartTokens{
+    TokenType::Identifier,
+    TokenType::I32, TokenType::I16, TokenType::I8, TokenType::I2,
+    TokenType::Bool, TokenType::Void,
+    TokenType::T81BigInt, TokenType::T81Float, TokenType::T81Fraction,
+    TokenType::Vector, TokenType::Matrix, TokenType::Tensor, TokenType::Graph,
+};
+} // anonymous namespace
+
 /**
  * @brief Constructs a new Parser.
  * @param lexer The Lexer instance providing the token stream.
  */
 Parser::Parser(Lexer& lexer, std::string source_name)
-    : _lexer(lexer), _source_name(std::move(source_name)) {
+    : _lexer(&lexer), _source_name(std::move(source_name)), _errors(&std::cerr) {
     // Prime the pump by fetching the first token. This ensures that `_current`
     // is valid before any parsing methods are called.
-    _current = _lexer.next_token();
+    _current = next_token();
+}
+
+/**
+ * @brief Constructs a Parser over a pre-tokenized stream.
+ * @param tokens The TokenStream to consume by index.
+ */
+Parser::Parser(const TokenStream& tokens, std::string source_name)
+    : _tokens(&tokens), _source_name(std::move(source_name)), _errors(&std::cerr) {
+    _current = next_token();
 }
 
 void Parser::report_error(const Token& token, const std::string& message) {
     const std::string file = _source_name.empty() ? "<source>" : _source_name;
-    std::cerr << file << ':' << token.line << ':' << token.column
+    *_errors << file << ':' << token.line << ':' << token.column
               << ": error: " << message << '\n';
     _had_error = true;
 }
@@ -37,26 +68,32 @@ void Parser::report_error(const Token& token, const std::string& message) {
  * @brief Parses the entire token stream and produces a list of statements.
  * @return A vector of unique_ptrs to the root statements of the AST.
  */
-std::vector<std::unique_ptr<Stmt>> Parser::parse() {
-    std::vector<std::unique_ptr<Stmt>> statements;
+SyntaxTree Parser::parse() {
+    SyntaxTree tree;
+    tree.arena = _arena;
     while (!is_at_end()) {
-        statements.push_back(declaration());
+        tree.statements.push_back(declaration());
     }
-    return statements;
+    tree.node_count = _next_node_id;
+    return tree;
 }
 
 // --- Private Helper Methods ---
 
-// Checks if the current token matches any of the given types. If so,
-// it consumes the token and returns true.
-bool Parser::match(const std::vector<TokenType>& types) {
-    for (TokenType type : types) {
-        if (check(type)) {
-            advance();
-            return true;
-        }
-    }
-    return false;
+// Checks if the current token is of the given type. If so, it consumes the
+// token and returns true.
+bool Parser::match(TokenType type) {
+    if (!check(type)) return false;
+    advance();
+    return true;
+}
+
+// Checks if the current token is any of the types in `types`. If so, it
+// consumes the token and returns true.
+bool Parser::match(TokenSet types) {
+    if (is_at_end() || !types.contains(_current.type)) return false;
+    advance();
+    return true;
 }
 
 // Returns true if the current token is of the given type, without consuming it.
@@ -69,11 +106,23 @@ bool Parser::check(TokenType type) {
 Token Parser::advance() {
     if (!is_at_end()) {
         _previous = _current;
-        _current = _lexer.next_token();
+        _current = next_token();
     }
     return previous();
 }
 
+// Pulls the next token from whichever source backs this parser.
+Token Parser::next_token() {
+    if (_tokens) return _tokens->token(_token_index++);
+    return _lexer->next_token();
+}
+
+// Returns the token after `_current` without consuming anything.
+Token Parser::peek_next_token() {
+    if (_tokens) return _tokens->token(_token_index);
+    return _lexer->peek_next_token();
+}
+
 // Returns true if the parser has reached the end of the token stream.
 bool Parser::is_at_end() {
     return peek().type == TokenType::Eof;
@@ -97,7 +146,7 @@ Token Parser::consume(TokenType type, const char* message) {
     if (!is_at_end()) {
         return advance();
     }
-    return Token{TokenType::Illegal, "", peek().line, peek().column};
+    return Token{TokenType::Illegal, kEmptySymbol, "", peek().line, peek().column};
 }
 
 // Discards tokens until it finds a likely statement boundary. This is a
@@ -127,20 +176,20 @@ void Parser::synchronize() {
 
 // Parses a declaration.
 // declaration -> fn_declaration | var_declaration | let_declaration | statement ;
-std::unique_ptr<Stmt> Parser::declaration() {
+AstPtr<Stmt> Parser::declaration() {
     try {
         auto struct_attrs = parse_structural_attributes();
         auto fn_attrs = parse_function_attributes();
-        if (match({TokenType::Module})) return module_declaration(previous());
-        if (match({TokenType::Import})) return import_declaration(previous());
-        if (match({TokenType::Type})) return type_declaration();
-        if (match({TokenType::Record})) return record_declaration(struct_attrs);
-        if (match({TokenType::Enum})) return enum_declaration(struct_attrs);
+        if (match(TokenType::Module)) return module_declaration(previous());
+        if (match(TokenType::Import)) return import_declaration(previous());
+        if (match(TokenType::Type)) return type_declaration();
+        if (match(TokenType::Record)) return record_declaration(struct_attrs);
+        if (match(TokenType::Enum)) return enum_declaration(struct_attrs);
         if (struct_attrs.has_value()) {
             const Token& anchor = struct_attrs->anchor.value_or(peek());
             report_error(anchor, "Structural attributes may only decorate records or enums.");
         }
-        if (match({TokenType::Fn})) {
+        if (match(TokenType::Fn)) {
             FunctionAttributes attrs = fn_attrs.has_value() ? fn_attrs->attributes : FunctionAttributes{};
             return function("function", std::move(attrs));
         }
@@ -148,8 +197,8 @@ std::unique_ptr<Stmt> Parser::declaration() {
             const Token& anchor = fn_attrs->anchor.value_or(peek());
             report_error(anchor, "Function attributes may only decorate functions.");
         }
-        if (match({TokenType::Var})) return var_declaration();
-        if (match({TokenType::Let})) return let_declaration();
+        if (match(TokenType::Var)) return var_declaration();
+        if (match(TokenType::Let)) return let_declaration();
         return statement();
     } catch (const std::runtime_error& error) {
         synchronize();
@@ -157,33 +206,33 @@ std::unique_ptr<Stmt> Parser::declaration() {
     }
 }
 
-std::unique_ptr<Stmt> Parser::module_declaration(Token keyword) {
+AstPtr<Stmt> Parser::module_declaration(Token keyword) {
     Token segment = consume(TokenType::Identifier, "Expect module path after 'module'.");
     std::string path(segment.lexeme);
-    while (match({TokenType::Dot})) {
+    while (match(TokenType::Dot)) {
         Token next = consume(TokenType::Identifier, "Expect module segment after '.'.");
         path.push_back('.');
         path.append(next.lexeme.data(), next.lexeme.size());
     }
     consume(TokenType::Semicolon, "Expect ';' after module declaration.");
-    return std::make_unique<ModuleDecl>(keyword, std::move(path));
+    return make<ModuleDecl>(keyword, _arena->copy_string(path));
 }
 
-std::unique_ptr<Stmt> Parser::import_declaration(Token keyword) {
+AstPtr<Stmt> Parser::import_declaration(Token keyword) {
     Token segment = consume(TokenType::Identifier, "Expect import path after 'import'.");
     std::string path(segment.lexeme);
-    while (match({TokenType::Dot})) {
+    while (match(TokenType::Dot)) {
         Token next = consume(TokenType::Identifier, "Expect import segment after '.'.");
         path.push_back('.');
         path.append(next.lexeme.data(), next.lexeme.size());
     }
     consume(TokenType::Semicolon, "Expect ';' after import declaration.");
-    return std::make_unique<ImportDecl>(keyword, std::move(path));
+    return make<ImportDecl>(keyword, _arena->copy_string(path));
 }
 
 // Parses a function declaration.
 // function -> "fn" IDENTIFIER "(" parameters? ")" ( "->" type )? "{" block "}" ;
-std::unique_ptr<Stmt> Parser::function(const std::string& kind, FunctionAttributes attributes) {
+AstPtr<Stmt> Parser::function(const std::string& kind, FunctionAttributes attributes) {
     Token name = consume(TokenType::Identifier, ("Expect " + kind + " name.").c_str());
     consume(TokenType::LParen, ("Expect '(' after " + kind + " name.").c_str());
     std::vector<Parameter> parameters;
@@ -195,40 +244,40 @@ std::unique_ptr<Stmt> Parser::function(const std::string& kind, FunctionAttribut
             Token param_name = consume(TokenType::Identifier, "Expect parameter name.");
             consume(TokenType::Colon, "Expect ':' after parameter name.");
             parameters.push_back({param_name, type()});
-        } while (match({TokenType::Comma}));
+        } while (match(TokenType::Comma));
     }
     consume(TokenType::RParen, "Expect ')' after parameters.");
 
-    std::unique_ptr<TypeExpr> return_type = nullptr;
-    if (match({TokenType::Arrow})) {
+    AstPtr<TypeExpr> return_type = nullptr;
+    if (match(TokenType::Arrow)) {
         return_type = type();
     }
 
     consume(TokenType::LBrace, ("Expect '{' before " + kind + " body.").c_str());
-    std::vector<std::unique_ptr<Stmt>> body = block();
-    return std::make_unique<FunctionStmt>(name, std::move(parameters), std::move(return_type), std::move(body), std::move(attributes));
+    AstList<AstPtr<Stmt>> body = block();
+    return make<FunctionStmt>(name, list(std::move(parameters)), return_type, body, attributes);
 }
 
-std::unique_ptr<Stmt> Parser::type_declaration() {
+AstPtr<Stmt> Parser::type_declaration() {
     Token name = consume(TokenType::Identifier, "Expect type name.");
     std::vector<Token> parameters;
-    if (match({TokenType::LBracket})) {
+    if (match(TokenType::LBracket)) {
         do {
             if (parameters.size() >= 8) {
                 report_error(peek(), "Too many generic parameters (max 8)");
                 break;
             }
             parameters.push_back(consume(TokenType::Identifier, "Expect generic parameter name."));
-        } while (match({TokenType::Comma}));
+        } while (match(TokenType::Comma));
         consume(TokenType::RBracket, "Expect ']' after generic parameters.");
     }
     consume(TokenType::Equal, "Expect '=' after type declaration.");
-    std::unique_ptr<TypeExpr> alias = type();
+    AstPtr<TypeExpr> alias = type();
     consume(TokenType::Semicolon, "Expect ';' after type declaration.");
-    return std::make_unique<TypeDecl>(name, std::move(parameters), std::move(alias));
+    return make<TypeDecl>(name, list(std::move(parameters)), alias);
 }
 
-std::unique_ptr<Stmt> Parser::record_declaration(std::optional<StructuralAttributes> attributes) {
+AstPtr<Stmt> Parser::record_declaration(std::optional<StructuralAttributes> attributes) {
     Token name = consume(TokenType::Identifier, "Expect record name.");
     consume(TokenType::LBrace, "Expect '{' after record name.");
     std::vector<RecordDecl::Field> fields;
@@ -242,22 +291,22 @@ std::unique_ptr<Stmt> Parser::record_declaration(std::optional<StructuralAttribu
     consume(TokenType::RBrace, "Expect '}' after record declaration.");
     consume(TokenType::Semicolon, "Expect ';' after record declaration.");
     std::optional<std::int64_t> schema_version;
-    std::optional<std::string> module_path;
+    std::optional<std::string_view> module_path;
     if (attributes) {
         schema_version = attributes->schema_version;
-        module_path = attributes->module_path;
+        if (attributes->module_path) module_path = _arena->copy_string(*attributes->module_path);
     }
-    return std::make_unique<RecordDecl>(name, std::move(fields), schema_version, module_path);
+    return make<RecordDecl>(name, list(std::move(fields)), schema_version, module_path);
 }
 
-std::unique_ptr<Stmt> Parser::enum_declaration(std::optional<StructuralAttributes> attributes) {
+AstPtr<Stmt> Parser::enum_declaration(std::optional<StructuralAttributes> attributes) {
     Token name = consume(TokenType::Identifier, "Expect enum name.");
     consume(TokenType::LBrace, "Expect '{' after enum name.");
     std::vector<EnumDecl::Variant> variants;
     while (!check(TokenType::RBrace) && !is_at_end()) {
         Token variant = consume(TokenType::Identifier, "Expect variant name.");
-        std::unique_ptr<TypeExpr> payload = nullptr;
-        if (match({TokenType::LParen})) {
+        AstPtr<TypeExpr> payload = nullptr;
+        if (match(TokenType::LParen)) {
             payload = type();
             consume(TokenType::RParen, "Expect ')' after variant payload type.");
         }
@@ -267,98 +316,98 @@ std::unique_ptr<Stmt> Parser::enum_declaration(std::optional<StructuralAttribute
     consume(TokenType::RBrace, "Expect '}' after enum declaration.");
     consume(TokenType::Semicolon, "Expect ';' after enum declaration.");
     std::optional<std::int64_t> schema_version;
-    std::optional<std::string> module_path;
+    std::optional<std::string_view> module_path;
     if (attributes) {
         schema_version = attributes->schema_version;
-        module_path = attributes->module_path;
+        if (attributes->module_path) module_path = _arena->copy_string(*attributes->module_path);
     }
-    return std::make_unique<EnumDecl>(name, std::move(variants), schema_version, module_path);
+    return make<EnumDecl>(name, list(std::move(variants)), schema_version, module_path);
 }
 
 // Parses a variable declaration.
 // var_declaration -> "var" IDENTIFIER ( ":" type )? ( "=" expression )? ";" ;
-std::unique_ptr<Stmt> Parser::var_declaration() {
+AstPtr<Stmt> Parser::var_declaration() {
     Token name = consume(TokenType::Identifier, "Expect variable name.");
-    std::unique_ptr<TypeExpr> type_expr = nullptr;
-    if (match({TokenType::Colon})) {
+    AstPtr<TypeExpr> type_expr = nullptr;
+    if (match(TokenType::Colon)) {
         type_expr = type();
     }
-    std::unique_ptr<Expr> initializer = nullptr;
-    if (match({TokenType::Equal})) {
+    AstPtr<Expr> initializer = nullptr;
+    if (match(TokenType::Equal)) {
         initializer = expression();
     }
     consume(TokenType::Semicolon, "Expect ';' after variable declaration.");
-    return std::make_unique<VarStmt>(name, std::move(type_expr), std::move(initializer));
+    return make<VarStmt>(name, std::move(type_expr), std::move(initializer));
 }
 
 // Parses a constant declaration.
 // let_declaration -> "let" IDENTIFIER ( ":" type )? "=" expression ";" ;
-std::unique_ptr<Stmt> Parser::let_declaration() {
+AstPtr<Stmt> Parser::let_declaration() {
     Token name = consume(TokenType::Identifier, "Expect constant name.");
-    std::unique_ptr<TypeExpr> type_expr = nullptr;
-    if (match({TokenType::Colon})) {
+    AstPtr<TypeExpr> type_expr = nullptr;
+    if (match(TokenType::Colon)) {
         type_expr = type();
     }
     consume(TokenType::Equal, "Expect '=' after constant name.");
-    std::unique_ptr<Expr> initializer = expression();
+    AstPtr<Expr> initializer = expression();
     consume(TokenType::Semicolon, "Expect ';' after constant declaration.");
-    return std::make_unique<LetStmt>(name, std::move(type_expr), std::move(initializer));
+    return make<LetStmt>(name, std::move(type_expr), std::move(initializer));
 }
 
 // Parses a statement.
 // statement -> if_stmt | while_stmt | return_stmt | block | expr_stmt ;
-std::unique_ptr<Stmt> Parser::statement() {
-    if (match({TokenType::If})) {
+AstPtr<Stmt> Parser::statement() {
+    if (match(TokenType::If)) {
         consume(TokenType::LParen, "Expect '(' after 'if'.");
         auto condition = expression();
         consume(TokenType::RParen, "Expect ')' after if condition.");
         auto then_branch = statement();
-        std::unique_ptr<Stmt> else_branch = nullptr;
-        if (match({TokenType::Else})) {
+        AstPtr<Stmt> else_branch = nullptr;
+        if (match(TokenType::Else)) {
             else_branch = statement();
         }
-        return std::make_unique<IfStmt>(std::move(condition), std::move(then_branch), std::move(else_branch));
+        return make<IfStmt>(std::move(condition), std::move(then_branch), std::move(else_branch));
     }
-    if (match({TokenType::While})) {
+    if (match(TokenType::While)) {
         consume(TokenType::LParen, "Expect '(' after 'while'.");
         auto condition = expression();
         consume(TokenType::RParen, "Expect ')' after while condition.");
         auto body = statement();
-        return std::make_unique<WhileStmt>(std::move(condition), std::move(body));
+        return make<WhileStmt>(std::move(condition), std::move(body));
     }
     if (check(TokenType::At) || check(TokenType::Loop)) {
         return loop_statement();
     }
-    if (match({TokenType::Break})) {
+    if (match(TokenType::Break)) {
         Token keyword = previous();
         consume(TokenType::Semicolon, "Expect ';' after 'break'.");
-        return std::make_unique<BreakStmt>(keyword);
+        return make<BreakStmt>(keyword);
     }
-    if (match({TokenType::Continue})) {
+    if (match(TokenType::Continue)) {
         Token keyword = previous();
         consume(TokenType::Semicolon, "Expect ';' after 'continue'.");
-        return std::make_unique<ContinueStmt>(keyword);
+        return make<ContinueStmt>(keyword);
     }
-    if (match({TokenType::Return})) {
+    if (match(TokenType::Return)) {
         Token keyword = previous();
-        std::unique_ptr<Expr> value = nullptr;
+        AstPtr<Expr> value = nullptr;
         if (!check(TokenType::Semicolon)) {
             value = expression();
         }
         consume(TokenType::Semicolon, "Expect ';' after return value.");
-        return std::make_unique<ReturnStmt>(keyword, std::move(value));
+        return make<ReturnStmt>(keyword, std::move(value));
     }
-    if (match({TokenType::LBrace})) {
-        return std::make_unique<BlockStmt>(block());
+    if (match(TokenType::LBrace)) {
+        return make<BlockStmt>(block());
     }
     return expression_statement();
 }
 
-std::unique_ptr<Stmt> Parser::loop_statement() {
+AstPtr<Stmt> Parser::loop_statement() {
     LoopStmt::BoundKind loop_bound_kind = LoopStmt::BoundKind::None;
     std::optional<std::int64_t> loop_bound_value;
     Token loop_attr{};
-    std::unique_ptr<Expr> guard_expr;
+    AstPtr<Expr> guard_expr;
     bool saw_annotation = parse_loop_annotation(loop_bound_kind, loop_bound_value, loop_attr, guard_expr);
 
     Token loop_token = consume(TokenType::Loop, "Expect 'loop' keyword.");
@@ -369,193 +418,193 @@ std::unique_ptr<Stmt> Parser::loop_statement() {
 
     consume(TokenType::LBrace, "Expect '{' after 'loop'.");
     auto body = block();
-    return std::make_unique<LoopStmt>(loop_token, loop_bound_kind, loop_bound_value,
+    return make<LoopStmt>(loop_token, loop_bound_kind, loop_bound_value,
                                       std::move(guard_expr), std::move(body));
 }
 
 // Parses a block of statements.
 // block -> "{" declaration* "}" ;
-std::vector<std::unique_ptr<Stmt>> Parser::block() {
-    std::vector<std::unique_ptr<Stmt>> statements;
+AstList<AstPtr<Stmt>> Parser::block() {
+    std::vector<AstPtr<Stmt>> statements;
     while (!check(TokenType::RBrace) && !is_at_end()) {
         statements.push_back(declaration());
     }
     consume(TokenType::RBrace, "Expect '}' after block.");
-    return statements;
+    return list(std::move(statements));
 }
 
 // Parses an expression statement.
 // expr_stmt -> expression ";" ;
-std::unique_ptr<Stmt> Parser::expression_statement() {
-    std::unique_ptr<Expr> expr = expression();
+AstPtr<Stmt> Parser::expression_statement() {
+    AstPtr<Expr> expr = expression();
     consume(TokenType::Semicolon, "Expect ';' after expression.");
-    return std::make_unique<ExpressionStmt>(std::move(expr));
+    return make<ExpressionStmt>(std::move(expr));
 }
 
 // Parses an expression.
 // expression -> assignment ;
-std::unique_ptr<Expr> Parser::expression() {
+AstPtr<Expr> Parser::expression() {
     return assignment();
 }
 
 // Parses an assignment expression.
 // assignment -> IDENTIFIER "=" assignment | equality ;
-std::unique_ptr<Expr> Parser::assignment() {
-    std::unique_ptr<Expr> expr = logical_or();
-    if (match({TokenType::Equal})) {
+AstPtr<Expr> Parser::assignment() {
+    AstPtr<Expr> expr = logical_or();
+    if (match(TokenType::Equal)) {
         Token equals = previous();
-        std::unique_ptr<Expr> value = assignment();
+        AstPtr<Expr> value = assignment();
         if (auto* var_expr = dynamic_cast<VariableExpr*>(expr.get())) {
             Token name = var_expr->name;
-            return std::make_unique<AssignExpr>(name, std::move(value));
+            return make<AssignExpr>(name, std::move(value));
         }
         report_error(equals, "Invalid assignment target");
     }
     return expr;
 }
 
-std::unique_ptr<Expr> Parser::logical_or() {
-    std::unique_ptr<Expr> expr = logical_and();
-    while (match({TokenType::PipePipe})) {
+AstPtr<Expr> Parser::logical_or() {
+    AstPtr<Expr> expr = logical_and();
+    while (match(TokenType::PipePipe)) {
         Token op = previous();
-        std::unique_ptr<Expr> right = logical_and();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(right));
+        AstPtr<Expr> right = logical_and();
+        expr = make<BinaryExpr>(std::move(expr), op, std::move(right));
     }
     return expr;
 }
 
-std::unique_ptr<Expr> Parser::logical_and() {
-    std::unique_ptr<Expr> expr = equality();
-    while (match({TokenType::AmpAmp})) {
+AstPtr<Expr> Parser::logical_and() {
+    AstPtr<Expr> expr = equality();
+    while (match(TokenType::AmpAmp)) {
         Token op = previous();
-        std::unique_ptr<Expr> right = equality();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(right));
+        AstPtr<Expr> right = equality();
+        expr = make<BinaryExpr>(std::move(expr), op, std::move(right));
     }
     return expr;
 }
 
 // Parses an equality expression.
 // equality -> comparison ( ( "!=" | "==" ) comparison )* ;
-std::unique_ptr<Expr> Parser::equality() {
-    std::unique_ptr<Expr> expr = comparison();
-    while (match({TokenType::BangEqual, TokenType::EqualEqual})) {
+AstPtr<Expr> Parser::equality() {
+    AstPtr<Expr> expr = comparison();
+    while (match(kEqualityOps)) {
         Token op = previous();
-        std::unique_ptr<Expr> right = comparison();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(right));
+        AstPtr<Expr> right = comparison();
+        expr = make<BinaryExpr>(std::move(expr), op, std::move(right));
     }
     return expr;
 }
 
 // Parses a comparison expression.
 // comparison -> term ( ( ">" | ">=" | "<" | "<=" ) term )* ;
-std::unique_ptr<Expr> Parser::comparison() {
-    std::unique_ptr<Expr> expr = term();
-    while (match({TokenType::Greater, TokenType::GreaterEqual, TokenType::Less, TokenType::LessEqual})) {
+AstPtr<Expr> Parser::comparison() {
+    AstPtr<Expr> expr = term();
+    while (match(kComparisonOps)) {
         Token op = previous();
-        std::unique_ptr<Expr> right = term();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(right));
+        AstPtr<Expr> right = term();
+        expr = make<BinaryExpr>(std::move(expr), op, std::move(right));
     }
     return expr;
 }
 
 // Parses an addition/subtraction expression.
 // term -> factor ( ( "-" | "+" ) factor )* ;
-std::unique_ptr<Expr> Parser::term() {
-    std::unique_ptr<Expr> expr = factor();
-    while (match({TokenType::Minus, TokenType::Plus})) {
+AstPtr<Expr> Parser::term() {
+    AstPtr<Expr> expr = factor();
+    while (match(kTermOps)) {
         Token op = previous();
-        std::unique_ptr<Expr> right = factor();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(right));
+        AstPtr<Expr> right = factor();
+        expr = make<BinaryExpr>(std::move(expr), op, std::move(right));
     }
     return expr;
 }
 
 // Parses a multiplication/division/modulo expression.
 // factor -> unary ( ( "/" | "*" | "%" ) unary )* ;
-std::unique_ptr<Expr> Parser::factor() {
-    std::unique_ptr<Expr> expr = unary();
-    while (match({TokenType::Slash, TokenType::Star, TokenType::Percent})) {
+AstPtr<Expr> Parser::factor() {
+    AstPtr<Expr> expr = unary();
+    while (match(kFactorOps)) {
         Token op = previous();
-        std::unique_ptr<Expr> right = unary();
-        expr = std::make_unique<BinaryExpr>(std::move(expr), op, std::move(right));
+        AstPtr<Expr> right = unary();
+        expr = make<BinaryExpr>(std::move(expr), op, std::move(right));
     }
     return expr;
 }
 
 // Parses a unary expression.
 // unary -> ( "!" | "-" ) unary | call ;
-std::unique_ptr<Expr> Parser::unary() {
-    if (match({TokenType::Bang, TokenType::Minus})) {
+AstPtr<Expr> Parser::unary() {
+    if (match(kUnaryOps)) {
         Token op = previous();
-        std::unique_ptr<Expr> right = unary();
-        return std::make_unique<UnaryExpr>(op, std::move(right));
+        AstPtr<Expr> right = unary();
+        return make<UnaryExpr>(op, std::move(right));
     }
     return primary();
 }
 
 // Parses a primary expression, which is the highest-precedence expression.
 // primary -> "false" | "true" | INTEGER | FLOAT | STRING | "(" expression ")" | IDENTIFIER ;
-std::unique_ptr<Expr> Parser::primary() {
-    if (match({TokenType::Match})) {
+AstPtr<Expr> Parser::primary() {
+    if (match(TokenType::Match)) {
         return match_expression();
     }
 
-    if (match({TokenType::False, TokenType::True, TokenType::Integer, TokenType::Float, TokenType::String})) {
-        return std::make_unique<LiteralExpr>(previous());
+    if (match(kLiteralTokens)) {
+        return make<LiteralExpr>(previous());
     }
 
-    if (match({TokenType::LBracket})) {
+    if (match(TokenType::LBracket)) {
         Token bracket = previous();
-        std::vector<std::unique_ptr<Expr>> elements;
+        std::vector<AstPtr<Expr>> elements;
         if (!check(TokenType::RBracket)) {
             do {
                 elements.push_back(expression());
-            } while (match({TokenType::Comma}));
+            } while (match(TokenType::Comma));
         }
         consume(TokenType::RBracket, "Expect ']' after vector literal.");
-        return std::make_unique<VectorLiteralExpr>(bracket, std::move(elements));
+        return make<VectorLiteralExpr>(bracket, list(std::move(elements)));
     }
 
-    if (match({TokenType::LParen})) {
-        std::unique_ptr<Expr> expr = expression();
+    if (match(TokenType::LParen)) {
+        AstPtr<Expr> expr = expression();
         consume(TokenType::RParen, "Expect ')' after expression.");
-        return std::make_unique<GroupingExpr>(std::move(expr));
+        return make<GroupingExpr>(std::move(expr));
     }
 
-    if (match({TokenType::Identifier})) {
+    if (match(TokenType::Identifier)) {
         Token name = previous();
         Token enum_name_token;
         Token variant_token;
         if (try_parse_enum_literal(name, enum_name_token, variant_token)) {
-            std::unique_ptr<Expr> payload = nullptr;
-            if (match({TokenType::LParen})) {
+            AstPtr<Expr> payload = nullptr;
+            if (match(TokenType::LParen)) {
                 payload = expression();
                 consume(TokenType::RParen, "Expect ')' after enum variant payload.");
             }
-            return std::make_unique<EnumLiteralExpr>(enum_name_token, variant_token, std::move(payload));
+            return make<EnumLiteralExpr>(enum_name_token, variant_token, std::move(payload));
         }
         if (check(TokenType::LBracket)) {
             return parse_generic_type(name);
         }
-        if (match({TokenType::LBrace})) {
+        if (match(TokenType::LBrace)) {
             return record_literal(std::move(name));
         }
-        std::unique_ptr<Expr> expr;
-        if (match({TokenType::LParen})) {
-            std::vector<std::unique_ptr<Expr>> arguments;
+        AstPtr<Expr> expr;
+        if (match(TokenType::LParen)) {
+            std::vector<AstPtr<Expr>> arguments;
             if (!check(TokenType::RParen)) {
                 do {
                     arguments.push_back(expression());
-                } while (match({TokenType::Comma}));
+                } while (match(TokenType::Comma));
             }
             Token paren = consume(TokenType::RParen, "Expect ')' after arguments.");
-            expr = std::make_unique<CallExpr>(std::make_unique<VariableExpr>(name), paren, std::move(arguments));
+            expr = make<CallExpr>(make<VariableExpr>(name), paren, list(std::move(arguments)));
         } else {
-            expr = std::make_unique<VariableExpr>(name);
+            expr = make<VariableExpr>(name);
         }
-        while (match({TokenType::Dot})) {
+        while (match(TokenType::Dot)) {
             Token field = consume(TokenType::Identifier, "Expect field name after '.'.");
-            expr = std::make_unique<FieldAccessExpr>(std::move(expr), field);
+            expr = make<FieldAccessExpr>(std::move(expr), field);
         }
         return expr;
     }
@@ -564,60 +613,62 @@ std::unique_ptr<Expr> Parser::primary() {
     throw std::runtime_error("Expect expression.");
 }
 
-std::unique_ptr<Expr> Parser::match_expression() {
+AstPtr<Expr> Parser::match_expression() {
     consume(TokenType::LParen, "Expect '(' after 'match'.");
-    std::unique_ptr<Expr> scrutinee = expression();
+    AstPtr<Expr> scrutinee = expression();
     consume(TokenType::RParen, "Expect ')' after match scrutinee.");
     consume(TokenType::LBrace, "Expect '{' before match arms.");
 
     std::vector<MatchArm> arms;
     while (!check(TokenType::RBrace) && !is_at_end()) {
         arms.push_back(match_arm());
-        if (match({TokenType::Semicolon, TokenType::Comma})) {
+        if (match(kListSeparators)) {
             continue;
         }
         break;
     }
 
     consume(TokenType::RBrace, "Expect '}' after match arms.");
-    return std::make_unique<MatchExpr>(std::move(scrutinee), std::move(arms));
+    return make<MatchExpr>(scrutinee, list(std::move(arms)));
 }
 
-std::unique_ptr<Expr> Parser::record_literal(Token type_name) {
-    std::vector<std::pair<Token, std::unique_ptr<Expr>>> fields;
+AstPtr<Expr> Parser::record_literal(Token type_name) {
+    std::vector<std::pair<Token, AstPtr<Expr>>> fields;
     if (!check(TokenType::RBrace)) {
         do {
             Token field_name = consume(TokenType::Identifier, "Expect field name in record literal.");
             consume(TokenType::Colon, "Expect ':' after field name.");
             auto value = expression();
             fields.emplace_back(field_name, std::move(value));
-        } while (match({TokenType::Comma, TokenType::Semicolon}));
+        } while (match(kListSeparators));
     }
     consume(TokenType::RBrace, "Expect '}' after record literal.");
-    return std::make_unique<RecordLiteralExpr>(type_name, std::move(fields));
+    return make<RecordLiteralExpr>(type_name, list(std::move(fields)));
 }
 
 MatchPattern Parser::parse_match_pattern() {
     MatchPattern pattern;
-    if (match({TokenType::LBrace})) {
+    if (match(TokenType::LBrace)) {
         pattern.kind = MatchPattern::Kind::Record;
+        std::vector<std::pair<Token, Token>> record_bindings;
         if (!check(TokenType::RBrace)) {
             do {
                 Token field_name = consume(TokenType::Identifier, "Expect field name in record pattern.");
                 Token binding = field_name;
-                if (match({TokenType::Colon})) {
+                if (match(TokenType::Colon)) {
                     binding = consume(TokenType::Identifier, "Expect binding name after ':' in record pattern.");
                 }
-                pattern.record_bindings.emplace_back(field_name, binding);
-            } while (match({TokenType::Comma, TokenType::Semicolon}));
+                record_bindings.emplace_back(field_name, binding);
+            } while (match(kListSeparators));
         }
         consume(TokenType::RBrace, "Expect '}' after record pattern.");
+        pattern.record_bindings = list(std::move(record_bindings));
         return pattern;
     }
 
-    if (match({TokenType::Identifier})) {
+    if (match(TokenType::Identifier)) {
         Token first = previous();
-        if (match({TokenType::LParen})) {
+        if (match(TokenType::LParen)) {
             MatchPattern nested;
             if (!check(TokenType::RParen)) {
                 nested = parse_match_pattern();
@@ -628,19 +679,19 @@ MatchPattern Parser::parse_match_pattern() {
             if (nested.kind != MatchPattern::Kind::None ||
                 !nested.tuple_bindings.empty() ||
                 !nested.record_bindings.empty() ||
-                nested.binding_is_wildcard ||
-                nested.variant_name.type != TokenType::Illegal) {
-                pattern.variant_payload = std::make_unique<MatchPattern>(std::move(nested));
+                nested.binding_is_wildcard) {
+                pattern.variant_payload = make<MatchPattern>(nested);
             }
             return pattern;
         }
-        if (match({TokenType::Comma})) {
+        if (match(TokenType::Comma)) {
             pattern.kind = MatchPattern::Kind::Tuple;
-            pattern.tuple_bindings.push_back(first);
+            std::vector<Token> tuple_bindings{first};
             do {
                 Token binding = consume(TokenType::Identifier, "Expect binding identifier in tuple pattern.");
-                pattern.tuple_bindings.push_back(binding);
-            } while (match({TokenType::Comma}));
+                tuple_bindings.push_back(binding);
+            } while (match(TokenType::Comma));
+            pattern.tuple_bindings = list(std::move(tuple_bindings));
             return pattern;
         }
         pattern.kind = MatchPattern::Kind::Identifier;
@@ -657,28 +708,28 @@ MatchArm Parser::match_arm() {
     Token keyword = consume(TokenType::Identifier, "Expect match arm variant.");
     MatchPattern pattern;
 
-    if (match({TokenType::LParen})) {
+    if (match(TokenType::LParen)) {
         if (!check(TokenType::RParen)) {
             pattern = parse_match_pattern();
         }
         consume(TokenType::RParen, "Expect ')' after match binding.");
     }
 
-    std::unique_ptr<Expr> guard = nullptr;
-    if (match({TokenType::If})) {
+    AstPtr<Expr> guard = nullptr;
+    if (match(TokenType::If)) {
         guard = expression();
     }
 
     consume(TokenType::FatArrow, "Expect '=>' after match arm pattern.");
-    std::unique_ptr<Expr> body = expression();
+    AstPtr<Expr> body = expression();
     return MatchArm(keyword, std::move(pattern), std::move(guard), std::move(body));
 }
 
 bool Parser::parse_loop_annotation(LoopStmt::BoundKind& bound_kind,
                                   std::optional<std::int64_t>& bound_value,
                                   Token& attr_token,
-                                  std::unique_ptr<Expr>& guard_expr) {
-    if (!match({TokenType::At})) {
+                                  AstPtr<Expr>& guard_expr) {
+    if (!match(TokenType::At)) {
         return false;
     }
     Token name = consume(TokenType::Identifier, "Expect attribute name after '@'.");
@@ -691,9 +742,9 @@ bool Parser::parse_loop_annotation(LoopStmt::BoundKind& bound_kind,
     consume(TokenType::LParen, "Expect '(' after annotation name.");
     bound_kind = LoopStmt::BoundKind::None;
     bound_value.reset();
-    guard_expr.reset();
+    guard_expr = nullptr;
     Token arg;
-    if (match({TokenType::Identifier, TokenType::Loop})) {
+    if (match(kLoopBoundArgTokens)) {
         arg = previous();
         std::string_view lexeme{arg.lexeme};
         if (lexeme == "infinite") {
@@ -706,7 +757,7 @@ bool Parser::parse_loop_annotation(LoopStmt::BoundKind& bound_kind,
         } else {
             report_error(arg, "'@bounded' only accepts 'infinite', an integer, or 'loop(...)'");
         }
-    } else if (match({TokenType::Integer})) {
+    } else if (match(TokenType::Integer)) {
         arg = previous();
         try {
             bound_kind = LoopStmt::BoundKind::Static;
@@ -726,7 +777,7 @@ std::optional<StructuralAttributes> Parser::parse_structural_attributes() {
     StructuralAttributes attrs;
     bool seen = false;
     while (check(TokenType::At)) {
-        Token lookahead = _lexer.peek_next_token();
+        Token lookahead = peek_next_token();
         if (lookahead.type != TokenType::Identifier) {
             break;
         }
@@ -734,7 +785,7 @@ std::optional<StructuralAttributes> Parser::parse_structural_attributes() {
         if (attr_candidate != "schema" && attr_candidate != "module") {
             break;
         }
-        match({TokenType::At});
+        match(TokenType::At);
         Token name = consume(TokenType::Identifier, "Expect attribute name after '@'.");
         std::string attr_name{name.lexeme};
         if (!seen) {
@@ -764,7 +815,7 @@ std::optional<StructuralAttributes> Parser::parse_structural_attributes() {
             }
             Token segment = consume(TokenType::Identifier, "Expect module name.");
             std::string path(segment.lexeme);
-            while (match({TokenType::Dot})) {
+            while (match(TokenType::Dot)) {
                 Token next = consume(TokenType::Identifier, "Expect module segment after '.'.");
                 path.push_back('.');
                 path.append(next.lexeme.data(), next.lexeme.size());
@@ -789,16 +840,16 @@ std::optional<Parser::FunctionAttributesParse> Parser::parse_function_attributes
     FunctionAttributesParse attrs;
     bool seen = false;
     while (check(TokenType::At)) {
-        Token lookahead = _lexer.peek_next_token();
+        Token lookahead = peek_next_token();
         if (lookahead.type != TokenType::Identifier) {
             break;
         }
         std::string attr_candidate{lookahead.lexeme};
-        if (attr_candidate != "effect" && attr_candidate != "tier") {
+        if (attr_candidate != "effect" && attr_candidate != "tailrec" && attr_candidate != "tier") {
             break;
         }
 
-        match({TokenType::At});
+        match(TokenType::At);
         Token name = consume(TokenType::Identifier, "Expect attribute name after '@'.");
         if (!seen) {
             attrs.anchor = name;
@@ -810,6 +861,10 @@ std::optional<Parser::FunctionAttributesParse> Parser::parse_function_attributes
             attrs.attributes.is_effectful = true;
             continue;
         }
+        if (attr_name == "tailrec") {
+            attrs.attributes.is_tailrec = true;
+            continue;
+        }
 
         consume(TokenType::LParen, "Expect '(' after '@tier'.");
         Token value = consume(TokenType::Integer, "Expect integer tier value.");
@@ -853,17 +908,20 @@ bool Parser::try_parse_enum_literal(const Token& token, Token& enum_name, Token&
     if (!is_upper(enum_part) || !is_upper(variant_part)) {
         return false;
     }
+    auto& identifiers = IdentifierInterner::global();
     enum_name = token;
     enum_name.lexeme = enum_part;
+    enum_name.symbol = identifiers.intern(enum_part);
     variant_name = token;
     variant_name.lexeme = variant_part;
+    variant_name.symbol = identifiers.intern(variant_part);
     variant_name.column = token.column + static_cast<int>(dot_pos + 1);
     return true;
 }
 
-std::unique_ptr<GenericTypeExpr> Parser::parse_generic_type(Token name) {
+AstPtr<GenericTypeExpr> Parser::parse_generic_type(Token name) {
     consume(TokenType::LBracket, "Expect '[' after generic type name.");
-    std::array<std::unique_ptr<Expr>, 8> parameters;
+    std::array<AstPtr<Expr>, 8> parameters;
     size_t param_count = 0;
     std::string_view type_name{name.lexeme};
 
@@ -871,7 +929,7 @@ std::unique_ptr<GenericTypeExpr> Parser::parse_generic_type(Token name) {
     parameters[param_count++] = type();
 
     // Subsequent parameters are constant value expressions (structural-result types are treated specially).
-    while (match({TokenType::Comma})) {
+    while (match(TokenType::Comma)) {
         if (param_count >= 8) {
             report_error(peek(), "Too many generic parameters (max 8)");
             return nullptr;
@@ -888,20 +946,16 @@ std::unique_ptr<GenericTypeExpr> Parser::parse_generic_type(Token name) {
     }
 
     consume(TokenType::RBracket, "Expect ']' after type parameters.");
-    return std::make_unique<GenericTypeExpr>(name, std::move(parameters), param_count);
+    return make<GenericTypeExpr>(name, parameters, param_count);
 }
 
 bool Parser::is_type_start() {
-    return check(TokenType::Identifier) ||
-           check(TokenType::I32) || check(TokenType::I16) || check(TokenType::I8) || check(TokenType::I2) ||
-           check(TokenType::Bool) || check(TokenType::Void) ||
-           check(TokenType::T81BigInt) || check(TokenType::T81Float) || check(TokenType::T81Fraction) ||
-           check(TokenType::Vector) || check(TokenType::Matrix) || check(TokenType::Tensor) || check(TokenType::Graph);
+    return !is_at_end() && kTypeStartTokens.contains(_current.type);
 }
 
 // Parses a type expression.
 // type -> (IDENTIFIER | primitive_type_keyword) ( "[" type ( "," expression )* "]" )? ;
-std::unique_ptr<TypeExpr> Parser::type() {
+AstPtr<TypeExpr> Parser::type() {
     if (!is_type_start()) {
         report_error(peek(), "Expect type name");
         return nullptr;
@@ -918,7 +972,7 @@ std::unique_ptr<TypeExpr> Parser::type() {
         return parse_generic_type(name);
     }
 
-    return std::make_unique<SimpleTypeExpr>(name);
+    return make<SimpleTypeExpr>(name);
 }
 
 } // namespace frontend
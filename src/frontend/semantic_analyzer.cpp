@@ -8,9 +8,12 @@ thread_local int type_to_string_depth = 0;
 #endif
 
 #include "t81/frontend/semantic_analyzer.hpp"
+#include "t81/support/work_stealing_pool.hpp"
 #include <cstdlib>
+#include <exception>
 #include <iostream>
 #include <algorithm>
+#include <latch>
 #include <sstream>
 #include <string_view>
 #include <utility>
@@ -49,22 +52,7 @@ std::optional<float> parse_numeric_literal_value(const t81::frontend::Token& tok
 namespace t81 {
 namespace frontend {
 
-Type Type::constant(std::string repr) {
-    Type t;
-    t.kind = Kind::Constant;
-    t.custom_name = std::move(repr);
-    return t;
-}
-
-bool Type::operator==(const Type& other) const {
-    if (kind != other.kind) return false;
-    if (kind == Kind::Custom || kind == Kind::Constant) {
-        return custom_name == other.custom_name;
-    }
-    return params == other.params;
-}
-
-SemanticAnalyzer::SemanticAnalyzer(const std::vector<std::unique_ptr<Stmt>>& statements,
+SemanticAnalyzer::SemanticAnalyzer(std::span<const AstPtr<Stmt>> statements,
                                    std::string source_name)
     : _statements(statements),
       _source_name(std::move(source_name)) {
@@ -76,7 +64,7 @@ void SemanticAnalyzer::analyze() {
     // First pass: declare all functions at global scope
     for (const auto& stmt : _statements) {
         if (auto* func = dynamic_cast<const FunctionStmt*>(stmt.get())) {
-            if (is_defined_in_current_scope(std::string(func->name.lexeme))) {
+            if (is_defined_in_current_scope(func->name)) {
                 error(func->name, "Function '" + std::string(func->name.lexeme) + "' is already defined.");
             } else {
                 define_symbol(func->name, SymbolKind::Function);
@@ -88,20 +76,191 @@ void SemanticAnalyzer::analyze() {
     // when definitions appear later in the source.
     register_function_signatures();
 
-    // Third pass: analyze all statements and bodies
+    // Third pass: analyze all statements and bodies. Consecutive functions
+    // whose bodies declare nothing global see the same tables, so each such
+    // run is checked as one batch (in parallel when a pool is attached).
+    std::vector<const FunctionStmt*> run;
     for (const auto& stmt : _statements) {
-        if (stmt) {  // Skip null statements from parse errors
-            analyze(*stmt);
+        if (!stmt) continue;  // Skip null statements from parse errors
+        if (stmt->kind == StmtKind::Function) {
+            const auto& func = static_cast<const FunctionStmt&>(*stmt);
+            if (body_is_independent(func)) {
+                run.push_back(&func);
+                continue;
+            }
+        }
+        check_function_bodies(run);
+        run.clear();
+        analyze(*stmt);
+    }
+    check_function_bodies(run);
+}
+
+SemanticAnalyzer::SemanticAnalyzer(const SemanticAnalyzer& parent, WorkerTag)
+    : _statements(parent._statements),
+      _source_name(parent._source_name),
+      _scopes(parent._scopes),
+      _generic_arities(parent._generic_arities),
+      _defined_generics(parent._defined_generics),
+      _type_aliases(parent._type_aliases),
+      _record_definitions(parent._record_definitions),
+      _enum_definitions(parent._enum_definitions),
+      _declared_module(parent._declared_module),
+      _imports(parent._imports) {}
+
+// Type, record, enum, module and import declarations update the analyzer's
+// global tables even when nested in a block, so a body containing one has
+// to be checked in source order with everything else.
+bool SemanticAnalyzer::body_is_independent(const FunctionStmt& func) {
+    std::vector<const Stmt*> pending;
+    for (const auto& stmt : func.body) pending.push_back(stmt.get());
+    while (!pending.empty()) {
+        const Stmt* stmt = pending.back();
+        pending.pop_back();
+        if (!stmt) return false;
+        switch (stmt->kind) {
+            case StmtKind::Module:
+            case StmtKind::Import:
+            case StmtKind::TypeDecl:
+            case StmtKind::Record:
+            case StmtKind::Enum:
+                return false;
+            case StmtKind::Block:
+                for (const auto& inner : static_cast<const BlockStmt&>(*stmt).statements) pending.push_back(inner.get());
+                break;
+            case StmtKind::If: {
+                const auto& branch = static_cast<const IfStmt&>(*stmt);
+                pending.push_back(branch.then_branch.get());
+                if (branch.else_branch) pending.push_back(branch.else_branch.get());
+                break;
+            }
+            case StmtKind::While:
+                pending.push_back(static_cast<const WhileStmt&>(*stmt).body.get());
+                break;
+            case StmtKind::Loop:
+                for (const auto& inner : static_cast<const LoopStmt&>(*stmt).body) pending.push_back(inner.get());
+                break;
+            case StmtKind::Function:
+                for (const auto& inner : static_cast<const FunctionStmt&>(*stmt).body) pending.push_back(inner.get());
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+// Checks a run of function bodies. Workers each copy the declaration tables
+// and global scope, check a contiguous slice of the run into their own
+// diagnostics and side tables, and the results are merged back in source
+// order, so loop ids, metadata order and diagnostics match a serial pass.
+//
+// The one global a body can write is `_generic_arities` (first use of an
+// undeclared generic registers its arity). Workers see only the arities
+// registered by the function itself; a function that registered a name an
+// earlier function in the run also registered is re-checked serially.
+void SemanticAnalyzer::check_function_bodies(std::span<const FunctionStmt* const> functions) {
+    constexpr std::size_t kMinParallelBodies = 4;
+    if (!_pool || _pool->size() < 2 || functions.size() < kMinParallelBodies) {
+        for (const auto* func : functions) analyze(*func);
+        return;
+    }
+
+    struct BodyResult {
+        SemanticAnalyzer* worker = nullptr;
+        size_t diag_begin = 0, diag_end = 0;
+        size_t loop_begin = 0, loop_end = 0;
+        size_t match_begin = 0, match_end = 0;
+        std::vector<std::pair<std::string, size_t>> arities;
+    };
+    std::vector<BodyResult> results(functions.size());
+
+    const std::size_t chunks = std::min(functions.size(), _pool->size() * 4);
+    std::vector<std::unique_ptr<SemanticAnalyzer>> workers(chunks);
+    std::vector<std::exception_ptr> errors(chunks);
+    std::latch done(static_cast<std::ptrdiff_t>(chunks));
+
+    for (std::size_t c = 0; c < chunks; ++c) {
+        _pool->submit([&, c] {
+            try {
+                workers[c].reset(new SemanticAnalyzer(*this, WorkerTag{}));
+                SemanticAnalyzer& worker = *workers[c];
+                const std::size_t begin = functions.size() * c / chunks;
+                const std::size_t end = functions.size() * (c + 1) / chunks;
+                for (std::size_t i = begin; i < end; ++i) {
+                    BodyResult& result = results[i];
+                    result.worker = &worker;
+                    result.diag_begin = worker._diagnostics.size();
+                    result.loop_begin = worker._loop_metadata.size();
+                    result.match_begin = worker._match_metadata.size();
+                    worker._arity_log = &result.arities;
+                    worker.analyze(*functions[i]);
+                    worker._arity_log = nullptr;
+                    result.diag_end = worker._diagnostics.size();
+                    result.loop_end = worker._loop_metadata.size();
+                    result.match_end = worker._match_metadata.size();
+                    // Hide this body's registrations from the next one.
+                    for (const auto& [name, arity] : result.arities) worker._generic_arities.erase(name);
+                }
+            } catch (...) {
+                errors[c] = std::current_exception();
+            }
+            done.count_down();
+        });
+    }
+    done.wait();
+    for (auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    for (auto& worker : workers) {
+        _expr_type_cache.merge(std::move(worker->_expr_type_cache));
+        _vector_literal_data.merge(std::move(worker->_vector_literal_data));
+        _body_facts.merge(std::move(worker->_body_facts));
+    }
+
+    std::unordered_set<std::string> registered;
+    for (std::size_t i = 0; i < functions.size(); ++i) {
+        BodyResult& result = results[i];
+        const bool stale = std::any_of(result.arities.begin(), result.arities.end(),
+                                       [&](const auto& entry) { return registered.count(entry.first) != 0; });
+        if (stale) {
+            std::vector<std::pair<std::string, size_t>> arities;
+            _arity_log = &arities;
+            analyze(*functions[i]);
+            _arity_log = nullptr;
+            for (const auto& entry : arities) registered.insert(entry.first);
+            continue;
+        }
+
+        SemanticAnalyzer& worker = *result.worker;
+        for (size_t d = result.diag_begin; d < result.diag_end; ++d) {
+            _had_error = true;
+            _diagnostics.push_back(std::move(worker._diagnostics[d]));
+        }
+        for (size_t l = result.loop_begin; l < result.loop_end; ++l) {
+            LoopMetadata meta = std::move(worker._loop_metadata[l]);
+            meta.id = _next_loop_id++;
+            _loop_index[meta.stmt->id] = _loop_metadata.size();
+            _loop_metadata.push_back(std::move(meta));
+        }
+        for (size_t m = result.match_begin; m < result.match_end; ++m) {
+            _match_index[worker._match_metadata[m].expr->id] = _match_metadata.size();
+            _match_metadata.push_back(std::move(worker._match_metadata[m]));
+        }
+        for (auto& [name, arity] : result.arities) {
+            registered.insert(name);
+            _generic_arities.emplace(std::move(name), arity);
         }
     }
 }
 
 void SemanticAnalyzer::analyze(const Stmt& stmt) {
-    stmt.accept(*this);
+    visit_stmt(stmt);
 }
 
-std::any SemanticAnalyzer::analyze(const Expr& expr) {
-    return expr.accept(*this);
+Type SemanticAnalyzer::analyze(const Expr& expr) {
+    return visit_expr(expr);
 }
 
 void SemanticAnalyzer::error(const Token& token, const std::string& message) {
@@ -118,37 +277,30 @@ void SemanticAnalyzer::error_at(const Token& token, const std::string& message)
 // --- Symbol Table Operations ---
 
 void SemanticAnalyzer::enter_scope() {
-    _scopes.emplace_back();
+    _scopes.enter_scope();
 }
 
 void SemanticAnalyzer::exit_scope() {
-    if (!_scopes.empty()) {
-        _scopes.pop_back();
-    }
+    _scopes.exit_scope();
+}
+
+// Identifier tokens arrive with their SymbolId from the lexer; tokens the
+// analyzer synthesizes itself may not, so fall back to interning the lexeme.
+SymbolId SemanticAnalyzer::symbol_of(const Token& name) {
+    if (name.symbol != kEmptySymbol || name.lexeme.empty()) return name.symbol;
+    return IdentifierInterner::global().intern(name.lexeme);
 }
 
 void SemanticAnalyzer::define_symbol(const Token& name, SymbolKind kind) {
-    if (!_scopes.empty()) {
-        std::string name_str = std::string(name.lexeme);
-        _scopes.back()[name_str] = SemanticSymbol{kind, name, Type{}, {}, false, std::nullopt, false};
-    }
+    _scopes.define(symbol_of(name), SemanticSymbol{kind, name, Type{}, {}, false, std::nullopt, false});
 }
 
 SemanticSymbol* SemanticAnalyzer::resolve_symbol(const Token& name) {
-    std::string name_str = std::string(name.lexeme);
-    // Search from innermost to outermost scope
-    for (auto it = _scopes.rbegin(); it != _scopes.rend(); ++it) {
-        auto found = it->find(name_str);
-        if (found != it->end()) {
-            return &found->second;
-        }
-    }
-    return nullptr;
+    return _scopes.lookup(symbol_of(name));
 }
 
-bool SemanticAnalyzer::is_defined_in_current_scope(const std::string& name) const {
-    if (_scopes.empty()) return false;
-    return _scopes.back().find(name) != _scopes.back().end();
+bool SemanticAnalyzer::is_defined_in_current_scope(const Token& name) const {
+    return _scopes.defined_in_current_scope(symbol_of(name));
 }
 
 Type SemanticAnalyzer::make_error_type() {
@@ -156,7 +308,7 @@ Type SemanticAnalyzer::make_error_type() {
 }
 
 int SemanticAnalyzer::numeric_rank(const Type& type) const {
-    switch (type.kind) {
+    switch (type.kind()) {
         case Type::Kind::I2: return 1;
         case Type::Kind::I8: return 2;
         case Type::Kind::I16: return 3;
@@ -173,7 +325,7 @@ bool SemanticAnalyzer::is_numeric(const Type& type) const {
 }
 
 bool SemanticAnalyzer::is_integer_type(const Type& type) const {
-    switch (type.kind) {
+    switch (type.kind()) {
         case Type::Kind::I2:
         case Type::Kind::I8:
         case Type::Kind::I16:
@@ -186,11 +338,11 @@ bool SemanticAnalyzer::is_integer_type(const Type& type) const {
 }
 
 bool SemanticAnalyzer::is_float_type(const Type& type) const {
-    return type.kind == Type::Kind::Float;
+    return type.kind() == Type::Kind::Float;
 }
 
 bool SemanticAnalyzer::is_fraction_type(const Type& type) const {
-    return type.kind == Type::Kind::Fraction;
+    return type.kind() == Type::Kind::Fraction;
 }
 
 bool SemanticAnalyzer::is_primitive_numeric_type(const Type& type) const {
@@ -198,10 +350,10 @@ bool SemanticAnalyzer::is_primitive_numeric_type(const Type& type) const {
 }
 
 std::optional<Type> SemanticAnalyzer::deduce_numeric_type(const Type& left, const Type& right, const Token& op) {
-    if (left.kind == Type::Kind::Error || right.kind == Type::Kind::Error) {
+    if (left.kind() == Type::Kind::Error || right.kind() == Type::Kind::Error) {
         return make_error_type();
     }
-    if (left.kind == Type::Kind::Unknown || right.kind == Type::Kind::Unknown) {
+    if (left.kind() == Type::Kind::Unknown || right.kind() == Type::Kind::Unknown) {
         return Type{Type::Kind::Unknown};
     }
     if (!is_primitive_numeric_type(left) || !is_primitive_numeric_type(right)) {
@@ -225,10 +377,10 @@ std::optional<Type> SemanticAnalyzer::deduce_numeric_type(const Type& left, cons
     if (is_integer_type(right) && is_fraction_type(left)) {
         return left;
     }
-    if (left.kind == Type::Kind::Float && right.kind == Type::Kind::Float) {
+    if (left.kind() == Type::Kind::Float && right.kind() == Type::Kind::Float) {
         return left;
     }
-    if (left.kind == Type::Kind::Fraction && right.kind == Type::Kind::Fraction) {
+    if (left.kind() == Type::Kind::Fraction && right.kind() == Type::Kind::Fraction) {
         return left;
     }
 
@@ -238,82 +390,86 @@ std::optional<Type> SemanticAnalyzer::deduce_numeric_type(const Type& left, cons
 }
 
 Type SemanticAnalyzer::refine_generic_type(const Type& declared, const Type& initializer) const {
-    if (declared.kind == Type::Kind::Option && initializer.kind == Type::Kind::Option) {
-        Type result = declared;
-        if (initializer.params.size() >= 1) {
-            if (result.params.empty()) {
-                result.params = initializer.params;
-            } else if (result.params[0].kind == Type::Kind::Unknown) {
-                result.params[0] = initializer.params[0];
+    if (declared.kind() == Type::Kind::Option && initializer.kind() == Type::Kind::Option) {
+        if (initializer.params().size() >= 1) {
+            if (declared.params().empty()) {
+                return declared.with_params(initializer.params());
+            }
+            if (declared.params()[0].kind() == Type::Kind::Unknown) {
+                std::vector<Type> params = declared.params();
+                params[0] = initializer.params()[0];
+                return declared.with_params(std::move(params));
             }
         }
-        return result;
+        return declared;
     }
-    if (declared.kind == Type::Kind::Result && initializer.kind == Type::Kind::Result) {
-        Type result = declared;
-        if (result.params.size() < 2) {
-            result.params.resize(2, Type{Type::Kind::Unknown});
+    if (declared.kind() == Type::Kind::Result && initializer.kind() == Type::Kind::Result) {
+        std::vector<Type> params = declared.params();
+        if (params.size() < 2) {
+            params.resize(2, Type{Type::Kind::Unknown});
         }
-        for (size_t i = 0; i < 2 && i < initializer.params.size(); ++i) {
-            if (result.params[i].kind == Type::Kind::Unknown) {
-                result.params[i] = initializer.params[i];
+        for (size_t i = 0; i < 2 && i < initializer.params().size(); ++i) {
+            if (params[i].kind() == Type::Kind::Unknown) {
+                params[i] = initializer.params()[i];
             }
         }
-        return result;
+        return declared.with_params(std::move(params));
     }
-    if (declared.kind == initializer.kind && declared.kind != Type::Kind::Unknown) {
-        Type result = declared;
-        size_t max_params = std::max(result.params.size(), initializer.params.size());
-        result.params.resize(max_params, Type{Type::Kind::Unknown});
-        for (size_t i = 0; i < initializer.params.size(); ++i) {
-            if (result.params[i].kind == Type::Kind::Unknown) {
-                result.params[i] = initializer.params[i];
+    if (declared.kind() == initializer.kind() && declared.kind() != Type::Kind::Unknown) {
+        std::vector<Type> params = declared.params();
+        size_t max_params = std::max(params.size(), initializer.params().size());
+        params.resize(max_params, Type{Type::Kind::Unknown});
+        for (size_t i = 0; i < initializer.params().size(); ++i) {
+            if (params[i].kind() == Type::Kind::Unknown) {
+                params[i] = initializer.params()[i];
             }
         }
-        return result;
+        return declared.with_params(std::move(params));
     }
     return declared;
 }
 
 void SemanticAnalyzer::merge_expected_params(Type& target, const Type* expected) const {
-    if (!expected || target.kind != expected->kind) {
+    if (!expected || target.kind() != expected->kind()) {
         return;
     }
-    if (target.kind == Type::Kind::Custom && target.custom_name != expected->custom_name) {
+    if (target.kind() == Type::Kind::Custom && target.custom_name() != expected->custom_name()) {
         return;
     }
-    if (target.params.empty() && !expected->params.empty()) {
-        target.params = expected->params;
+    if (target.params().empty() && !expected->params().empty()) {
+        target = target.with_params(expected->params());
         return;
     }
-    size_t max_params = std::max(target.params.size(), expected->params.size());
-    target.params.resize(max_params, Type{Type::Kind::Unknown});
-    for (size_t i = 0; i < expected->params.size(); ++i) {
-        if (target.params[i].kind == Type::Kind::Unknown && expected->params[i].kind != Type::Kind::Unknown) {
-            target.params[i] = expected->params[i];
+    std::vector<Type> params = target.params();
+    size_t max_params = std::max(params.size(), expected->params().size());
+    params.resize(max_params, Type{Type::Kind::Unknown});
+    for (size_t i = 0; i < expected->params().size(); ++i) {
+        if (params[i].kind() == Type::Kind::Unknown && expected->params()[i].kind() != Type::Kind::Unknown) {
+            params[i] = expected->params()[i];
         }
     }
+    target = target.with_params(std::move(params));
 }
 
 bool SemanticAnalyzer::structural_params_assignable(const Type& target, const Type& value) const {
-    size_t count = std::max(target.params.size(), value.params.size());
-    size_t target_defined = target.params.size();
-    size_t value_defined = value.params.size();
+    size_t count = std::max(target.params().size(), value.params().size());
+    size_t target_defined = target.params().size();
+    size_t value_defined = value.params().size();
 
     if (target_defined && value_defined && target_defined != value_defined) {
         return false;
     }
 
     for (size_t i = 0; i < count; ++i) {
-        Type target_param = (i < target.params.size()) ? target.params[i] : Type{Type::Kind::Unknown};
-        Type value_param = (i < value.params.size()) ? value.params[i] : Type{Type::Kind::Unknown};
+        Type target_param = (i < target.params().size()) ? target.params()[i] : Type{Type::Kind::Unknown};
+        Type value_param = (i < value.params().size()) ? value.params()[i] : Type{Type::Kind::Unknown};
 
-        if (target_param.kind == Type::Kind::Constant || value_param.kind == Type::Kind::Constant) {
-            if (target_param.kind == Type::Kind::Constant && value_param.kind == Type::Kind::Constant) {
-                if (target_param.custom_name != value_param.custom_name) {
+        if (target_param.kind() == Type::Kind::Constant || value_param.kind() == Type::Kind::Constant) {
+            if (target_param.kind() == Type::Kind::Constant && value_param.kind() == Type::Kind::Constant) {
+                if (target_param.custom_name() != value_param.custom_name()) {
                     return false;
                 }
-            } else if (target_param.kind == Type::Kind::Unknown || value_param.kind == Type::Kind::Unknown) {
+            } else if (target_param.kind() == Type::Kind::Unknown || value_param.kind() == Type::Kind::Unknown) {
                 // Allow unspecified parameters to align with constants.
             } else {
                 return false;
@@ -349,15 +505,16 @@ Type SemanticAnalyzer::instantiate_alias(const AliasInfo& alias,
 }
 
 void SemanticAnalyzer::enforce_generic_arity(const Type& type, const Token& location) {
-    if (type.kind != Type::Kind::Custom) return;
-    size_t arity = type.params.size();
-    auto it = _generic_arities.find(type.custom_name);
+    if (type.kind() != Type::Kind::Custom) return;
+    size_t arity = type.params().size();
+    auto it = _generic_arities.find(type.custom_name());
     if (it == _generic_arities.end()) {
-        _generic_arities[type.custom_name] = arity;
+        _generic_arities[type.custom_name()] = arity;
+        if (_arity_log) _arity_log->emplace_back(type.custom_name(), arity);
         return;
     }
     if (it->second != arity) {
-        error(location, "Generic type '" + type.custom_name + "' expects " +
+        error(location, "Generic type '" + type.custom_name() + "' expects " +
                         std::to_string(it->second) + " parameters but got " +
                         std::to_string(arity) + ".");
     }
@@ -389,9 +546,8 @@ Type SemanticAnalyzer::type_from_token(const Token& name) {
 }
 
 const std::vector<float>* SemanticAnalyzer::vector_literal_data(const VectorLiteralExpr* expr) const {
-    auto it = _vector_literal_data.find(expr);
-    if (it == _vector_literal_data.end()) return nullptr;
-    return &it->second;
+    if (!expr) return nullptr;
+    return _vector_literal_data.find(expr->id);
 }
 
 std::string SemanticAnalyzer::expr_to_string(const Expr& expr) const {
@@ -457,16 +613,9 @@ Type SemanticAnalyzer::analyze_type_expr(const TypeExpr& expr,
 {
     auto prev_env = _current_type_env;
     _current_type_env = env;
-    auto result = expr.accept(*this);
+    Type result = visit_expr(expr);
     _current_type_env = prev_env;
-    if (result.has_value()) {
-        try {
-            return std::any_cast<Type>(result);
-        } catch (const std::bad_any_cast&) {
-            return make_error_type();
-        }
-    }
-    return make_error_type();
+    return result;
 }
 
 std::string SemanticAnalyzer::type_to_string(const Type& type) const {
@@ -479,7 +628,7 @@ std::string SemanticAnalyzer::type_to_string(const Type& type) const {
 
     std::string result;
 
-    switch (type.kind) {
+    switch (type.kind()) {
         case Type::Kind::Void:     result = "void"; break;
         case Type::Kind::Bool:     result = "bool"; break;
         case Type::Kind::I2:       result = "i2"; break;
@@ -494,21 +643,21 @@ std::string SemanticAnalyzer::type_to_string(const Type& type) const {
         case Type::Kind::Tensor:   result = "Tensor"; break;
         case Type::Kind::Graph:    result = "Graph"; break;
         case Type::Kind::String:   result = "T81String"; break;
-        case Type::Kind::Constant: result = "const(" + type.custom_name + ")"; break;
-        case Type::Kind::Custom:   result = type.custom_name; break;
+        case Type::Kind::Constant: result = "const(" + type.custom_name() + ")"; break;
+        case Type::Kind::Custom:   result = type.custom_name(); break;
         case Type::Kind::Unknown:  result = "<unknown>"; break;
         case Type::Kind::Error:    result = "<error>"; break;
 
         case Type::Kind::Option:
         case Type::Kind::Result: {
             std::ostringstream oss;
-            oss << (type.kind == Type::Kind::Option ? "Option" : "Result");
+            oss << (type.kind() == Type::Kind::Option ? "Option" : "Result");
 
-            if (!type.params.empty()) {
+            if (!type.params().empty()) {
                 oss << '[';
-                for (size_t i = 0; i < type.params.size(); ++i) {
+                for (size_t i = 0; i < type.params().size(); ++i) {
                     if (i > 0) oss << ", ";
-                    oss << type_to_string(type.params[i]);  // now safe
+                    oss << type_to_string(type.params()[i]);  // now safe
                 }
                 oss << ']';
             }
@@ -522,21 +671,21 @@ std::string SemanticAnalyzer::type_to_string(const Type& type) const {
 }
 
 bool SemanticAnalyzer::is_assignable(const Type& target, const Type& value) const {
-    if (target.kind == Type::Kind::Error || value.kind == Type::Kind::Error) return true;
-    if (target.kind == Type::Kind::Unknown || value.kind == Type::Kind::Unknown) return true;
+    if (target.kind() == Type::Kind::Error || value.kind() == Type::Kind::Error) return true;
+    if (target.kind() == Type::Kind::Unknown || value.kind() == Type::Kind::Unknown) return true;
     if (target == value) return true;
 
-    if (target.kind == Type::Kind::Option && value.kind == Type::Kind::Option) {
-        Type target_param = target.params.empty() ? Type{Type::Kind::Unknown} : target.params[0];
-        Type value_param = value.params.empty() ? Type{Type::Kind::Unknown} : value.params[0];
+    if (target.kind() == Type::Kind::Option && value.kind() == Type::Kind::Option) {
+        Type target_param = target.params().empty() ? Type{Type::Kind::Unknown} : target.params()[0];
+        Type value_param = value.params().empty() ? Type{Type::Kind::Unknown} : value.params()[0];
         return is_assignable(target_param, value_param);
     }
 
-    if (target.kind == Type::Kind::Result && value.kind == Type::Kind::Result) {
-        Type target_success = target.params.size() > 0 ? target.params[0] : Type{Type::Kind::Unknown};
-        Type target_error = target.params.size() > 1 ? target.params[1] : Type{Type::Kind::Unknown};
-        Type value_success = value.params.size() > 0 ? value.params[0] : Type{Type::Kind::Unknown};
-        Type value_error = value.params.size() > 1 ? value.params[1] : Type{Type::Kind::Unknown};
+    if (target.kind() == Type::Kind::Result && value.kind() == Type::Kind::Result) {
+        Type target_success = target.params().size() > 0 ? target.params()[0] : Type{Type::Kind::Unknown};
+        Type target_error = target.params().size() > 1 ? target.params()[1] : Type{Type::Kind::Unknown};
+        Type value_success = value.params().size() > 0 ? value.params()[0] : Type{Type::Kind::Unknown};
+        Type value_error = value.params().size() > 1 ? value.params()[1] : Type{Type::Kind::Unknown};
         return is_assignable(target_success, value_success) &&
                is_assignable(target_error, value_error);
     }
@@ -549,35 +698,35 @@ bool SemanticAnalyzer::is_assignable(const Type& target, const Type& value) cons
     // accepted as source values for matrix/tensor/graph typed destinations.
     // This keeps first-class T81* surface syntax usable while richer shape/type
     // semantics are expanded in later phases.
-    if ((target.kind == Type::Kind::Matrix ||
-         target.kind == Type::Kind::Tensor ||
-         target.kind == Type::Kind::Graph) &&
-        value.kind == Type::Kind::Vector) {
+    if ((target.kind() == Type::Kind::Matrix ||
+         target.kind() == Type::Kind::Tensor ||
+         target.kind() == Type::Kind::Graph) &&
+        value.kind() == Type::Kind::Vector) {
         return true;
     }
 
-    if (target.kind == value.kind && (!target.params.empty() || !value.params.empty())) {
-        if (target.kind == Type::Kind::Custom && target.custom_name != value.custom_name) {
+    if (target.kind() == value.kind() && (!target.params().empty() || !value.params().empty())) {
+        if (target.kind() == Type::Kind::Custom && target.custom_name() != value.custom_name()) {
             return false;
         }
         return structural_params_assignable(target, value);
     }
 
-    if (target.kind == Type::Kind::Custom && value.kind == Type::Kind::Custom) {
-        return target.custom_name == value.custom_name;
+    if (target.kind() == Type::Kind::Custom && value.kind() == Type::Kind::Custom) {
+        return target.custom_name() == value.custom_name();
     }
-    if (target.kind == Type::Kind::Constant && value.kind == Type::Kind::Constant) {
-        return target.custom_name == value.custom_name;
+    if (target.kind() == Type::Kind::Constant && value.kind() == Type::Kind::Constant) {
+        return target.custom_name() == value.custom_name();
     }
 
     return false;
 }
 
 Type SemanticAnalyzer::widen_numeric(const Type& left, const Type& right, const Token& op) {
-    if (left.kind == Type::Kind::Error || right.kind == Type::Kind::Error) {
+    if (left.kind() == Type::Kind::Error || right.kind() == Type::Kind::Error) {
         return make_error_type();
     }
-    if (left.kind == Type::Kind::Unknown || right.kind == Type::Kind::Unknown) {
+    if (left.kind() == Type::Kind::Unknown || right.kind() == Type::Kind::Unknown) {
         return Type{Type::Kind::Unknown};
     }
     if (op.type == TokenType::Percent && (!is_integer_type(left) || !is_integer_type(right))) {
@@ -597,20 +746,10 @@ Type SemanticAnalyzer::widen_numeric(const Type& left, const Type& right, const
 
 Type SemanticAnalyzer::evaluate_expression(const Expr& expr, const Type* expected) {
     _expected_type_stack.push_back(expected);
-    auto result = analyze(expr);
+    Type result = analyze(expr);
     _expected_type_stack.pop_back();
-    if (!result.has_value()) {
-        return Type{Type::Kind::Unknown};
-    }
-    try {
-        Type casted = std::any_cast<Type>(result);
-        _expr_type_cache[&expr] = casted;
-        return casted;
-    } catch (const std::bad_any_cast&) {
-        Type err = make_error_type();
-        _expr_type_cache[&expr] = err;
-        return err;
-    }
+    _expr_type_cache[expr.id] = result;
+    return result;
 }
 
 const Type* SemanticAnalyzer::current_expected_type() const {
@@ -620,23 +759,20 @@ const Type* SemanticAnalyzer::current_expected_type() const {
     return _expected_type_stack.back();
 }
 
-const Type* SemanticAnalyzer::type_of(const Expr* expr) const {
-    if (!expr) return nullptr;
-    auto it = _expr_type_cache.find(expr);
-    if (it == _expr_type_cache.end()) return nullptr;
-    return &it->second;
+std::optional<Type> SemanticAnalyzer::type_of(const Expr* expr) const {
+    if (!expr) return std::nullopt;
+    const Type* type = _expr_type_cache.find(expr->id);
+    return type ? std::optional<Type>(*type) : std::nullopt;
 }
 
 const SemanticAnalyzer::LoopMetadata* SemanticAnalyzer::loop_metadata_for(const LoopStmt& stmt) const {
-    auto it = _loop_index.find(&stmt);
-    if (it == _loop_index.end()) return nullptr;
-    return &_loop_metadata[it->second];
+    const size_t* index = _loop_index.find(stmt.id);
+    return index ? &_loop_metadata[*index] : nullptr;
 }
 
 const SemanticAnalyzer::MatchMetadata* SemanticAnalyzer::match_metadata_for(const MatchExpr& expr) const {
-    auto it = _match_index.find(&expr);
-    if (it == _match_index.end()) return nullptr;
-    return &_match_metadata[it->second];
+    const size_t* index = _match_index.find(expr.id);
+    return index ? &_match_metadata[*index] : nullptr;
 }
 
 Type SemanticAnalyzer::expect_condition_bool(const Expr& expr, const Token& location) {
@@ -686,109 +822,105 @@ Token SemanticAnalyzer::extract_token(const Expr& expr) const {
     if (auto* call = dynamic_cast<const CallExpr*>(&expr)) return extract_token(*call->callee);
     if (auto* grouping = dynamic_cast<const GroupingExpr*>(&expr)) return extract_token(*grouping->expression);
 
-    return Token{TokenType::Illegal, "", 0, 0};
+    return Token{TokenType::Illegal, kEmptySymbol, "", 0, 0};
 }
 
 // --- Visitor Method Implementations ---
 
-std::any SemanticAnalyzer::visit(const ExpressionStmt& stmt) {
+void SemanticAnalyzer::visit(const ExpressionStmt& stmt) {
     evaluate_expression(*stmt.expression);
-    return {};
 }
 
-std::any SemanticAnalyzer::visit(const VarStmt& stmt) {
-    if (is_defined_in_current_scope(std::string(stmt.name.lexeme))) {
+void SemanticAnalyzer::visit(const VarStmt& stmt) {
+    if (is_defined_in_current_scope(stmt.name)) {
         error(stmt.name, "Variable '" + std::string(stmt.name.lexeme) + "' is already defined in this scope.");
-        return {};
+        return;
     }
 
     Type declared_type = stmt.type ? analyze_type_expr(*stmt.type) : Type{Type::Kind::Unknown};
     Type init_type = stmt.initializer ? evaluate_expression(*stmt.initializer, &declared_type) : Type{Type::Kind::Unknown};
 
-    if (declared_type.kind == Type::Kind::Unknown && init_type.kind == Type::Kind::Unknown) {
+    if (declared_type.kind() == Type::Kind::Unknown && init_type.kind() == Type::Kind::Unknown) {
         error(stmt.name, "Variable '" + std::string(stmt.name.lexeme) + "' requires a type annotation or initializer.");
     }
 
     Type checked_declared = declared_type;
-    if (declared_type.kind != Type::Kind::Unknown && init_type.kind != Type::Kind::Unknown) {
+    if (declared_type.kind() != Type::Kind::Unknown && init_type.kind() != Type::Kind::Unknown) {
         checked_declared = refine_generic_type(declared_type, init_type);
     }
 
-    if (declared_type.kind != Type::Kind::Unknown && init_type.kind != Type::Kind::Unknown &&
+    if (declared_type.kind() != Type::Kind::Unknown && init_type.kind() != Type::Kind::Unknown &&
         !is_assignable(checked_declared, init_type)) {
         error(stmt.name, "Cannot assign initializer of type '" + type_to_string(init_type) +
                               "' to variable of type '" + type_to_string(declared_type) + "'.");
     }
 
-    Type final_type = declared_type.kind == Type::Kind::Unknown ? init_type : checked_declared;
+    Type final_type = declared_type.kind() == Type::Kind::Unknown ? init_type : checked_declared;
     define_symbol(stmt.name, SymbolKind::Variable);
     if (auto* symbol = resolve_symbol(stmt.name)) {
         symbol->type = final_type;
     }
-    return final_type;
 }
 
-std::any SemanticAnalyzer::visit(const LetStmt& stmt) {
-    if (is_defined_in_current_scope(std::string(stmt.name.lexeme))) {
+void SemanticAnalyzer::visit(const LetStmt& stmt) {
+    if (is_defined_in_current_scope(stmt.name)) {
         error(stmt.name, "Variable '" + std::string(stmt.name.lexeme) + "' is already defined in this scope.");
-        return {};
+        return;
     }
 
     Type declared_type = stmt.type ? analyze_type_expr(*stmt.type) : Type{Type::Kind::Unknown};
     Type init_type = stmt.initializer ? evaluate_expression(*stmt.initializer, &declared_type) : Type{Type::Kind::Unknown};
 
-    if (declared_type.kind == Type::Kind::Unknown && init_type.kind == Type::Kind::Unknown) {
+    if (declared_type.kind() == Type::Kind::Unknown && init_type.kind() == Type::Kind::Unknown) {
         error(stmt.name, "Constant '" + std::string(stmt.name.lexeme) + "' requires a type annotation or initializer.");
     }
 
     Type checked_declared = declared_type;
-    if (declared_type.kind != Type::Kind::Unknown && init_type.kind != Type::Kind::Unknown) {
+    if (declared_type.kind() != Type::Kind::Unknown && init_type.kind() != Type::Kind::Unknown) {
         checked_declared = refine_generic_type(declared_type, init_type);
     }
 
-    if (declared_type.kind != Type::Kind::Unknown && init_type.kind != Type::Kind::Unknown &&
+    if (declared_type.kind() != Type::Kind::Unknown && init_type.kind() != Type::Kind::Unknown &&
         !is_assignable(checked_declared, init_type)) {
         error(stmt.name, "Cannot assign initializer of type '" + type_to_string(init_type) +
                               "' to constant of type '" + type_to_string(declared_type) + "'.");
     }
 
-    Type final_type = declared_type.kind == Type::Kind::Unknown ? init_type : checked_declared;
+    Type final_type = declared_type.kind() == Type::Kind::Unknown ? init_type : checked_declared;
     define_symbol(stmt.name, SymbolKind::Variable);
     if (auto* symbol = resolve_symbol(stmt.name)) {
         symbol->type = final_type;
     }
-    return final_type;
 }
 
-std::any SemanticAnalyzer::visit(const BlockStmt& stmt) {
+void SemanticAnalyzer::visit(const BlockStmt& stmt) {
     enter_scope();
     for (const auto& statement : stmt.statements) {
         analyze(*statement);
     }
     exit_scope();
-    return {};
 }
 
-std::any SemanticAnalyzer::visit(const IfStmt& stmt) {
+void SemanticAnalyzer::visit(const IfStmt& stmt) {
     Token cond_token = extract_token(*stmt.condition);
     expect_condition_bool(*stmt.condition, cond_token);
     analyze(*stmt.then_branch);
     if (stmt.else_branch) {
         analyze(*stmt.else_branch);
     }
-    return {};
 }
 
-std::any SemanticAnalyzer::visit(const WhileStmt& stmt) {
+void SemanticAnalyzer::visit(const WhileStmt& stmt) {
+    if (_current_body) _current_body->partial = true;
     Token cond_token = extract_token(*stmt.condition);
     expect_condition_bool(*stmt.condition, cond_token);
     _loop_stack.push_back(nullptr); // WhileStmt doesn't have metadata yet, but it's a loop
     analyze(*stmt.body);
     _loop_stack.pop_back();
-    return {};
 }
 
-std::any SemanticAnalyzer::visit(const LoopStmt& stmt) {
+void SemanticAnalyzer::visit(const LoopStmt& stmt) {
+    if (_current_body) _current_body->partial = true;
     if (stmt.bound_kind == LoopStmt::BoundKind::None) {
         error(stmt.keyword, "Loops must be annotated with '@bounded(...)'.");
     }
@@ -816,53 +948,51 @@ std::any SemanticAnalyzer::visit(const LoopStmt& stmt) {
     meta.depth = depth;
     meta.id = _next_loop_id++;
     meta.source_file = _source_name;
-    _loop_index[&stmt] = _loop_metadata.size();
+    _loop_index[stmt.id] = _loop_metadata.size();
     _loop_metadata.push_back(meta);
     _loop_stack.push_back(&stmt);
     for (const auto& statement : stmt.body) {
         analyze(*statement);
     }
     _loop_stack.pop_back();
-    return {};
 }
 
-std::any SemanticAnalyzer::visit(const BreakStmt& stmt) {
+void SemanticAnalyzer::visit(const BreakStmt& stmt) {
     if (_loop_stack.empty()) {
         error(stmt.keyword, "Break statement outside of a loop.");
     }
-    return {};
 }
 
-std::any SemanticAnalyzer::visit(const ContinueStmt& stmt) {
+void SemanticAnalyzer::visit(const ContinueStmt& stmt) {
     if (_loop_stack.empty()) {
         error(stmt.keyword, "Continue statement outside of a loop.");
     }
-    return {};
 }
 
-std::any SemanticAnalyzer::visit(const ReturnStmt& stmt) {
+void SemanticAnalyzer::visit(const ReturnStmt& stmt) {
     if (_function_return_stack.empty()) {
         error(stmt.keyword, "Return statement outside of a function.");
-        return make_error_type();
+        return;
     }
 
     const Type expected = _function_return_stack.back();
     if (!stmt.value) {
-        if (expected.kind != Type::Kind::Void) {
+        if (expected.kind() != Type::Kind::Void) {
             error(stmt.keyword, "Return type mismatch: expected '" + type_to_string(expected) + "' but got 'void'.");
         }
-        return expected;
+        return;
     }
 
+    _tail_call = dynamic_cast<const CallExpr*>(stmt.value.get());
     Type value_type = evaluate_expression(*stmt.value, &expected);
+    _tail_call = nullptr;
     if (!is_assignable(expected, value_type)) {
         error(stmt.keyword, "Return type mismatch: expected '" + type_to_string(expected) + "' but got '" +
                                  type_to_string(value_type) + "'.");
     }
-    return expected;
 }
 
-std::any SemanticAnalyzer::visit(const FunctionStmt& stmt) {
+void SemanticAnalyzer::visit(const FunctionStmt& stmt) {
     if (stmt.attributes.tier.has_value() && *stmt.attributes.tier <= 0) {
         error(stmt.name, "Function tier must be a positive integer.");
     }
@@ -876,6 +1006,10 @@ std::any SemanticAnalyzer::visit(const FunctionStmt& stmt) {
     enter_scope();
     _function_return_stack.push_back(symbol ? symbol->type : Type{Type::Kind::Unknown});
     _function_effect_stack.push_back(stmt.attributes.is_effectful);
+    _tailrec_stack.push_back(stmt.attributes.is_tailrec ? &stmt : nullptr);
+    BodyFacts* enclosing_body = _current_body;
+    _current_body = &_body_facts[std::string(stmt.name.lexeme)];
+    *_current_body = BodyFacts{};
 
     if (symbol && symbol->param_types.size() != stmt.params.size()) {
         error(stmt.name, "Function parameter count mismatch between declaration and definition.");
@@ -886,11 +1020,11 @@ std::any SemanticAnalyzer::visit(const FunctionStmt& stmt) {
         Type param_type = (symbol && i < symbol->param_types.size()) ? symbol->param_types[i]
                                                                      : Type{Type::Kind::Unknown};
 
-        if (param.type && param_type.kind == Type::Kind::Unknown) {
+        if (param.type && param_type.kind() == Type::Kind::Unknown) {
             param_type = analyze_type_expr(*param.type);
         }
 
-        if (is_defined_in_current_scope(std::string(param.name.lexeme))) {
+        if (is_defined_in_current_scope(param.name)) {
             error(param.name, "Parameter '" + std::string(param.name.lexeme) + "' is already defined.");
         } else {
             define_symbol(param.name, SymbolKind::Variable);
@@ -906,35 +1040,51 @@ std::any SemanticAnalyzer::visit(const FunctionStmt& stmt) {
 
     _function_return_stack.pop_back();
     _function_effect_stack.pop_back();
+    _tailrec_stack.pop_back();
+    _current_body = enclosing_body;
     exit_scope();
-    return symbol ? symbol->type : Type{Type::Kind::Unknown};
 }
 
-std::any SemanticAnalyzer::visit(const ModuleDecl& stmt) {
+bool SemanticAnalyzer::is_total(std::string_view name) const {
+    // Depth-first over the call graph. A function met again while its own
+    // callees are being checked is recursive, which is never total.
+    std::unordered_map<std::string_view, bool> known;
+    auto total = [&](auto& self, std::string_view function) -> bool {
+        if (auto it = known.find(function); it != known.end()) return it->second;
+        auto facts = _body_facts.find(std::string(function));
+        if (facts == _body_facts.end() || facts->second.partial) return known[function] = false;
+        known[function] = false;
+        for (const std::string& callee : facts->second.callees) {
+            if (!self(self, callee)) return false;
+        }
+        return known[function] = true;
+    };
+    return total(total, name);
+}
+
+void SemanticAnalyzer::visit(const ModuleDecl& stmt) {
     if (_declared_module.has_value()) {
         error(stmt.keyword, "Module already declared as '" + *_declared_module + "'.");
-        return {};
+        return;
     }
     _declared_module = stmt.path;
-    return {};
 }
 
-std::any SemanticAnalyzer::visit(const ImportDecl& stmt) {
+void SemanticAnalyzer::visit(const ImportDecl& stmt) {
     if (stmt.path.empty()) {
         error(stmt.keyword, "Import path cannot be empty.");
-        return {};
+        return;
     }
     if (stmt.path == _declared_module.value_or(std::string{})) {
         error(stmt.keyword, "Module cannot import itself.");
-        return {};
+        return;
     }
-    if (!_imports.insert(stmt.path).second) {
-        error(stmt.keyword, "Duplicate import '" + stmt.path + "'.");
+    if (!_imports.insert(std::string(stmt.path)).second) {
+        error(stmt.keyword, "Duplicate import '" + std::string(stmt.path) + "'.");
     }
-    return {};
 }
 
-std::any SemanticAnalyzer::visit(const TypeDecl& stmt) {
+void SemanticAnalyzer::visit(const TypeDecl& stmt) {
     std::string name_str = std::string(stmt.name.lexeme);
     size_t arity = stmt.params.size();
     auto it = _generic_arities.find(name_str);
@@ -959,14 +1109,13 @@ std::any SemanticAnalyzer::visit(const TypeDecl& stmt) {
         _type_aliases[name_str] = info;
         analyze_type_expr(*stmt.alias);
     }
-    return {};
 }
 
-std::any SemanticAnalyzer::visit(const RecordDecl& stmt) {
+void SemanticAnalyzer::visit(const RecordDecl& stmt) {
     std::string name_str = std::string(stmt.name.lexeme);
     if (_record_definitions.find(name_str) != _record_definitions.end()) {
         error(stmt.name, "Record '" + name_str + "' is already defined.");
-        return {};
+        return;
     }
 
     RecordInfo info;
@@ -995,17 +1144,16 @@ std::any SemanticAnalyzer::visit(const RecordDecl& stmt) {
         if (stmt.schema_version.has_value() && *stmt.schema_version > 0) {
             info.schema_version = static_cast<std::uint32_t>(*stmt.schema_version);
         }
-        info.module_path = stmt.module_path.has_value() ? *stmt.module_path : _source_name;
+        info.module_path = stmt.module_path.has_value() ? std::string(*stmt.module_path) : _source_name;
         _record_definitions.emplace(name_str, std::move(info));
     }
-    return {};
 }
 
-std::any SemanticAnalyzer::visit(const EnumDecl& stmt) {
+void SemanticAnalyzer::visit(const EnumDecl& stmt) {
     std::string name_str = std::string(stmt.name.lexeme);
     if (_enum_definitions.find(name_str) != _enum_definitions.end()) {
         error(stmt.name, "Enum '" + name_str + "' is already defined.");
-        return {};
+        return;
     }
 
     EnumInfo info;
@@ -1039,13 +1187,12 @@ std::any SemanticAnalyzer::visit(const EnumDecl& stmt) {
         if (stmt.schema_version.has_value() && *stmt.schema_version > 0) {
             info.schema_version = static_cast<std::uint32_t>(*stmt.schema_version);
         }
-        info.module_path = stmt.module_path.has_value() ? *stmt.module_path : _source_name;
+        info.module_path = stmt.module_path.has_value() ? std::string(*stmt.module_path) : _source_name;
         _enum_definitions.emplace(name_str, std::move(info));
     }
-    return {};
 }
 
-std::any SemanticAnalyzer::visit(const AssignExpr& expr) {
+Type SemanticAnalyzer::visit(const AssignExpr& expr) {
     auto* symbol = resolve_symbol(expr.name);
     if (!symbol) {
         error(expr.name, "Undefined variable '" + std::string(expr.name.lexeme) + "'.");
@@ -1064,13 +1211,16 @@ std::any SemanticAnalyzer::visit(const AssignExpr& expr) {
     return symbol->type;
 }
 
-std::any SemanticAnalyzer::visit(const BinaryExpr& expr) {
+Type SemanticAnalyzer::visit(const BinaryExpr& expr) {
     Type left_type = evaluate_expression(*expr.left);
     Type right_type = evaluate_expression(*expr.right);
+    if (_current_body && (expr.op.type == TokenType::Slash || expr.op.type == TokenType::Percent)) {
+        _current_body->partial = true;
+    }
 
     switch (expr.op.type) {
         case TokenType::Plus:
-            if (left_type.kind == Type::Kind::String && right_type.kind == Type::Kind::String) {
+            if (left_type.kind() == Type::Kind::String && right_type.kind() == Type::Kind::String) {
                 return Type{Type::Kind::String};
             }
             [[fallthrough]];
@@ -1110,7 +1260,7 @@ std::any SemanticAnalyzer::visit(const BinaryExpr& expr) {
     }
 }
 
-std::any SemanticAnalyzer::visit(const CallExpr& expr) {
+Type SemanticAnalyzer::visit(const CallExpr& expr) {
     std::vector<Type> arg_types;
     arg_types.reserve(expr.arguments.size());
     for (const auto& arg : expr.arguments) {
@@ -1123,11 +1273,13 @@ std::any SemanticAnalyzer::visit(const CallExpr& expr) {
 
         auto build_result_template = [&](const Type* context) {
             Type result{Type::Kind::Result};
-            if (context && context->kind == Type::Kind::Result) {
+            if (context && context->kind() == Type::Kind::Result) {
                 result = *context;
             }
-            if (result.params.size() < 2) {
-                result.params.resize(2, Type{Type::Kind::Unknown});
+            if (result.params().size() < 2) {
+                std::vector<Type> params = result.params();
+                params.resize(2, Type{Type::Kind::Unknown});
+                result = result.with_params(std::move(params));
             }
             return result;
         };
@@ -1139,16 +1291,14 @@ std::any SemanticAnalyzer::visit(const CallExpr& expr) {
             }
             Type payload = arg_types[0];
             Type result{Type::Kind::Option, {payload}};
-            if (expected && expected->kind == Type::Kind::Option) {
-                Type expected_payload = expected->params.empty() ? Type{Type::Kind::Unknown} : expected->params[0];
-                if (expected_payload.kind != Type::Kind::Unknown &&
+            if (expected && expected->kind() == Type::Kind::Option) {
+                Type expected_payload = expected->params().empty() ? Type{Type::Kind::Unknown} : expected->params()[0];
+                if (expected_payload.kind() != Type::Kind::Unknown &&
                     !is_assignable(expected_payload, payload)) {
                     error(var_expr->name, "The 'Some' constructor argument must match the contextual Option payload ('" +
                                          type_to_string(expected_payload) + "').");
-                } else if (expected_payload.kind != Type::Kind::Unknown) {
-                    result.params[0] = expected_payload;
-                } else {
-                    result.params[0] = payload;
+                } else if (expected_payload.kind() != Type::Kind::Unknown) {
+                    result = Type{Type::Kind::Option, {expected_payload}};
                 }
                 merge_expected_params(result, expected);
             }
@@ -1158,13 +1308,13 @@ std::any SemanticAnalyzer::visit(const CallExpr& expr) {
             if (!arg_types.empty()) {
                 error(var_expr->name, "The 'None' constructor does not take arguments.");
             }
-            if (!expected || expected->kind != Type::Kind::Option) {
+            if (!expected || expected->kind() != Type::Kind::Option) {
                 error(var_expr->name, "The 'None' constructor requires a contextual Option[T] type.");
                 return make_error_type();
             }
             Type option_type = *expected;
-            if (option_type.params.empty()) {
-                option_type.params.emplace_back(Type{Type::Kind::Unknown});
+            if (option_type.params().empty()) {
+                option_type = option_type.with_params({Type{Type::Kind::Unknown}});
             }
             return option_type;
         }
@@ -1173,19 +1323,20 @@ std::any SemanticAnalyzer::visit(const CallExpr& expr) {
                 error(var_expr->name, "The 'Ok' constructor expects exactly one argument.");
                 return make_error_type();
             }
-            if (!expected || expected->kind != Type::Kind::Result) {
+            if (!expected || expected->kind() != Type::Kind::Result) {
                 error(var_expr->name, "The 'Ok' constructor requires a contextual Result[T, E] type.");
                 return make_error_type();
             }
             Type result_type = build_result_template(expected);
-            Type success_expected = result_type.params[0];
+            Type success_expected = result_type.params()[0];
             Type success_arg = arg_types[0];
 
             if (!is_assignable(success_expected, success_arg)) {
                 error(var_expr->name, "The 'Ok' constructor argument must match the success type of the contextual Result.");
             }
-            result_type.params[0] =
-                (success_expected.kind == Type::Kind::Unknown ? success_arg : success_expected);
+            result_type = result_type.with_params(
+                {success_expected.kind() == Type::Kind::Unknown ? success_arg : success_expected,
+                 result_type.params()[1]});
             merge_expected_params(result_type, expected);
             return result_type;
         }
@@ -1194,28 +1345,30 @@ std::any SemanticAnalyzer::visit(const CallExpr& expr) {
                 error(var_expr->name, "The 'Err' constructor expects exactly one argument.");
                 return make_error_type();
             }
-            if (!expected || expected->kind != Type::Kind::Result) {
+            if (!expected || expected->kind() != Type::Kind::Result) {
                 error(var_expr->name, "The 'Err' constructor requires a contextual Result[T, E] type.");
                 return make_error_type();
             }
             Type result_type = build_result_template(expected);
-            Type error_expected = result_type.params[1];
+            Type error_expected = result_type.params()[1];
             Type error_arg = arg_types[0];
 
             if (!is_assignable(error_expected, error_arg)) {
                 error(var_expr->name, "The 'Err' constructor argument must match the error type of the contextual Result.");
             }
-            result_type.params[1] =
-                (error_expected.kind == Type::Kind::Unknown ? error_arg : error_expected);
+            result_type = result_type.with_params(
+                {result_type.params()[0],
+                 error_expected.kind() == Type::Kind::Unknown ? error_arg : error_expected});
             merge_expected_params(result_type, expected);
             return result_type;
         }
         if (func_name == "weights.load") {
+            if (_current_body) _current_body->partial = true;
             if (arg_types.size() != 1) {
                 error(var_expr->name, "The 'weights.load' builtin expects exactly one argument.");
                 return make_error_type();
             }
-            if (arg_types[0].kind != Type::Kind::String) {
+            if (arg_types[0].kind() != Type::Kind::String) {
                 error(var_expr->name, "The 'weights.load' argument must be a string literal.");
                 return make_error_type();
             }
@@ -1230,7 +1383,7 @@ std::any SemanticAnalyzer::visit(const CallExpr& expr) {
                 error(var_expr->name, "The 'print' builtin expects exactly one argument.");
                 return make_error_type();
             }
-            if (arg_types[0].kind != Type::Kind::String) {
+            if (arg_types[0].kind() != Type::Kind::String) {
                 error(var_expr->name, "The 'print' builtin expects a T81String argument.");
                 return make_error_type();
             }
@@ -1247,6 +1400,15 @@ std::any SemanticAnalyzer::visit(const CallExpr& expr) {
             return make_error_type();
         }
 
+        if (_current_body) _current_body->callees.push_back(func_name);
+
+        const FunctionStmt* tailrec = _tailrec_stack.empty() ? nullptr : _tailrec_stack.back();
+        if (tailrec && func_name == tailrec->name.lexeme && &expr != _tail_call) {
+            error(var_expr->name, "Recursive call to '" + func_name +
+                                      "' is not in tail position, so '@tailrec' cannot turn it into a loop. "
+                                      "Return the call's result directly.");
+        }
+
         const bool caller_effectful = !_function_effect_stack.empty() && _function_effect_stack.back();
         if (symbol->is_effectful && !caller_effectful) {
             error(var_expr->name,
@@ -1271,16 +1433,18 @@ std::any SemanticAnalyzer::visit(const CallExpr& expr) {
         return symbol->type;
     }
 
+    if (_current_body) _current_body->partial = true;
     evaluate_expression(*expr.callee);
     return make_error_type();
 }
 
-std::any SemanticAnalyzer::visit(const MatchExpr& expr) {
+Type SemanticAnalyzer::visit(const MatchExpr& expr) {
+    if (_current_body) _current_body->partial = true;
     Type scrutinee_type = evaluate_expression(*expr.scrutinee);
     Token scrutinee_token = extract_token(*expr.scrutinee);
-    bool is_option = scrutinee_type.kind == Type::Kind::Option;
-    bool is_result = scrutinee_type.kind == Type::Kind::Result;
-    bool is_enum = scrutinee_type.kind == Type::Kind::Custom;
+    bool is_option = scrutinee_type.kind() == Type::Kind::Option;
+    bool is_result = scrutinee_type.kind() == Type::Kind::Result;
+    bool is_enum = scrutinee_type.kind() == Type::Kind::Custom;
 
     struct VariantMeta {
         std::optional<Type> payload;
@@ -1298,22 +1462,22 @@ std::any SemanticAnalyzer::visit(const MatchExpr& expr) {
 
     if (is_option) {
         match_label = "Option";
-        Type payload = scrutinee_type.params.empty() ? Type{Type::Kind::Unknown} : scrutinee_type.params[0];
+        Type payload = scrutinee_type.params().empty() ? Type{Type::Kind::Unknown} : scrutinee_type.params()[0];
         allowed_variants.emplace("Some", VariantMeta{payload, 0});
         allowed_variants.emplace("None", VariantMeta{std::nullopt, 1});
         required_variants = {"Some", "None"};
     } else if (is_result) {
         match_label = "Result";
-        Type success = scrutinee_type.params.size() >= 1 ? scrutinee_type.params[0] : Type{Type::Kind::Unknown};
-        Type error = scrutinee_type.params.size() >= 2 ? scrutinee_type.params[1] : Type{Type::Kind::Unknown};
+        Type success = scrutinee_type.params().size() >= 1 ? scrutinee_type.params()[0] : Type{Type::Kind::Unknown};
+        Type error = scrutinee_type.params().size() >= 2 ? scrutinee_type.params()[1] : Type{Type::Kind::Unknown};
         allowed_variants.emplace("Ok", VariantMeta{success, 0});
         allowed_variants.emplace("Err", VariantMeta{error, 1});
         required_variants = {"Ok", "Err"};
     } else if (is_enum) {
         match_label = "Enum";
-        auto enum_it = _enum_definitions.find(scrutinee_type.custom_name);
+        auto enum_it = _enum_definitions.find(scrutinee_type.custom_name());
         if (enum_it == _enum_definitions.end()) {
-            error(scrutinee_token, "Type '" + scrutinee_type.custom_name + "' is not a known enum.");
+            error(scrutinee_token, "Type '" + scrutinee_type.custom_name() + "' is not a known enum.");
             return make_error_type();
         }
         const EnumInfo& info = enum_it->second;
@@ -1334,7 +1498,7 @@ std::any SemanticAnalyzer::visit(const MatchExpr& expr) {
 
     const Type* contextual_expected = current_expected_type();
     Type result_type = contextual_expected ? *contextual_expected : Type{Type::Kind::Unknown};
-    bool result_type_locked = contextual_expected && contextual_expected->kind != Type::Kind::Unknown;
+    bool result_type_locked = contextual_expected && contextual_expected->kind() != Type::Kind::Unknown;
     bool structural_error = false;
     std::unordered_set<std::string> seen_variants;
     std::unordered_set<std::string> variants_with_no_guard;
@@ -1353,7 +1517,10 @@ std::any SemanticAnalyzer::visit(const MatchExpr& expr) {
         if (name == "Ok") saw_ok = true;
         if (name == "Err") saw_err = true;
         bool has_guard = arm.guard != nullptr;
-        if (!has_guard) {
+        // A nested variant pattern can fail like a guard, so later arms for
+        // the same variant are still reachable.
+        bool refutable = has_guard || arm.pattern.kind == MatchPattern::Kind::Variant;
+        if (!refutable) {
             if (!variants_with_no_guard.insert(name).second) {
                 error(arm.keyword, "Duplicate match arm for '" + name + "' without a guard.");
                 structural_error = true;
@@ -1413,12 +1580,12 @@ std::any SemanticAnalyzer::visit(const MatchExpr& expr) {
         Type arm_type = evaluate_expression(*arm.expression, arm_expected);
         exit_scope();
 
-        if (!result_type_locked && arm_type.kind != Type::Kind::Unknown) {
+        if (!result_type_locked && arm_type.kind() != Type::Kind::Unknown) {
             result_type = arm_type;
             result_type_locked = true;
         }
 
-        if (result_type_locked && arm_type.kind != Type::Kind::Unknown &&
+        if (result_type_locked && arm_type.kind() != Type::Kind::Unknown &&
                 !is_assignable(result_type, arm_type)) {
             error(arm.keyword, "All match arms must produce the same type.");
             structural_error = true;
@@ -1443,7 +1610,7 @@ std::any SemanticAnalyzer::visit(const MatchExpr& expr) {
         return info.has_guard;
     });
     meta.arms = std::move(arm_infos);
-    _match_index[&expr] = _match_metadata.size();
+    _match_index[expr.id] = _match_metadata.size();
     _match_metadata.push_back(std::move(meta));
 
 
@@ -1468,30 +1635,30 @@ std::any SemanticAnalyzer::visit(const MatchExpr& expr) {
     return result_type;
 }
 
-std::any SemanticAnalyzer::visit(const FieldAccessExpr& expr) {
+Type SemanticAnalyzer::visit(const FieldAccessExpr& expr) {
     Type object_type = evaluate_expression(*expr.object);
-    if (object_type.kind != Type::Kind::Custom || object_type.custom_name.empty()) {
+    if (object_type.kind() != Type::Kind::Custom || object_type.custom_name().empty()) {
         error(expr.field, "Field access requires a record value.");
         return make_error_type();
     }
 
-    auto record_it = _record_definitions.find(object_type.custom_name);
+    auto record_it = _record_definitions.find(object_type.custom_name());
     if (record_it == _record_definitions.end()) {
-        error(expr.field, "Type '" + object_type.custom_name + "' has no record fields.");
+        error(expr.field, "Type '" + object_type.custom_name() + "' has no record fields.");
         return make_error_type();
     }
 
     std::string field_name(expr.field.lexeme);
     auto field_it = record_it->second.field_map.find(field_name);
     if (field_it == record_it->second.field_map.end()) {
-        error(expr.field, "Record '" + object_type.custom_name + "' has no field '" + field_name + "'.");
+        error(expr.field, "Record '" + object_type.custom_name() + "' has no field '" + field_name + "'.");
         return make_error_type();
     }
 
     return field_it->second;
 }
 
-std::any SemanticAnalyzer::visit(const RecordLiteralExpr& expr) {
+Type SemanticAnalyzer::visit(const RecordLiteralExpr& expr) {
     std::string type_name(expr.type_name.lexeme);
     auto record_it = _record_definitions.find(type_name);
     if (record_it == _record_definitions.end()) {
@@ -1539,12 +1706,10 @@ std::any SemanticAnalyzer::visit(const RecordLiteralExpr& expr) {
         return make_error_type();
     }
 
-    Type result{Type::Kind::Custom};
-    result.custom_name = type_name;
-    return result;
+    return Type{Type::Kind::Custom, {}, type_name};
 }
 
-std::any SemanticAnalyzer::visit(const EnumLiteralExpr& expr) {
+Type SemanticAnalyzer::visit(const EnumLiteralExpr& expr) {
     std::string enum_name(expr.enum_name.lexeme);
     auto enum_it = _enum_definitions.find(enum_name);
     if (enum_it == _enum_definitions.end()) {
@@ -1576,27 +1741,19 @@ std::any SemanticAnalyzer::visit(const EnumLiteralExpr& expr) {
         return make_error_type();
     }
 
-    Type result{Type::Kind::Custom};
-    result.custom_name = enum_name;
-    return result;
+    return Type{Type::Kind::Custom, {}, enum_name};
 }
 
-std::any SemanticAnalyzer::visit(const VectorLiteralExpr& expr) {
+Type SemanticAnalyzer::visit(const VectorLiteralExpr& expr) {
     if (expr.elements.empty()) {
         const Type* expected = current_expected_type();
-        if (expected && (expected->kind == Type::Kind::Vector || expected->kind == Type::Kind::Tensor)) {
-            Type result;
-            if (expected->kind == Type::Kind::Vector) {
-                result = *expected;
-            } else {
-                result.kind = Type::Kind::Vector;
-                if (!expected->params.empty()) {
-                    result.params.push_back(expected->params[0]);
-                } else {
-                    result.params.push_back(Type{Type::Kind::Unknown});
-                }
+        if (expected && (expected->kind() == Type::Kind::Vector || expected->kind() == Type::Kind::Tensor)) {
+            Type result = *expected;
+            if (expected->kind() != Type::Kind::Vector) {
+                result = Type{Type::Kind::Vector,
+                              {expected->params().empty() ? Type{Type::Kind::Unknown} : expected->params()[0]}};
             }
-            _vector_literal_data[&expr] = {};
+            _vector_literal_data[expr.id] = {};
             return result;
         }
         error(expr.token, "Empty vector literal requires a contextual Vector[T] type.");
@@ -1609,11 +1766,11 @@ std::any SemanticAnalyzer::visit(const VectorLiteralExpr& expr) {
 
     for (const auto& element : expr.elements) {
         Type elem_type = evaluate_expression(*element);
-        if (elem_type.kind == Type::Kind::Error) {
+        if (elem_type.kind() == Type::Kind::Error) {
             return make_error_type();
         }
 
-        if (element_type.kind == Type::Kind::Unknown) {
+        if (element_type.kind() == Type::Kind::Unknown) {
             element_type = elem_type;
         } else if (element_type != elem_type) {
             if (is_numeric(element_type) && is_numeric(elem_type)) {
@@ -1647,19 +1804,18 @@ std::any SemanticAnalyzer::visit(const VectorLiteralExpr& expr) {
         values.push_back(*parsed);
     }
 
-    Type result{Type::Kind::Vector};
-    result.params.push_back(
-        element_type.kind == Type::Kind::Unknown ? Type{Type::Kind::Unknown} : element_type);
+    Type result{Type::Kind::Vector,
+                {element_type.kind() == Type::Kind::Unknown ? Type{Type::Kind::Unknown} : element_type}};
     merge_expected_params(result, current_expected_type());
-    _vector_literal_data[&expr] = std::move(values);
+    _vector_literal_data[expr.id] = std::move(values);
     return result;
 }
 
-std::any SemanticAnalyzer::visit(const GroupingExpr& expr) {
+Type SemanticAnalyzer::visit(const GroupingExpr& expr) {
     return evaluate_expression(*expr.expression);
 }
 
-std::any SemanticAnalyzer::visit(const LiteralExpr& expr) {
+Type SemanticAnalyzer::visit(const LiteralExpr& expr) {
     switch (expr.value.type) {
         case TokenType::True:
         case TokenType::False:
@@ -1677,7 +1833,7 @@ std::any SemanticAnalyzer::visit(const LiteralExpr& expr) {
     }
 }
 
-std::any SemanticAnalyzer::visit(const UnaryExpr& expr) {
+Type SemanticAnalyzer::visit(const UnaryExpr& expr) {
     Type right = evaluate_expression(*expr.right);
     if (expr.op.type == TokenType::Bang) {
         if (!is_assignable(Type{Type::Kind::Bool}, right)) {
@@ -1698,7 +1854,7 @@ std::any SemanticAnalyzer::visit(const UnaryExpr& expr) {
     return make_error_type();
 }
 
-std::any SemanticAnalyzer::visit(const VariableExpr& expr) {
+Type SemanticAnalyzer::visit(const VariableExpr& expr) {
     std::string name_str = std::string(expr.name.lexeme);
 
     if (name_str == "Some" || name_str == "None" || name_str == "Ok" || name_str == "Err") {
@@ -1711,9 +1867,10 @@ std::any SemanticAnalyzer::visit(const VariableExpr& expr) {
         if (dot != std::string::npos && dot > 0 && dot + 1 < name_str.size()) {
             Token base_token = expr.name;
             base_token.lexeme = std::string_view(expr.name.lexeme.data(), dot);
+            base_token.symbol = IdentifierInterner::global().intern(base_token.lexeme);
             auto* base_symbol = resolve_symbol(base_token);
-            if (base_symbol && base_symbol->type.kind == Type::Kind::Custom && !base_symbol->type.custom_name.empty()) {
-                auto record_it = _record_definitions.find(base_symbol->type.custom_name);
+            if (base_symbol && base_symbol->type.kind() == Type::Kind::Custom && !base_symbol->type.custom_name().empty()) {
+                auto record_it = _record_definitions.find(base_symbol->type.custom_name());
                 if (record_it != _record_definitions.end()) {
                     const std::string field = name_str.substr(dot + 1);
                     auto field_it = record_it->second.field_map.find(field);
@@ -1729,11 +1886,11 @@ std::any SemanticAnalyzer::visit(const VariableExpr& expr) {
     return symbol->type;
 }
 
-std::any SemanticAnalyzer::visit(const SimpleTypeExpr& expr) {
+Type SemanticAnalyzer::visit(const SimpleTypeExpr& expr) {
     return type_from_token(expr.name);
 }
 
-std::any SemanticAnalyzer::visit(const GenericTypeExpr& expr) {
+Type SemanticAnalyzer::visit(const GenericTypeExpr& expr) {
     std::string type_name = std::string(expr.name.lexeme);
     std::vector<Type> params;
     params.reserve(expr.param_count);
@@ -1741,7 +1898,7 @@ std::any SemanticAnalyzer::visit(const GenericTypeExpr& expr) {
         if (!raw) return std::nullopt;
         if (auto* variable = dynamic_cast<const VariableExpr*>(raw)) {
             Type type = type_from_token(variable->name);
-            if (type.kind != Type::Kind::Unknown && type.kind != Type::Kind::Constant) {
+            if (type.kind() != Type::Kind::Unknown && type.kind() != Type::Kind::Constant) {
                 return type;
             }
         }
@@ -1785,7 +1942,7 @@ std::any SemanticAnalyzer::visit(const GenericTypeExpr& expr) {
         return make_error_type();
     }
 
-    if (params[0].kind == Type::Kind::Constant) {
+    if (params[0].kind() == Type::Kind::Constant) {
         error(expr.name, "The first generic parameter must be a type.");
         return make_error_type();
     }
@@ -1803,7 +1960,7 @@ std::any SemanticAnalyzer::visit(const GenericTypeExpr& expr) {
         if (params.size() != 2) {
             error(expr.name, "The 'Result' type expects exactly two type parameters, but got " + std::to_string(params.size()) + ".");
         }
-        if (params.size() > 1 && params[1].kind == Type::Kind::Constant) {
+        if (params.size() > 1 && params[1].kind() == Type::Kind::Constant) {
             if (auto normalized = type_from_expr(expr.params[1].get())) {
                 params[1] = *normalized;
             }
@@ -1822,8 +1979,7 @@ std::any SemanticAnalyzer::visit(const GenericTypeExpr& expr) {
         return alias_type;
     }
 
-    Type base = type_from_token(expr.name);
-    base.params = params;
+    Type base = type_from_token(expr.name).with_params(std::move(params));
     merge_expected_params(base, expected);
     enforce_generic_arity(base, expr.name);
     return base;
@@ -1852,29 +2008,29 @@ bool SemanticAnalyzer::bind_pattern_payload(const MatchPattern& pattern,
             return true;
         case MatchPattern::Kind::Tuple: {
             size_t expected_fields = pattern.tuple_bindings.size();
-            if (payload_type.params.empty()) {
+            if (payload_type.params().empty()) {
                 error(keyword, "Tuple pattern for variant '" + std::string(keyword.lexeme) + "' lacks payload type information.");
                 return false;
             }
-            if (payload_type.params.size() != expected_fields) {
+            if (payload_type.params().size() != expected_fields) {
                 error(keyword, "Tuple pattern for variant '" + std::string(keyword.lexeme) + "' expects " +
                                std::to_string(expected_fields) + " fields but payload has " +
-                               std::to_string(payload_type.params.size()) + ".");
+                               std::to_string(payload_type.params().size()) + ".");
                 return false;
             }
             for (size_t i = 0; i < expected_fields; ++i) {
-                bind_pattern_symbol(pattern.tuple_bindings[i], payload_type.params[i]);
+                bind_pattern_symbol(pattern.tuple_bindings[i], payload_type.params()[i]);
             }
             return true;
         }
         case MatchPattern::Kind::Record: {
-            if (payload_type.kind != Type::Kind::Custom || payload_type.custom_name.empty()) {
+            if (payload_type.kind() != Type::Kind::Custom || payload_type.custom_name().empty()) {
                 error(keyword, "Record pattern for variant '" + std::string(keyword.lexeme) + "' requires a record payload.");
                 return false;
             }
-            auto record_it = _record_definitions.find(payload_type.custom_name);
+            auto record_it = _record_definitions.find(payload_type.custom_name());
             if (record_it == _record_definitions.end()) {
-                error(keyword, "Variant '" + std::string(keyword.lexeme) + "' payload '" + payload_type.custom_name + "' is not a known record.");
+                error(keyword, "Variant '" + std::string(keyword.lexeme) + "' payload '" + payload_type.custom_name() + "' is not a known record.");
                 return false;
             }
             const auto& info = record_it->second;
@@ -1883,7 +2039,7 @@ bool SemanticAnalyzer::bind_pattern_payload(const MatchPattern& pattern,
                 std::string field_name(binding.first.lexeme);
                 auto field_it = info.field_map.find(field_name);
                 if (field_it == info.field_map.end()) {
-                    error(binding.first, "Record '" + payload_type.custom_name + "' has no field '" + field_name + "'.");
+                    error(binding.first, "Record '" + payload_type.custom_name() + "' has no field '" + field_name + "'.");
                     ok = false;
                     continue;
                 }
@@ -1898,21 +2054,21 @@ bool SemanticAnalyzer::bind_pattern_payload(const MatchPattern& pattern,
 }
 
 bool SemanticAnalyzer::analyze_nested_variant(const MatchPattern& pattern, const Type& payload_type) {
-    if (payload_type.kind != Type::Kind::Custom || payload_type.custom_name.empty()) {
+    if (payload_type.kind() != Type::Kind::Custom || payload_type.custom_name().empty()) {
         error(pattern.variant_name, "Variant '" + std::string(pattern.variant_name.lexeme) +
                                     "' requires an enum payload.");
         return false;
     }
-    auto enum_it = _enum_definitions.find(payload_type.custom_name);
+    auto enum_it = _enum_definitions.find(payload_type.custom_name());
     if (enum_it == _enum_definitions.end()) {
-        error(pattern.variant_name, "Enum '" + payload_type.custom_name + "' is not defined.");
+        error(pattern.variant_name, "Enum '" + payload_type.custom_name() + "' is not defined.");
         return false;
     }
     const auto& variants = enum_it->second.variants;
     std::string variant_name(pattern.variant_name.lexeme);
     auto variant_it = variants.find(variant_name);
     if (variant_it == variants.end()) {
-        error(pattern.variant_name, "Variant '" + variant_name + "' is not part of '" + payload_type.custom_name + "'.");
+        error(pattern.variant_name, "Variant '" + variant_name + "' is not part of '" + payload_type.custom_name() + "'.");
         return false;
     }
     if (!pattern.variant_payload) {
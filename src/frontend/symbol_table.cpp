@@ -9,27 +9,32 @@ SymbolTable::SymbolTable() {
 }
 
 void SymbolTable::enter_scope() {
-    _scopes.emplace_back();
+    _scopes.enter_scope();
 }
 
 void SymbolTable::exit_scope() {
-    if (!_scopes.empty()) {
-        _scopes.pop_back();
-    }
+    _scopes.exit_scope();
 }
 
 void SymbolTable::define(std::string_view name, Symbol symbol) {
-    if (!_scopes.empty()) {
-        _scopes.back()[std::string(name)] = symbol;
-    }
+    define(IdentifierInterner::global().intern(name), symbol);
+}
+
+void SymbolTable::define(SymbolId name, Symbol symbol) {
+    _scopes.define(name, symbol);
 }
 
 std::optional<Symbol> SymbolTable::lookup(std::string_view name) const {
-    for (auto it = _scopes.rbegin(); it != _scopes.rend(); ++it) {
-        auto found = it->find(std::string(name));
-        if (found != it->end()) {
-            return found->second;
-        }
+    // A spelling that was never interned cannot be bound anywhere.
+    if (auto id = IdentifierInterner::global().find(name)) {
+        return lookup(*id);
+    }
+    return std::nullopt;
+}
+
+std::optional<Symbol> SymbolTable::lookup(SymbolId name) const {
+    if (const Symbol* symbol = _scopes.lookup(name)) {
+        return *symbol;
     }
     return std::nullopt;
 }
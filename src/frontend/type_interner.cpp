@@ -0,0 +1,111 @@
+#include "t81/frontend/type_interner.hpp"
+
+#include <functional>
+#include <mutex>
+#include <utility>
+
+namespace t81::frontend {
+
+namespace {
+
+std::size_t hash_node(Type::Kind kind, const std::vector<Type>& params, const std::string& custom_name) {
+    std::size_t hash = std::hash<std::string>{}(custom_name) ^ (static_cast<std::size_t>(kind) * 0x9e3779b97f4a7c15ULL);
+    for (const auto& param : params) {
+        hash ^= std::hash<const void*>{}(param.node()) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+bool compares_by_name(Type::Kind kind) {
+    return kind == Type::Kind::Custom || kind == Type::Kind::Constant;
+}
+
+} // namespace
+
+Type::Type(Kind kind_, std::vector<Type> params_, std::string custom_name_)
+    : _node(params_.empty() && custom_name_.empty()
+                ? TypeInterner::global().primitive(kind_)
+                : TypeInterner::global().intern(kind_, std::move(params_), std::move(custom_name_))) {}
+
+Type Type::constant(std::string repr) {
+    return Type{Kind::Constant, {}, std::move(repr)};
+}
+
+Type Type::with_params(std::vector<Type> params_) const {
+    return Type{kind(), std::move(params_), custom_name()};
+}
+
+bool TypeInterner::NodeEqual::operator()(const TypeNode* lhs, const TypeNode* rhs) const noexcept {
+    if (lhs->kind != rhs->kind || lhs->custom_name != rhs->custom_name) return false;
+    if (lhs->params.size() != rhs->params.size()) return false;
+    for (std::size_t i = 0; i < lhs->params.size(); ++i) {
+        if (lhs->params[i].node() != rhs->params[i].node()) return false;
+    }
+    return true;
+}
+
+TypeInterner& TypeInterner::global() {
+    static TypeInterner interner;
+    return interner;
+}
+
+TypeInterner::TypeInterner() {
+    for (std::size_t i = 0; i < Type::kKindCount; ++i) {
+        const auto kind = static_cast<Type::Kind>(i);
+        TypeNode& node = _nodes.emplace_back(TypeNode{kind, {}, {}, hash_node(kind, {}, {}), nullptr});
+        node.equivalence = &node;
+        _index.insert(&node);
+        _primitives[i] = &node;
+    }
+}
+
+const TypeNode* TypeInterner::intern(Type::Kind kind, std::vector<Type> params, std::string custom_name) {
+    const std::size_t hash = hash_node(kind, params, custom_name);
+    TypeNode probe{kind, std::move(params), std::move(custom_name), hash, nullptr};
+    {
+        std::shared_lock lock(_mutex);
+        if (auto it = _index.find(&probe); it != _index.end()) return *it;
+    }
+    std::unique_lock lock(_mutex);
+    return intern_locked(std::move(probe));
+}
+
+// Inserts `probe` if it is new, then links it to the representative of its
+// equality class: `Custom`/`Constant` types are equal by name alone, other
+// kinds by the classes of their parameters.
+const TypeNode* TypeInterner::intern_locked(TypeNode&& probe) {
+    if (auto it = _index.find(&probe); it != _index.end()) return *it;
+
+    const TypeNode* equivalence = nullptr;
+    if (compares_by_name(probe.kind)) {
+        if (!probe.params.empty()) {
+            equivalence = intern_locked(TypeNode{probe.kind, {}, probe.custom_name,
+                                                 hash_node(probe.kind, {}, probe.custom_name), nullptr});
+        }
+    } else {
+        bool canonical = probe.custom_name.empty();
+        std::vector<Type> params;
+        params.reserve(probe.params.size());
+        for (const auto& param : probe.params) {
+            const TypeNode* param_class = param.node()->equivalence;
+            canonical = canonical && param_class == param.node();
+            params.push_back(Type(param_class));
+        }
+        if (!canonical) {
+            const std::size_t hash = hash_node(probe.kind, params, {});
+            equivalence = intern_locked(TypeNode{probe.kind, std::move(params), {}, hash, nullptr});
+        }
+    }
+
+    TypeNode& node = _nodes.emplace_back(std::move(probe));
+    node.equivalence = equivalence ? equivalence : &node;
+    _index.insert(&node);
+    return &node;
+}
+
+std::size_t TypeInterner::size() const {
+    std::shared_lock lock(_mutex);
+    return _nodes.size();
+}
+
+} // namespace t81::frontend
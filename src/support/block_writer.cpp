@@ -0,0 +1,109 @@
+#include "t81/support/block_writer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define T81_HAVE_POSIX_IO 1
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace t81 {
+
+namespace {
+
+// The descriptor is a POSIX fd, or elsewhere a FILE* with stdio buffering
+// turned off; either way each flush is one large write.
+std::intptr_t open_output(const std::filesystem::path& path) {
+#if defined(T81_HAVE_POSIX_IO)
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#else
+    std::FILE* file = std::fopen(path.string().c_str(), "wb");
+    if (!file) return -1;
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    return reinterpret_cast<std::intptr_t>(file);
+#endif
+}
+
+bool write_all(std::intptr_t fd, const char* data, std::size_t size) {
+#if defined(T81_HAVE_POSIX_IO)
+    while (size > 0) {
+        const ssize_t written = ::write(static_cast<int>(fd), data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+#else
+    return std::fwrite(data, 1, size, reinterpret_cast<std::FILE*>(fd)) == size;
+#endif
+}
+
+bool close_output(std::intptr_t fd) {
+#if defined(T81_HAVE_POSIX_IO)
+    return ::close(static_cast<int>(fd)) == 0;
+#else
+    return std::fclose(reinterpret_cast<std::FILE*>(fd)) == 0;
+#endif
+}
+
+} // namespace
+
+BlockWriter::BlockWriter(const std::filesystem::path& path)
+    : _fd(open_output(path)),
+      _buffer(std::make_unique<char[]>(kBlockSize)) {}
+
+BlockWriter::~BlockWriter() {
+    close();
+}
+
+BlockWriter& BlockWriter::write(std::string_view text) {
+    while (!text.empty()) {
+        if (_used == kBlockSize) {
+            flush();
+        }
+        const std::size_t take = std::min(text.size(), kBlockSize - _used);
+        std::memcpy(_buffer.get() + _used, text.data(), take);
+        _used += take;
+        text.remove_prefix(take);
+    }
+    return *this;
+}
+
+BlockWriter& BlockWriter::write(std::int64_t value) {
+    // An int64 needs at most 20 characters, sign included.
+    if (kBlockSize - _used < 20) {
+        flush();
+    }
+    const auto result = std::to_chars(_buffer.get() + _used, _buffer.get() + kBlockSize, value);
+    _used = static_cast<std::size_t>(result.ptr - _buffer.get());
+    return *this;
+}
+
+void BlockWriter::flush() {
+    if (_fd < 0 || _failed || !write_all(_fd, _buffer.get(), _used)) {
+        _failed = true;
+    }
+    _used = 0;
+}
+
+bool BlockWriter::close() {
+    if (_fd < 0) {
+        return false;
+    }
+    flush();
+    if (!close_output(_fd)) {
+        _failed = true;
+    }
+    _fd = -1;
+    return !_failed;
+}
+
+} // namespace t81
@@ -0,0 +1,87 @@
+#include "t81/support/mapped_file.hpp"
+
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define T81_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace t81 {
+
+std::optional<MappedFile> MappedFile::open(const std::filesystem::path& path) {
+    MappedFile file;
+#if defined(T81_HAVE_MMAP)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return std::nullopt;
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    file._size = static_cast<std::size_t>(info.st_size);
+    if (file._size > 0) {
+        void* addr = ::mmap(nullptr, file._size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            return std::nullopt;
+        }
+        file._data = static_cast<const std::byte*>(addr);
+        file._mapped = true;
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return std::nullopt;
+    in.seekg(0, std::ios::end);
+    file._owned.resize(static_cast<std::size_t>(in.tellg()));
+    in.seekg(0, std::ios::beg);
+    in.read(reinterpret_cast<char*>(file._owned.data()), static_cast<std::streamsize>(file._owned.size()));
+    if (!in) return std::nullopt;
+    file._data = file._owned.data();
+    file._size = file._owned.size();
+#endif
+    return file;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _data(std::exchange(other._data, nullptr)),
+      _size(std::exchange(other._size, 0)),
+      _mapped(std::exchange(other._mapped, false)),
+      _owned(std::move(other._owned)) {
+    if (!_mapped && _size > 0) _data = _owned.data();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+        _mapped = std::exchange(other._mapped, false);
+        _owned = std::move(other._owned);
+        if (!_mapped && _size > 0) _data = _owned.data();
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+void MappedFile::release() {
+#if defined(T81_HAVE_MMAP)
+    if (_mapped) {
+        ::munmap(const_cast<std::byte*>(_data), _size);
+    }
+#endif
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+    _owned.clear();
+}
+
+} // namespace t81
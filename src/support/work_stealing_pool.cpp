@@ -0,0 +1,119 @@
+#include "t81/support/work_stealing_pool.hpp"
+
+#include <utility>
+
+namespace t81 {
+
+namespace {
+// Identifies the pool and deque of the calling worker thread, if any.
+thread_local const WorkStealingPool* tl_pool = nullptr;
+thread_local std::size_t tl_queue = 0;
+} // namespace
+
+WorkStealingPool::WorkStealingPool(std::size_t threads) {
+    if (threads == 0) threads = 1;
+    _queues.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        _queues.push_back(std::make_unique<Queue>());
+    }
+    _workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        _workers.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard lock(_mutex);
+        _stopping = true;
+    }
+    _work_cv.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+std::size_t WorkStealingPool::default_concurrency() {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : static_cast<std::size_t>(n);
+}
+
+void WorkStealingPool::submit(Task task) {
+    const std::size_t index = tl_pool == this
+                                  ? tl_queue
+                                  : _next_queue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+    {
+        std::lock_guard lock(_queues[index]->mutex);
+        _queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lock(_mutex);
+        ++_queued;
+        ++_unfinished;
+    }
+    _work_cv.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock lock(_mutex);
+    _idle_cv.wait(lock, [this] { return _unfinished == 0; });
+    if (_error) {
+        std::rethrow_exception(std::exchange(_error, nullptr));
+    }
+}
+
+// Pops from the back of the worker's own deque, otherwise steals from the
+// front of the others. The caller has already claimed one queued task, so
+// some deque is guaranteed to hold one for it.
+WorkStealingPool::Task WorkStealingPool::take(std::size_t index) {
+    const std::size_t n = _queues.size();
+    for (;;) {
+        {
+            auto& own = *_queues[index];
+            std::lock_guard lock(own.mutex);
+            if (!own.tasks.empty()) {
+                Task task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return task;
+            }
+        }
+        for (std::size_t k = 1; k < n; ++k) {
+            auto& victim = *_queues[(index + k) % n];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                Task task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return task;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+void WorkStealingPool::worker_loop(std::size_t index) {
+    tl_pool = this;
+    tl_queue = index;
+    for (;;) {
+        {
+            std::unique_lock lock(_mutex);
+            _work_cv.wait(lock, [this] { return _stopping || _queued > 0; });
+            if (_queued == 0) return;
+            --_queued;
+        }
+
+        Task task = take(index);
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard lock(_mutex);
+            if (!_error) _error = std::current_exception();
+        }
+
+        std::lock_guard lock(_mutex);
+        if (--_unfinished == 0) {
+            _idle_cv.notify_all();
+        }
+    }
+}
+
+} // namespace t81
@@ -0,0 +1,447 @@
+#include "t81/tisc/binary_format.hpp"
+
+#include "t81/support/sha256.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+// tisc-bin-v1 layout. All integers are little-endian.
+//
+//   header (64 bytes)
+//     0  "TISC"   4  u32 version   8  u32 section_count   12 u32 flags
+//     16 u64 file_size   24 u8[32] SHA-256 of bytes [64, file_size)
+//     56 u64 reserved
+//   section table: section_count x {u32 kind, u32 reserved, u64 offset, u64 size}
+//   sections, each 8-byte aligned and opened by {u32 count, u32 reserved}:
+//     Insns        count x 24-byte records laid out as t81::tisc::Insn:
+//                  u8 opcode, 3 pad, i32 a, i64 b, i32 c, u8 literal_kind, 3 pad;
+//                  a Call record holds the callee in a and its argument
+//                  count in b, the arguments being where
+//                  calling_convention.hpp puts them
+//     Floats       count x f64
+//     Symbols      count x {u32 length, bytes}
+//     Tensors      count x {u32 rank, i32 dims[rank], u32 n, f32 data[n]}
+//     Shapes       count x {u32 rank, i32 dims[rank]}
+//     TypeAliases  count x {str name, u32 n, str params[n], str alias,
+//                           u32 kind, u32 n, {str name, str type}[n],
+//                           u32 n, {str name, u32 has_payload, str payload}[n],
+//                           u32 schema_version, str module_path}
+//     Policy       count = byte length, then the policy text
+//   where str is {u32 length, bytes}. Unknown section kinds are skipped.
+
+namespace t81::tisc {
+
+namespace {
+
+constexpr char kMagic[4] = {'T', 'I', 'S', 'C'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kHeaderSize = 64;
+constexpr std::size_t kSectionEntrySize = 24;
+constexpr std::size_t kInsnSize = 24;
+
+enum class Section : std::uint32_t {
+    Insns = 1,
+    Floats,
+    Symbols,
+    Tensors,
+    Shapes,
+    TypeAliases,
+    Policy,
+};
+constexpr std::uint32_t kSectionCount = 7;
+
+static_assert(sizeof(Insn) == kInsnSize && offsetof(Insn, a) == 4 && offsetof(Insn, b) == 8 &&
+                  offsetof(Insn, c) == 16 && offsetof(Insn, literal_kind) == 20,
+              "tisc-bin-v1 instruction records mirror the in-memory Insn layout");
+
+class Writer {
+public:
+    void u8(std::uint8_t value) { _out.push_back(static_cast<char>(value)); }
+    void u32(std::uint32_t value) {
+        for (int i = 0; i < 4; ++i) u8(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+    void u64(std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) u8(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+    void zeros(std::size_t count) { _out.append(count, '\0'); }
+    void str(std::string_view value) {
+        u32(static_cast<std::uint32_t>(value.size()));
+        _out.append(value);
+    }
+    void align8() { zeros((8 - _out.size() % 8) % 8); }
+    void patch_u64(std::size_t at, std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) _out[at + i] = static_cast<char>(value >> (8 * i));
+    }
+    std::size_t size() const { return _out.size(); }
+    std::string& data() { return _out; }
+
+private:
+    std::string _out;
+};
+
+// Bounds-checked cursor; once a read fails every later read fails too.
+class Reader {
+public:
+    Reader(std::span<const std::byte> bytes, std::size_t pos, std::size_t end)
+        : _bytes(bytes), _pos(pos), _end(end) {}
+
+    bool ok() const { return _ok; }
+    std::size_t pos() const { return _pos; }
+
+    const std::byte* take(std::size_t count) {
+        if (!_ok || count > _end - _pos) {
+            _ok = false;
+            return nullptr;
+        }
+        const std::byte* p = _bytes.data() + _pos;
+        _pos += count;
+        return p;
+    }
+    std::uint32_t u32() {
+        const std::byte* p = take(4);
+        if (!p) return 0;
+        std::uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) value |= std::uint32_t{std::to_integer<std::uint8_t>(p[i])} << (8 * i);
+        return value;
+    }
+    std::uint64_t u64() {
+        const std::uint64_t lo = u32();
+        return lo | (std::uint64_t{u32()} << 32);
+    }
+    std::string_view str() {
+        const std::uint32_t length = u32();
+        const std::byte* p = take(length);
+        return p ? std::string_view(reinterpret_cast<const char*>(p), length) : std::string_view();
+    }
+
+private:
+    std::span<const std::byte> _bytes;
+    std::size_t _pos;
+    std::size_t _end;
+    bool _ok = true;
+};
+
+void write_insn(Writer& out, const Insn& insn) {
+    out.u8(static_cast<std::uint8_t>(insn.opcode));
+    out.zeros(3);
+    out.u32(static_cast<std::uint32_t>(insn.a));
+    out.u64(static_cast<std::uint64_t>(insn.b));
+    out.u32(static_cast<std::uint32_t>(insn.c));
+    out.u8(static_cast<std::uint8_t>(insn.literal_kind));
+    out.zeros(3);
+}
+
+Insn read_insn(Reader& in) {
+    Insn insn;
+    const std::byte* head = in.take(4);
+    insn.opcode = head ? static_cast<Opcode>(std::to_integer<std::uint8_t>(head[0])) : Opcode::Nop;
+    insn.a = static_cast<std::int32_t>(in.u32());
+    insn.b = static_cast<std::int64_t>(in.u64());
+    insn.c = static_cast<std::int32_t>(in.u32());
+    const std::byte* tail = in.take(4);
+    insn.literal_kind = tail ? static_cast<LiteralKind>(std::to_integer<std::uint8_t>(tail[0])) : LiteralKind::Int;
+    return insn;
+}
+
+void write_dims(Writer& out, const std::vector<int>& dims) {
+    out.u32(static_cast<std::uint32_t>(dims.size()));
+    for (int dim : dims) out.u32(static_cast<std::uint32_t>(dim));
+}
+
+std::vector<int> read_dims(Reader& in) {
+    const std::uint32_t rank = in.u32();
+    std::vector<int> dims;
+    for (std::uint32_t i = 0; i < rank && in.ok(); ++i) {
+        dims.push_back(static_cast<int>(in.u32()));
+    }
+    return dims;
+}
+
+TypeAliasMetadata read_alias(Reader& in) {
+    TypeAliasMetadata meta;
+    meta.name = in.str();
+    for (std::uint32_t n = in.u32(); n > 0 && in.ok(); --n) meta.params.emplace_back(in.str());
+    meta.alias = in.str();
+    meta.kind = static_cast<StructuralKind>(in.u32());
+    for (std::uint32_t n = in.u32(); n > 0 && in.ok(); --n) {
+        FieldInfo field;
+        field.name = in.str();
+        field.type = in.str();
+        meta.fields.push_back(std::move(field));
+    }
+    for (std::uint32_t n = in.u32(); n > 0 && in.ok(); --n) {
+        VariantInfo variant;
+        variant.name = in.str();
+        const bool has_payload = in.u32() != 0;
+        const std::string_view payload = in.str();
+        if (has_payload) variant.payload = std::string(payload);
+        meta.variants.push_back(std::move(variant));
+    }
+    meta.schema_version = in.u32();
+    meta.module_path = in.str();
+    return meta;
+}
+
+// Starts a section: records its table entry and writes the count header.
+std::size_t begin_section(Writer& out, std::size_t table_at, Section kind, std::size_t count) {
+    out.align8();
+    const std::size_t entry = table_at + (static_cast<std::size_t>(kind) - 1) * kSectionEntrySize;
+    out.patch_u64(entry + 8, out.size());
+    out.u32(static_cast<std::uint32_t>(count));
+    out.u32(0);
+    return entry;
+}
+
+void end_section(Writer& out, std::size_t entry) {
+    std::uint64_t offset = 0;
+    for (int i = 0; i < 8; ++i) offset |= std::uint64_t{static_cast<std::uint8_t>(out.data()[entry + 8 + i])} << (8 * i);
+    out.patch_u64(entry + 16, out.size() - offset);
+}
+
+} // namespace
+
+std::string encode_binary(const Program& program, std::string_view policy_text) {
+    Writer out;
+    out.data().append(kMagic, sizeof(kMagic));
+    out.u32(kVersion);
+    out.u32(kSectionCount);
+    out.u32(0);
+    out.u64(0);       // file size, patched below
+    out.zeros(32);    // content hash, patched below
+    out.u64(0);
+
+    const std::size_t table_at = out.size();
+    for (std::uint32_t kind = 1; kind <= kSectionCount; ++kind) {
+        out.u32(kind);
+        out.u32(0);
+        out.u64(0);
+        out.u64(0);
+    }
+
+    std::size_t entry = begin_section(out, table_at, Section::Insns, program.insns.size());
+    for (const auto& insn : program.insns) write_insn(out, insn);
+    end_section(out, entry);
+
+    entry = begin_section(out, table_at, Section::Floats, program.float_pool.size());
+    for (double value : program.float_pool) out.u64(std::bit_cast<std::uint64_t>(value));
+    end_section(out, entry);
+
+    entry = begin_section(out, table_at, Section::Symbols, program.symbol_pool.size());
+    for (const auto& symbol : program.symbol_pool) out.str(symbol);
+    end_section(out, entry);
+
+    entry = begin_section(out, table_at, Section::Tensors, program.tensor_pool.size());
+    for (const auto& tensor : program.tensor_pool) {
+        write_dims(out, tensor.shape());
+        out.u32(static_cast<std::uint32_t>(tensor.data().size()));
+        for (float value : tensor.data()) out.u32(std::bit_cast<std::uint32_t>(value));
+    }
+    end_section(out, entry);
+
+    entry = begin_section(out, table_at, Section::Shapes, program.shape_pool.size());
+    for (const auto& shape : program.shape_pool) write_dims(out, shape);
+    end_section(out, entry);
+
+    entry = begin_section(out, table_at, Section::TypeAliases, program.type_aliases.size());
+    for (const auto& meta : program.type_aliases) {
+        out.str(meta.name);
+        out.u32(static_cast<std::uint32_t>(meta.params.size()));
+        for (const auto& param : meta.params) out.str(param);
+        out.str(meta.alias);
+        out.u32(static_cast<std::uint32_t>(meta.kind));
+        out.u32(static_cast<std::uint32_t>(meta.fields.size()));
+        for (const auto& field : meta.fields) {
+            out.str(field.name);
+            out.str(field.type);
+        }
+        out.u32(static_cast<std::uint32_t>(meta.variants.size()));
+        for (const auto& variant : meta.variants) {
+            out.str(variant.name);
+            out.u32(variant.payload ? 1 : 0);
+            out.str(variant.payload.value_or(""));
+        }
+        out.u32(meta.schema_version);
+        out.str(meta.module_path);
+    }
+    end_section(out, entry);
+
+    entry = begin_section(out, table_at, Section::Policy, policy_text.size());
+    out.data().append(policy_text);
+    end_section(out, entry);
+
+    out.patch_u64(16, out.size());
+    const std::string& bytes = out.data();
+    const auto digest = Sha256().update(bytes.data() + kHeaderSize, bytes.size() - kHeaderSize).finish();
+    std::memcpy(out.data().data() + 24, digest.data(), digest.size());
+    return std::move(out.data());
+}
+
+std::optional<ProgramView> ProgramView::open(std::span<const std::byte> bytes) {
+    ProgramView view(bytes);
+    if (!view.validate()) {
+        return std::nullopt;
+    }
+    return view;
+}
+
+bool ProgramView::validate() {
+    if (_bytes.size() < kHeaderSize || std::memcmp(_bytes.data(), kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    Reader header(_bytes, 4, kHeaderSize);
+    const std::uint32_t version = header.u32();
+    const std::uint32_t section_count = header.u32();
+    header.u32();
+    if (version != kVersion || header.u64() != _bytes.size()) {
+        return false;
+    }
+
+    Reader table(_bytes, kHeaderSize, _bytes.size());
+    for (std::uint32_t i = 0; i < section_count; ++i) {
+        const std::uint32_t kind = table.u32();
+        table.u32();
+        const std::uint64_t offset = table.u64();
+        const std::uint64_t size = table.u64();
+        if (!table.ok() || offset > _bytes.size() || size > _bytes.size() - offset || size < 8) {
+            return false;
+        }
+        Reader in(_bytes, static_cast<std::size_t>(offset), static_cast<std::size_t>(offset + size));
+        const std::uint32_t count = in.u32();
+        in.u32();
+
+        switch (static_cast<Section>(kind)) {
+            case Section::Insns: {
+                const std::byte* records = in.take(std::size_t{count} * kInsnSize);
+                if (!records) return false;
+                const bool aliasable = std::endian::native == std::endian::little &&
+                                       reinterpret_cast<std::uintptr_t>(records) % alignof(Insn) == 0;
+                if (aliasable) {
+                    _insns = {reinterpret_cast<const Insn*>(records), count};
+                } else {
+                    auto decoded = std::make_shared<std::vector<Insn>>();
+                    Reader records_in(_bytes, in.pos() - std::size_t{count} * kInsnSize, in.pos());
+                    for (std::uint32_t n = 0; n < count; ++n) decoded->push_back(read_insn(records_in));
+                    _insns = *decoded;
+                    _decoded_insns = std::move(decoded);
+                }
+                break;
+            }
+            case Section::Floats:
+                _floats = {in.pos(), count};
+                if (!in.take(std::size_t{count} * 8)) return false;
+                break;
+            case Section::Symbols:
+                _symbols.clear();
+                for (std::uint32_t n = 0; n < count && in.ok(); ++n) {
+                    _symbols.push_back(in.pos());
+                    in.str();
+                }
+                break;
+            case Section::Tensors:
+                _tensors.clear();
+                for (std::uint32_t n = 0; n < count && in.ok(); ++n) {
+                    _tensors.push_back(in.pos());
+                    const std::vector<int> dims = read_dims(in);
+                    std::uint64_t expected = dims.empty() ? 0 : 1;
+                    for (int dim : dims) {
+                        if (dim <= 0) return false;
+                        expected *= static_cast<std::uint64_t>(dim);
+                        if (expected > _bytes.size()) return false;
+                    }
+                    const std::uint32_t values = in.u32();
+                    if (values != expected || !in.take(std::size_t{values} * 4)) return false;
+                }
+                break;
+            case Section::Shapes:
+                _shapes.clear();
+                for (std::uint32_t n = 0; n < count && in.ok(); ++n) {
+                    _shapes.push_back(in.pos());
+                    read_dims(in);
+                }
+                break;
+            case Section::TypeAliases:
+                _aliases.clear();
+                for (std::uint32_t n = 0; n < count && in.ok(); ++n) {
+                    _aliases.push_back(in.pos());
+                    read_alias(in);
+                }
+                break;
+            case Section::Policy: {
+                const std::byte* text = in.take(count);
+                if (!text) return false;
+                _policy = {reinterpret_cast<const char*>(text), count};
+                break;
+            }
+            default:
+                break;  // A section this version does not know about.
+        }
+        if (!in.ok()) {
+            return false;
+        }
+    }
+    return table.ok();
+}
+
+double ProgramView::float_at(std::size_t index) const {
+    Reader in(_bytes, _floats.offset + index * 8, _bytes.size());
+    return std::bit_cast<double>(in.u64());
+}
+
+std::string_view ProgramView::symbol(std::size_t index) const {
+    Reader in(_bytes, _symbols.at(index), _bytes.size());
+    return in.str();
+}
+
+T729Tensor ProgramView::tensor(std::size_t index) const {
+    Reader in(_bytes, _tensors.at(index), _bytes.size());
+    std::vector<int> shape = read_dims(in);
+    std::vector<float> data(in.u32());
+    for (float& value : data) value = std::bit_cast<float>(in.u32());
+    return T729Tensor(std::move(shape), std::move(data));
+}
+
+std::vector<int> ProgramView::shape(std::size_t index) const {
+    Reader in(_bytes, _shapes.at(index), _bytes.size());
+    return read_dims(in);
+}
+
+std::string ProgramView::content_hash() const {
+    Sha256::Digest digest{};
+    std::memcpy(digest.data(), _bytes.data() + 24, digest.size());
+    return Sha256::to_hex(digest);
+}
+
+bool ProgramView::content_hash_matches() const {
+    const auto digest = Sha256().update(_bytes.data() + kHeaderSize, _bytes.size() - kHeaderSize).finish();
+    return std::memcmp(digest.data(), _bytes.data() + 24, digest.size()) == 0;
+}
+
+Program ProgramView::materialize() const {
+    Program program;
+    program.insns.assign(_insns.begin(), _insns.end());
+    for (std::size_t i = 0; i < float_count(); ++i) program.float_pool.push_back(float_at(i));
+    for (std::size_t i = 0; i < symbol_count(); ++i) program.symbol_pool.emplace_back(symbol(i));
+    for (std::size_t i = 0; i < tensor_count(); ++i) program.tensor_pool.push_back(tensor(i));
+    for (std::size_t i = 0; i < shape_count(); ++i) program.shape_pool.push_back(shape(i));
+    for (std::size_t offset : _aliases) {
+        Reader in(_bytes, offset, _bytes.size());
+        program.type_aliases.push_back(read_alias(in));
+    }
+    return program;
+}
+
+std::optional<MappedProgram> MappedProgram::open(const std::filesystem::path& path) {
+    auto file = MappedFile::open(path);
+    if (!file) {
+        return std::nullopt;
+    }
+    auto view = ProgramView::open(file->bytes());
+    if (!view) {
+        return std::nullopt;
+    }
+    return MappedProgram(std::move(*file), std::move(*view));
+}
+
+} // namespace t81::tisc
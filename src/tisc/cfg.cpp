@@ -0,0 +1,272 @@
+#include "t81/tisc/cfg.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <variant>
+
+namespace t81::tisc::ir {
+
+namespace {
+
+const Register* reg_at(const Instruction& instr, std::size_t index) {
+    return index < instr.operands.size() ? std::get_if<Register>(&instr.operands[index]) : nullptr;
+}
+
+void add_register_uses(const Instruction& instr, std::size_t from, RegisterEffects& effects) {
+    for (std::size_t i = from; i < instr.operands.size(); ++i) {
+        if (const Register* reg = reg_at(instr, i)) {
+            effects.uses.push_back(reg->index);
+        }
+    }
+}
+
+} // namespace
+
+RegisterEffects register_effects(const Instruction& instr) {
+    RegisterEffects effects;
+    switch (instr.opcode) {
+        case Opcode::LABEL:
+        case Opcode::JMP:
+        case Opcode::TRAP:
+            break;
+        case Opcode::HALT:
+        case Opcode::RET:
+            effects.uses.push_back(kReturnRegister);
+            break;
+        case Opcode::JZ:
+        case Opcode::JNZ:
+        case Opcode::JN:
+        case Opcode::JP:
+        case Opcode::STORE:
+        case Opcode::PUSH:
+        case Opcode::NOP:
+            add_register_uses(instr, 0, effects);
+            break;
+        case Opcode::CALL:
+            // Lowering treats every call as producing its result in r0.
+            add_register_uses(instr, 1, effects);
+            effects.def = kReturnRegister;
+            break;
+        default:
+            // Everything else writes its first register operand and reads
+            // the rest.
+            if (const Register* dest = reg_at(instr, 0)) {
+                effects.def = dest->index;
+                add_register_uses(instr, 1, effects);
+            } else {
+                add_register_uses(instr, 0, effects);
+            }
+            break;
+    }
+    return effects;
+}
+
+bool is_conditional_jump(Opcode opcode) {
+    return opcode == Opcode::JZ || opcode == Opcode::JNZ || opcode == Opcode::JN || opcode == Opcode::JP;
+}
+
+bool ends_control_flow(Opcode opcode) {
+    return opcode == Opcode::JMP || opcode == Opcode::HALT || opcode == Opcode::RET || opcode == Opcode::TRAP;
+}
+
+std::optional<int> jump_target(const Instruction& instr) {
+    if ((instr.opcode != Opcode::JMP && !is_conditional_jump(instr.opcode)) || instr.operands.empty()) {
+        return std::nullopt;
+    }
+    if (const auto* label = std::get_if<Label>(&instr.operands.front())) {
+        return label->id;
+    }
+    return std::nullopt;
+}
+
+void RegisterSet::insert(int reg) {
+    const auto word = static_cast<std::size_t>(reg) / 64;
+    if (word >= _words.size()) {
+        _words.resize(word + 1, 0);
+    }
+    _words[word] |= std::uint64_t{1} << (static_cast<std::size_t>(reg) % 64);
+}
+
+void RegisterSet::erase(int reg) {
+    const auto word = static_cast<std::size_t>(reg) / 64;
+    if (word < _words.size()) {
+        _words[word] &= ~(std::uint64_t{1} << (static_cast<std::size_t>(reg) % 64));
+    }
+}
+
+bool RegisterSet::contains(int reg) const {
+    const auto word = static_cast<std::size_t>(reg) / 64;
+    return word < _words.size() && (_words[word] >> (static_cast<std::size_t>(reg) % 64) & 1) != 0;
+}
+
+bool RegisterSet::merge(const RegisterSet& other) {
+    if (other._words.size() > _words.size()) {
+        _words.resize(other._words.size(), 0);
+    }
+    bool changed = false;
+    for (std::size_t i = 0; i < other._words.size(); ++i) {
+        const std::uint64_t merged = _words[i] | other._words[i];
+        changed = changed || merged != _words[i];
+        _words[i] = merged;
+    }
+    return changed;
+}
+
+bool RegisterSet::operator==(const RegisterSet& other) const {
+    const std::size_t common = std::min(_words.size(), other._words.size());
+    for (std::size_t i = 0; i < common; ++i) {
+        if (_words[i] != other._words[i]) return false;
+    }
+    const auto& longer = _words.size() > other._words.size() ? _words : other._words;
+    return std::all_of(longer.begin() + static_cast<std::ptrdiff_t>(common), longer.end(),
+                       [](std::uint64_t word) { return word == 0; });
+}
+
+ControlFlowGraph ControlFlowGraph::build(const std::vector<Instruction>& instrs) {
+    ControlFlowGraph cfg;
+    std::unordered_map<int, std::size_t> label_block;
+    for (std::size_t i = 0; i < instrs.size(); ++i) {
+        const Opcode opcode = instrs[i].opcode;
+        const bool leader = i == 0 || opcode == Opcode::LABEL ||
+                            ends_control_flow(instrs[i - 1].opcode) || is_conditional_jump(instrs[i - 1].opcode);
+        if (leader) {
+            BasicBlock block;
+            block.begin = i;
+            cfg._blocks.push_back(block);
+        }
+        cfg._blocks.back().end = i + 1;
+        if (opcode == Opcode::LABEL && !instrs[i].operands.empty()) {
+            if (const auto* label = std::get_if<Label>(&instrs[i].operands.front())) {
+                label_block.emplace(label->id, cfg._blocks.size() - 1);
+            }
+        }
+    }
+
+    auto link = [&cfg](std::size_t from, std::size_t to) {
+        auto& successors = cfg._blocks[from].successors;
+        if (std::find(successors.begin(), successors.end(), to) == successors.end()) {
+            successors.push_back(to);
+            cfg._blocks[to].predecessors.push_back(from);
+        }
+    };
+    for (std::size_t b = 0; b < cfg._blocks.size(); ++b) {
+        const Instruction& last = instrs[cfg._blocks[b].end - 1];
+        if (auto target = jump_target(last)) {
+            if (auto it = label_block.find(*target); it != label_block.end()) {
+                link(b, it->second);
+            }
+        }
+        if (!ends_control_flow(last.opcode) && b + 1 < cfg._blocks.size()) {
+            link(b, b + 1);
+        }
+    }
+    return cfg;
+}
+
+std::vector<bool> ControlFlowGraph::reachable() const {
+    std::vector<bool> seen(_blocks.size(), false);
+    if (_blocks.empty()) return seen;
+    std::vector<std::size_t> work{0};
+    seen[0] = true;
+    while (!work.empty()) {
+        const std::size_t block = work.back();
+        work.pop_back();
+        for (std::size_t next : _blocks[block].successors) {
+            if (!seen[next]) {
+                seen[next] = true;
+                work.push_back(next);
+            }
+        }
+    }
+    return seen;
+}
+
+Liveness Liveness::compute(const std::vector<Instruction>& instrs, const ControlFlowGraph& cfg) {
+    const auto& blocks = cfg.blocks();
+    Liveness liveness;
+    liveness._live_in.resize(blocks.size());
+    liveness._live_out.resize(blocks.size());
+
+    // Per-block upward-exposed uses and definitions.
+    std::vector<RegisterSet> uses(blocks.size());
+    std::vector<RegisterSet> defs(blocks.size());
+    for (std::size_t b = 0; b < blocks.size(); ++b) {
+        for (std::size_t i = blocks[b].begin; i < blocks[b].end; ++i) {
+            const RegisterEffects effects = register_effects(instrs[i]);
+            for (int reg : effects.uses) {
+                if (!defs[b].contains(reg)) uses[b].insert(reg);
+            }
+            if (effects.def) defs[b].insert(*effects.def);
+        }
+        const Instruction& last = instrs[blocks[b].end - 1];
+        if (blocks[b].successors.empty() && !ends_control_flow(last.opcode)) {
+            liveness._live_out[b].insert(kReturnRegister);
+        }
+    }
+
+    // Backward fixpoint; visiting blocks in reverse order converges fast
+    // because most edges point forward.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (std::size_t b = blocks.size(); b-- > 0;) {
+            for (std::size_t next : blocks[b].successors) {
+                changed = liveness._live_out[b].merge(liveness._live_in[next]) || changed;
+            }
+            RegisterSet in = uses[b];
+            liveness._live_out[b].for_each([&](int reg) {
+                if (!defs[b].contains(reg)) in.insert(reg);
+            });
+            if (!(in == liveness._live_in[b])) {
+                liveness._live_in[b] = std::move(in);
+                changed = true;
+            }
+        }
+    }
+    return liveness;
+}
+
+std::vector<LiveInterval> live_intervals(const std::vector<Instruction>& instrs, const ControlFlowGraph& cfg,
+                                         const Liveness& liveness) {
+    std::vector<LiveInterval> intervals;
+    std::vector<bool> written;
+    std::unordered_map<int, std::size_t> slot;
+    auto extend = [&](int reg, std::size_t position) -> LiveInterval& {
+        auto [it, inserted] = slot.emplace(reg, intervals.size());
+        if (inserted) {
+            intervals.push_back(LiveInterval{reg, PrimitiveKind::Unknown, position, position});
+            written.push_back(false);
+        }
+        LiveInterval& interval = intervals[it->second];
+        interval.start = std::min(interval.start, position);
+        interval.end = std::max(interval.end, position);
+        return interval;
+    };
+
+    const auto& blocks = cfg.blocks();
+    for (std::size_t b = 0; b < blocks.size(); ++b) {
+        liveness.live_in(b).for_each([&](int reg) { extend(reg, 2 * blocks[b].begin); });
+        liveness.live_out(b).for_each([&](int reg) { extend(reg, 2 * blocks[b].end - 1); });
+        for (std::size_t i = blocks[b].begin; i < blocks[b].end; ++i) {
+            const RegisterEffects effects = register_effects(instrs[i]);
+            for (int reg : effects.uses) {
+                extend(reg, 2 * i);
+            }
+            if (effects.def) {
+                LiveInterval& interval = extend(*effects.def, 2 * i + 1);
+                const std::size_t index = slot.at(*effects.def);
+                if (!written[index]) {
+                    written[index] = true;
+                    interval.kind = instrs[i].boolean_result ? PrimitiveKind::Boolean : instrs[i].primitive;
+                }
+            }
+        }
+    }
+
+    std::sort(intervals.begin(), intervals.end(), [](const LiveInterval& a, const LiveInterval& b) {
+        return a.start != b.start ? a.start < b.start : a.reg < b.reg;
+    });
+    return intervals;
+}
+
+} // namespace t81::tisc::ir
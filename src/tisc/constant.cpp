@@ -0,0 +1,294 @@
+#include "t81/tisc/constant.hpp"
+
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <variant>
+
+namespace t81::tisc::ir {
+
+namespace {
+
+constexpr std::int64_t kMin = std::numeric_limits<std::int64_t>::min();
+constexpr std::int64_t kMax = std::numeric_limits<std::int64_t>::max();
+
+// Overflow-checked int64 arithmetic; nullopt when the exact result does not
+// fit.
+std::optional<std::int64_t> checked_add(std::int64_t a, std::int64_t b) {
+    if ((b > 0 && a > kMax - b) || (b < 0 && a < kMin - b)) return std::nullopt;
+    return a + b;
+}
+
+std::optional<std::int64_t> checked_sub(std::int64_t a, std::int64_t b) {
+    if ((b < 0 && a > kMax + b) || (b > 0 && a < kMin + b)) return std::nullopt;
+    return a - b;
+}
+
+std::optional<std::int64_t> checked_neg(std::int64_t a) {
+    if (a == kMin) return std::nullopt;
+    return -a;
+}
+
+std::optional<std::int64_t> checked_mul(std::int64_t a, std::int64_t b) {
+    if (a == 0 || b == 0) return 0;
+    if (a == -1) return checked_neg(b);
+    if (b == -1) return checked_neg(a);
+    const bool overflows = a > 0 ? (b > 0 ? a > kMax / b : b < kMin / a) : (b > 0 ? a < kMin / b : a < kMax / b);
+    if (overflows) return std::nullopt;
+    return a * b;
+}
+
+// Integer arithmetic folds only when the result is what any int64 machine
+// would compute: overflow and division by zero are left to the runtime.
+std::optional<std::int64_t> fold_integer(Opcode opcode, std::int64_t a, std::int64_t b) {
+    switch (opcode) {
+        case Opcode::ADD: return checked_add(a, b);
+        case Opcode::SUB: return checked_sub(a, b);
+        case Opcode::MUL: return checked_mul(a, b);
+        case Opcode::DIV:
+            if (b == 0 || (a == kMin && b == -1)) return std::nullopt;
+            return a / b;
+        case Opcode::MOD:
+            if (b == 0 || (a == kMin && b == -1)) return std::nullopt;
+            return a % b;
+        default: return std::nullopt;
+    }
+}
+
+// IEEE double arithmetic; a zero divisor is left to the runtime, which may
+// trap rather than produce an infinity.
+std::optional<double> fold_float(Opcode opcode, double a, double b) {
+    switch (opcode) {
+        case Opcode::FADD: return a + b;
+        case Opcode::FSUB: return a - b;
+        case Opcode::FMUL: return a * b;
+        case Opcode::FDIV:
+            if (b == 0.0) return std::nullopt;
+            return a / b;
+        default: return std::nullopt;
+    }
+}
+
+// Exact rational arithmetic; gives up rather than round when a cross
+// product overflows.
+std::optional<Constant> fold_fraction(Opcode opcode, const Constant& a, const Constant& b) {
+    std::optional<std::int64_t> num;
+    std::optional<std::int64_t> den;
+    switch (opcode) {
+        case Opcode::FRACADD:
+        case Opcode::FRACSUB: {
+            const auto lhs = checked_mul(a.num, b.den);
+            const auto rhs = checked_mul(b.num, a.den);
+            if (!lhs || !rhs) return std::nullopt;
+            num = opcode == Opcode::FRACADD ? checked_add(*lhs, *rhs) : checked_sub(*lhs, *rhs);
+            den = checked_mul(a.den, b.den);
+            break;
+        }
+        case Opcode::FRACMUL:
+            num = checked_mul(a.num, b.num);
+            den = checked_mul(a.den, b.den);
+            break;
+        case Opcode::FRACDIV:
+            num = checked_mul(a.num, b.den);
+            den = checked_mul(a.den, b.num);
+            break;
+        default:
+            return std::nullopt;
+    }
+    if (!num || !den) return std::nullopt;
+    return Constant::of_fraction(*num, *den);
+}
+
+// -1, 0 or 1; nullopt when the operands are of kinds CMP never mixes.
+std::optional<int> compare(const Constant& a, const Constant& b) {
+    if (a.is_integral() && b.is_integral()) {
+        return (a.integer > b.integer) - (a.integer < b.integer);
+    }
+    if (a.kind == PrimitiveKind::Float && b.kind == PrimitiveKind::Float) {
+        if (std::isnan(a.real) || std::isnan(b.real)) return std::nullopt;
+        return (a.real > b.real) - (a.real < b.real);
+    }
+    if (a.kind == PrimitiveKind::Fraction && b.kind == PrimitiveKind::Fraction) {
+        const auto lhs = checked_mul(a.num, b.den);
+        const auto rhs = checked_mul(b.num, a.den);
+        if (!lhs || !rhs) return std::nullopt;
+        return (*lhs > *rhs) - (*lhs < *rhs);
+    }
+    return std::nullopt;
+}
+
+std::optional<bool> relation_holds(ComparisonRelation relation, int order) {
+    switch (relation) {
+        case ComparisonRelation::Less: return order < 0;
+        case ComparisonRelation::LessEqual: return order <= 0;
+        case ComparisonRelation::Greater: return order > 0;
+        case ComparisonRelation::GreaterEqual: return order >= 0;
+        case ComparisonRelation::Equal: return order == 0;
+        case ComparisonRelation::NotEqual: return order != 0;
+        case ComparisonRelation::None: return std::nullopt;
+    }
+    return std::nullopt;
+}
+
+// Sign of a branch condition: JZ/JNZ test against zero, JN/JP the sign.
+std::optional<int> sign_of(const Constant& value) {
+    switch (value.kind) {
+        case PrimitiveKind::Float:
+            if (std::isnan(value.real)) return std::nullopt;
+            return (value.real > 0) - (value.real < 0);
+        case PrimitiveKind::Fraction:
+            return (value.num > 0) - (value.num < 0);
+        default:
+            return (value.integer > 0) - (value.integer < 0);
+    }
+}
+
+std::optional<Constant> fold_unary(Opcode opcode, const Constant& src) {
+    switch (opcode) {
+        case Opcode::NEG:
+            if (src.kind == PrimitiveKind::Integer) {
+                if (auto v = checked_neg(src.integer)) return Constant::of_integer(*v);
+            } else if (src.kind == PrimitiveKind::Float) {
+                return Constant::of_float(-src.real);
+            } else if (src.kind == PrimitiveKind::Fraction) {
+                return Constant::of_fraction(-src.num, src.den);
+            }
+            return std::nullopt;
+        case Opcode::I2F:
+            if (!src.is_integral()) return std::nullopt;
+            // Only integers a double holds exactly, so the runtime's
+            // rounding mode never matters.
+            if (src.integer < -(std::int64_t{1} << 53) || src.integer > (std::int64_t{1} << 53)) {
+                return std::nullopt;
+            }
+            return Constant::of_float(static_cast<double>(src.integer));
+        case Opcode::I2FRAC:
+            if (!src.is_integral()) return std::nullopt;
+            return Constant::of_fraction(src.integer, 1);
+        case Opcode::F2I:
+            // Only exact conversions: how the runtime rounds is not part of
+            // the IR contract.
+            if (src.kind != PrimitiveKind::Float || src.real != std::trunc(src.real) || std::fabs(src.real) > 9.0e15) {
+                return std::nullopt;
+            }
+            return Constant::of_integer(static_cast<std::int64_t>(src.real));
+        case Opcode::FRAC2I:
+            if (src.kind != PrimitiveKind::Fraction || src.den != 1) return std::nullopt;
+            return Constant::of_integer(src.num);
+        default:
+            return std::nullopt;
+    }
+}
+
+std::optional<Constant> fold_binary(const Instruction& instr, const Constant& lhs, const Constant& rhs) {
+    switch (instr.opcode) {
+        case Opcode::ADD:
+        case Opcode::SUB:
+        case Opcode::MUL:
+        case Opcode::DIV:
+        case Opcode::MOD:
+            if (lhs.kind != PrimitiveKind::Integer || rhs.kind != PrimitiveKind::Integer) return std::nullopt;
+            if (auto v = fold_integer(instr.opcode, lhs.integer, rhs.integer)) return Constant::of_integer(*v);
+            return std::nullopt;
+        case Opcode::FADD:
+        case Opcode::FSUB:
+        case Opcode::FMUL:
+        case Opcode::FDIV:
+            if (lhs.kind != PrimitiveKind::Float || rhs.kind != PrimitiveKind::Float) return std::nullopt;
+            if (auto v = fold_float(instr.opcode, lhs.real, rhs.real)) return Constant::of_float(*v);
+            return std::nullopt;
+        case Opcode::FRACADD:
+        case Opcode::FRACSUB:
+        case Opcode::FRACMUL:
+        case Opcode::FRACDIV:
+            if (lhs.kind != PrimitiveKind::Fraction || rhs.kind != PrimitiveKind::Fraction) return std::nullopt;
+            return fold_fraction(instr.opcode, lhs, rhs);
+        case Opcode::CMP: {
+            const auto order = compare(lhs, rhs);
+            if (!order) return std::nullopt;
+            const auto holds = relation_holds(instr.relation, *order);
+            if (!holds) return std::nullopt;
+            return Constant::of_integer(*holds ? 1 : 0, PrimitiveKind::Boolean);
+        }
+        default:
+            return std::nullopt;
+    }
+}
+
+} // namespace
+
+bool Constant::operator==(const Constant& other) const {
+    if (kind != other.kind) return false;
+    switch (kind) {
+        case PrimitiveKind::Float:
+            return std::bit_cast<std::uint64_t>(real) == std::bit_cast<std::uint64_t>(other.real);
+        case PrimitiveKind::Fraction:
+            return num == other.num && den == other.den;
+        default:
+            return integer == other.integer;
+    }
+}
+
+std::optional<Constant> Constant::of_fraction(std::int64_t num, std::int64_t den) {
+    if (den == 0 || num == kMin || den == kMin) return std::nullopt;
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+    const std::int64_t divisor = std::gcd(num, den);
+    Constant c;
+    c.kind = PrimitiveKind::Fraction;
+    c.num = num / divisor;
+    c.den = den / divisor;
+    return c;
+}
+
+bool is_integer_load(const Instruction& instr) {
+    return instr.opcode == Opcode::LOADI && instr.literal_kind == tisc::LiteralKind::Int &&
+           !instr.text_literal.has_value() && instr.operands.size() == 2 &&
+           std::holds_alternative<Register>(instr.operands[0]) && std::holds_alternative<Immediate>(instr.operands[1]);
+}
+
+std::optional<Constant> fold_instruction(const Instruction& instr, std::span<const Constant* const> operands) {
+    auto known = [&](std::size_t index) -> const Constant* {
+        return index < operands.size() ? operands[index] : nullptr;
+    };
+    switch (instr.opcode) {
+        case Opcode::LOADI:
+            if (!is_integer_load(instr)) return std::nullopt;
+            return Constant::of_integer(std::get<Immediate>(instr.operands[1]).value,
+                                        instr.primitive == PrimitiveKind::Boolean ? PrimitiveKind::Boolean
+                                                                                  : PrimitiveKind::Integer);
+        case Opcode::MOV:
+            if (instr.operands.size() != 2) return std::nullopt;
+            if (const Constant* src = known(1)) return *src;
+            return std::nullopt;
+        default:
+            break;
+    }
+    if (instr.operands.size() == 2) {
+        const Constant* src = known(1);
+        if (!src) return std::nullopt;
+        return fold_unary(instr.opcode, *src);
+    }
+    if (instr.operands.size() != 3) return std::nullopt;
+    const Constant* lhs = known(1);
+    const Constant* rhs = known(2);
+    if (!lhs || !rhs) return std::nullopt;
+    return fold_binary(instr, *lhs, *rhs);
+}
+
+std::optional<bool> fold_branch_condition(Opcode opcode, const Constant& condition) {
+    const auto sign = sign_of(condition);
+    if (!sign) return std::nullopt;
+    switch (opcode) {
+        case Opcode::JZ: return *sign == 0;
+        case Opcode::JNZ: return *sign != 0;
+        case Opcode::JN: return *sign < 0;
+        case Opcode::JP: return *sign > 0;
+        default: return std::nullopt;
+    }
+}
+
+} // namespace t81::tisc::ir
@@ -0,0 +1,127 @@
+#include "t81/tisc/pass_manager.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+#include "t81/tisc/passes.hpp"
+#include "t81/tisc/pretty_printer.hpp"
+
+namespace t81::tisc::ir {
+
+namespace {
+
+struct PassInfo {
+    std::string_view name;
+    OptLevel min_level;
+    std::unique_ptr<Pass> (*create)();
+};
+
+// The built-in pipeline, in the order it runs. A pass's position here is
+// part of the output format: reordering changes the emitted bytecode.
+constexpr PassInfo kPipeline[] = {
+    {"constant-fold", OptLevel::O1, &make_constant_fold_pass},
+    {"unreachable-code", OptLevel::O1, &make_unreachable_code_pass},
+    {"sccp", OptLevel::O2, &make_sccp_pass},
+    {"gvn", OptLevel::O2, &make_gvn_pass},
+    {"coalesce-copies", OptLevel::O2, &make_coalesce_copies_pass},
+    {"dead-registers", OptLevel::O1, &make_dead_registers_pass},
+    {"simplify-jumps", OptLevel::O1, &make_simplify_jumps_pass},
+    {"register-allocation", OptLevel::O1, &make_register_allocation_pass},
+    {"lower-calls", OptLevel::O0, &make_lower_calls_pass},
+};
+
+std::string format_ms(double ms) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%10.3f ms", ms);
+    return buffer;
+}
+
+} // namespace
+
+std::optional<OptLevel> parse_opt_level(std::string_view flag) {
+    if (flag == "-O0") return OptLevel::O0;
+    if (flag == "-O1") return OptLevel::O1;
+    if (flag == "-O2") return OptLevel::O2;
+    return std::nullopt;
+}
+
+std::string_view opt_level_name(OptLevel level) {
+    switch (level) {
+        case OptLevel::O0: return "O0";
+        case OptLevel::O1: return "O1";
+        case OptLevel::O2: return "O2";
+    }
+    return "O0";
+}
+
+void PassContext::count(std::string_view counter, std::int64_t value) {
+    _counters.emplace_back(std::string(counter), value);
+}
+
+PassManager PassManager::for_level(OptLevel level) {
+    PassManager manager;
+    for (const PassInfo& info : kPipeline) {
+        if (level >= info.min_level) {
+            manager.add_pass(info.create());
+        }
+    }
+    return manager;
+}
+
+std::vector<std::string_view> PassManager::pass_names() {
+    std::vector<std::string_view> names;
+    for (const PassInfo& info : kPipeline) {
+        names.push_back(info.name);
+    }
+    return names;
+}
+
+void PassManager::add_pass(std::unique_ptr<Pass> pass) {
+    _passes.push_back(std::move(pass));
+}
+
+void PassManager::print_after(std::string name, std::ostream& out) {
+    _print_after = std::move(name);
+    _print_out = &out;
+}
+
+void PassManager::run(IntermediateProgram& program) {
+    using Clock = std::chrono::steady_clock;
+    _instructions_in = program.instructions().size();
+    for (const auto& pass : _passes) {
+        PassContext context;
+        PassTiming timing;
+        timing.name = std::string(pass->name());
+        timing.instructions_before = program.instructions().size();
+        const auto start = Clock::now();
+        timing.changed = pass->run(program, context);
+        timing.wall_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        timing.instructions_after = program.instructions().size();
+        timing.counters = context.counters();
+        _timings.push_back(std::move(timing));
+
+        if (_print_out && pass->name() == _print_after) {
+            *_print_out << "; IR after " << _print_after << "\n" << pretty_print(program) << "\n";
+        }
+    }
+    _instructions_out = program.instructions().size();
+}
+
+void PassManager::write_timing_report(std::ostream& out) const {
+    out << "pass timing:\n";
+    double total_ms = 0.0;
+    for (const PassTiming& timing : _timings) {
+        total_ms += timing.wall_ms;
+        out << "  " << timing.name << std::string(timing.name.size() < 24 ? 24 - timing.name.size() : 1, ' ')
+            << format_ms(timing.wall_ms) << "  insns " << timing.instructions_before << " -> "
+            << timing.instructions_after;
+        for (const auto& [counter, value] : timing.counters) {
+            out << "  " << counter << "=" << value;
+        }
+        out << "\n";
+    }
+    out << "  total" << std::string(19, ' ') << format_ms(total_ms) << "  insns " << _instructions_in << " -> "
+        << _instructions_out << "\n";
+}
+
+} // namespace t81::tisc::ir
@@ -0,0 +1,167 @@
+#include "t81/tisc/passes.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#include "t81/tisc/constant.hpp"
+
+namespace t81::tisc::ir {
+
+namespace {
+
+const Register* reg_at(const Instruction& instr, std::size_t index) {
+    return index < instr.operands.size() ? std::get_if<Register>(&instr.operands[index]) : nullptr;
+}
+
+Instruction make_loadi(Register dest, std::int64_t value, PrimitiveKind primitive) {
+    Instruction instr(Opcode::LOADI, {dest, Immediate{value}});
+    instr.primitive = primitive;
+    return instr;
+}
+
+/**
+ * Local constant folding and propagation.
+ *
+ * Walks each extended basic block (from a LABEL to the next one) tracking
+ * which registers hold known constants. Arithmetic, comparisons, copies
+ * and conversions over known inputs become a single LOADI, and
+ * conditional jumps on known conditions become a JMP or disappear.
+ * Knowledge is dropped at every LABEL, since another path may join there,
+ * and at every CALL, whose callee may write any register.
+ *
+ * TISC operands are registers only, so a constant is propagated by folding
+ * it into its users; a LOADI that ends up with no reader anywhere in the
+ * program is then deleted. r0 carries the return value out of HALT and is
+ * never treated as unread.
+ */
+class ConstantFoldPass final : public Pass {
+public:
+    std::string_view name() const override { return "constant-fold"; }
+
+    bool run(IntermediateProgram& program, PassContext& context) override {
+        auto& instrs = program.mutable_instructions();
+        std::int64_t folded = 0;
+        std::int64_t branches = 0;
+
+        std::unordered_map<int, Constant> known;
+        std::vector<Instruction> out;
+        out.reserve(instrs.size());
+        for (Instruction& instr : instrs) {
+            if (instr.opcode == Opcode::LABEL || instr.opcode == Opcode::CALL) {
+                known.clear();
+                out.push_back(std::move(instr));
+                continue;
+            }
+            if (auto taken = fold_branch(instr, known)) {
+                ++branches;
+                if (*taken) {
+                    Instruction jump(Opcode::JMP, {instr.operands[0]});
+                    out.push_back(std::move(jump));
+                }
+                continue;
+            }
+            const Register* written = reg_at(instr, 0);
+            const std::optional<Register> dest = written ? std::optional<Register>(*written) : std::nullopt;
+            std::optional<Constant> value = dest ? evaluate(instr, known) : std::nullopt;
+            if (value && value->is_integral() && !is_integer_load(instr)) {
+                instr = make_loadi(*dest, value->integer, value->kind);
+                ++folded;
+            }
+            if (value) {
+                known[dest->index] = *value;
+            } else {
+                forget_written(instr, known);
+            }
+            out.push_back(std::move(instr));
+        }
+
+        const std::int64_t removed = remove_unread_loads(out);
+        instrs = std::move(out);
+        context.count("folded", folded);
+        context.count("branches-folded", branches);
+        context.count("loads-removed", removed);
+        return folded + branches + removed > 0;
+    }
+
+private:
+    static const Constant* lookup(const Instruction& instr, std::size_t index,
+                                  const std::unordered_map<int, Constant>& known) {
+        const Register* reg = reg_at(instr, index);
+        if (!reg) return nullptr;
+        auto it = known.find(reg->index);
+        return it == known.end() ? nullptr : &it->second;
+    }
+
+    static std::optional<bool> fold_branch(const Instruction& instr, const std::unordered_map<int, Constant>& known) {
+        if (instr.opcode != Opcode::JZ && instr.opcode != Opcode::JNZ && instr.opcode != Opcode::JN &&
+            instr.opcode != Opcode::JP) {
+            return std::nullopt;
+        }
+        if (instr.operands.size() != 2 || !std::holds_alternative<Label>(instr.operands[0])) {
+            return std::nullopt;
+        }
+        const Constant* cond = lookup(instr, 1, known);
+        if (!cond) return std::nullopt;
+        return fold_branch_condition(instr.opcode, *cond);
+    }
+
+    // The value `instr` writes to its first operand, if it is known.
+    static std::optional<Constant> evaluate(const Instruction& instr, const std::unordered_map<int, Constant>& known) {
+        std::array<const Constant*, 3> operands{};
+        for (std::size_t i = 0; i < operands.size(); ++i) {
+            operands[i] = lookup(instr, i, known);
+        }
+        return fold_instruction(instr, operands);
+    }
+
+    // Any register an unmodelled instruction names may have been written.
+    static void forget_written(const Instruction& instr, std::unordered_map<int, Constant>& known) {
+        for (const Operand& operand : instr.operands) {
+            if (const auto* reg = std::get_if<Register>(&operand)) {
+                known.erase(reg->index);
+            }
+        }
+    }
+
+    // Deletes integer LOADIs into registers that nothing else names. A
+    // register named only as the destination of such loads is never read.
+    static std::int64_t remove_unread_loads(std::vector<Instruction>& instrs) {
+        std::unordered_set<int> named;
+        for (const Instruction& instr : instrs) {
+            const bool load = is_integer_load(instr);
+            for (std::size_t i = load ? 1 : 0; i < instr.operands.size(); ++i) {
+                if (const auto* reg = std::get_if<Register>(&instr.operands[i])) {
+                    named.insert(reg->index);
+                }
+            }
+        }
+        std::int64_t removed = 0;
+        std::vector<Instruction> kept;
+        kept.reserve(instrs.size());
+        for (Instruction& instr : instrs) {
+            if (is_integer_load(instr)) {
+                const int index = reg_at(instr, 0)->index;
+                if (index != 0 && !named.contains(index)) {
+                    ++removed;
+                    continue;
+                }
+            }
+            kept.push_back(std::move(instr));
+        }
+        instrs = std::move(kept);
+        return removed;
+    }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> make_constant_fold_pass() {
+    return std::make_unique<ConstantFoldPass>();
+}
+
+} // namespace t81::tisc::ir
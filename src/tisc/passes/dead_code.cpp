@@ -0,0 +1,173 @@
+#include "t81/tisc/passes.hpp"
+
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+#include "t81/tisc/cfg.hpp"
+
+namespace t81::tisc::ir {
+
+namespace {
+
+// Whether the function a CALL names is known to be free of effects and to
+// return. Calls to `@effect` functions, to functions that may trap or not
+// return, and to functions this program has no metadata for (imports,
+// builtins), must stay.
+bool is_pure_call(const Instruction& instr, const IntermediateProgram& program) {
+    if (instr.operands.empty()) return false;
+    const auto* id = std::get_if<Immediate>(&instr.operands.front());
+    const auto& targets = program.call_targets();
+    if (!id || id->value < 1 || static_cast<std::size_t>(id->value) > targets.size()) return false;
+    const std::string& name = targets[static_cast<std::size_t>(id->value) - 1];
+    for (const FunctionMetadata& meta : program.function_metadata()) {
+        if (meta.name == name) return !meta.is_effectful && meta.is_total;
+    }
+    return false;
+}
+
+// Instructions that only compute a register value and cannot trap, so
+// removing one whose result is never read changes nothing observable.
+// Division, unwrapping, memory, stack and weight loads can fail at run
+// time and are kept.
+bool is_removable(const Instruction& instr, const IntermediateProgram& program) {
+    switch (instr.opcode) {
+        case Opcode::ADD:
+        case Opcode::SUB:
+        case Opcode::MUL:
+        case Opcode::NEG:
+        case Opcode::FADD:
+        case Opcode::FSUB:
+        case Opcode::FMUL:
+        case Opcode::FRACADD:
+        case Opcode::FRACSUB:
+        case Opcode::FRACMUL:
+        case Opcode::CMP:
+        case Opcode::MOV:
+        case Opcode::LOADI:
+        case Opcode::I2F:
+        case Opcode::F2I:
+        case Opcode::I2FRAC:
+        case Opcode::FRAC2I:
+        case Opcode::MAKE_OPTION_SOME:
+        case Opcode::MAKE_OPTION_NONE:
+        case Opcode::MAKE_RESULT_OK:
+        case Opcode::MAKE_RESULT_ERR:
+        case Opcode::OPTION_IS_SOME:
+        case Opcode::RESULT_IS_OK:
+        case Opcode::MAKE_ENUM_VARIANT:
+        case Opcode::MAKE_ENUM_VARIANT_PAYLOAD:
+        case Opcode::ENUM_IS_VARIANT:
+            return true;
+        case Opcode::CALL:
+            return is_pure_call(instr, program);
+        default:
+            return false;
+    }
+}
+
+bool is_self_move(const Instruction& instr) {
+    if (instr.opcode != Opcode::MOV || instr.operands.size() != 2) return false;
+    const auto* dest = std::get_if<Register>(&instr.operands[0]);
+    const auto* src = std::get_if<Register>(&instr.operands[1]);
+    return dest && src && dest->index == src->index;
+}
+
+/**
+ * Removes every basic block the entry cannot reach: code after a HALT,
+ * JMP or TRAP up to the next label something still jumps to, and the arms
+ * of branches constant folding resolved.
+ */
+class UnreachableCodePass final : public Pass {
+public:
+    std::string_view name() const override { return "unreachable-code"; }
+
+    bool run(IntermediateProgram& program, PassContext& context) override {
+        auto& instrs = program.mutable_instructions();
+        const auto cfg = ControlFlowGraph::build(instrs);
+        const auto reachable = cfg.reachable();
+
+        std::vector<Instruction> kept;
+        kept.reserve(instrs.size());
+        std::int64_t blocks = 0;
+        for (std::size_t b = 0; b < cfg.blocks().size(); ++b) {
+            const BasicBlock& block = cfg.blocks()[b];
+            if (!reachable[b]) {
+                ++blocks;
+                continue;
+            }
+            for (std::size_t i = block.begin; i < block.end; ++i) {
+                kept.push_back(std::move(instrs[i]));
+            }
+        }
+        const auto removed = static_cast<std::int64_t>(instrs.size() - kept.size());
+        instrs = std::move(kept);
+        context.count("blocks-removed", blocks);
+        context.count("instructions-removed", removed);
+        return removed > 0;
+    }
+};
+
+/**
+ * Removes instructions whose destination register is dead: not read on
+ * any path before it is next written. Liveness is recomputed until
+ * nothing more can go, since removing one instruction can make the
+ * registers it read dead in turn. Side-effecting instructions (TRAP,
+ * calls to `@effect` functions, anything that can fail at run time) stay
+ * even when their result is unused.
+ */
+class DeadRegistersPass final : public Pass {
+public:
+    std::string_view name() const override { return "dead-registers"; }
+
+    bool run(IntermediateProgram& program, PassContext& context) override {
+        auto& instrs = program.mutable_instructions();
+        std::int64_t removed = 0;
+        std::int64_t rounds = 0;
+        while (true) {
+            ++rounds;
+            const auto cfg = ControlFlowGraph::build(instrs);
+            const auto liveness = Liveness::compute(instrs, cfg);
+            std::vector<bool> dead(instrs.size(), false);
+            std::int64_t found = 0;
+            for (std::size_t b = 0; b < cfg.blocks().size(); ++b) {
+                const BasicBlock& block = cfg.blocks()[b];
+                RegisterSet live = liveness.live_out(b);
+                for (std::size_t i = block.end; i-- > block.begin;) {
+                    const RegisterEffects effects = register_effects(instrs[i]);
+                    if (is_self_move(instrs[i]) ||
+                        (effects.def && !live.contains(*effects.def) && is_removable(instrs[i], program))) {
+                        dead[i] = true;
+                        ++found;
+                        continue;
+                    }
+                    if (effects.def) live.erase(*effects.def);
+                    for (int reg : effects.uses) live.insert(reg);
+                }
+            }
+            if (found == 0) break;
+            std::vector<Instruction> kept;
+            kept.reserve(instrs.size() - static_cast<std::size_t>(found));
+            for (std::size_t i = 0; i < instrs.size(); ++i) {
+                if (!dead[i]) kept.push_back(std::move(instrs[i]));
+            }
+            instrs = std::move(kept);
+            removed += found;
+        }
+        context.count("instructions-removed", removed);
+        context.count("rounds", rounds);
+        return removed > 0;
+    }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> make_unreachable_code_pass() {
+    return std::make_unique<UnreachableCodePass>();
+}
+
+std::unique_ptr<Pass> make_dead_registers_pass() {
+    return std::make_unique<DeadRegistersPass>();
+}
+
+} // namespace t81::tisc::ir
@@ -0,0 +1,258 @@
+#include "t81/tisc/passes.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "t81/tisc/cfg.hpp"
+#include "t81/tisc/ssa.hpp"
+
+namespace t81::tisc::ir {
+
+namespace {
+
+// Instructions whose result depends only on their operands. Those that can
+// trap (division, unwrapping) still qualify: a dominating twin with the
+// same operands has already trapped if this one would. Constructors are
+// left out, since the runtime may give each new value its own identity.
+bool is_value_numbered(Opcode opcode) {
+    switch (opcode) {
+        case Opcode::ADD:
+        case Opcode::SUB:
+        case Opcode::MUL:
+        case Opcode::DIV:
+        case Opcode::MOD:
+        case Opcode::NEG:
+        case Opcode::FADD:
+        case Opcode::FSUB:
+        case Opcode::FMUL:
+        case Opcode::FDIV:
+        case Opcode::FRACADD:
+        case Opcode::FRACSUB:
+        case Opcode::FRACMUL:
+        case Opcode::FRACDIV:
+        case Opcode::CMP:
+        case Opcode::LOADI:
+        case Opcode::I2F:
+        case Opcode::F2I:
+        case Opcode::I2FRAC:
+        case Opcode::FRAC2I:
+        case Opcode::OPTION_IS_SOME:
+        case Opcode::OPTION_UNWRAP:
+        case Opcode::RESULT_IS_OK:
+        case Opcode::RESULT_UNWRAP_OK:
+        case Opcode::RESULT_UNWRAP_ERR:
+        case Opcode::ENUM_IS_VARIANT:
+        case Opcode::ENUM_UNWRAP_PAYLOAD:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool is_commutative(const Instruction& instr) {
+    switch (instr.opcode) {
+        case Opcode::ADD:
+        case Opcode::MUL:
+        case Opcode::FADD:
+        case Opcode::FMUL:
+        case Opcode::FRACADD:
+        case Opcode::FRACMUL:
+            return true;
+        case Opcode::CMP:
+            return instr.relation == ComparisonRelation::Equal || instr.relation == ComparisonRelation::NotEqual;
+        default:
+            return false;
+    }
+}
+
+// Everything but the destination that decides the result, as a string.
+// r0 changes under the instruction's feet (every CALL writes it), so an
+// instruction reading it has no key.
+std::optional<std::string> value_key(const Instruction& instr) {
+    std::vector<std::string> operands;
+    for (std::size_t k = 1; k < instr.operands.size(); ++k) {
+        const Operand& operand = instr.operands[k];
+        if (const auto* reg = std::get_if<Register>(&operand)) {
+            if (reg->index == kReturnRegister) return std::nullopt;
+            operands.push_back("r" + std::to_string(reg->index));
+        } else if (const auto* imm = std::get_if<Immediate>(&operand)) {
+            operands.push_back("#" + std::to_string(imm->value));
+        } else {
+            operands.push_back("L" + std::to_string(std::get<Label>(operand).id));
+        }
+    }
+    if (is_commutative(instr) && operands.size() == 2) {
+        std::sort(operands.begin(), operands.end());
+    }
+    std::string key = std::to_string(static_cast<int>(instr.opcode)) + "/" +
+                      std::to_string(static_cast<int>(instr.primitive)) + "/" + (instr.boolean_result ? "b" : "") +
+                      (instr.is_conversion ? "c" : "") + "/" + std::to_string(static_cast<int>(instr.relation)) +
+                      "/" + std::to_string(static_cast<int>(instr.literal_kind)) + "/" +
+                      (instr.text_literal ? "\"" + *instr.text_literal + "\"" : "");
+    for (const std::string& operand : operands) {
+        key += " " + operand;
+    }
+    return key;
+}
+
+/**
+ * Dominator-based global value numbering over SSA form.
+ *
+ * Walks the dominator tree with a scoped table from each computation to
+ * the first value that holds it. A later instruction computing the same
+ * thing from the same values, in a block the first one dominates, is
+ * deleted and its readers use the earlier value. Copies are numbered as
+ * their source, which also propagates them, and a phi whose arguments
+ * are all one value becomes that value.
+ */
+class GlobalValueNumberingPass final : public Pass {
+public:
+    std::string_view name() const override { return "gvn"; }
+
+    bool run(IntermediateProgram& program, PassContext& context) override {
+        auto& instrs = program.mutable_instructions();
+        auto form = SsaForm::build(instrs);
+        if (!form) {
+            context.count("skipped", 1);
+            return false;
+        }
+        auto& blocks = form->blocks();
+        std::vector<std::vector<std::size_t>> successors;
+        successors.reserve(blocks.size());
+        for (const SsaBlock& block : blocks) {
+            successors.push_back(block.successors);
+        }
+        const auto dominators = DominatorTree::build(successors);
+
+        std::unordered_map<int, int> replacement;
+        auto resolve = [&](int value) {
+            for (auto it = replacement.find(value); it != replacement.end(); it = replacement.find(value)) {
+                value = it->second;
+            }
+            return value;
+        };
+        std::unordered_map<std::string, int> table;
+        std::int64_t redundant = 0;
+        std::int64_t copies = 0;
+        std::int64_t phis = 0;
+
+        struct Frame {
+            std::size_t block;
+            bool entered;
+            std::vector<std::string> scoped;
+        };
+        std::vector<Frame> frames{Frame{0, false, {}}};
+        while (!frames.empty()) {
+            if (frames.back().entered) {
+                for (const std::string& key : frames.back().scoped) table.erase(key);
+                frames.pop_back();
+                continue;
+            }
+            frames.back().entered = true;
+            SsaBlock& block = blocks[frames.back().block];
+            std::vector<std::string> scoped;
+
+            std::erase_if(block.phis, [&](const Phi& phi) {
+                int same = 0;
+                for (int arg : phi.args) {
+                    const int value = resolve(arg);
+                    if (value == phi.dest || value == same) continue;
+                    if (same != 0) return false;
+                    same = value;
+                }
+                if (same == 0) return false;
+                replacement[phi.dest] = same;
+                ++phis;
+                return true;
+            });
+
+            std::erase_if(block.instrs, [&](Instruction& instr) {
+                const auto effects = register_effects(instr);
+                const auto def = instr.opcode == Opcode::CALL ? std::nullopt : effects.def;
+                for (std::size_t k = def ? 1 : 0; k < instr.operands.size(); ++k) {
+                    if (auto* reg = std::get_if<Register>(&instr.operands[k])) reg->index = resolve(reg->index);
+                }
+                if (!def || *def == kReturnRegister) return false;
+                if (instr.opcode == Opcode::MOV && instr.operands.size() == 2) {
+                    const auto* src = std::get_if<Register>(&instr.operands[1]);
+                    if (!src || src->index == kReturnRegister) return false;
+                    replacement[*def] = src->index;
+                    ++copies;
+                    return true;
+                }
+                if (!is_value_numbered(instr.opcode)) return false;
+                auto key = value_key(instr);
+                if (!key) return false;
+                auto [it, inserted] = table.emplace(*key, *def);
+                if (inserted) {
+                    scoped.push_back(std::move(*key));
+                    return false;
+                }
+                replacement[*def] = it->second;
+                ++redundant;
+                return true;
+            });
+
+            frames.back().scoped = std::move(scoped);
+            const auto& children = dominators.children(frames.back().block);
+            for (auto it = children.rbegin(); it != children.rend(); ++it) {
+                frames.push_back(Frame{*it, false, {}});
+            }
+        }
+
+        const bool changed = redundant + copies + phis > 0;
+        if (changed) {
+            form->replace_uses(replacement);
+            SsaLoweringStats stats;
+            instrs = form->lower(&stats);
+            context.count("copies-inserted", stats.copies_inserted);
+        }
+        context.count("redundant", redundant);
+        context.count("copies-propagated", copies);
+        context.count("phis-removed", phis);
+        return changed;
+    }
+};
+
+/**
+ * Rebuilds SSA and lowers it straight back, so the variable copies the
+ * generator emits (`copy_to_dest`) collapse wherever the values involved
+ * never overlap.
+ */
+class CoalesceCopiesPass final : public Pass {
+public:
+    std::string_view name() const override { return "coalesce-copies"; }
+
+    bool run(IntermediateProgram& program, PassContext& context) override {
+        auto& instrs = program.mutable_instructions();
+        auto form = SsaForm::build(instrs);
+        if (!form) {
+            context.count("skipped", 1);
+            return false;
+        }
+        SsaLoweringStats stats;
+        auto lowered = form->lower(&stats);
+        const bool changed = lowered.size() != instrs.size() || stats.copies_coalesced > 0;
+        instrs = std::move(lowered);
+        context.count("copies-coalesced", stats.copies_coalesced);
+        context.count("copies-inserted", stats.copies_inserted);
+        context.count("edges-split", stats.edges_split);
+        return changed;
+    }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> make_gvn_pass() {
+    return std::make_unique<GlobalValueNumberingPass>();
+}
+
+std::unique_ptr<Pass> make_coalesce_copies_pass() {
+    return std::make_unique<CoalesceCopiesPass>();
+}
+
+} // namespace t81::tisc::ir
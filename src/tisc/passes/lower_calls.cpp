@@ -0,0 +1,179 @@
+#include "t81/tisc/passes.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+#include "t81/tisc/calling_convention.hpp"
+#include "t81/tisc/cfg.hpp"
+
+namespace t81::tisc::ir {
+
+namespace {
+
+struct ArgumentMove {
+    int dest;
+    int src;
+};
+
+// Emits the moves as if they all happened at once: a move goes once no
+// other still reads its destination, and a cycle is broken through `temp`.
+std::int64_t emit_parallel_moves(std::vector<ArgumentMove> pending, int temp, std::vector<Instruction>& out) {
+    std::int64_t emitted = 0;
+    while (!pending.empty()) {
+        auto ready = std::find_if(pending.begin(), pending.end(), [&](const ArgumentMove& move) {
+            return std::none_of(pending.begin(), pending.end(),
+                                [&](const ArgumentMove& other) { return other.src == move.dest; });
+        });
+        ++emitted;
+        if (ready != pending.end()) {
+            out.push_back(Instruction(Opcode::MOV, {Register{ready->dest}, Register{ready->src}}));
+            pending.erase(ready);
+            continue;
+        }
+        const int saved = pending.front().dest;
+        out.push_back(Instruction(Opcode::MOV, {Register{temp}, Register{saved}}));
+        for (ArgumentMove& move : pending) {
+            if (move.src == saved) move.src = temp;
+        }
+    }
+    return emitted;
+}
+
+/**
+ * Rewrites each `CALL #callee, a0, ..., an-1` into the calling convention
+ * of calling_convention.hpp with lower_call. Runs at every level, after
+ * register allocation, which has already kept values that live across a
+ * call out of the caller-saved registers and placed arguments in their own
+ * registers where it could; those moves vanish here. A lowered CALL names
+ * only r1-rk, so running the pass again changes nothing.
+ */
+class LowerCallsPass final : public Pass {
+public:
+    std::string_view name() const override { return "lower-calls"; }
+
+    bool run(IntermediateProgram& program, PassContext& context) override {
+        auto& instrs = program.mutable_instructions();
+        std::vector<Instruction> out;
+        out.reserve(instrs.size());
+        std::int64_t calls = 0;
+        std::int64_t pushed = 0;
+        std::int64_t moves = 0;
+        for (Instruction& instr : instrs) {
+            if (instr.opcode != Opcode::CALL || instr.operands.empty()) {
+                out.push_back(std::move(instr));
+                continue;
+            }
+            ++calls;
+            std::vector<CallArgument> args;
+            for (std::size_t k = 1; k < instr.operands.size(); ++k) {
+                CallArgument arg;
+                arg.reg = std::get<Register>(instr.operands[k]).index;
+                args.push_back(arg);
+            }
+            const LoweredCall lowered = lower_call(std::move(instr), args, kFirstCallScratchRegister, out);
+            pushed += lowered.stack_arguments;
+            moves += lowered.moves;
+        }
+        instrs = std::move(out);
+        context.count("calls", calls);
+        context.count("stack-arguments", pushed);
+        context.count("argument-moves", moves);
+        return pushed + moves > 0;
+    }
+};
+
+} // namespace
+
+LoweredCall lower_call(Instruction call, const std::vector<CallArgument>& args, int scratch,
+                       std::vector<Instruction>& out) {
+    LoweredCall lowered;
+    auto reload = [&](int reg, const CallArgument& arg) {
+        Instruction load(Opcode::LOAD, {Register{reg}, Immediate{*arg.slot}});
+        load.primitive = arg.kind;
+        out.push_back(std::move(load));
+        ++lowered.reloads;
+    };
+    for (std::size_t i = args.size(); i-- > static_cast<std::size_t>(kArgumentRegisterCount);) {
+        int reg = args[i].reg;
+        if (args[i].slot) {
+            reload(scratch, args[i]);
+            reg = scratch;
+        }
+        out.push_back(Instruction(Opcode::PUSH, {Register{reg}}));
+        ++lowered.stack_arguments;
+    }
+
+    call.operands.resize(1);
+    call.stack_arguments += static_cast<std::size_t>(lowered.stack_arguments);
+    std::vector<ArgumentMove> pending;
+    std::vector<int> sources;
+    const std::size_t in_registers = args.size() - stack_argument_count(args.size());
+    for (std::size_t i = 0; i < in_registers; ++i) {
+        const int dest = argument_register(i);
+        if (!args[i].slot) {
+            sources.push_back(args[i].reg);
+            if (args[i].reg != dest) pending.push_back(ArgumentMove{dest, args[i].reg});
+        }
+        call.operands.push_back(Register{dest});
+    }
+    // A cycle needs a source among r1-r6, which leaves one of r7-r12 that
+    // no register argument comes from. Caller-saved, it holds nothing the
+    // call does not clobber anyway.
+    int temp = kFirstCallScratchRegister;
+    while (std::find(sources.begin(), sources.end(), temp) != sources.end()) ++temp;
+    lowered.moves = emit_parallel_moves(std::move(pending), temp, out);
+    // Loaded last, so that no move still reads the register they fill.
+    for (std::size_t i = 0; i < in_registers; ++i) {
+        if (args[i].slot) reload(argument_register(i), args[i]);
+    }
+    out.push_back(std::move(call));
+
+    // The caller takes its stack arguments back off; r7 is dead after a call.
+    for (std::int64_t i = 0; i < lowered.stack_arguments; ++i) {
+        out.push_back(Instruction(Opcode::POP, {Register{kFirstCallScratchRegister}}));
+    }
+    return lowered;
+}
+
+LoweredFrame lower_frame(std::vector<Instruction>& body, std::int64_t slots, bool entry) {
+    std::vector<int> saved;
+    if (!entry) {
+        for (const Instruction& instr : body) {
+            if (const auto def = register_effects(instr).def; def && !is_caller_saved(*def)) {
+                saved.push_back(*def);
+            }
+        }
+        std::sort(saved.begin(), saved.end());
+        saved.erase(std::unique(saved.begin(), saved.end()), saved.end());
+    }
+    LoweredFrame frame{static_cast<std::int64_t>(saved.size()), slots};
+    if (saved.empty() && slots == 0) return frame;
+
+    std::vector<Instruction> out;
+    out.reserve(body.size() + 2 * saved.size() + 2);
+    for (int reg : saved) {
+        out.push_back(Instruction(Opcode::PUSH, {Register{reg}}));
+    }
+    if (slots > 0) out.push_back(Instruction(Opcode::STACK_ALLOC, {Immediate{slots}}));
+    const Opcode exit = entry ? Opcode::HALT : Opcode::RET;
+    for (Instruction& instr : body) {
+        if (instr.opcode == exit) {
+            if (slots > 0) out.push_back(Instruction(Opcode::STACK_FREE, {Immediate{slots}}));
+            for (auto it = saved.rbegin(); it != saved.rend(); ++it) {
+                out.push_back(Instruction(Opcode::POP, {Register{*it}}));
+            }
+        }
+        out.push_back(std::move(instr));
+    }
+    body = std::move(out);
+    return frame;
+}
+
+std::unique_ptr<Pass> make_lower_calls_pass() {
+    return std::make_unique<LowerCallsPass>();
+}
+
+} // namespace t81::tisc::ir
@@ -0,0 +1,341 @@
+#include "t81/tisc/passes.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "t81/tisc/calling_convention.hpp"
+#include "t81/tisc/cfg.hpp"
+
+namespace t81::tisc::ir {
+
+namespace {
+
+struct Assignment {
+    std::unordered_map<int, int> physical; ///< Register -> physical register.
+    std::vector<std::size_t> spilled;      ///< Indices into the intervals.
+};
+
+// What the calling convention asks of the allocation: the positions at
+// which a CALL overwrites the caller-saved registers, and for each
+// argument the register lower-calls will move it into.
+struct CallConstraints {
+    std::vector<std::size_t> clobbers; ///< Ascending.
+    std::unordered_map<int, int> hints;
+
+    static CallConstraints of(const std::vector<Instruction>& instrs) {
+        CallConstraints out;
+        for (std::size_t i = 0; i < instrs.size(); ++i) {
+            const Instruction& instr = instrs[i];
+            if (instr.opcode != Opcode::CALL) continue;
+            out.clobbers.push_back(2 * i + 1);
+            for (std::size_t k = 1; k <= static_cast<std::size_t>(kArgumentRegisterCount) && k < instr.operands.size();
+                 ++k) {
+                if (const auto* reg = std::get_if<Register>(&instr.operands[k])) {
+                    out.hints.emplace(reg->index, argument_register(k - 1));
+                }
+            }
+        }
+        return out;
+    }
+
+    bool crosses_call(const LiveInterval& interval) const {
+        auto it = std::lower_bound(clobbers.begin(), clobbers.end(), interval.start);
+        return it != clobbers.end() && *it <= interval.end;
+    }
+};
+
+// Poletto-Sarkar linear scan over physical registers [first, limit). The
+// return register is never renamed and sits outside the pool. An interval
+// live across a call only takes callee-saved registers, and an argument
+// tries the register it is passed in first. When no register fits, the
+// interval that ends last among those whose register would is spilled,
+// which frees a register for the longest stretch.
+Assignment linear_scan(const std::vector<LiveInterval>& intervals, const CallConstraints& calls, int first,
+                       int limit) {
+    Assignment out;
+    std::vector<bool> busy(static_cast<std::size_t>(limit), false);
+    std::vector<std::size_t> active; // Sorted by end.
+    for (std::size_t i = 0; i < intervals.size(); ++i) {
+        const LiveInterval& current = intervals[i];
+        if (current.reg == kReturnRegister) {
+            out.physical[current.reg] = kReturnRegister;
+            continue;
+        }
+        while (!active.empty() && intervals[active.front()].end < current.start) {
+            busy[static_cast<std::size_t>(out.physical.at(intervals[active.front()].reg))] = false;
+            active.erase(active.begin());
+        }
+        auto activate = [&](std::size_t index, int reg) {
+            out.physical[intervals[index].reg] = reg;
+            busy[static_cast<std::size_t>(reg)] = true;
+            auto pos = std::upper_bound(active.begin(), active.end(), index, [&](std::size_t a, std::size_t b) {
+                return intervals[a].end < intervals[b].end;
+            });
+            active.insert(pos, index);
+        };
+
+        const int lowest = calls.crosses_call(current) ? std::max(first, kFirstCalleeSavedRegister) : first;
+        auto fits = [&](int reg) { return reg >= lowest && reg < limit; };
+        int free = limit;
+        if (auto hint = calls.hints.find(current.reg);
+            hint != calls.hints.end() && fits(hint->second) && !busy[static_cast<std::size_t>(hint->second)]) {
+            free = hint->second;
+        } else {
+            free = lowest;
+            while (free < limit && busy[static_cast<std::size_t>(free)]) ++free;
+        }
+        if (free < limit) {
+            activate(i, free);
+            continue;
+        }
+        auto victim = std::find_if(active.rbegin(), active.rend(), [&](std::size_t index) {
+            return intervals[index].end > current.end && fits(out.physical.at(intervals[index].reg));
+        });
+        if (victim != active.rend()) {
+            const std::size_t index = *victim;
+            active.erase(std::next(victim).base());
+            const int reg = out.physical.at(intervals[index].reg);
+            out.physical.erase(intervals[index].reg);
+            out.spilled.push_back(index);
+            busy[static_cast<std::size_t>(reg)] = false;
+            activate(i, reg);
+        } else {
+            out.spilled.push_back(i);
+        }
+    }
+    return out;
+}
+
+// The largest number of intervals live at one position.
+std::int64_t max_pressure(const std::vector<LiveInterval>& intervals) {
+    std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<>> ends;
+    std::size_t peak = 0;
+    for (const LiveInterval& interval : intervals) {
+        while (!ends.empty() && ends.top() < interval.start) ends.pop();
+        ends.push(interval.end);
+        peak = std::max(peak, ends.size());
+    }
+    return static_cast<std::int64_t>(peak);
+}
+
+// Index of the operand an instruction writes, if it writes one in place.
+// CALL writes the return register implicitly.
+std::optional<std::size_t> def_operand(const Instruction& instr) {
+    if (instr.opcode == Opcode::CALL || !register_effects(instr).def) return std::nullopt;
+    return 0;
+}
+
+// Scratch registers the spill code of one instruction needs at most. A
+// CALL is not counted: lower_call loads its spilled arguments straight
+// into the argument registers, or through one scratch register for the
+// stack.
+std::size_t spilled_uses_bound(const std::vector<Instruction>& instrs) {
+    std::size_t bound = 1;
+    for (const Instruction& instr : instrs) {
+        if (instr.opcode == Opcode::CALL) continue;
+        std::vector<int> uses = register_effects(instr).uses;
+        std::sort(uses.begin(), uses.end());
+        uses.erase(std::unique(uses.begin(), uses.end()), uses.end());
+        std::erase(uses, kReturnRegister);
+        bound = std::max(bound, uses.size());
+    }
+    return bound;
+}
+
+/**
+ * Maps the generator's unbounded virtual registers onto a bounded physical
+ * register file with linear scan over the intervals `live_intervals`
+ * derives from block liveness. Intervals that do not fit live in numbered
+ * slots of the function's frame instead: each read is preceded by a LOAD
+ * into a scratch register and each write followed by a STORE, and
+ * lower_frame reserves the slots with STACK_ALLOC on entry and releases
+ * them before each exit. TISC registers are untyped,
+ * so PrimitiveKind classes are kept on the spill code and on the slots: a
+ * slot is shared only by intervals of one kind. Calls follow
+ * calling_convention.hpp: a value live across one stays out of the
+ * caller-saved registers, and an argument that can sits in the register
+ * lower-calls passes it in, so that no move is needed there. A call with a
+ * spilled argument is lowered here, where the slots are known. A register
+ * file too small for the spill code or for the convention is an error:
+ * the pass throws std::runtime_error rather than leave registers past the
+ * file in the program.
+ */
+class RegisterAllocationPass final : public Pass {
+public:
+    explicit RegisterAllocationPass(int physical_registers) : _physical_registers(physical_registers) {}
+
+    std::string_view name() const override { return "register-allocation"; }
+
+    bool run(IntermediateProgram& program, PassContext& context) override {
+        auto& instrs = program.mutable_instructions();
+        const auto cfg = ControlFlowGraph::build(instrs);
+        const auto liveness = Liveness::compute(instrs, cfg);
+        const auto intervals = live_intervals(instrs, cfg, liveness);
+
+        // Scratch registers for spill code are reserved only once something
+        // has to spill.
+        const int first = kReturnRegister + 1;
+        const auto calls = CallConstraints::of(instrs);
+        Assignment assignment = linear_scan(intervals, calls, first, _physical_registers);
+        int scratch = _physical_registers;
+        if (!assignment.spilled.empty()) {
+            const auto reserved = static_cast<int>(spilled_uses_bound(instrs));
+            if (_physical_registers - reserved <= first) {
+                throw std::runtime_error("register-allocation: " + std::to_string(_physical_registers) +
+                                         " physical registers leave none to allocate beside " +
+                                         std::to_string(reserved) + " for spill code");
+            }
+            scratch = _physical_registers - reserved;
+            assignment = linear_scan(intervals, calls, first, scratch);
+        }
+
+        // Spill slots, reused once an interval of the same kind has ended.
+        std::unordered_map<int, std::int64_t> slot_of;
+        std::unordered_map<int, PrimitiveKind> kind_of;
+        std::vector<std::pair<PrimitiveKind, std::size_t>> slots; // Kind, end of last occupant.
+        std::sort(assignment.spilled.begin(), assignment.spilled.end());
+        for (std::size_t index : assignment.spilled) {
+            const LiveInterval& interval = intervals[index];
+            std::size_t slot = 0;
+            while (slot < slots.size() &&
+                   (slots[slot].first != interval.kind || slots[slot].second >= interval.start)) {
+                ++slot;
+            }
+            if (slot == slots.size()) slots.emplace_back(interval.kind, 0);
+            slots[slot].second = interval.end;
+            slot_of[interval.reg] = static_cast<std::int64_t>(slot);
+            kind_of[interval.reg] = interval.kind;
+        }
+
+        std::vector<Instruction> out;
+        out.reserve(instrs.size());
+        std::int64_t loads = 0;
+        std::int64_t stores = 0;
+        bool renamed = false;
+        int highest = kReturnRegister;
+        int needed = kReturnRegister; // By the calls, once lowered.
+        for (Instruction& instr : instrs) {
+            if (instr.opcode == Opcode::CALL) {
+                // Lowered here to see which registers the convention needs,
+                // and kept when an argument is in memory; otherwise
+                // lower-calls lowers it again after allocation.
+                std::vector<CallArgument> args;
+                bool spilled_argument = false;
+                for (std::size_t k = 1; k < instr.operands.size(); ++k) {
+                    CallArgument arg;
+                    const int virtual_reg = std::get<Register>(instr.operands[k]).index;
+                    if (auto it = assignment.physical.find(virtual_reg); it != assignment.physical.end()) {
+                        arg.reg = it->second;
+                    } else {
+                        arg.slot = slot_of.at(virtual_reg);
+                        arg.kind = kind_of.at(virtual_reg);
+                        spilled_argument = true;
+                    }
+                    args.push_back(arg);
+                }
+                std::vector<Instruction> lowered;
+                const LoweredCall counts = lower_call(instr, args, scratch, lowered);
+                int call_highest = kReturnRegister;
+                for (const Instruction& emitted : lowered) {
+                    for (const Operand& operand : emitted.operands) {
+                        if (const auto* reg = std::get_if<Register>(&operand)) {
+                            call_highest = std::max(call_highest, reg->index);
+                        }
+                    }
+                }
+                needed = std::max(needed, call_highest);
+                if (spilled_argument) {
+                    renamed = true;
+                    highest = std::max(highest, call_highest);
+                    loads += counts.reloads;
+                    std::move(lowered.begin(), lowered.end(), std::back_inserter(out));
+                    continue;
+                }
+            }
+            const auto def = def_operand(instr);
+            std::unordered_map<int, int> loaded;
+            std::optional<Instruction> store;
+            for (std::size_t k = 0; k < instr.operands.size(); ++k) {
+                auto* reg = std::get_if<Register>(&instr.operands[k]);
+                if (!reg) continue;
+                const int virtual_reg = reg->index;
+                if (auto it = assignment.physical.find(virtual_reg); it != assignment.physical.end()) {
+                    renamed = renamed || it->second != virtual_reg;
+                    reg->index = it->second;
+                    highest = std::max(highest, reg->index);
+                    continue;
+                }
+                const std::int64_t slot = slot_of.at(virtual_reg);
+                const PrimitiveKind kind = kind_of.at(virtual_reg);
+                if (def && *def == k) {
+                    // Uses are read before the result is written, so the
+                    // first scratch register is free again here.
+                    reg->index = scratch;
+                    Instruction spill(Opcode::STORE, {Immediate{slot}, Register{scratch}});
+                    spill.primitive = kind;
+                    store = std::move(spill);
+                } else {
+                    auto [it, inserted] = loaded.emplace(virtual_reg, scratch + static_cast<int>(loaded.size()));
+                    if (inserted) {
+                        Instruction reload(Opcode::LOAD, {Register{it->second}, Immediate{slot}});
+                        reload.primitive = kind;
+                        out.push_back(std::move(reload));
+                        ++loads;
+                    }
+                    reg->index = it->second;
+                }
+                highest = std::max(highest, reg->index);
+            }
+            out.push_back(std::move(instr));
+            if (store) {
+                out.push_back(std::move(*store));
+                ++stores;
+            }
+        }
+        if (std::max(highest, needed) >= _physical_registers) {
+            throw std::runtime_error("register-allocation: calls need r" + std::to_string(std::max(highest, needed)) +
+                                     ", past the " + std::to_string(_physical_registers) + " physical registers");
+        }
+        // The generator lowers only the entry function, which ends in HALT.
+        lower_frame(out, static_cast<std::int64_t>(slots.size()), true);
+        instrs = std::move(out);
+
+        context.count("virtual-registers", static_cast<std::int64_t>(intervals.size()));
+        context.count("max-live", max_pressure(intervals));
+        context.count("physical-registers", highest + 1);
+        context.count("live-across-calls",
+                      std::count_if(intervals.begin(), intervals.end(), [&](const LiveInterval& interval) {
+                          return interval.reg != kReturnRegister && calls.crosses_call(interval);
+                      }));
+        context.count("spilled", static_cast<std::int64_t>(assignment.spilled.size()));
+        context.count("spill-loads", loads);
+        context.count("spill-stores", stores);
+        context.count("frame-slots", static_cast<std::int64_t>(slots.size()));
+        return renamed || loads > 0 || stores > 0;
+    }
+
+private:
+    int _physical_registers;
+};
+
+} // namespace
+
+std::unique_ptr<Pass> make_register_allocation_pass() {
+    return make_register_allocation_pass(kDefaultPhysicalRegisters);
+}
+
+std::unique_ptr<Pass> make_register_allocation_pass(int physical_registers) {
+    return std::make_unique<RegisterAllocationPass>(physical_registers);
+}
+
+} // namespace t81::tisc::ir
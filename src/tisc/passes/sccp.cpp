@@ -0,0 +1,368 @@
+#include "t81/tisc/passes.hpp"
+
+#include <array>
+#include <cstdint>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#include "t81/tisc/cfg.hpp"
+#include "t81/tisc/constant.hpp"
+#include "t81/tisc/ssa.hpp"
+
+namespace t81::tisc::ir {
+
+namespace {
+
+// Lattice value of one SSA value: not yet known to be reached (Top), a
+// single constant on every executable path, or anything (Bottom).
+struct LatticeValue {
+    enum class Level { Top, Constant, Bottom };
+    Level level = Level::Top;
+    Constant value;
+};
+
+bool is_foldable(Opcode opcode) {
+    switch (opcode) {
+        case Opcode::ADD:
+        case Opcode::SUB:
+        case Opcode::MUL:
+        case Opcode::DIV:
+        case Opcode::MOD:
+        case Opcode::NEG:
+        case Opcode::FADD:
+        case Opcode::FSUB:
+        case Opcode::FMUL:
+        case Opcode::FDIV:
+        case Opcode::FRACADD:
+        case Opcode::FRACSUB:
+        case Opcode::FRACMUL:
+        case Opcode::FRACDIV:
+        case Opcode::CMP:
+        case Opcode::MOV:
+        case Opcode::LOADI:
+        case Opcode::I2F:
+        case Opcode::F2I:
+        case Opcode::I2FRAC:
+        case Opcode::FRAC2I:
+            return true;
+        default:
+            return false;
+    }
+}
+
+const Register* reg_at(const Instruction& instr, std::size_t index) {
+    return index < instr.operands.size() ? std::get_if<Register>(&instr.operands[index]) : nullptr;
+}
+
+std::uint64_t edge_key(std::size_t from, std::size_t to) {
+    return (static_cast<std::uint64_t>(from) << 32) | static_cast<std::uint64_t>(to);
+}
+
+/**
+ * Sparse conditional constant propagation (Wegman-Zadeck) over SSA form.
+ *
+ * Values start unknown and only move down the lattice; blocks are only
+ * evaluated once an edge into them is found executable, and a branch on a
+ * constant marks just the edge it takes. So unlike "constant-fold", it sees
+ * through phis and proves constants that only hold because some path is
+ * never taken, such as a variable that every executable assignment sets to
+ * the same value. Integer and boolean constants become LOADIs, decided
+ * branches become JMPs or disappear, and blocks no executable edge reaches
+ * are deleted.
+ */
+class SparseConditionalConstantPass final : public Pass {
+public:
+    std::string_view name() const override { return "sccp"; }
+
+    bool run(IntermediateProgram& program, PassContext& context) override {
+        auto& instrs = program.mutable_instructions();
+        auto form = SsaForm::build(instrs);
+        if (!form) {
+            context.count("skipped", 1);
+            return false;
+        }
+        _form = &*form;
+        propagate();
+        const auto [folded, branches, blocks] = rewrite();
+        if (folded + branches + blocks > 0) {
+            SsaLoweringStats stats;
+            instrs = form->lower(&stats);
+            context.count("copies-inserted", stats.copies_inserted);
+        }
+        context.count("values-folded", folded);
+        context.count("branches-folded", branches);
+        context.count("blocks-removed", blocks);
+        return folded + branches + blocks > 0;
+    }
+
+private:
+    struct Site {
+        std::size_t block;
+        std::size_t index;
+        bool phi;
+    };
+
+    void propagate() {
+        auto& blocks = _form->blocks();
+        _values.assign(static_cast<std::size_t>(_form->value_count()) + 1, LatticeValue{});
+        _values[0].level = LatticeValue::Level::Bottom;
+        _uses.assign(_values.size(), {});
+        for (std::size_t b = 0; b < blocks.size(); ++b) {
+            for (std::size_t i = 0; i < blocks[b].phis.size(); ++i) {
+                for (int arg : blocks[b].phis[i].args) _uses[static_cast<std::size_t>(arg)].push_back({b, i, true});
+            }
+            for (std::size_t i = 0; i < blocks[b].instrs.size(); ++i) {
+                for (int reg : register_effects(blocks[b].instrs[i]).uses) {
+                    _uses[static_cast<std::size_t>(reg)].push_back({b, i, false});
+                }
+            }
+        }
+        _executable.assign(blocks.size(), false);
+        _edges.clear();
+
+        mark_edge(kEntry, 0);
+        while (!_flow_work.empty() || !_value_work.empty()) {
+            while (!_flow_work.empty()) {
+                const auto [from, to] = _flow_work.back();
+                _flow_work.pop_back();
+                visit_edge(from, to);
+            }
+            while (!_value_work.empty()) {
+                const int value = _value_work.back();
+                _value_work.pop_back();
+                for (const Site& site : _uses[static_cast<std::size_t>(value)]) {
+                    if (!_executable[site.block]) continue;
+                    if (site.phi) {
+                        visit_phi(site.block, site.index);
+                    } else {
+                        visit_instruction(site.block, site.index);
+                    }
+                }
+            }
+        }
+    }
+
+    static constexpr std::size_t kEntry = static_cast<std::size_t>(-1);
+
+    void mark_edge(std::size_t from, std::size_t to) { _flow_work.emplace_back(from, to); }
+
+    void visit_edge(std::size_t from, std::size_t to) {
+        if (from != kEntry && !_edges.insert(edge_key(from, to)).second) return;
+        SsaBlock& block = _form->blocks()[to];
+        for (std::size_t i = 0; i < block.phis.size(); ++i) {
+            visit_phi(to, i);
+        }
+        if (_executable[to]) return;
+        _executable[to] = true;
+        for (std::size_t i = 0; i < block.instrs.size(); ++i) {
+            visit_instruction(to, i);
+        }
+        if (block.instrs.empty()) {
+            if (auto next = _form->fall_through(to)) mark_edge(to, *next);
+        }
+    }
+
+    void lower_to(int value, const LatticeValue& next) {
+        LatticeValue& current = _values[static_cast<std::size_t>(value)];
+        if (current.level == next.level && (next.level != LatticeValue::Level::Constant || current.value == next.value)) {
+            return;
+        }
+        if (current.level == LatticeValue::Level::Bottom) return;
+        if (current.level == LatticeValue::Level::Constant && next.level == LatticeValue::Level::Constant) {
+            current.level = LatticeValue::Level::Bottom;
+        } else if (static_cast<int>(next.level) > static_cast<int>(current.level)) {
+            current = next;
+        } else {
+            return;
+        }
+        _value_work.push_back(value);
+    }
+
+    void visit_phi(std::size_t b, std::size_t index) {
+        const SsaBlock& block = _form->blocks()[b];
+        const Phi& phi = block.phis[index];
+        LatticeValue merged;
+        for (std::size_t j = 0; j < phi.args.size(); ++j) {
+            if (!_edges.contains(edge_key(block.predecessors[j], b))) continue;
+            const LatticeValue& arg = _values[static_cast<std::size_t>(phi.args[j])];
+            if (arg.level == LatticeValue::Level::Top) continue;
+            if (arg.level == LatticeValue::Level::Bottom ||
+                (merged.level == LatticeValue::Level::Constant && !(merged.value == arg.value))) {
+                merged.level = LatticeValue::Level::Bottom;
+                break;
+            }
+            merged = arg;
+        }
+        lower_to(phi.dest, merged);
+    }
+
+    void visit_instruction(std::size_t b, std::size_t index) {
+        const SsaBlock& block = _form->blocks()[b];
+        const Instruction& instr = block.instrs[index];
+        const bool last = index + 1 == block.instrs.size();
+        if (is_conditional_jump(instr.opcode)) {
+            visit_branch(b, instr);
+            return;
+        }
+        if (last) {
+            if (instr.opcode == Opcode::JMP) {
+                if (auto target = _form->target_block(instr)) mark_edge(b, *target);
+            } else if (auto next = _form->fall_through(b)) {
+                mark_edge(b, *next);
+            }
+        }
+        const auto effects = register_effects(instr);
+        if (!effects.def || *effects.def == kReturnRegister || instr.opcode == Opcode::CALL) return;
+        lower_to(*effects.def, evaluate(instr));
+    }
+
+    LatticeValue evaluate(const Instruction& instr) const {
+        LatticeValue result;
+        if (!is_foldable(instr.opcode)) {
+            result.level = LatticeValue::Level::Bottom;
+            return result;
+        }
+        std::array<const Constant*, 3> operands{};
+        for (std::size_t k = 1; k < instr.operands.size(); ++k) {
+            const Register* reg = reg_at(instr, k);
+            if (!reg) continue;
+            const LatticeValue& value = _values[static_cast<std::size_t>(reg->index)];
+            if (value.level == LatticeValue::Level::Bottom) {
+                result.level = LatticeValue::Level::Bottom;
+                return result;
+            }
+            if (value.level == LatticeValue::Level::Top) return result;
+            if (k < operands.size()) operands[k] = &value.value;
+        }
+        if (auto folded = fold_instruction(instr, operands)) {
+            result.level = LatticeValue::Level::Constant;
+            result.value = *folded;
+        } else {
+            result.level = LatticeValue::Level::Bottom;
+        }
+        return result;
+    }
+
+    void visit_branch(std::size_t b, const Instruction& jump) {
+        const auto target = _form->target_block(jump);
+        const auto next = _form->fall_through(b);
+        std::optional<bool> taken;
+        if (const Register* cond = reg_at(jump, 1)) {
+            const LatticeValue& value = _values[static_cast<std::size_t>(cond->index)];
+            if (value.level == LatticeValue::Level::Constant) {
+                taken = fold_branch_condition(jump.opcode, value.value);
+            }
+        }
+        if (target && taken.value_or(true)) mark_edge(b, *target);
+        if (next && !taken.value_or(false)) mark_edge(b, *next);
+    }
+
+    struct Rewrites {
+        std::int64_t folded = 0;
+        std::int64_t branches = 0;
+        std::int64_t blocks = 0;
+    };
+
+    Rewrites rewrite() {
+        Rewrites out;
+        auto& blocks = _form->blocks();
+        for (std::size_t b = 0; b < blocks.size(); ++b) {
+            SsaBlock& block = blocks[b];
+            if (!block.live) continue;
+            if (!_executable[b]) {
+                for (std::size_t succ : std::vector<std::size_t>(block.successors)) _form->remove_edge(b, succ);
+                block.live = false;
+                block.phis.clear();
+                block.instrs.clear();
+                ++out.blocks;
+                continue;
+            }
+            for (std::size_t succ : std::vector<std::size_t>(block.successors)) {
+                if (!_edges.contains(edge_key(b, succ))) _form->remove_edge(b, succ);
+            }
+        }
+
+        for (std::size_t b = 0; b < blocks.size(); ++b) {
+            SsaBlock& block = blocks[b];
+            if (!block.live) continue;
+            std::vector<Instruction> instrs;
+            instrs.reserve(block.instrs.size() + block.phis.size());
+            std::size_t i = 0;
+            if (!block.instrs.empty() && block.instrs.front().opcode == Opcode::LABEL) {
+                instrs.push_back(std::move(block.instrs.front()));
+                i = 1;
+            }
+            std::erase_if(block.phis, [&](const Phi& phi) {
+                const auto* value = integral_constant(phi.dest);
+                if (!value) return false;
+                instrs.push_back(make_load(phi.dest, *value));
+                ++out.folded;
+                return true;
+            });
+            for (; i < block.instrs.size(); ++i) {
+                Instruction& instr = block.instrs[i];
+                if (is_conditional_jump(instr.opcode)) {
+                    const Register* cond = reg_at(instr, 1);
+                    const auto* value = cond ? constant_of(cond->index) : nullptr;
+                    const auto taken = value ? fold_branch_condition(instr.opcode, *value) : std::nullopt;
+                    if (taken) {
+                        // Drop the edge not taken, unless both lead to the
+                        // same block.
+                        const auto target = _form->target_block(instr);
+                        const auto next = _form->fall_through(b);
+                        const auto dropped = *taken ? next : target;
+                        if (dropped && dropped != (*taken ? target : next)) _form->remove_edge(b, *dropped);
+                        ++out.branches;
+                        if (*taken) instrs.push_back(Instruction(Opcode::JMP, {instr.operands.front()}));
+                        continue;
+                    }
+                }
+                const auto effects = register_effects(instr);
+                if (effects.def && *effects.def != kReturnRegister && instr.opcode != Opcode::CALL &&
+                    !is_integer_load(instr)) {
+                    if (const auto* value = integral_constant(*effects.def)) {
+                        instrs.push_back(make_load(*effects.def, *value));
+                        ++out.folded;
+                        continue;
+                    }
+                }
+                instrs.push_back(std::move(instr));
+            }
+            block.instrs = std::move(instrs);
+        }
+        return out;
+    }
+
+    const Constant* constant_of(int value) const {
+        const LatticeValue& lattice = _values[static_cast<std::size_t>(value)];
+        return lattice.level == LatticeValue::Level::Constant ? &lattice.value : nullptr;
+    }
+
+    const Constant* integral_constant(int value) const {
+        const Constant* constant = constant_of(value);
+        return constant && constant->is_integral() ? constant : nullptr;
+    }
+
+    static Instruction make_load(int dest, const Constant& value) {
+        Instruction load(Opcode::LOADI, {Register{dest}, Immediate{value.integer}});
+        load.primitive = value.kind;
+        return load;
+    }
+
+    SsaForm* _form = nullptr;
+    std::vector<LatticeValue> _values;
+    std::vector<std::vector<Site>> _uses;
+    std::vector<bool> _executable;
+    std::unordered_set<std::uint64_t> _edges;
+    std::vector<std::pair<std::size_t, std::size_t>> _flow_work;
+    std::vector<int> _value_work;
+};
+
+} // namespace
+
+std::unique_ptr<Pass> make_sccp_pass() {
+    return std::make_unique<SparseConditionalConstantPass>();
+}
+
+} // namespace t81::tisc::ir
@@ -0,0 +1,96 @@
+#include "t81/tisc/passes.hpp"
+
+#include <cstdint>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+namespace t81::tisc::ir {
+
+namespace {
+
+bool is_jump(Opcode opcode) {
+    switch (opcode) {
+        case Opcode::JMP:
+        case Opcode::JZ:
+        case Opcode::JNZ:
+        case Opcode::JN:
+        case Opcode::JP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// True if `target` is one of the labels starting at `from`, i.e. control
+// reaches it whether or not the jump is taken.
+bool falls_through_to(const std::vector<Instruction>& instrs, std::size_t from, int target) {
+    for (std::size_t i = from; i < instrs.size() && instrs[i].opcode == Opcode::LABEL; ++i) {
+        const auto& operands = instrs[i].operands;
+        const auto* label = operands.empty() ? nullptr : std::get_if<Label>(&operands.front());
+        if (label && label->id == target) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// A label nothing jumps to only splits the block it sits in, which keeps
+// block-local passes from seeing across it.
+std::int64_t remove_unused_labels(std::vector<Instruction>& instrs) {
+    std::unordered_set<int> targets;
+    for (const Instruction& instr : instrs) {
+        if (instr.opcode == Opcode::LABEL) continue;
+        for (const Operand& operand : instr.operands) {
+            if (const auto* label = std::get_if<Label>(&operand)) {
+                targets.insert(label->id);
+            }
+        }
+    }
+    const auto unused = [&targets](const Instruction& instr) {
+        if (instr.opcode != Opcode::LABEL || instr.operands.empty()) return false;
+        const auto* label = std::get_if<Label>(&instr.operands.front());
+        return label && !targets.contains(label->id);
+    };
+    const auto before = instrs.size();
+    std::erase_if(instrs, unused);
+    return static_cast<std::int64_t>(before - instrs.size());
+}
+
+// Conditional jumps only read their condition register, so a jump to the
+// next instruction can go whichever kind it is.
+class SimplifyJumpsPass final : public Pass {
+public:
+    std::string_view name() const override { return "simplify-jumps"; }
+
+    bool run(IntermediateProgram& program, PassContext& context) override {
+        auto& instrs = program.mutable_instructions();
+        std::vector<Instruction> kept;
+        kept.reserve(instrs.size());
+        std::int64_t removed = 0;
+        for (std::size_t i = 0; i < instrs.size(); ++i) {
+            const Instruction& instr = instrs[i];
+            if (is_jump(instr.opcode) && !instr.operands.empty()) {
+                const auto* label = std::get_if<Label>(&instr.operands.front());
+                if (label && falls_through_to(instrs, i + 1, label->id)) {
+                    ++removed;
+                    continue;
+                }
+            }
+            kept.push_back(std::move(instrs[i]));
+        }
+        instrs = std::move(kept);
+        const std::int64_t labels = remove_unused_labels(instrs);
+        context.count("jumps-removed", removed);
+        context.count("labels-removed", labels);
+        return removed + labels > 0;
+    }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> make_simplify_jumps_pass() {
+    return std::make_unique<SimplifyJumpsPass>();
+}
+
+} // namespace t81::tisc::ir
@@ -37,6 +37,8 @@ std::string opcode_name(ir::Opcode opcode) {
     case ir::Opcode::JP: return "JP";
     case ir::Opcode::CALL: return "CALL";
     case ir::Opcode::RET: return "RET";
+    case ir::Opcode::STACK_ALLOC: return "STACK_ALLOC";
+    case ir::Opcode::STACK_FREE: return "STACK_FREE";
     case ir::Opcode::I2F: return "I2F";
     case ir::Opcode::F2I: return "F2I";
     case ir::Opcode::I2FRAC: return "I2FRAC";
@@ -0,0 +1,629 @@
+#include "t81/tisc/ssa.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+
+#include "t81/tisc/cfg.hpp"
+
+namespace t81::tisc::ir {
+
+namespace {
+
+// The operand an instruction writes in place; CALL writes r0 implicitly.
+std::optional<std::size_t> def_operand(const Instruction& instr) {
+    if (instr.opcode == Opcode::CALL || !register_effects(instr).def) return std::nullopt;
+    return 0;
+}
+
+std::uint64_t pair_key(int a, int b) {
+    if (a > b) std::swap(a, b);
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(a)) << 32) | static_cast<std::uint32_t>(b);
+}
+
+class UnionFind {
+public:
+    explicit UnionFind(int size) : _parent(static_cast<std::size_t>(size)) {
+        for (int i = 0; i < size; ++i) {
+            _parent[static_cast<std::size_t>(i)] = i;
+            _members.push_back({i});
+        }
+    }
+
+    int find(int v) {
+        while (_parent[static_cast<std::size_t>(v)] != v) {
+            auto& parent = _parent[static_cast<std::size_t>(v)];
+            parent = _parent[static_cast<std::size_t>(parent)];
+            v = parent;
+        }
+        return v;
+    }
+
+    const std::vector<int>& members(int root) const { return _members[static_cast<std::size_t>(root)]; }
+
+    void unite(int a, int b) {
+        if (_members[static_cast<std::size_t>(a)].size() < _members[static_cast<std::size_t>(b)].size()) {
+            std::swap(a, b);
+        }
+        _parent[static_cast<std::size_t>(b)] = a;
+        auto& into = _members[static_cast<std::size_t>(a)];
+        auto& from = _members[static_cast<std::size_t>(b)];
+        into.insert(into.end(), from.begin(), from.end());
+        from.clear();
+    }
+
+private:
+    std::vector<int> _parent;
+    std::vector<std::vector<int>> _members;
+};
+
+struct Copy {
+    int dest;
+    int src;
+    PrimitiveKind primitive;
+};
+
+Instruction make_move(int dest, int src, PrimitiveKind primitive) {
+    Instruction move(Opcode::MOV, {Register{dest}, Register{src}});
+    move.primitive = primitive;
+    return move;
+}
+
+// Orders a set of simultaneous copies so no source is overwritten before
+// it is read, breaking cycles through `temp`.
+void sequentialize(std::vector<Copy> pending, int temp, std::vector<Instruction>& out) {
+    while (!pending.empty()) {
+        auto ready = std::find_if(pending.begin(), pending.end(), [&](const Copy& copy) {
+            return std::none_of(pending.begin(), pending.end(),
+                                [&](const Copy& other) { return other.src == copy.dest; });
+        });
+        if (ready != pending.end()) {
+            out.push_back(make_move(ready->dest, ready->src, ready->primitive));
+            pending.erase(ready);
+            continue;
+        }
+        // Every destination is still to be read: save one and redirect its
+        // readers to the saved copy.
+        const int saved = pending.front().dest;
+        out.push_back(make_move(temp, saved, pending.front().primitive));
+        for (Copy& copy : pending) {
+            if (copy.src == saved) copy.src = temp;
+        }
+    }
+}
+
+} // namespace
+
+DominatorTree DominatorTree::build(const std::vector<std::vector<std::size_t>>& successors) {
+    const std::size_t count = successors.size();
+    DominatorTree tree;
+    tree._idom.assign(count, kNone);
+    tree._children.resize(count);
+    if (count == 0) return tree;
+
+    // Postorder by iterative depth-first search from the entry.
+    std::vector<std::size_t> postorder;
+    std::vector<bool> seen(count, false);
+    std::vector<std::pair<std::size_t, std::size_t>> stack{{0, 0}};
+    seen[0] = true;
+    while (!stack.empty()) {
+        auto& [block, next] = stack.back();
+        if (next < successors[block].size()) {
+            const std::size_t succ = successors[block][next++];
+            if (!seen[succ]) {
+                seen[succ] = true;
+                stack.emplace_back(succ, 0);
+            }
+            continue;
+        }
+        postorder.push_back(block);
+        stack.pop_back();
+    }
+    tree._order.assign(postorder.rbegin(), postorder.rend());
+    std::vector<std::size_t> number(count, kNone);
+    for (std::size_t i = 0; i < postorder.size(); ++i) {
+        number[postorder[i]] = i;
+    }
+
+    std::vector<std::vector<std::size_t>> predecessors(count);
+    for (std::size_t b = 0; b < count; ++b) {
+        if (!seen[b]) continue;
+        for (std::size_t succ : successors[b]) {
+            predecessors[succ].push_back(b);
+        }
+    }
+
+    auto intersect = [&](std::size_t a, std::size_t b) {
+        while (a != b) {
+            while (number[a] < number[b]) a = tree._idom[a];
+            while (number[b] < number[a]) b = tree._idom[b];
+        }
+        return a;
+    };
+    tree._idom[0] = 0;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (std::size_t block : tree._order) {
+            if (block == 0) continue;
+            std::size_t idom = kNone;
+            for (std::size_t pred : predecessors[block]) {
+                if (tree._idom[pred] == kNone) continue;
+                idom = idom == kNone ? pred : intersect(pred, idom);
+            }
+            if (tree._idom[block] != idom) {
+                tree._idom[block] = idom;
+                changed = true;
+            }
+        }
+    }
+    for (std::size_t b = 1; b < count; ++b) {
+        if (tree._idom[b] != kNone) tree._children[tree._idom[b]].push_back(b);
+    }
+    return tree;
+}
+
+bool DominatorTree::dominates(std::size_t a, std::size_t b) const {
+    if (!reachable(a) || !reachable(b)) return false;
+    while (b != a && b != 0) {
+        b = _idom[b];
+    }
+    return b == a;
+}
+
+std::optional<SsaForm> SsaForm::build(const std::vector<Instruction>& instrs) {
+    if (instrs.empty()) return std::nullopt;
+    const auto cfg = ControlFlowGraph::build(instrs);
+    const auto liveness = Liveness::compute(instrs, cfg);
+    bool reads_uninitialized = false;
+    liveness.live_in(0).for_each([&](int reg) { reads_uninitialized = reads_uninitialized || reg != kReturnRegister; });
+    if (reads_uninitialized) return std::nullopt;
+
+    const auto& blocks = cfg.blocks();
+    std::vector<std::vector<std::size_t>> successors;
+    successors.reserve(blocks.size());
+    for (const BasicBlock& block : blocks) {
+        successors.push_back(block.successors);
+    }
+    const auto dominators = DominatorTree::build(successors);
+
+    SsaForm form;
+    form._blocks.resize(blocks.size());
+    int max_reg = 0;
+    int max_label = -1;
+    for (std::size_t b = 0; b < blocks.size(); ++b) {
+        SsaBlock& block = form._blocks[b];
+        if (!dominators.reachable(b)) {
+            block.live = false;
+            continue;
+        }
+        block.instrs.assign(instrs.begin() + static_cast<std::ptrdiff_t>(blocks[b].begin),
+                            instrs.begin() + static_cast<std::ptrdiff_t>(blocks[b].end));
+        block.successors = blocks[b].successors;
+        for (std::size_t pred : blocks[b].predecessors) {
+            if (dominators.reachable(pred)) block.predecessors.push_back(pred);
+        }
+        for (const Instruction& instr : block.instrs) {
+            for (const Operand& operand : instr.operands) {
+                if (const auto* reg = std::get_if<Register>(&operand)) max_reg = std::max(max_reg, reg->index);
+                if (const auto* label = std::get_if<Label>(&operand)) max_label = std::max(max_label, label->id);
+            }
+            if (instr.opcode == Opcode::LABEL && !instr.operands.empty()) {
+                if (const auto* label = std::get_if<Label>(&instr.operands.front())) {
+                    form._label_block[label->id] = b;
+                }
+            }
+        }
+    }
+    form._next_label = max_label + 1;
+
+    // Dominance frontiers.
+    std::vector<std::vector<std::size_t>> frontier(blocks.size());
+    for (std::size_t b = 0; b < blocks.size(); ++b) {
+        const auto& preds = form._blocks[b].predecessors;
+        if (preds.size() < 2) continue;
+        for (std::size_t pred : preds) {
+            for (std::size_t runner = pred; runner != dominators.idom(b); runner = dominators.idom(runner)) {
+                auto& df = frontier[runner];
+                if (std::find(df.begin(), df.end(), b) == df.end()) df.push_back(b);
+            }
+        }
+    }
+
+    // Pruned phi placement: iterated dominance frontier of each register's
+    // definitions, restricted to blocks where the register is live on entry.
+    std::vector<std::vector<std::size_t>> def_blocks(static_cast<std::size_t>(max_reg) + 1);
+    for (std::size_t b = 0; b < blocks.size(); ++b) {
+        for (const Instruction& instr : form._blocks[b].instrs) {
+            const auto def = register_effects(instr).def;
+            if (def && *def != kReturnRegister) {
+                auto& sites = def_blocks[static_cast<std::size_t>(*def)];
+                if (sites.empty() || sites.back() != b) sites.push_back(b);
+            }
+        }
+    }
+    std::vector<std::vector<int>> phi_origin(blocks.size());
+    std::vector<int> has_phi(blocks.size(), 0);
+    std::vector<int> queued(blocks.size(), 0);
+    for (int reg = 1; reg <= max_reg; ++reg) {
+        std::vector<std::size_t> work = def_blocks[static_cast<std::size_t>(reg)];
+        for (std::size_t b : work) queued[b] = reg;
+        while (!work.empty()) {
+            const std::size_t b = work.back();
+            work.pop_back();
+            for (std::size_t join : frontier[b]) {
+                if (has_phi[join] == reg || !liveness.live_in(join).contains(reg)) continue;
+                has_phi[join] = reg;
+                Phi phi;
+                phi.args.assign(form._blocks[join].predecessors.size(), 0);
+                form._blocks[join].phis.push_back(std::move(phi));
+                phi_origin[join].push_back(reg);
+                if (queued[join] != reg) {
+                    queued[join] = reg;
+                    work.push_back(join);
+                }
+            }
+        }
+    }
+
+    // Renaming, walking the dominator tree with an explicit stack.
+    std::vector<std::vector<int>> current(static_cast<std::size_t>(max_reg) + 1);
+    std::vector<PrimitiveKind> kinds{PrimitiveKind::Unknown};
+    bool complete = true;
+    auto top = [&](int reg) {
+        const auto& stack = current[static_cast<std::size_t>(reg)];
+        if (stack.empty()) {
+            complete = false;
+            return 0;
+        }
+        return stack.back();
+    };
+    auto define = [&](int reg, PrimitiveKind kind, std::vector<int>& pushed) {
+        const int value = static_cast<int>(kinds.size());
+        kinds.push_back(kind);
+        current[static_cast<std::size_t>(reg)].push_back(value);
+        pushed.push_back(reg);
+        return value;
+    };
+
+    struct Frame {
+        std::size_t block;
+        bool entered;
+        std::vector<int> pushed;
+    };
+    std::vector<Frame> frames;
+    frames.push_back(Frame{0, false, {}});
+    while (!frames.empty()) {
+        if (frames.back().entered) {
+            for (int reg : frames.back().pushed) {
+                current[static_cast<std::size_t>(reg)].pop_back();
+            }
+            frames.pop_back();
+            continue;
+        }
+        frames.back().entered = true;
+        const std::size_t b = frames.back().block;
+        std::vector<int> pushed;
+        SsaBlock& block = form._blocks[b];
+        for (std::size_t i = 0; i < block.phis.size(); ++i) {
+            block.phis[i].dest = define(phi_origin[b][i], PrimitiveKind::Unknown, pushed);
+        }
+        for (Instruction& instr : block.instrs) {
+            for (std::size_t k = 0; k < instr.operands.size(); ++k) {
+                auto* reg = std::get_if<Register>(&instr.operands[k]);
+                const auto def = def_operand(instr);
+                if (!reg || reg->index == kReturnRegister || (def && *def == k)) continue;
+                reg->index = top(reg->index);
+            }
+            if (const auto def = def_operand(instr)) {
+                auto& reg = std::get<Register>(instr.operands[*def]);
+                if (reg.index != kReturnRegister) {
+                    reg.index = define(reg.index, instr.primitive, pushed);
+                }
+            }
+        }
+        for (std::size_t succ : block.successors) {
+            SsaBlock& next = form._blocks[succ];
+            const auto pos = std::find(next.predecessors.begin(), next.predecessors.end(), b);
+            const auto j = static_cast<std::size_t>(pos - next.predecessors.begin());
+            for (std::size_t i = 0; i < next.phis.size(); ++i) {
+                next.phis[i].args[j] = top(phi_origin[succ][i]);
+            }
+        }
+        frames.back().pushed = std::move(pushed);
+        const auto& children = dominators.children(b);
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            frames.push_back(Frame{*it, false, {}});
+        }
+    }
+    if (!complete) return std::nullopt;
+    form._value_count = static_cast<int>(kinds.size()) - 1;
+
+    // A phi takes the kind of whichever incoming value has one.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (SsaBlock& block : form._blocks) {
+            for (Phi& phi : block.phis) {
+                if (kinds[static_cast<std::size_t>(phi.dest)] != PrimitiveKind::Unknown) continue;
+                for (int arg : phi.args) {
+                    if (kinds[static_cast<std::size_t>(arg)] != PrimitiveKind::Unknown) {
+                        phi.primitive = kinds[static_cast<std::size_t>(arg)];
+                        kinds[static_cast<std::size_t>(phi.dest)] = phi.primitive;
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return form;
+}
+
+std::optional<std::size_t> SsaForm::target_block(const Instruction& jump) const {
+    const auto label = jump_target(jump);
+    if (!label) return std::nullopt;
+    auto it = _label_block.find(*label);
+    if (it == _label_block.end()) return std::nullopt;
+    return it->second;
+}
+
+std::optional<std::size_t> SsaForm::fall_through(std::size_t block) const {
+    const auto& instrs = _blocks[block].instrs;
+    if (!instrs.empty() && ends_control_flow(instrs.back().opcode)) return std::nullopt;
+    if (block + 1 >= _blocks.size()) return std::nullopt;
+    return block + 1;
+}
+
+void SsaForm::remove_edge(std::size_t from, std::size_t to) {
+    std::erase(_blocks[from].successors, to);
+    auto& preds = _blocks[to].predecessors;
+    const auto pos = std::find(preds.begin(), preds.end(), from);
+    if (pos == preds.end()) return;
+    const auto j = pos - preds.begin();
+    preds.erase(pos);
+    for (Phi& phi : _blocks[to].phis) {
+        phi.args.erase(phi.args.begin() + j);
+    }
+}
+
+void SsaForm::replace_uses(const std::unordered_map<int, int>& replacement) {
+    auto resolve = [&](int value) {
+        for (auto it = replacement.find(value); it != replacement.end(); it = replacement.find(value)) {
+            value = it->second;
+        }
+        return value;
+    };
+    for (SsaBlock& block : _blocks) {
+        for (Phi& phi : block.phis) {
+            for (int& arg : phi.args) arg = resolve(arg);
+        }
+        for (Instruction& instr : block.instrs) {
+            const auto def = def_operand(instr);
+            for (std::size_t k = 0; k < instr.operands.size(); ++k) {
+                if (def && *def == k) continue;
+                if (auto* reg = std::get_if<Register>(&instr.operands[k])) reg->index = resolve(reg->index);
+            }
+        }
+    }
+}
+
+std::vector<Instruction> SsaForm::lower(SsaLoweringStats* stats) const {
+    SsaLoweringStats local;
+    SsaLoweringStats& counts = stats ? *stats : local;
+    const std::size_t count = _blocks.size();
+
+    // Liveness over values. A phi reads its argument at the end of the
+    // matching predecessor and defines its result on entry to its block.
+    std::vector<RegisterSet> uses(count);
+    std::vector<RegisterSet> defs(count);
+    std::vector<RegisterSet> phi_reads(count);
+    for (std::size_t b = 0; b < count; ++b) {
+        const SsaBlock& block = _blocks[b];
+        if (!block.live) continue;
+        for (const Phi& phi : block.phis) {
+            defs[b].insert(phi.dest);
+            for (std::size_t j = 0; j < phi.args.size(); ++j) {
+                if (phi.args[j] != kReturnRegister) phi_reads[block.predecessors[j]].insert(phi.args[j]);
+            }
+        }
+        for (const Instruction& instr : block.instrs) {
+            const RegisterEffects effects = register_effects(instr);
+            for (int reg : effects.uses) {
+                if (reg != kReturnRegister && !defs[b].contains(reg)) uses[b].insert(reg);
+            }
+            if (effects.def && *effects.def != kReturnRegister) defs[b].insert(*effects.def);
+        }
+    }
+    std::vector<RegisterSet> live_in(count);
+    std::vector<RegisterSet> live_out(count);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (std::size_t b = count; b-- > 0;) {
+            if (!_blocks[b].live) continue;
+            RegisterSet out = phi_reads[b];
+            for (std::size_t succ : _blocks[b].successors) out.merge(live_in[succ]);
+            RegisterSet in = uses[b];
+            out.for_each([&](int value) {
+                if (!defs[b].contains(value)) in.insert(value);
+            });
+            if (!(out == live_out[b]) || !(in == live_in[b])) {
+                live_out[b] = std::move(out);
+                live_in[b] = std::move(in);
+                changed = true;
+            }
+        }
+    }
+
+    // Interference: a value interferes with everything live where it is
+    // defined, except the source of the copy that defines it.
+    std::unordered_set<std::uint64_t> interference;
+    for (std::size_t b = 0; b < count; ++b) {
+        const SsaBlock& block = _blocks[b];
+        if (!block.live) continue;
+        RegisterSet live = live_out[b];
+        for (std::size_t i = block.instrs.size(); i-- > 0;) {
+            const Instruction& instr = block.instrs[i];
+            const RegisterEffects effects = register_effects(instr);
+            if (effects.def && *effects.def != kReturnRegister) {
+                const int def = *effects.def;
+                const int copied = instr.opcode == Opcode::MOV && !effects.uses.empty() ? effects.uses.front() : -1;
+                live.for_each([&](int value) {
+                    if (value != def && value != copied) interference.insert(pair_key(def, value));
+                });
+                live.erase(def);
+            }
+            for (int reg : effects.uses) {
+                if (reg != kReturnRegister) live.insert(reg);
+            }
+        }
+        for (const Phi& phi : block.phis) live.erase(phi.dest);
+        for (std::size_t p = 0; p < block.phis.size(); ++p) {
+            const int dest = block.phis[p].dest;
+            live.for_each([&](int value) { interference.insert(pair_key(dest, value)); });
+            for (std::size_t q = p + 1; q < block.phis.size(); ++q) {
+                interference.insert(pair_key(dest, block.phis[q].dest));
+            }
+        }
+    }
+
+    // Coalesce phi-related values first, since a phi move that stays may
+    // need an edge of its own, then plain copies.
+    UnionFind classes(_value_count + 1);
+    auto try_coalesce = [&](int a, int b) {
+        if (a == kReturnRegister || b == kReturnRegister) return;
+        a = classes.find(a);
+        b = classes.find(b);
+        if (a == b) return;
+        for (int x : classes.members(a)) {
+            for (int y : classes.members(b)) {
+                if (interference.contains(pair_key(x, y))) return;
+            }
+        }
+        classes.unite(a, b);
+    };
+    for (const SsaBlock& block : _blocks) {
+        if (!block.live) continue;
+        for (const Phi& phi : block.phis) {
+            for (int arg : phi.args) try_coalesce(phi.dest, arg);
+        }
+    }
+    for (const SsaBlock& block : _blocks) {
+        if (!block.live) continue;
+        for (const Instruction& instr : block.instrs) {
+            if (instr.opcode != Opcode::MOV || instr.operands.size() != 2) continue;
+            const auto* dest = std::get_if<Register>(&instr.operands[0]);
+            const auto* src = std::get_if<Register>(&instr.operands[1]);
+            if (dest && src) try_coalesce(dest->index, src->index);
+        }
+    }
+
+    auto rename = [&](Instruction instr) {
+        for (Operand& operand : instr.operands) {
+            if (auto* reg = std::get_if<Register>(&operand); reg && reg->index != kReturnRegister) {
+                reg->index = classes.find(reg->index);
+            }
+        }
+        return instr;
+    };
+    auto edge_copies = [&](std::size_t from, std::size_t to) {
+        std::vector<Copy> copies;
+        const SsaBlock& target = _blocks[to];
+        const auto pos = std::find(target.predecessors.begin(), target.predecessors.end(), from);
+        if (pos == target.predecessors.end()) return copies;
+        const auto j = static_cast<std::size_t>(pos - target.predecessors.begin());
+        for (const Phi& phi : target.phis) {
+            const int dest = classes.find(phi.dest);
+            const int src = phi.args[j] == kReturnRegister ? kReturnRegister : classes.find(phi.args[j]);
+            if (dest == src) {
+                ++counts.copies_coalesced;
+            } else {
+                copies.push_back(Copy{dest, src, phi.primitive});
+            }
+        }
+        counts.copies_inserted += static_cast<std::int64_t>(copies.size());
+        return copies;
+    };
+
+    const int temp = _value_count + 1;
+    int next_label = _next_label;
+    std::vector<Instruction> out;
+    std::vector<Instruction> split;
+    for (std::size_t b = 0; b < count; ++b) {
+        const SsaBlock& block = _blocks[b];
+        if (!block.live) continue;
+        const std::size_t body = block.instrs.empty() ? 0 : block.instrs.size() - 1;
+        for (std::size_t i = 0; i < body; ++i) {
+            Instruction instr = rename(block.instrs[i]);
+            if (instr.opcode == Opcode::MOV && instr.operands.size() == 2) {
+                const auto* dest = std::get_if<Register>(&instr.operands[0]);
+                const auto* src = std::get_if<Register>(&instr.operands[1]);
+                if (dest && src && dest->index == src->index) {
+                    ++counts.copies_coalesced;
+                    continue;
+                }
+            }
+            out.push_back(std::move(instr));
+        }
+        if (block.instrs.empty()) {
+            if (auto next = fall_through(b)) sequentialize(edge_copies(b, *next), temp, out);
+            continue;
+        }
+        Instruction last = rename(block.instrs.back());
+        const bool is_move = last.opcode == Opcode::MOV && last.operands.size() == 2 &&
+                             std::holds_alternative<Register>(last.operands[0]) &&
+                             std::holds_alternative<Register>(last.operands[1]) &&
+                             std::get<Register>(last.operands[0]).index == std::get<Register>(last.operands[1]).index;
+        if (last.opcode == Opcode::JMP) {
+            if (auto target = target_block(last)) sequentialize(edge_copies(b, *target), temp, out);
+            out.push_back(std::move(last));
+        } else if (is_conditional_jump(last.opcode)) {
+            // Moves for the taken edge get a block of their own at the end
+            // of the stream; moves for the fall-through edge go after the
+            // jump.
+            if (auto target = target_block(last)) {
+                auto copies = edge_copies(b, *target);
+                if (!copies.empty()) {
+                    const int label = next_label++;
+                    split.push_back(Instruction(Opcode::LABEL, {Label{label}}));
+                    sequentialize(std::move(copies), temp, split);
+                    split.push_back(Instruction(Opcode::JMP, {last.operands.front()}));
+                    last.operands.front() = Label{label};
+                    ++counts.edges_split;
+                }
+            }
+            out.push_back(std::move(last));
+            if (auto next = fall_through(b)) sequentialize(edge_copies(b, *next), temp, out);
+        } else {
+            if (is_move) {
+                ++counts.copies_coalesced;
+            } else {
+                out.push_back(std::move(last));
+            }
+            if (auto next = fall_through(b)) sequentialize(edge_copies(b, *next), temp, out);
+        }
+    }
+    if (!split.empty()) {
+        // Falling off the end halts; keep doing so rather than run into
+        // the split edges.
+        if (!out.empty() && !ends_control_flow(out.back().opcode)) out.push_back(Instruction(Opcode::HALT));
+        std::move(split.begin(), split.end(), std::back_inserter(out));
+    }
+
+    // Dense register numbers in order of first appearance.
+    std::unordered_map<int, int> numbering;
+    for (Instruction& instr : out) {
+        for (Operand& operand : instr.operands) {
+            if (auto* reg = std::get_if<Register>(&operand); reg && reg->index != kReturnRegister) {
+                auto [it, inserted] = numbering.emplace(reg->index, static_cast<int>(numbering.size()) + 1);
+                reg->index = it->second;
+            }
+        }
+    }
+    return out;
+}
+
+} // namespace t81::tisc::ir
@@ -0,0 +1,56 @@
+/**
+ * @file bench_corpus.hpp
+ * @brief The `.t81` corpus the frontend throughput benches run over.
+ */
+#ifndef T81_BENCH_CORPUS_HPP
+#define T81_BENCH_CORPUS_HPP
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace t81::bench {
+
+// Every .t81 file under `root`, read in path order so runs compare.
+inline std::vector<std::string> load_corpus(const std::filesystem::path& root) {
+    std::vector<std::filesystem::path> paths;
+    std::error_code ec;
+    if (!std::filesystem::is_directory(root, ec)) return {};
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".t81") {
+            paths.push_back(entry.path());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<std::string> sources;
+    sources.reserve(paths.size());
+    for (const auto& path : paths) {
+        std::ifstream in(path, std::ios::binary);
+        std::ostringstream buffer;
+        buffer << in.rdbuf();
+        sources.push_back(buffer.str());
+    }
+    return sources;
+}
+
+// The corpus named by a bench's first argument, `examples` by default.
+// Reports an empty or missing corpus and returns nullopt.
+inline std::optional<std::vector<std::string>> corpus_from_args(int argc, char** argv) {
+    const std::filesystem::path corpus_dir = argc > 1 ? argv[1] : "examples";
+    auto sources = load_corpus(corpus_dir);
+    if (sources.empty()) {
+        std::cerr << "no .t81 sources under " << corpus_dir << "\n";
+        return std::nullopt;
+    }
+    return sources;
+}
+
+} // namespace t81::bench
+
+#endif // T81_BENCH_CORPUS_HPP
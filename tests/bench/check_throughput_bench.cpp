@@ -0,0 +1,65 @@
+/**
+ * @file check_throughput_bench.cpp
+ * @brief Measures SemanticAnalyzer throughput over the examples/ corpus.
+ *
+ * Every file is parsed once up front; the timed loop runs only the checker,
+ * so the report isolates type checking, scope resolution and side-table
+ * bookkeeping from lexing and parsing.
+ *
+ * Usage: check_throughput_bench [corpus_dir] [iterations]
+ */
+#include "bench_corpus.hpp"
+#include "t81/frontend/lexer.hpp"
+#include "t81/frontend/parser.hpp"
+#include "t81/frontend/semantic_analyzer.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace t81::frontend;
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 500;
+
+    const auto corpus = t81::bench::corpus_from_args(argc, argv);
+    if (!corpus) return 1;
+    const auto& sources = *corpus;
+
+    // Diagnostics from intentionally failing examples are not part of the measurement.
+    std::cerr.setstate(std::ios::failbit);
+
+    std::vector<SyntaxTree> trees;
+    std::size_t nodes_per_pass = 0;
+    for (const auto& source : sources) {
+        const TokenStream tokens = TokenStream::tokenize(source);
+        Parser parser(tokens);
+        SyntaxTree tree = parser.parse();
+        // Like the CLI, only trees that parsed cleanly reach the checker.
+        if (parser.had_error()) continue;
+        nodes_per_pass += tree.node_count;
+        trees.push_back(std::move(tree));
+    }
+
+    std::size_t rejected = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (const auto& tree : trees) {
+            SemanticAnalyzer analyzer(tree, "bench.t81");
+            analyzer.analyze();
+            rejected += analyzer.had_error() ? 1 : 0;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    const double checks = static_cast<double>(iterations) * static_cast<double>(trees.size());
+
+    std::cout << "check: files=" << trees.size() << " nodes/pass=" << nodes_per_pass
+              << " iterations=" << iterations << " rejected=" << rejected / iterations << "\n";
+    std::cout << "check: " << static_cast<std::size_t>(nodes_per_pass * iterations / seconds)
+              << " nodes/sec, " << static_cast<std::size_t>(seconds * 1e6 / checks) << " us/file\n";
+    return 0;
+}
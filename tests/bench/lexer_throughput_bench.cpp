@@ -0,0 +1,50 @@
+/**
+ * @file lexer_throughput_bench.cpp
+ * @brief Measures Lexer throughput (tokens/sec) over the examples/ corpus.
+ *
+ * Usage: lexer_throughput_bench [corpus_dir] [iterations]
+ */
+#include "bench_corpus.hpp"
+#include "t81/frontend/lexer.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace t81::frontend;
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 2000;
+
+    const auto corpus = t81::bench::corpus_from_args(argc, argv);
+    if (!corpus) return 1;
+    const auto& sources = *corpus;
+
+    std::size_t bytes = 0;
+    for (const auto& source : sources) bytes += source.size();
+
+    std::size_t tokens = 0;
+    std::size_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (const auto& source : sources) {
+            Lexer lexer(source);
+            for (Token token = lexer.next_token(); token.type != TokenType::Eof;
+                 token = lexer.next_token()) {
+                checksum += static_cast<std::size_t>(token.type);
+                ++tokens;
+            }
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "lexer: files=" << sources.size() << " bytes=" << bytes
+              << " iterations=" << iterations << " tokens=" << tokens << "\n";
+    std::cout << "lexer: " << static_cast<std::size_t>(tokens / seconds) << " tokens/sec, "
+              << (static_cast<double>(bytes) * iterations / seconds / (1024.0 * 1024.0))
+              << " MiB/sec (checksum " << checksum << ")\n";
+    return 0;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file parser_throughput_bench.cpp
+ * @brief Measures Parser throughput and heap traffic over the examples/ corpus.
+ *
+ * Global operator new/delete are replaced with counting hooks so the report
+ * shows allocations per parse alongside tokens/sec.
+ *
+ * Usage: parser_throughput_bench [corpus_dir] [iterations]
+ */
+#include "bench_corpus.hpp"
+#include "t81/frontend/lexer.hpp"
+#include "t81/frontend/parser.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace t81::frontend;
+
+namespace {
+std::atomic<std::size_t> g_allocations{0};
+std::atomic<std::size_t> g_allocated_bytes{0};
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 2 ? std::atoi(argv[2]) : 500;
+
+    const auto corpus = t81::bench::corpus_from_args(argc, argv);
+    if (!corpus) return 1;
+    const auto& sources = *corpus;
+
+    std::vector<TokenStream> streams;
+    std::size_t tokens_per_pass = 0;
+    for (const auto& source : sources) {
+        streams.push_back(TokenStream::tokenize(source));
+        tokens_per_pass += streams.back().size();
+    }
+
+    // Diagnostics from intentionally failing examples are not part of the measurement.
+    std::cerr.setstate(std::ios::failbit);
+
+    std::size_t statements = 0;
+    const std::size_t allocations_before = g_allocations.load();
+    const std::size_t bytes_before = g_allocated_bytes.load();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (const auto& stream : streams) {
+            Parser parser(stream);
+            statements += parser.parse().size();
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const std::size_t allocations = g_allocations.load() - allocations_before;
+    const std::size_t bytes = g_allocated_bytes.load() - bytes_before;
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    const double parses = static_cast<double>(iterations) * static_cast<double>(streams.size());
+
+    std::cout << "parser: files=" << streams.size() << " tokens/pass=" << tokens_per_pass
+              << " iterations=" << iterations << " statements=" << statements << "\n";
+    std::cout << "parser: " << static_cast<std::size_t>(tokens_per_pass * iterations / seconds)
+              << " tokens/sec, " << static_cast<std::size_t>(allocations / parses) << " allocs/file, "
+              << static_cast<std::size_t>(bytes / parses) << " bytes/file\n";
+    return 0;
+}
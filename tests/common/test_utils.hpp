@@ -4,11 +4,21 @@
 #include "t81/frontend/ast.hpp"
 #include "t81/frontend/parser.hpp"
 #include "t81/frontend/semantic_analyzer.hpp"
+#include "t81/tisc/calling_convention.hpp"
+#include "t81/tisc/ir.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <sstream>
 #include <any>
+#include <unordered_map>
+#include <utility>
+#include <variant>
 #include <vector>
 
 using namespace t81::frontend;
@@ -105,6 +115,9 @@ public:
         if (stmt.attributes.is_effectful) {
             ss << " @effect";
         }
+        if (stmt.attributes.is_tailrec) {
+            ss << " @tailrec";
+        }
         if (stmt.attributes.tier.has_value()) {
             ss << " @tier(" << *stmt.attributes.tier << ")";
         }
@@ -131,11 +144,11 @@ public:
     }
 
     std::any visit(const ModuleDecl& stmt) override {
-        return std::string("(module " + stmt.path + ")");
+        return "(module " + std::string(stmt.path) + ")";
     }
 
     std::any visit(const ImportDecl& stmt) override {
-        return std::string("(import " + stmt.path + ")");
+        return "(import " + std::string(stmt.path) + ")";
     }
 
     std::any visit(const TypeDecl& stmt) override {
@@ -320,10 +333,10 @@ private:
         ss << "(" << name;
         for (const auto& part : parts) {
             ss << " ";
-            if (part.type() == typeid(const std::unique_ptr<Expr>*)) {
-                ss << print(**std::any_cast<const std::unique_ptr<Expr>*>(part));
-            } else if (part.type() == typeid(const std::unique_ptr<Stmt>*)) {
-                 ss << print(**std::any_cast<const std::unique_ptr<Stmt>*>(part));
+            if (part.type() == typeid(const AstPtr<Expr>*)) {
+                ss << print(**std::any_cast<const AstPtr<Expr>*>(part));
+            } else if (part.type() == typeid(const AstPtr<Stmt>*)) {
+                 ss << print(**std::any_cast<const AstPtr<Stmt>*>(part));
             }
         }
         ss << ")";
@@ -374,4 +387,193 @@ inline void expect_semantic_failure(const std::string& source, const char* label
     }
 }
 
+inline t81::tisc::ir::Instruction loadi(int reg, long long value,
+                                        t81::tisc::ir::PrimitiveKind primitive = t81::tisc::ir::PrimitiveKind::Integer) {
+    t81::tisc::ir::Instruction instr(t81::tisc::ir::Opcode::LOADI,
+                                     {t81::tisc::ir::Register{reg}, t81::tisc::ir::Immediate{value}});
+    instr.primitive = primitive;
+    return instr;
+}
+
+inline t81::tisc::ir::IntermediateProgram program_of(std::vector<t81::tisc::ir::Instruction> instrs) {
+    t81::tisc::ir::IntermediateProgram program;
+    for (auto& instr : instrs) {
+        program.add_instruction(std::move(instr));
+    }
+    return program;
+}
+
+inline std::size_t count_of(const std::vector<t81::tisc::ir::Instruction>& instrs, t81::tisc::ir::Opcode opcode) {
+    return static_cast<std::size_t>(std::count_if(instrs.begin(), instrs.end(),
+                                                  [&](const auto& instr) { return instr.opcode == opcode; }));
+}
+
+// A register holds an integer, or a tagged value with an optional payload.
+struct IrValue {
+    long long scalar = 0;
+    long long tag = -1;
+    std::shared_ptr<IrValue> payload;
+};
+
+// What a CALL does under run_ir: how many arguments the callee takes and
+// what it returns for them, or nullopt when it traps. Without one, a CALL
+// is a test failure.
+struct IrCallee {
+    std::function<std::size_t(long long)> arity;
+    std::function<std::optional<long long>(long long, const std::vector<long long>&)> result;
+};
+
+// Runs the integer and tagged-value subset of the IR the tests produce and
+// returns r0 at HALT, or nullopt on TRAP, on division by zero and when a
+// callee traps. A CALL follows
+// calling_convention.hpp whether or not lower-calls has run: it reads the
+// registers it names and any further arguments from the stack, where it
+// leaves them for the caller, then overwrites every caller-saved register
+// and puts the result in r0. STACK_ALLOC and STACK_FREE reserve and release
+// a frame of cells on the same stack, which LOAD and STORE address from the
+// frame's base, and RET ends the run like HALT, so a function
+// body can be run on its own. A program still running after `max_steps`
+// instructions fails the test rather than hang it.
+inline std::optional<long long> run_ir(const std::vector<t81::tisc::ir::Instruction>& instrs,
+                                       const IrCallee& callee = {}, std::size_t max_steps = 1'000'000) {
+    using namespace t81::tisc::ir;
+    std::unordered_map<int, std::size_t> labels;
+    for (std::size_t i = 0; i < instrs.size(); ++i) {
+        if (instrs[i].opcode == Opcode::LABEL) labels[std::get<Label>(instrs[i].operands[0]).id] = i;
+    }
+    std::map<int, IrValue> regs;
+    std::vector<IrValue> stack;
+    std::vector<std::pair<std::size_t, std::size_t>> frames; // Base, cells.
+    auto reg = [&](const Instruction& instr, std::size_t k) -> IrValue& {
+        return regs[std::get<Register>(instr.operands[k]).index];
+    };
+    auto imm = [](const Instruction& instr, std::size_t k) { return std::get<Immediate>(instr.operands[k]).value; };
+    auto frame_cell = [&](long long cell) {
+        assert(!frames.empty() && cell >= 0 && static_cast<std::size_t>(cell) < frames.back().second);
+        return frames.back().first + static_cast<std::size_t>(cell);
+    };
+    auto scalar = [](long long value) { return IrValue{value, -1, nullptr}; };
+    auto boxed = [](const IrValue& value) { return std::make_shared<IrValue>(value); };
+    std::size_t steps = 0;
+    for (std::size_t pc = 0; pc < instrs.size(); ++pc) {
+        assert(++steps <= max_steps && "program does not halt");
+        const Instruction& instr = instrs[pc];
+        auto jump_to = [&] { pc = labels.at(std::get<Label>(instr.operands[0]).id); };
+        switch (instr.opcode) {
+            case Opcode::LOADI: reg(instr, 0) = scalar(imm(instr, 1)); break;
+            case Opcode::MOV: reg(instr, 0) = reg(instr, 1); break;
+            case Opcode::ADD: reg(instr, 0) = scalar(reg(instr, 1).scalar + reg(instr, 2).scalar); break;
+            case Opcode::SUB: reg(instr, 0) = scalar(reg(instr, 1).scalar - reg(instr, 2).scalar); break;
+            case Opcode::MUL: reg(instr, 0) = scalar(reg(instr, 1).scalar * reg(instr, 2).scalar); break;
+            case Opcode::DIV:
+            case Opcode::MOD: {
+                const long long divisor = reg(instr, 2).scalar;
+                if (divisor == 0) return std::nullopt;
+                const long long dividend = reg(instr, 1).scalar;
+                reg(instr, 0) = scalar(instr.opcode == Opcode::DIV ? dividend / divisor : dividend % divisor);
+                break;
+            }
+            case Opcode::CMP: {
+                const long long a = reg(instr, 1).scalar;
+                const long long b = reg(instr, 2).scalar;
+                bool holds = false;
+                switch (instr.relation) {
+                    case ComparisonRelation::Less: holds = a < b; break;
+                    case ComparisonRelation::LessEqual: holds = a <= b; break;
+                    case ComparisonRelation::Greater: holds = a > b; break;
+                    case ComparisonRelation::GreaterEqual: holds = a >= b; break;
+                    case ComparisonRelation::Equal: holds = a == b; break;
+                    case ComparisonRelation::NotEqual: holds = a != b; break;
+                    case ComparisonRelation::None: assert(false && "comparison without a relation"); break;
+                }
+                reg(instr, 0) = scalar(holds ? 1 : 0);
+                break;
+            }
+            case Opcode::LOAD: reg(instr, 0) = stack.at(frame_cell(imm(instr, 1))); break;
+            case Opcode::STORE: stack.at(frame_cell(imm(instr, 0))) = reg(instr, 1); break;
+            case Opcode::PUSH: stack.push_back(reg(instr, 0)); break;
+            case Opcode::STACK_ALLOC:
+                frames.emplace_back(stack.size(), static_cast<std::size_t>(imm(instr, 0)));
+                stack.resize(stack.size() + frames.back().second);
+                break;
+            case Opcode::STACK_FREE:
+                assert(!frames.empty() && frames.back().second == static_cast<std::size_t>(imm(instr, 0)));
+                assert(stack.size() == frames.back().first + frames.back().second);
+                stack.resize(frames.back().first);
+                frames.pop_back();
+                break;
+            case Opcode::POP:
+                assert(!stack.empty());
+                reg(instr, 0) = stack.back();
+                stack.pop_back();
+                break;
+            case Opcode::CALL: {
+                assert(callee.arity && callee.result && "CALL without a callee model");
+                const long long id = imm(instr, 0);
+                const std::size_t arity = callee.arity(id);
+                const std::size_t named = instr.operands.size() - 1;
+                assert(named <= arity);
+                assert(instr.stack_arguments == 0 || named + instr.stack_arguments == arity);
+                std::vector<long long> args;
+                for (std::size_t i = 0; i < arity; ++i) {
+                    if (i < named) {
+                        args.push_back(reg(instr, i + 1).scalar);
+                        continue;
+                    }
+                    const std::size_t depth = i - named;
+                    assert(depth < stack.size());
+                    args.push_back(stack[stack.size() - 1 - depth].scalar);
+                }
+                const std::optional<long long> result = callee.result(id, args);
+                if (!result) return std::nullopt;
+                for (int r = 0; is_caller_saved(r); ++r) regs[r] = scalar(-999);
+                regs[kReturnRegister] = scalar(*result);
+                break;
+            }
+            case Opcode::MAKE_OPTION_SOME: reg(instr, 0) = IrValue{0, 1, boxed(reg(instr, 1))}; break;
+            case Opcode::MAKE_OPTION_NONE: reg(instr, 0) = IrValue{0, 0, nullptr}; break;
+            case Opcode::MAKE_ENUM_VARIANT: reg(instr, 0) = IrValue{0, imm(instr, 1), nullptr}; break;
+            case Opcode::MAKE_ENUM_VARIANT_PAYLOAD:
+                reg(instr, 0) = IrValue{0, imm(instr, 2), boxed(reg(instr, 1))};
+                break;
+            case Opcode::OPTION_IS_SOME: reg(instr, 0) = scalar(reg(instr, 1).tag == 1 ? 1 : 0); break;
+            case Opcode::ENUM_IS_VARIANT: reg(instr, 0) = scalar(reg(instr, 1).tag == imm(instr, 2) ? 1 : 0); break;
+            case Opcode::OPTION_UNWRAP:
+            case Opcode::ENUM_UNWRAP_PAYLOAD: {
+                const IrValue& source = reg(instr, 1);
+                assert(source.payload && "unwrapped a value without a payload");
+                reg(instr, 0) = *source.payload;
+                break;
+            }
+            case Opcode::JMP: jump_to(); break;
+            case Opcode::JZ:
+                if (reg(instr, 1).scalar == 0) jump_to();
+                break;
+            case Opcode::JNZ:
+                if (reg(instr, 1).scalar != 0) jump_to();
+                break;
+            case Opcode::LABEL:
+            case Opcode::NOP: break;
+            case Opcode::TRAP: return std::nullopt;
+            case Opcode::HALT:
+            case Opcode::RET:
+                assert(stack.empty());
+                return regs[kReturnRegister].scalar;
+            default: assert(false && "unexpected opcode");
+        }
+    }
+    return regs[kReturnRegister].scalar;
+}
+
+// run_ir for programs that must reach HALT.
+inline long long evaluate(const std::vector<t81::tisc::ir::Instruction>& instrs, const IrCallee& callee = {}) {
+    const auto result = run_ir(instrs, callee);
+    assert(result.has_value() && "program trapped");
+    return *result;
+}
+
+inline long long evaluate(const t81::tisc::ir::IntermediateProgram& program, const IrCallee& callee = {}) {
+    return evaluate(program.instructions(), callee);
+}
+
 #endif // T81_TEST_UTILS_HPP
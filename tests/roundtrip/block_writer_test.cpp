@@ -0,0 +1,49 @@
+#include "t81/support/block_writer.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+int main() {
+    const auto path = std::filesystem::temp_directory_path() / "t81_block_writer_test.txt";
+
+    // Enough output to cross several block boundaries, mixing text and
+    // integers so some land exactly on a boundary.
+    std::ostringstream expected;
+    {
+        t81::BlockWriter out(path);
+        assert(out.is_open());
+        const std::int64_t extremes[] = {0, -1, 7, std::numeric_limits<std::int64_t>::min(),
+                                         std::numeric_limits<std::int64_t>::max()};
+        for (int i = 0; i < 40000; ++i) {
+            const std::int64_t value = i % 5 < 3 ? extremes[i % 5] + i : extremes[i % 5];
+            out.write("{\"a\": ").write(value).write("}");
+            expected << "{\"a\": " << value << "}";
+            if (i % 997 == 0) {
+                const std::string long_text(t81::BlockWriter::kBlockSize + 13, 'x');
+                out.write(long_text);
+                expected << long_text;
+            }
+        }
+        assert(out.close());
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream actual;
+    actual << in.rdbuf();
+    assert(actual.str() == expected.str());
+    std::filesystem::remove(path);
+
+    t81::BlockWriter missing(std::filesystem::path("/nonexistent-dir/t81/out.txt"));
+    assert(!missing.is_open());
+    missing.write("dropped").write(std::int64_t{1});
+    assert(!missing.close());
+
+    std::cout << "Block writer tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,302 @@
+#include "../common/test_utils.hpp"
+#include "t81/frontend/ir_generator.hpp"
+#include "t81/frontend/lexer.hpp"
+#include "t81/frontend/parser.hpp"
+#include "t81/frontend/semantic_analyzer.hpp"
+#include "t81/tisc/ir.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace t81::frontend;
+using namespace t81::tisc::ir;
+
+namespace {
+
+struct Lowered {
+    std::vector<Instruction> instrs;
+    std::vector<IRGenerator::InlineRemark> remarks;
+};
+
+Lowered lower(const std::string& source, int threshold = IRGenerator::kDefaultInlineThreshold) {
+    Lexer lexer(source);
+    Parser parser(lexer);
+    auto stmts = parser.parse();
+    assert(!parser.had_error());
+
+    SemanticAnalyzer analyzer(stmts);
+    analyzer.analyze();
+    assert(!analyzer.had_error());
+
+    IRGenerator generator;
+    generator.attach_semantic_analyzer(&analyzer);
+    generator.set_inline_threshold(threshold);
+    auto program = generator.generate(stmts);
+    return Lowered{program.instructions(), generator.inline_remarks()};
+}
+
+const IRGenerator::InlineRemark& remark_for(const Lowered& lowered, const std::string& callee) {
+    auto it = std::find_if(lowered.remarks.begin(), lowered.remarks.end(),
+                           [&](const IRGenerator::InlineRemark& remark) { return remark.callee == callee; });
+    assert(it != lowered.remarks.end());
+    return *it;
+}
+
+} // namespace
+
+int main() {
+    // Small pure callees are expanded in place, leaving no CALL behind.
+    {
+        const auto lowered = lower(R"(
+            fn square(x: i32) -> i32 {
+                return x * x;
+            }
+
+            fn main() -> i32 {
+                return square(3) + square(4);
+            }
+        )");
+        assert(count_of(lowered.instrs, Opcode::CALL) == 0);
+        assert(evaluate(lowered.instrs) == 25);
+        assert(lowered.remarks.size() == 2);
+        const auto& remark = lowered.remarks.front();
+        assert(remark.inlined && remark.callee == "square" && remark.caller == "main");
+        assert(remark.line == 7 && remark.reason.starts_with("cost "));
+    }
+
+    // Effectful callees stay calls, and so does the recursive call left in
+    // an inlined body, each with the reason recorded.
+    {
+        const auto lowered = lower(R"(
+            @effect
+            fn log(x: i32) -> i32 {
+                return x;
+            }
+
+            fn fact(n: i32) -> i32 {
+                if (n < 2) {
+                    return 1;
+                }
+                return n * fact(n - 1);
+            }
+
+            @effect
+            fn main() -> i32 {
+                return log(1) + fact(5);
+            }
+        )");
+        const auto& effect = remark_for(lowered, "log");
+        assert(!effect.inlined && effect.reason == "marked @effect");
+        const auto& recursive = std::find_if(lowered.remarks.rbegin(), lowered.remarks.rend(),
+                                             [](const auto& remark) { return remark.callee == "fact"; });
+        assert(!recursive->inlined && recursive->reason == "recursive" && recursive->caller == "fact");
+        assert(count_of(lowered.instrs, Opcode::CALL) == 2);
+    }
+
+    // Inside inlined code only leaves are inlined further.
+    {
+        const auto lowered = lower(R"(
+            fn inc(x: i32) -> i32 {
+                return x + 1;
+            }
+
+            fn twice(x: i32) -> i32 {
+                return inc(inc(x));
+            }
+
+            fn main() -> i32 {
+                return twice(1);
+            }
+        )");
+        assert(count_of(lowered.instrs, Opcode::CALL) == 0);
+        assert(evaluate(lowered.instrs) == 3);
+        assert(remark_for(lowered, "inc").caller == "twice");
+    }
+
+    // Bodies above the threshold are left alone.
+    {
+        const auto lowered = lower(R"(
+            fn poly(x: i32) -> i32 {
+                return x * x * x + x * x + x + 1;
+            }
+
+            fn main() -> i32 {
+                return poly(2);
+            }
+        )",
+                                   4);
+        assert(count_of(lowered.instrs, Opcode::CALL) == 1);
+        assert(!lowered.remarks.front().inlined && lowered.remarks.front().reason.ends_with("threshold 4"));
+    }
+
+    // Early returns jump to the end of the inlined body.
+    {
+        const auto lowered = lower(R"(
+            fn clamp(x: i32) -> i32 {
+                if (x > 10) {
+                    return 10;
+                }
+                return x;
+            }
+
+            fn main() -> i32 {
+                return clamp(15) + clamp(3);
+            }
+        )");
+        assert(count_of(lowered.instrs, Opcode::CALL) == 0);
+        assert(evaluate(lowered.instrs) == 13);
+    }
+
+    // Assigning to a parameter leaves the caller's variable untouched.
+    {
+        const auto lowered = lower(R"(
+            fn bump(x: i32) -> i32 {
+                x = x + 1;
+                return x;
+            }
+
+            fn main() -> i32 {
+                let a: i32 = 1;
+                let b: i32 = bump(a);
+                return a * 10 + b;
+            }
+        )");
+        assert(count_of(lowered.instrs, Opcode::CALL) == 0);
+        assert(evaluate(lowered.instrs) == 12);
+    }
+
+    // A self tail call in an inlined body restarts it as a loop, however
+    // deep the recursion would have gone. @tailrec bodies are expanded
+    // whatever their size.
+    {
+        const auto lowered = lower(R"(
+            @tailrec
+            fn sum_to(n: i32, acc: i32) -> i32 {
+                if (n == 0) {
+                    return acc;
+                }
+                return sum_to(n - 1, acc + n);
+            }
+
+            fn main() -> i32 {
+                return sum_to(100000, 0);
+            }
+        )",
+                                   4);
+        assert(count_of(lowered.instrs, Opcode::CALL) == 0);
+        assert(evaluate(lowered.instrs) == 5000050000LL);
+        assert(remark_for(lowered, "sum_to").inlined && remark_for(lowered, "sum_to").reason.ends_with("@tailrec"));
+        const auto& loop = lowered.remarks.back();
+        assert(loop.tail_call && loop.callee == "sum_to" && loop.caller == "sum_to" && loop.line == 7);
+    }
+
+    // A @tailrec function is expanded into its loop at every level, even
+    // with inlining off and even when it is @effect.
+    for (int threshold : {0, IRGenerator::kDefaultInlineThreshold}) {
+        const auto lowered = lower(R"(
+            @effect
+            @tailrec
+            fn count(n: i32, acc: i32) -> i32 {
+                if (n == 0) {
+                    return acc;
+                }
+                return count(n - 1, acc + 1);
+            }
+
+            @effect
+            fn main() -> i32 {
+                return count(5000, 0);
+            }
+        )",
+                                   threshold);
+        assert(count_of(lowered.instrs, Opcode::CALL) == 0);
+        assert(evaluate(lowered.instrs) == 5000);
+        assert(lowered.remarks.back().tail_call);
+    }
+
+    // When the call cannot be expanded it is an error, not a CALL: here
+    // `pong` calls back into the `ping` it is being expanded inside.
+    for (int threshold : {0, IRGenerator::kDefaultInlineThreshold}) {
+        bool rejected = false;
+        try {
+            lower(R"(
+                @tailrec
+                fn ping(n: i32) -> i32 {
+                    if (n < 1) {
+                        return 0;
+                    }
+                    return pong(n - 1);
+                }
+
+                @tailrec
+                fn pong(n: i32) -> i32 {
+                    if (n < 1) {
+                        return 1;
+                    }
+                    return ping(n - 1);
+                }
+
+                fn main() -> i32 {
+                    return ping(7);
+                }
+            )",
+                  threshold);
+        } catch (const std::runtime_error& error) {
+            rejected = std::string(error.what()).find("cannot turn the call to @tailrec 'ping' into a loop: recursive") !=
+                       std::string::npos;
+        }
+        assert(rejected);
+    }
+
+    // Arguments that name other parameters are read before any parameter
+    // is overwritten.
+    {
+        const auto lowered = lower(R"(
+            fn gcd(a: i32, b: i32) -> i32 {
+                if (b == 0) {
+                    return a;
+                }
+                return gcd(b, a % b);
+            }
+
+            fn swap_down(a: i32, b: i32) -> i32 {
+                if (a < 1) {
+                    return b;
+                }
+                return swap_down(b - 1, a);
+            }
+
+            fn main() -> i32 {
+                return gcd(84, 36) * 100 + swap_down(3, 5);
+            }
+        )");
+        assert(count_of(lowered.instrs, Opcode::CALL) == 0);
+        // swap_down(3, 5) -> (4, 3) -> (2, 4) -> (3, 2) -> (1, 3) -> (2, 1)
+        // -> (0, 2) -> 2
+        assert(evaluate(lowered.instrs) == 1200 + 2);
+    }
+
+    // A threshold of 0 turns inlining off.
+    {
+        const auto lowered = lower(R"(
+            fn square(x: i32) -> i32 {
+                return x * x;
+            }
+
+            fn main() -> i32 {
+                return square(3);
+            }
+        )",
+                                   0);
+        assert(count_of(lowered.instrs, Opcode::CALL) == 1);
+        assert(lowered.remarks.empty());
+    }
+
+    std::cout << "Frontend IR inline tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "../common/test_utils.hpp"
+#include "t81/frontend/ir_generator.hpp"
+#include "t81/frontend/lexer.hpp"
+#include "t81/frontend/parser.hpp"
+#include "t81/frontend/semantic_analyzer.hpp"
+#include "t81/tisc/ir.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace t81::frontend;
+using namespace t81::tisc::ir;
+
+namespace {
+
+std::vector<Instruction> lower(const std::string& source) {
+    Lexer lexer(source);
+    Parser parser(lexer);
+    auto stmts = parser.parse();
+    assert(!parser.had_error());
+
+    SemanticAnalyzer analyzer(stmts);
+    analyzer.analyze();
+    assert(!analyzer.had_error());
+
+    IRGenerator generator;
+    generator.attach_semantic_analyzer(&analyzer);
+    return generator.generate(stmts).instructions();
+}
+
+// Substitutes `value` for the `$` in `source`.
+std::string with(std::string source, const std::string& value) {
+    source.replace(source.find('$'), 1, value);
+    return source;
+}
+
+} // namespace
+
+int main() {
+    // An exhaustive enum match tests every variant but the last; the last
+    // is reached once the others have been ruled out.
+    {
+        const std::string source = R"(
+            enum Op {
+                Add;
+                Sub;
+                Mul;
+                Div;
+                Halt;
+            };
+
+            fn main() -> i32 {
+                let op: Op = $;
+                return match (op) {
+                    Add => 1;
+                    Sub => 2;
+                    Mul => 3;
+                    Div => 4;
+                    Halt => 5;
+                };
+            }
+        )";
+        const std::vector<std::string> variants = {"Add", "Sub", "Mul", "Div", "Halt"};
+        for (std::size_t i = 0; i < variants.size(); ++i) {
+            const auto instrs = lower(with(source, "Op." + variants[i]));
+            assert(count_of(instrs, Opcode::ENUM_IS_VARIANT) == variants.size() - 1);
+            assert(run_ir(instrs) == static_cast<long long>(i + 1));
+        }
+    }
+
+    // Guarded arms for one variant share a single test and a single unwrap,
+    // and a failed guard falls to the next arm for the same variant.
+    {
+        const std::string source = R"(
+            fn main() -> i32 {
+                let maybe: Option[i32] = $;
+                return match (maybe) {
+                    Some(v) if v > 10 => 1;
+                    Some(v) => 2;
+                    None => 3;
+                };
+            }
+        )";
+        const auto large = lower(with(source, "Some(20)"));
+        assert(count_of(large, Opcode::OPTION_IS_SOME) == 1);
+        assert(count_of(large, Opcode::OPTION_UNWRAP) == 1);
+        assert(run_ir(large) == 1);
+        assert(run_ir(lower(with(source, "Some(5)"))) == 2);
+        assert(run_ir(lower(with(source, "None"))) == 3);
+    }
+
+    // Nested patterns become a decision tree over the payload: each payload
+    // variant is tested once, even when several arms need it, and a value
+    // no arm accepts traps.
+    {
+        const std::string source = R"(
+            enum Shape {
+                Circle(i32);
+                Square(i32);
+                Dot;
+            };
+
+            fn main() -> i32 {
+                let shape: Option[Shape] = $;
+                return match (shape) {
+                    Some(Circle(r)) if r > 5 => 100;
+                    Some(Circle(r)) => r;
+                    Some(Square(w)) if w > 5 => w + 1;
+                    Some(Dot()) => 7;
+                    None => 0;
+                };
+            }
+        )";
+        const auto circle = lower(with(source, "Some(Shape.Circle(9))"));
+        assert(count_of(circle, Opcode::ENUM_IS_VARIANT) == 3);
+        assert(count_of(circle, Opcode::OPTION_IS_SOME) == 1);
+        assert(run_ir(circle) == 100);
+        assert(run_ir(lower(with(source, "Some(Shape.Circle(3))"))) == 3);
+        assert(run_ir(lower(with(source, "Some(Shape.Square(8))"))) == 9);
+        assert(!run_ir(lower(with(source, "Some(Shape.Square(2))"))).has_value());
+        assert(run_ir(lower(with(source, "Some(Shape.Dot)"))) == 7);
+        assert(run_ir(lower(with(source, "None"))) == 0);
+    }
+
+    std::cout << "Frontend IR match lowering tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "t81/tisc/binary_format.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace t81::tisc;
+
+namespace {
+
+std::span<const std::byte> as_bytes(const std::string& data) {
+    return {reinterpret_cast<const std::byte*>(data.data()), data.size()};
+}
+
+bool same_insns(std::span<const Insn> lhs, const std::vector<Insn>& rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        if (lhs[i].opcode != rhs[i].opcode || lhs[i].a != rhs[i].a || lhs[i].b != rhs[i].b ||
+            lhs[i].c != rhs[i].c || lhs[i].literal_kind != rhs[i].literal_kind) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Program sample_program() {
+    Program program;
+    program.insns = {
+        {Opcode::LoadImm, 1, -42, 0, LiteralKind::Int},
+        {Opcode::LoadImm, 2, 1, 0, LiteralKind::SymbolHandle},
+        {Opcode::LoadImm, 3, 1, 0, LiteralKind::TensorHandle},
+        {Opcode::JumpIfZero, 1, 5, 0, LiteralKind::Int},
+        {Opcode::Add, 4, 1, -1, LiteralKind::Int},
+        {Opcode::Halt, 0, 0, 0, LiteralKind::Int},
+    };
+    program.float_pool = {0.5, -1e300};
+    program.symbol_pool = {"hello", "", "weights/a.bin"};
+    program.tensor_pool.emplace_back(std::vector<int>{2, 2}, std::vector<float>{1.f, 2.f, 3.f, 4.5f});
+    program.tensor_pool.emplace_back();
+    program.shape_pool = {{3, 1}, {}};
+
+    TypeAliasMetadata alias;
+    alias.name = "Pair";
+    alias.params = {"T"};
+    alias.alias = "Result[T, T]";
+    program.type_aliases.push_back(alias);
+    TypeAliasMetadata shape;
+    shape.name = "Shape";
+    shape.kind = StructuralKind::Enum;
+    shape.variants = {{"Circle", std::string("i32")}, {"Square", std::nullopt}};
+    shape.schema_version = 2;
+    shape.module_path = "app.shapes";
+    program.type_aliases.push_back(shape);
+    return program;
+}
+
+void expect_round_trip(const ProgramView& view, const Program& program) {
+    assert(same_insns(view.insns(), program.insns));
+    assert(view.float_count() == 2 && view.float_at(1) == -1e300);
+    assert(view.symbol_count() == 3 && view.symbol(2) == "weights/a.bin");
+    assert(view.tensor_count() == 2 && view.tensor(0).data()[3] == 4.5f);
+    assert(view.tensor(1).shape().empty());
+    assert(view.shape_count() == 2 && view.shape(0) == std::vector<int>({3, 1}));
+    assert(view.policy_text() == "(policy (tier 1))");
+    assert(view.content_hash_matches());
+
+    const Program copy = view.materialize();
+    assert(same_insns(copy.insns, program.insns));
+    assert(copy.float_pool == program.float_pool && copy.symbol_pool == program.symbol_pool);
+    assert(copy.shape_pool == program.shape_pool);
+    assert(copy.tensor_pool.size() == 2 && copy.tensor_pool[0].shape() == program.tensor_pool[0].shape());
+    assert(copy.tensor_pool[0].data() == program.tensor_pool[0].data());
+    assert(copy.type_aliases.size() == 2);
+    assert(copy.type_aliases[0].params == program.type_aliases[0].params);
+    assert(copy.type_aliases[0].alias == "Result[T, T]");
+    assert(copy.type_aliases[1].kind == StructuralKind::Enum);
+    assert(copy.type_aliases[1].variants[0].payload == "i32" && !copy.type_aliases[1].variants[1].payload);
+    assert(copy.type_aliases[1].schema_version == 2 && copy.type_aliases[1].module_path == "app.shapes");
+}
+
+} // namespace
+
+int main() {
+    const Program program = sample_program();
+    const std::string bytes = encode_binary(program, "(policy (tier 1))");
+    assert(bytes.compare(0, 4, "TISC") == 0);
+    assert(encode_binary(program, "(policy (tier 1))") == bytes);
+
+    auto view = ProgramView::open(as_bytes(bytes));
+    assert(view.has_value());
+    expect_round_trip(*view, program);
+    assert(view->content_hash().size() == 64);
+
+    // Loading from disk maps the file; the instructions alias the mapping.
+    const auto path = std::filesystem::temp_directory_path() / "t81_tisc_binary_format_test.tisc.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << bytes;
+    }
+    {
+        auto mapped = MappedProgram::open(path);
+        assert(mapped.has_value());
+        expect_round_trip(mapped->view(), program);
+        assert(mapped->view().content_hash() == view->content_hash());
+    }
+    std::filesystem::remove(path);
+
+    // Truncation is caught structurally; payload corruption by the hash.
+    for (std::size_t size = 0; size < bytes.size(); size += 5) {
+        assert(!ProgramView::open(as_bytes(bytes.substr(0, size))).has_value());
+    }
+    std::string corrupted = bytes;
+    corrupted[corrupted.size() - 3] ^= 0x20;
+    auto corrupted_view = ProgramView::open(as_bytes(corrupted));
+    assert(corrupted_view.has_value() && !corrupted_view->content_hash_matches());
+
+    const auto empty = encode_binary(Program{});
+    auto empty_view = ProgramView::open(as_bytes(empty));
+    assert(empty_view.has_value() && empty_view->insns().empty() && empty_view->policy_text().empty());
+
+    std::cout << "TISC binary format tests passed!" << std::endl;
+    return 0;
+}
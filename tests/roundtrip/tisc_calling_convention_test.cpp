@@ -0,0 +1,301 @@
+#include "../common/test_utils.hpp"
+#include "t81/frontend/ir_generator.hpp"
+#include "t81/frontend/lexer.hpp"
+#include "t81/frontend/parser.hpp"
+#include "t81/frontend/semantic_analyzer.hpp"
+#include "t81/tisc/calling_convention.hpp"
+#include "t81/tisc/pass_manager.hpp"
+#include "t81/tisc/passes.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace t81::tisc::ir;
+
+namespace {
+
+Instruction call(std::vector<int> args) {
+    Instruction instr(Opcode::CALL, {Immediate{1}});
+    for (int arg : args) instr.operands.push_back(Register{arg});
+    return instr;
+}
+
+const Instruction& only_call(const IntermediateProgram& program) {
+    const auto& instrs = program.instructions();
+    assert(count_of(instrs, Opcode::CALL) == 1);
+    return *std::find_if(instrs.begin(), instrs.end(), [](const Instruction& instr) { return instr.opcode == Opcode::CALL; });
+}
+
+int highest_register(const std::vector<Instruction>& instrs) {
+    int highest = 0;
+    for (const auto& instr : instrs) {
+        for (const auto& operand : instr.operands) {
+            if (const auto* reg = std::get_if<Register>(&operand)) highest = std::max(highest, reg->index);
+        }
+    }
+    return highest;
+}
+
+std::int64_t counter(const PassTiming& timing, const std::string& name) {
+    for (const auto& [key, value] : timing.counters) {
+        if (key == name) return value;
+    }
+    assert(false && "missing counter");
+    return -1;
+}
+
+// A callee that takes `arity` arguments and returns sum((i + 1) * arg_i).
+IrCallee weighted(std::size_t arity) {
+    IrCallee callee;
+    callee.arity = [arity](long long) { return arity; };
+    callee.result = [](long long, const std::vector<long long>& args) {
+        long long result = 0;
+        for (std::size_t i = 0; i < args.size(); ++i) result += static_cast<long long>(i + 1) * args[i];
+        return result;
+    };
+    return callee;
+}
+
+} // namespace
+
+int main() {
+    // Eight arguments: six in r1-r6, the last two pushed last first, so
+    // argument 6 is on top at the call, and popped again after it.
+    {
+        std::vector<Instruction> instrs;
+        std::vector<int> args;
+        for (int i = 0; i < 8; ++i) {
+            instrs.push_back(loadi(20 + i, i + 1));
+            args.push_back(20 + i);
+        }
+        instrs.push_back(call(args));
+        instrs.push_back(Instruction(Opcode::HALT));
+        auto program = program_of(instrs);
+        PassManager manager;
+        manager.add_pass(make_lower_calls_pass());
+        manager.run(program);
+
+        const Instruction& lowered = only_call(program);
+        assert(lowered.operands.size() == 1 + static_cast<std::size_t>(kArgumentRegisterCount));
+        for (std::size_t k = 1; k < lowered.operands.size(); ++k) {
+            assert(std::get<Register>(lowered.operands[k]).index == argument_register(k - 1));
+        }
+        const auto& out = program.instructions();
+        assert(count_of(out, Opcode::PUSH) == 2 && count_of(out, Opcode::POP) == 2);
+        assert(out[out.size() - 2].opcode == Opcode::POP && out[out.size() - 3].opcode == Opcode::POP);
+        assert(std::get<Register>(out[8].operands[0]).index == 27 && std::get<Register>(out[9].operands[0]).index == 26);
+        const PassTiming& timing = manager.timings().front();
+        assert(counter(timing, "stack-arguments") == 2 && counter(timing, "argument-moves") == 6);
+        // 1*1 + 2*2 + ... + 8*8
+        assert(evaluate(out, weighted(8)) == 204);
+    }
+
+    // Arguments already in each other's registers are swapped through a
+    // register no argument comes from.
+    {
+        auto program = program_of({loadi(1, 10), loadi(2, 20), call({2, 1}), Instruction(Opcode::HALT)});
+        PassManager manager;
+        manager.add_pass(make_lower_calls_pass());
+        manager.run(program);
+        assert(count_of(program.instructions(), Opcode::MOV) == 3);
+        assert(evaluate(program.instructions(), weighted(2)) == 20 + 2 * 10);
+    }
+
+    // The allocator keeps a value live across a call in a callee-saved
+    // register and starts each argument in its own argument register, so
+    // lowering the call needs no moves.
+    {
+        const std::vector<Instruction> instrs = {
+            loadi(7, 5),
+            loadi(8, 1),
+            loadi(9, 2),
+            call({8, 9}),
+            Instruction(Opcode::MOV, {Register{10}, Register{0}}),
+            Instruction(Opcode::ADD, {Register{0}, Register{7}, Register{10}}),
+            Instruction(Opcode::HALT),
+        };
+        auto program = program_of(instrs);
+        PassManager manager;
+        manager.add_pass(make_register_allocation_pass());
+        manager.add_pass(make_lower_calls_pass());
+        manager.run(program);
+        const auto& out = program.instructions();
+        assert(std::get<Register>(out[0].operands[0]).index >= kFirstCalleeSavedRegister);
+        assert(counter(manager.timings()[0], "live-across-calls") == 1);
+        assert(counter(manager.timings()[0], "spilled") == 0);
+        assert(!manager.timings()[1].changed && out.size() == instrs.size());
+        assert(evaluate(out, weighted(2)) == 5 + 1 + 2 * 2);
+
+        // Without callee-saved registers that value goes to memory.
+        auto small = program_of(instrs);
+        PassManager spilling;
+        spilling.add_pass(make_register_allocation_pass(kFirstCalleeSavedRegister));
+        spilling.add_pass(make_lower_calls_pass());
+        spilling.run(small);
+        assert(counter(spilling.timings()[0], "spilled") == 1);
+        assert(evaluate(small.instructions(), weighted(2)) == 10);
+    }
+
+    // A call as wide as the register file: its arguments do not count
+    // towards the spill scratch registers, so the sixteen values live
+    // across it still get the callee-saved registers, and the arguments
+    // that do not fit are reloaded straight into place.
+    {
+        std::vector<Instruction> instrs;
+        long long kept = 0;
+        for (int i = 0; i < 16; ++i) {
+            instrs.push_back(loadi(100 + i, 1000 * (i + 1)));
+            kept += 1000 * (i + 1);
+        }
+        std::vector<int> args;
+        for (int i = 0; i < 26; ++i) {
+            instrs.push_back(loadi(200 + i, i + 1));
+            args.push_back(200 + i);
+        }
+        instrs.push_back(call(args));
+        instrs.push_back(Instruction(Opcode::MOV, {Register{300}, Register{0}}));
+        for (int i = 0; i < 16; ++i) {
+            instrs.push_back(Instruction(Opcode::ADD, {Register{300}, Register{300}, Register{100 + i}}));
+        }
+        instrs.push_back(Instruction(Opcode::MOV, {Register{0}, Register{300}}));
+        instrs.push_back(Instruction(Opcode::HALT));
+
+        auto unallocated = program_of(instrs);
+        PassManager lowering;
+        lowering.add_pass(make_lower_calls_pass());
+        lowering.run(unallocated);
+        // 1*1 + 2*2 + ... + 26*26
+        const long long expected = 6201 + kept;
+        assert(evaluate(unallocated.instructions(), weighted(26)) == expected);
+
+        auto program = program_of(instrs);
+        PassManager manager;
+        manager.add_pass(make_register_allocation_pass(kDefaultPhysicalRegisters));
+        manager.add_pass(make_lower_calls_pass());
+        manager.run(program);
+        const auto& out = program.instructions();
+        assert(highest_register(out) < kDefaultPhysicalRegisters);
+        assert(counter(manager.timings()[0], "live-across-calls") == 16);
+        assert(counter(manager.timings()[0], "spilled") > 0);
+        assert(count_of(out, Opcode::PUSH) == 20 && count_of(out, Opcode::POP) == 20);
+        assert(evaluate(out, weighted(26)) == expected);
+    }
+
+    // Eight arguments in eight registers: two are spilled and pushed from
+    // memory; one register fewer leaves no r7 to pop into, which is an
+    // error rather than a register past the file.
+    {
+        std::vector<Instruction> instrs;
+        std::vector<int> args;
+        for (int i = 0; i < 8; ++i) {
+            instrs.push_back(loadi(20 + i, i + 1));
+            args.push_back(20 + i);
+        }
+        instrs.push_back(call(args));
+        instrs.push_back(Instruction(Opcode::HALT));
+
+        auto program = program_of(instrs);
+        PassManager manager;
+        manager.add_pass(make_register_allocation_pass(kFirstCallScratchRegister + 1));
+        manager.add_pass(make_lower_calls_pass());
+        manager.run(program);
+        assert(highest_register(program.instructions()) == kFirstCallScratchRegister);
+        assert(counter(manager.timings()[0], "spilled") == 2);
+        assert(evaluate(program.instructions(), weighted(8)) == 204);
+
+        auto cramped = program_of(instrs);
+        PassManager failing;
+        failing.add_pass(make_register_allocation_pass(kFirstCallScratchRegister));
+        bool threw = false;
+        try {
+            failing.run(cramped);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // The callee side: the callee-saved registers the body writes are
+    // saved around the frame, and both are undone before every RET. The
+    // entry function only gets the frame.
+    {
+        std::vector<Instruction> body = {
+            loadi(13, 5),
+            loadi(3, 1),
+            Instruction(Opcode::JZ, {Label{1}, Register{3}}),
+            Instruction(Opcode::MOV, {Register{0}, Register{13}}),
+            Instruction(Opcode::RET),
+            Instruction(Opcode::LABEL, {Label{1}}),
+            loadi(14, 7),
+            Instruction(Opcode::ADD, {Register{0}, Register{13}, Register{14}}),
+            Instruction(Opcode::RET),
+        };
+        const LoweredFrame frame = lower_frame(body, 2, false);
+        assert(frame.saved_registers == 2 && frame.slots == 2);
+        assert(body[0].opcode == Opcode::PUSH && std::get<Register>(body[0].operands[0]).index == 13);
+        assert(body[1].opcode == Opcode::PUSH && std::get<Register>(body[1].operands[0]).index == 14);
+        assert(body[2].opcode == Opcode::STACK_ALLOC && std::get<Immediate>(body[2].operands[0]).value == 2);
+        for (std::size_t i = 0; i < body.size(); ++i) {
+            if (body[i].opcode != Opcode::RET) continue;
+            assert(body[i - 3].opcode == Opcode::STACK_FREE);
+            assert(std::get<Register>(body[i - 2].operands[0]).index == 14);
+            assert(std::get<Register>(body[i - 1].operands[0]).index == 13);
+        }
+        assert(count_of(body, Opcode::POP) == 4);
+        assert(evaluate(body) == 5);
+
+        std::vector<Instruction> entry = {loadi(13, 4), Instruction(Opcode::MOV, {Register{0}, Register{13}}),
+                                          Instruction(Opcode::HALT)};
+        assert(lower_frame(entry, 1, true).saved_registers == 0);
+        assert(count_of(entry, Opcode::PUSH) == 0 && entry.front().opcode == Opcode::STACK_ALLOC);
+        assert(entry[entry.size() - 2].opcode == Opcode::STACK_FREE);
+        assert(evaluate(entry) == 4);
+
+        std::vector<Instruction> frameless = {loadi(13, 4), Instruction(Opcode::HALT)};
+        lower_frame(frameless, 0, true);
+        assert(frameless.size() == 2);
+    }
+
+    // From source: every argument reaches the callee, at -O0 and -O1, and
+    // the caller's variables survive the call.
+    {
+        const std::string source = R"(
+            fn weigh(a: i32, b: i32, c: i32, d: i32, e: i32, f: i32, g: i32, h: i32) -> i32 {
+                return a;
+            }
+
+            fn main() -> i32 {
+                let keep: i32 = 1000;
+                let one: i32 = 1;
+                return weigh(one, 2, 3, 4, 5, 6, 7, 8) + keep;
+            }
+        )";
+        using namespace t81::frontend;
+        Lexer lexer(source);
+        Parser parser(lexer);
+        auto stmts = parser.parse();
+        assert(!parser.had_error());
+        SemanticAnalyzer analyzer(stmts);
+        analyzer.analyze();
+        assert(!analyzer.had_error());
+        for (OptLevel level : {OptLevel::O0, OptLevel::O1}) {
+            IRGenerator generator;
+            generator.attach_semantic_analyzer(&analyzer);
+            auto program = generator.generate(stmts);
+            auto manager = PassManager::for_level(level);
+            manager.run(program);
+            assert(count_of(program.instructions(), Opcode::PUSH) == 2);
+            assert(count_of(program.instructions(), Opcode::POP) == 2);
+            assert(only_call(program).operands.size() == 7);
+            assert(evaluate(program.instructions(), weighted(8)) == 204 + 1000);
+        }
+    }
+
+    std::cout << "TISC calling convention tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "../common/test_utils.hpp"
+#include "t81/tisc/pass_manager.hpp"
+#include "t81/tisc/passes.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace t81::tisc::ir;
+
+namespace {
+
+Instruction op(Opcode opcode, std::vector<Operand> operands, PrimitiveKind primitive = PrimitiveKind::Integer) {
+    Instruction instr(opcode, std::move(operands));
+    instr.primitive = primitive;
+    return instr;
+}
+
+Instruction cmp(int dest, int lhs, int rhs, ComparisonRelation relation) {
+    Instruction instr(Opcode::CMP, {Register{dest}, Register{lhs}, Register{rhs}});
+    instr.primitive = PrimitiveKind::Boolean;
+    instr.boolean_result = true;
+    instr.relation = relation;
+    return instr;
+}
+
+std::vector<Instruction> fold(std::vector<Instruction> instrs) {
+    IntermediateProgram program = program_of(std::move(instrs));
+    PassContext context;
+    make_constant_fold_pass()->run(program, context);
+    return program.instructions();
+}
+
+bool is_loadi(const Instruction& instr, int reg, long long value) {
+    return instr.opcode == Opcode::LOADI && instr.operands.size() == 2 &&
+           std::get<Register>(instr.operands[0]).index == reg && std::get<Immediate>(instr.operands[1]).value == value;
+}
+
+} // namespace
+
+int main() {
+    // Integer arithmetic collapses into one load of the result into r0.
+    {
+        auto out = fold({loadi(1, 6), loadi(2, 7), op(Opcode::MUL, {Register{3}, Register{1}, Register{2}}),
+                         loadi(4, 2), op(Opcode::SUB, {Register{5}, Register{3}, Register{4}}),
+                         op(Opcode::MOV, {Register{0}, Register{5}}), Instruction(Opcode::HALT)});
+        assert(out.size() == 2);
+        assert(is_loadi(out[0], 0, 40));
+        assert(out[1].opcode == Opcode::HALT);
+    }
+
+    // Overflow, division by zero and INT64_MIN / -1 are left to the runtime.
+    {
+        constexpr long long kMax = std::numeric_limits<std::int64_t>::max();
+        constexpr long long kMin = std::numeric_limits<std::int64_t>::min();
+        auto out = fold({loadi(1, kMax), loadi(2, 1), op(Opcode::ADD, {Register{0}, Register{1}, Register{2}})});
+        assert(out.size() == 3 && out[2].opcode == Opcode::ADD);
+        out = fold({loadi(1, 5), loadi(2, 0), op(Opcode::DIV, {Register{0}, Register{1}, Register{2}})});
+        assert(out.size() == 3 && out[2].opcode == Opcode::DIV);
+        out = fold({loadi(1, kMin), loadi(2, -1), op(Opcode::MOD, {Register{0}, Register{1}, Register{2}})});
+        assert(out.size() == 3 && out[2].opcode == Opcode::MOD);
+        out = fold({loadi(1, -7), loadi(2, 2), op(Opcode::DIV, {Register{0}, Register{1}, Register{2}})});
+        assert(out.size() == 1 && is_loadi(out[0], 0, -3));
+    }
+
+    // Floats fold with IEEE semantics but only a comparison result can be
+    // materialized; 0.1 + 0.2 != 0.3 must hold, as it would at runtime.
+    {
+        auto out = fold({loadi(1, 1), loadi(2, 10), op(Opcode::I2F, {Register{3}, Register{1}}, PrimitiveKind::Float),
+                         op(Opcode::I2F, {Register{4}, Register{2}}, PrimitiveKind::Float),
+                         op(Opcode::FDIV, {Register{5}, Register{3}, Register{4}}, PrimitiveKind::Float),
+                         op(Opcode::FADD, {Register{6}, Register{5}, Register{5}}, PrimitiveKind::Float),
+                         op(Opcode::FADD, {Register{7}, Register{6}, Register{5}}, PrimitiveKind::Float),
+                         loadi(8, 3), op(Opcode::I2F, {Register{9}, Register{8}}, PrimitiveKind::Float),
+                         op(Opcode::FDIV, {Register{10}, Register{9}, Register{4}}, PrimitiveKind::Float),
+                         cmp(0, 7, 10, ComparisonRelation::Equal)});
+        assert(is_loadi(out.back(), 0, 0));
+        assert(out.back().primitive == PrimitiveKind::Boolean);
+        // The float ops themselves stay: there is no float immediate.
+        assert(out[out.size() - 2].opcode == Opcode::FDIV);
+    }
+
+    // Fractions are exact: 1/3 + 1/6 == 1/2, and FRAC2I folds when integral.
+    {
+        auto out = fold({loadi(1, 1), loadi(2, 3), loadi(3, 6), loadi(4, 2),
+                         op(Opcode::I2FRAC, {Register{5}, Register{1}}, PrimitiveKind::Fraction),
+                         op(Opcode::I2FRAC, {Register{6}, Register{2}}, PrimitiveKind::Fraction),
+                         op(Opcode::I2FRAC, {Register{7}, Register{3}}, PrimitiveKind::Fraction),
+                         op(Opcode::I2FRAC, {Register{8}, Register{4}}, PrimitiveKind::Fraction),
+                         op(Opcode::FRACDIV, {Register{9}, Register{5}, Register{6}}, PrimitiveKind::Fraction),
+                         op(Opcode::FRACDIV, {Register{10}, Register{5}, Register{7}}, PrimitiveKind::Fraction),
+                         op(Opcode::FRACDIV, {Register{11}, Register{5}, Register{8}}, PrimitiveKind::Fraction),
+                         op(Opcode::FRACADD, {Register{12}, Register{9}, Register{10}}, PrimitiveKind::Fraction),
+                         cmp(13, 12, 11, ComparisonRelation::Equal),
+                         op(Opcode::FRACMUL, {Register{14}, Register{12}, Register{8}}, PrimitiveKind::Fraction),
+                         op(Opcode::FRAC2I, {Register{15}, Register{14}}),
+                         op(Opcode::ADD, {Register{0}, Register{13}, Register{15}}),
+                         op(Opcode::FRAC2I, {Register{16}, Register{12}}),
+                         Instruction(Opcode::PUSH, {Register{16}})});
+        // r13 is a boolean and ADD only folds integers; r15 folded to 1.
+        bool saw_true = false;
+        for (const auto& instr : out) {
+            saw_true = saw_true || is_loadi(instr, 13, 1);
+            assert(!is_loadi(instr, 16, 0));
+        }
+        assert(saw_true);
+        // 1/2 has no exact integer value, so FRAC2I of it stays.
+        assert(out[out.size() - 2].opcode == Opcode::FRAC2I);
+    }
+
+    // Known conditions: a taken branch becomes a JMP, an untaken one goes.
+    {
+        auto out = fold({loadi(1, 0), Instruction(Opcode::JNZ, {Label{1}, Register{1}}),
+                         Instruction(Opcode::JZ, {Label{2}, Register{1}}), loadi(2, -4),
+                         Instruction(Opcode::JP, {Label{1}, Register{2}}), Instruction(Opcode::JN, {Label{1}, Register{2}}),
+                         Instruction(Opcode::LABEL, {Label{1}}), Instruction(Opcode::LABEL, {Label{2}}),
+                         Instruction(Opcode::HALT)});
+        assert(out.size() == 5);
+        assert(out[0].opcode == Opcode::JMP && std::get<Label>(out[0].operands[0]).id == 2);
+        assert(out[1].opcode == Opcode::JMP && std::get<Label>(out[1].operands[0]).id == 1);
+    }
+
+    // Knowledge ends at labels and calls, and a register another instruction
+    // names keeps its load.
+    {
+        auto out = fold({loadi(1, 1), Instruction(Opcode::LABEL, {Label{0}}),
+                         Instruction(Opcode::JZ, {Label{0}, Register{1}}), loadi(2, 0),
+                         Instruction(Opcode::CALL, {Immediate{1}, Register{2}}),
+                         Instruction(Opcode::JZ, {Label{0}, Register{2}}), Instruction(Opcode::HALT)});
+        assert(out.size() == 7);
+        assert(out[2].opcode == Opcode::JZ && out[5].opcode == Opcode::JZ);
+    }
+
+    // -O1 runs constant-fold first; later passes drop the arm it cut off.
+    {
+        IntermediateProgram program = program_of(
+            {loadi(1, 2), loadi(2, 3), cmp(3, 1, 2, ComparisonRelation::Less), Instruction(Opcode::JZ, {Label{0}, Register{3}}),
+             loadi(0, 1), Instruction(Opcode::HALT), Instruction(Opcode::LABEL, {Label{0}}), loadi(0, 0),
+             Instruction(Opcode::HALT)});
+        auto manager = PassManager::for_level(OptLevel::O1);
+        manager.run(program);
+        const auto& instrs = program.instructions();
+        assert(instrs.size() == 2);
+        assert(is_loadi(instrs[0], 0, 1) && instrs[1].opcode == Opcode::HALT);
+        assert(manager.timings().front().name == "constant-fold");
+    }
+
+    std::cout << "TISC constant fold tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "../common/test_utils.hpp"
+#include "t81/tisc/cfg.hpp"
+#include "t81/tisc/pass_manager.hpp"
+#include "t81/tisc/passes.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace t81::tisc::ir;
+
+namespace {
+
+Instruction label(int id) { return Instruction(Opcode::LABEL, {Label{id}}); }
+
+std::vector<Opcode> opcodes_after(std::unique_ptr<Pass> pass, IntermediateProgram& program) {
+    PassContext context;
+    pass->run(program, context);
+    std::vector<Opcode> out;
+    for (const auto& instr : program.instructions()) {
+        out.push_back(instr.opcode);
+    }
+    return out;
+}
+
+} // namespace
+
+int main() {
+    // Blocks split at labels and after jumps; edges follow targets and
+    // fall-through.
+    {
+        const std::vector<Instruction> instrs = {
+            loadi(1, 1),                                    // b0
+            Instruction(Opcode::JZ, {Label{1}, Register{1}}),
+            loadi(0, 2),                                    // b1
+            Instruction(Opcode::JMP, {Label{2}}),
+            loadi(0, 3),                                    // b2: unreachable
+            label(1),                                       // b3
+            loadi(0, 4),
+            label(2),                                       // b4
+            Instruction(Opcode::HALT),
+        };
+        const auto cfg = ControlFlowGraph::build(instrs);
+        const auto& blocks = cfg.blocks();
+        assert(blocks.size() == 5);
+        assert(blocks[0].begin == 0 && blocks[0].end == 2);
+        assert((blocks[0].successors == std::vector<std::size_t>{3, 1}));
+        assert((blocks[1].successors == std::vector<std::size_t>{4}));
+        assert((blocks[3].successors == std::vector<std::size_t>{4}));
+        assert(blocks[4].predecessors.size() == 2);
+        const auto reachable = cfg.reachable();
+        assert(reachable[0] && reachable[1] && !reachable[2] && reachable[3] && reachable[4]);
+
+        const auto liveness = Liveness::compute(instrs, cfg);
+        assert(liveness.live_in(4).contains(0));
+        assert(!liveness.live_in(3).contains(0) && liveness.live_out(3).contains(0));
+        assert(!liveness.live_out(0).contains(1));
+
+        auto program = program_of(instrs);
+        const auto out = opcodes_after(make_unreachable_code_pass(), program);
+        assert(out.size() == 8 && out[4] == Opcode::LABEL);
+    }
+
+    // Dead chains go in one pass run; a loop-carried register stays live.
+    {
+        auto program = program_of({
+            loadi(1, 0),
+            label(0),
+            loadi(2, 1),
+            Instruction(Opcode::ADD, {Register{1}, Register{1}, Register{2}}),
+            loadi(3, 7),
+            Instruction(Opcode::MUL, {Register{4}, Register{3}, Register{3}}),
+            Instruction(Opcode::MOV, {Register{5}, Register{4}}),
+            Instruction(Opcode::MOV, {Register{1}, Register{1}}),
+            Instruction(Opcode::JNZ, {Label{0}, Register{1}}),
+            Instruction(Opcode::HALT),
+        });
+        const auto out = opcodes_after(make_dead_registers_pass(), program);
+        assert((out == std::vector<Opcode>{Opcode::LOADI, Opcode::LABEL, Opcode::LOADI, Opcode::ADD, Opcode::JNZ,
+                                           Opcode::HALT}));
+    }
+
+    // Side effects stay: TRAP, DIV, prints and calls to @effect, unknown
+    // or possibly trapping functions. A call to a pure, total function
+    // whose result is unused goes, with its MOV.
+    {
+        IntermediateProgram program;
+        FunctionMetadata pure;
+        pure.name = "square";
+        pure.is_total = true;
+        program.add_function_metadata(pure);
+        FunctionMetadata effect;
+        effect.name = "log";
+        effect.is_effectful = true;
+        program.add_function_metadata(effect);
+        FunctionMetadata partial;
+        partial.name = "inverse";
+        program.add_function_metadata(partial);
+        assert(program.add_call_target("square") == 1);
+        assert(program.add_call_target("log") == 2);
+        assert(program.add_call_target("imported") == 3);
+        assert(program.add_call_target("inverse") == 4);
+        assert(program.add_call_target("square") == 1);
+
+        program.add_instruction(loadi(1, 4));
+        program.add_instruction(Instruction(Opcode::CALL, {Immediate{1}, Register{1}}));
+        program.add_instruction(Instruction(Opcode::MOV, {Register{2}, Register{0}}));
+        program.add_instruction(Instruction(Opcode::CALL, {Immediate{2}, Register{1}}));
+        program.add_instruction(Instruction(Opcode::MOV, {Register{3}, Register{0}}));
+        program.add_instruction(Instruction(Opcode::CALL, {Immediate{3}}));
+        program.add_instruction(Instruction(Opcode::CALL, {Immediate{4}, Register{1}}));
+        program.add_instruction(Instruction(Opcode::MOV, {Register{5}, Register{0}}));
+        program.add_instruction(Instruction(Opcode::DIV, {Register{4}, Register{1}, Register{1}}));
+        Instruction print(Opcode::NOP, {Register{1}});
+        print.text_literal = "print";
+        program.add_instruction(print);
+        program.add_instruction(loadi(0, 0));
+        program.add_instruction(Instruction(Opcode::TRAP));
+        const auto out = opcodes_after(make_dead_registers_pass(), program);
+        assert((out == std::vector<Opcode>{Opcode::LOADI, Opcode::CALL, Opcode::CALL, Opcode::CALL, Opcode::DIV,
+                                           Opcode::NOP, Opcode::TRAP}));
+        const auto& instrs = program.instructions();
+        assert(std::get<Immediate>(instrs[1].operands[0]).value == 2);
+        assert(std::get<Immediate>(instrs[2].operands[0]).value == 3);
+        assert(std::get<Immediate>(instrs[3].operands[0]).value == 4);
+    }
+
+    // A call writes r0, so an earlier write to r0 is dead; the call's own
+    // result reaches HALT and keeps even a pure call alive.
+    {
+        auto program = program_of({loadi(0, 5), Instruction(Opcode::CALL, {Immediate{1}}), Instruction(Opcode::HALT)});
+        program.add_function_metadata(FunctionMetadata{"id", false, std::nullopt, true});
+        program.add_call_target("id");
+        const auto out = opcodes_after(make_dead_registers_pass(), program);
+        assert((out == std::vector<Opcode>{Opcode::CALL, Opcode::HALT}));
+    }
+
+    // -O1 end to end: the untaken arm and its labels disappear.
+    {
+        auto program = program_of({
+            loadi(1, 0),
+            Instruction(Opcode::JZ, {Label{0}, Register{1}}),
+            loadi(2, 9),
+            Instruction(Opcode::MOV, {Register{0}, Register{2}}),
+            Instruction(Opcode::HALT),
+            label(0),
+            loadi(3, 1),
+            Instruction(Opcode::MOV, {Register{0}, Register{3}}),
+            Instruction(Opcode::HALT),
+            label(1),
+            Instruction(Opcode::HALT),
+        });
+        auto manager = PassManager::for_level(OptLevel::O1);
+        manager.run(program);
+        const auto& instrs = program.instructions();
+        assert(instrs.size() == 2);
+        assert(instrs[0].opcode == Opcode::LOADI && std::get<Immediate>(instrs[0].operands[1]).value == 1);
+        assert(instrs[1].opcode == Opcode::HALT);
+    }
+
+    std::cout << "TISC dead code tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,198 @@
+#include "../common/test_utils.hpp"
+#include "t81/frontend/ir_generator.hpp"
+#include "t81/frontend/lexer.hpp"
+#include "t81/frontend/parser.hpp"
+#include "t81/frontend/semantic_analyzer.hpp"
+#include "t81/tisc/pass_manager.hpp"
+#include "t81/tisc/passes.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace t81::frontend;
+using namespace t81::tisc::ir;
+
+namespace {
+
+// The callees of the programs below, as the C++ they compute, or nullopt
+// where they trap. -O2 expands the ones without @effect, every other level
+// calls them, so the model and the inlined bodies must agree.
+std::optional<long long> call_result(const std::string& name, const std::vector<long long>& args) {
+    if (name == "weigh") {
+        long long result = 0;
+        for (std::size_t i = 0; i < args.size(); ++i) result += static_cast<long long>(i + 1) * args[i];
+        return result;
+    }
+    if (name == "twice") return args[0] + args[0];
+    if (name == "square") return args[0] * args[0];
+    if (name == "minus") return args[0] - args[1];
+    if (name == "boom") return args[0] == 0 ? std::nullopt : std::optional<long long>(10 / args[0]);
+    assert(false && "unknown callee");
+    return 0;
+}
+
+IrCallee callee_of(const IntermediateProgram& program) {
+    const std::vector<std::string> targets = program.call_targets();
+    IrCallee callee;
+    callee.arity = [targets](long long id) -> std::size_t {
+        const std::string& name = targets.at(static_cast<std::size_t>(id - 1));
+        if (name == "weigh") return 10;
+        if (name == "minus") return 2;
+        return 1;
+    };
+    callee.result = [targets](long long id, const std::vector<long long>& args) {
+        return call_result(targets.at(static_cast<std::size_t>(id - 1)), args);
+    };
+    return callee;
+}
+
+IntermediateProgram lower(const std::string& source, bool inline_calls) {
+    Lexer lexer(source);
+    Parser parser(lexer);
+    auto stmts = parser.parse();
+    assert(!parser.had_error());
+
+    SemanticAnalyzer analyzer(stmts);
+    analyzer.analyze();
+    assert(!analyzer.had_error());
+
+    IRGenerator generator;
+    generator.attach_semantic_analyzer(&analyzer);
+    generator.set_inline_threshold(inline_calls ? IRGenerator::kDefaultInlineThreshold : 0);
+    return generator.generate(stmts);
+}
+
+// The -O2 pipeline with the register file cut to `physical_registers`.
+PassManager reduced_pipeline(int physical_registers) {
+    PassManager manager;
+    manager.add_pass(make_constant_fold_pass());
+    manager.add_pass(make_unreachable_code_pass());
+    manager.add_pass(make_sccp_pass());
+    manager.add_pass(make_gvn_pass());
+    manager.add_pass(make_coalesce_copies_pass());
+    manager.add_pass(make_dead_registers_pass());
+    manager.add_pass(make_simplify_jumps_pass());
+    manager.add_pass(make_register_allocation_pass(physical_registers));
+    manager.add_pass(make_lower_calls_pass());
+    return manager;
+}
+
+int highest_register(const IntermediateProgram& program) {
+    int highest = 0;
+    for (const auto& instr : program.instructions()) {
+        for (const auto& operand : instr.operands) {
+            if (const auto* reg = std::get_if<Register>(&operand)) highest = std::max(highest, reg->index);
+        }
+    }
+    return highest;
+}
+
+// Compiles `source` at every level and with small register files, runs
+// each result against the same callees and checks they all return
+// `expected`, or all trap when it is nullopt.
+void check_levels(const std::string& source, std::optional<long long> expected) {
+    for (OptLevel level : {OptLevel::O0, OptLevel::O1, OptLevel::O2}) {
+        auto program = lower(source, level == OptLevel::O2);
+        auto manager = PassManager::for_level(level);
+        manager.run(program);
+        // Below -O2 nothing is inlined, so every call is still there.
+        assert(level == OptLevel::O2 || count_of(program.instructions(), Opcode::CALL) > 0);
+        assert(run_ir(program.instructions(), callee_of(program)) == expected);
+    }
+    for (int physical_registers : {kDefaultPhysicalRegisters, 16, kFirstCalleeSavedRegister, 8}) {
+        auto program = lower(source, true);
+        auto manager = reduced_pipeline(physical_registers);
+        manager.run(program);
+        assert(highest_register(program) < physical_registers);
+        assert(run_ir(program.instructions(), callee_of(program)) == expected);
+    }
+}
+
+} // namespace
+
+int main() {
+    // Wide calls in a loop: four arguments go on the stack, and the loop
+    // variables and the results of earlier calls live across each call.
+    check_levels(R"(
+        @effect
+        fn weigh(a: i32, b: i32, c: i32, d: i32, e: i32, f: i32, g: i32, h: i32, i: i32, j: i32) -> i32 {
+            return a + 2 * b + 3 * c + 4 * d + 5 * e + 6 * f + 7 * g + 8 * h + 9 * i + 10 * j;
+        }
+
+        @effect
+        fn twice(x: i32) -> i32 {
+            return x + x;
+        }
+
+        fn square(x: i32) -> i32 {
+            return x * x;
+        }
+
+        @effect
+        fn main() -> i32 {
+            let a: i32 = 3;
+            let b: i32 = 5;
+            var total: i32 = 0;
+            var i: i32 = 0;
+            while (i < 4) {
+                let kept: i32 = twice(i);
+                total = total + weigh(i, a, b, kept, 1, 2, square(i), twice(b), total, a + b) % 1000;
+                total = total + kept;
+                i = i + 1;
+            }
+            return total + a * b;
+        }
+    )", [] {
+        long long total = 0;
+        for (long long i = 0; i < 4; ++i) {
+            const long long kept = 2 * i;
+            total += *call_result("weigh", {i, 3, 5, kept, 1, 2, i * i, 10, total, 8}) % 1000;
+            total += kept;
+        }
+        return total + 15;
+    }());
+
+    // Arguments swapped between consecutive calls, and calls nested in the
+    // arguments of others, so lowering has cycles to break.
+    check_levels(R"(
+        @effect
+        fn minus(x: i32, y: i32) -> i32 {
+            return x - y;
+        }
+
+        @effect
+        fn twice(x: i32) -> i32 {
+            return x + x;
+        }
+
+        @effect
+        fn main() -> i32 {
+            let x: i32 = 40;
+            let y: i32 = 2;
+            let first: i32 = minus(x, y);
+            let second: i32 = minus(y, x);
+            let third: i32 = minus(minus(first, twice(y)), minus(second, x));
+            return first * 100 + second + third;
+        }
+    )", 38 * 100 + -38 + ((38 - 4) - (-38 - 40)));
+
+    // An unused call to a function that traps still traps: dead-code
+    // elimination keeps it, and -O2 keeps the inlined division.
+    check_levels(R"(
+        fn boom(x: i32) -> i32 {
+            let y: i32 = x + 1;
+            return 10 / x;
+        }
+
+        fn main() -> i32 {
+            let z: i32 = boom(0);
+            return 1;
+        }
+    )", std::nullopt);
+
+    std::cout << "TISC differential tests passed!" << std::endl;
+    return 0;
+}
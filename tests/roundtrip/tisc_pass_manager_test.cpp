@@ -0,0 +1,125 @@
+#include "t81/tisc/pass_manager.hpp"
+#include "t81/tisc/passes.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace t81::tisc::ir;
+
+namespace {
+
+// Appends its tag to a shared log and drops the last instruction.
+class RecordingPass final : public Pass {
+public:
+    RecordingPass(std::string tag, std::vector<std::string>& log) : _tag(std::move(tag)), _log(log) {}
+
+    std::string_view name() const override { return _tag; }
+
+    bool run(IntermediateProgram& program, PassContext& context) override {
+        _log.push_back(_tag);
+        auto& instrs = program.mutable_instructions();
+        if (instrs.empty()) return false;
+        instrs.pop_back();
+        context.count("dropped", 1);
+        return true;
+    }
+
+private:
+    std::string _tag;
+    std::vector<std::string>& _log;
+};
+
+IntermediateProgram jumpy_program() {
+    IntermediateProgram program;
+    program.add_instruction(Instruction(Opcode::LOADI, {Register{1}, Immediate{1}}));
+    program.add_instruction(Instruction(Opcode::JZ, {Label{1}, Register{1}}));
+    program.add_instruction(Instruction(Opcode::LABEL, {Label{0}}));
+    program.add_instruction(Instruction(Opcode::LABEL, {Label{1}}));
+    program.add_instruction(Instruction(Opcode::JMP, {Label{2}}));
+    program.add_instruction(Instruction(Opcode::LOADI, {Register{0}, Immediate{7}}));
+    program.add_instruction(Instruction(Opcode::LABEL, {Label{2}}));
+    program.add_instruction(Instruction(Opcode::HALT));
+    return program;
+}
+
+} // namespace
+
+int main() {
+    assert(parse_opt_level("-O2") == OptLevel::O2);
+    assert(!parse_opt_level("-O3").has_value());
+    assert(opt_level_name(OptLevel::O1) == "O1");
+
+    // -O0 only lowers calls; higher levels run the same passes in the same
+    // order.
+    {
+        IntermediateProgram program = jumpy_program();
+        auto manager = PassManager::for_level(OptLevel::O0);
+        manager.run(program);
+        assert(manager.timings().size() == 1 && manager.timings().front().name == "lower-calls");
+        assert(!manager.timings().front().changed);
+        assert(program.instructions().size() == 8);
+    }
+    {
+        auto names = PassManager::pass_names();
+        assert(std::find(names.begin(), names.end(), "simplify-jumps") != names.end());
+        auto manager = PassManager::for_level(OptLevel::O2);
+        IntermediateProgram program = jumpy_program();
+        manager.run(program);
+        assert(manager.timings().size() == names.size());
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            assert(manager.timings()[i].name == names[i]);
+        }
+    }
+
+    // simplify-jumps keeps a jump over code, drops one that lands next and
+    // then the labels nothing targets any more.
+    {
+        IntermediateProgram program = jumpy_program();
+        PassManager manager;
+        manager.add_pass(make_simplify_jumps_pass());
+        std::ostringstream printed;
+        manager.print_after("simplify-jumps", printed);
+        manager.run(program);
+        const auto& instrs = program.instructions();
+        assert(instrs.size() == 5);
+        assert(instrs[1].opcode == Opcode::JMP && instrs[3].opcode == Opcode::LABEL);
+        const PassTiming& timing = manager.timings().front();
+        assert(timing.changed && timing.instructions_before == 8 && timing.instructions_after == 5);
+        assert(timing.counters.size() == 2 && timing.counters[0] == std::make_pair(std::string("jumps-removed"), std::int64_t{1}));
+        assert(timing.counters[1].second == 2);
+        assert(printed.str().find("; IR after simplify-jumps") == 0);
+        assert(printed.str().find("JMP L2") != std::string::npos);
+    }
+
+    // Added passes run in insertion order and the report covers each one.
+    {
+        std::vector<std::string> log;
+        PassManager manager;
+        manager.add_pass(std::make_unique<RecordingPass>("first", log));
+        manager.add_pass(std::make_unique<RecordingPass>("second", log));
+        std::ostringstream printed;
+        manager.print_after("second", printed);
+        IntermediateProgram program = jumpy_program();
+        manager.run(program);
+        assert((log == std::vector<std::string>{"first", "second"}));
+        assert(program.instructions().size() == 6);
+        assert(printed.str().find("; IR after second") == 0);
+        assert(printed.str().find("first") == std::string::npos);
+
+        std::ostringstream report;
+        manager.write_timing_report(report);
+        const std::string text = report.str();
+        assert(text.find("pass timing:\n") == 0);
+        assert(text.find("insns 8 -> 7  dropped=1") != std::string::npos);
+        assert(text.find("insns 7 -> 6  dropped=1") != std::string::npos);
+        assert(text.find("total") != std::string::npos && text.find("insns 8 -> 6\n") != std::string::npos);
+    }
+
+    std::cout << "TISC pass manager tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include "../common/test_utils.hpp"
+#include "t81/tisc/cfg.hpp"
+#include "t81/tisc/pass_manager.hpp"
+#include "t81/tisc/passes.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <variant>
+#include <vector>
+
+using namespace t81::tisc::ir;
+
+namespace {
+
+Instruction add(int dest, int lhs, int rhs) {
+    Instruction instr(Opcode::ADD, {Register{dest}, Register{lhs}, Register{rhs}});
+    instr.primitive = PrimitiveKind::Integer;
+    return instr;
+}
+
+int highest_register(const IntermediateProgram& program) {
+    int highest = -1;
+    for (const auto& instr : program.instructions()) {
+        for (const auto& operand : instr.operands) {
+            if (const auto* reg = std::get_if<Register>(&operand)) highest = std::max(highest, reg->index);
+        }
+    }
+    return highest;
+}
+
+std::int64_t counter(const PassTiming& timing, const std::string& name) {
+    for (const auto& [key, value] : timing.counters) {
+        if (key == name) return value;
+    }
+    assert(false && "missing counter");
+    return -1;
+}
+
+} // namespace
+
+int main() {
+    // Intervals: reads at 2i, writes at 2i + 1; a register live around a
+    // loop covers the whole loop.
+    {
+        const std::vector<Instruction> instrs = {
+            loadi(1, 3),                                  // 0
+            loadi(2, 0),                                  // 1
+            Instruction(Opcode::LABEL, {Label{0}}),       // 2
+            add(2, 2, 1),                                 // 3
+            loadi(3, 1),                                  // 4
+            Instruction(Opcode::SUB, {Register{1}, Register{1}, Register{3}}), // 5
+            Instruction(Opcode::JZ, {Label{1}, Register{1}}),                  // 6
+            Instruction(Opcode::JMP, {Label{0}}),         // 7
+            Instruction(Opcode::LABEL, {Label{1}}),       // 8
+            Instruction(Opcode::MOV, {Register{0}, Register{2}}),              // 9
+            Instruction(Opcode::HALT),                    // 10
+        };
+        const auto cfg = ControlFlowGraph::build(instrs);
+        const auto intervals = live_intervals(instrs, cfg, Liveness::compute(instrs, cfg));
+        assert(intervals.size() == 4);
+        assert(intervals[0].reg == 1 && intervals[0].start == 1 && intervals[0].end == 15);
+        assert(intervals[0].kind == PrimitiveKind::Integer);
+        assert(intervals[1].reg == 2 && intervals[1].start == 3 && intervals[1].end == 18);
+        assert(intervals[2].reg == 3 && intervals[2].start == 9 && intervals[2].end == 10);
+        assert(intervals[3].reg == 0 && intervals[3].start == 19 && intervals[3].end == 20);
+
+        auto program = program_of(instrs);
+        const long long expected = evaluate(program);
+        PassManager manager;
+        manager.add_pass(make_register_allocation_pass(4));
+        manager.run(program);
+        assert(evaluate(program) == expected && expected == 6);
+        assert(highest_register(program) == 3);
+    }
+
+    // A chain of short-lived temporaries reuses the same few registers; a
+    // register whose last read is an instruction can be that instruction's
+    // result.
+    {
+        std::vector<Instruction> instrs = {loadi(1, 1)};
+        for (int reg = 2; reg < 200; reg += 2) {
+            instrs.push_back(loadi(reg, reg));
+            instrs.push_back(add(reg + 1, reg - 1, reg));
+        }
+        instrs.push_back(Instruction(Opcode::MOV, {Register{0}, Register{199}}));
+        instrs.push_back(Instruction(Opcode::HALT));
+        auto program = program_of(instrs);
+        const long long expected = evaluate(program);
+        PassManager manager;
+        manager.add_pass(make_register_allocation_pass());
+        manager.run(program);
+        assert(evaluate(program) == expected);
+        assert(highest_register(program) == 2);
+        const PassTiming& timing = manager.timings().front();
+        assert(counter(timing, "virtual-registers") == 200);
+        assert(counter(timing, "max-live") == 2);
+        assert(counter(timing, "physical-registers") == 3);
+        assert(counter(timing, "spilled") == 0);
+    }
+
+    // Fourteen values live at once do not fit in five registers: some go to
+    // memory, reloaded into scratch registers around each use and tagged
+    // with their kind. A comparison result is a Boolean and never shares a
+    // slot with an integer.
+    {
+        std::vector<Instruction> instrs;
+        for (int reg = 1; reg <= 12; ++reg) {
+            instrs.push_back(loadi(reg, reg * 10));
+        }
+        Instruction less(Opcode::CMP, {Register{13}, Register{1}, Register{12}});
+        less.boolean_result = true;
+        less.relation = ComparisonRelation::Less;
+        instrs.push_back(less);
+        instrs.push_back(loadi(0, 0));
+        for (int reg = 1; reg <= 13; ++reg) {
+            instrs.push_back(add(0, 0, reg));
+        }
+        instrs.push_back(Instruction(Opcode::HALT));
+        auto program = program_of(instrs);
+        const long long expected = evaluate(program);
+        PassManager manager;
+        manager.add_pass(make_register_allocation_pass(5));
+        manager.run(program);
+        assert(evaluate(program) == expected && expected == 781);
+        assert(highest_register(program) <= 4);
+
+        std::map<long long, PrimitiveKind> slot_kinds;
+        bool stored_boolean = false;
+        for (const auto& instr : program.instructions()) {
+            if (instr.opcode != Opcode::STORE && instr.opcode != Opcode::LOAD) continue;
+            const long long slot = std::get<Immediate>(instr.operands[instr.opcode == Opcode::STORE ? 0 : 1]).value;
+            auto [it, inserted] = slot_kinds.emplace(slot, instr.primitive);
+            assert(it->second == instr.primitive);
+            stored_boolean = stored_boolean || (instr.opcode == Opcode::STORE && instr.primitive == PrimitiveKind::Boolean);
+        }
+        assert(stored_boolean);
+        const PassTiming& timing = manager.timings().front();
+        assert(counter(timing, "max-live") == 14);
+        assert(counter(timing, "spilled") > 0);
+        assert(counter(timing, "spill-loads") > 0 && counter(timing, "spill-stores") == counter(timing, "spilled"));
+
+        // The slots are cells of a frame the program reserves on entry and
+        // releases before HALT, not fixed memory addresses.
+        const auto& allocated = program.instructions();
+        const long long cells = counter(timing, "frame-slots");
+        assert(cells == static_cast<long long>(slot_kinds.size()));
+        assert(allocated.front().opcode == Opcode::STACK_ALLOC &&
+               std::get<Immediate>(allocated.front().operands[0]).value == cells);
+        const auto& freed = allocated[allocated.size() - 2];
+        assert(freed.opcode == Opcode::STACK_FREE && std::get<Immediate>(freed.operands[0]).value == cells);
+    }
+
+    // The pass runs last at -O1, ahead only of lower-calls, and its
+    // counters show up in the report.
+    {
+        const auto names = PassManager::pass_names();
+        assert(names.back() == "lower-calls" && names[names.size() - 2] == "register-allocation");
+        auto program = program_of({loadi(40, 2), loadi(41, 3), add(42, 40, 41),
+                                   Instruction(Opcode::MOV, {Register{0}, Register{42}}), Instruction(Opcode::HALT)});
+        auto manager = PassManager::for_level(OptLevel::O1);
+        manager.run(program);
+        assert(highest_register(program) <= kDefaultPhysicalRegisters - 1);
+        std::ostringstream report;
+        manager.write_timing_report(report);
+        assert(report.str().find("virtual-registers=") != std::string::npos);
+    }
+
+    std::cout << "TISC register allocation tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,198 @@
+#include "../common/test_utils.hpp"
+#include "t81/tisc/pass_manager.hpp"
+#include "t81/tisc/passes.hpp"
+#include "t81/tisc/ssa.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+using namespace t81::tisc::ir;
+
+namespace {
+
+Instruction binary(Opcode opcode, int dest, int lhs, int rhs) {
+    Instruction instr(opcode, {Register{dest}, Register{lhs}, Register{rhs}});
+    instr.primitive = PrimitiveKind::Integer;
+    return instr;
+}
+
+Instruction compare(ComparisonRelation relation, int dest, int lhs, int rhs) {
+    Instruction instr(Opcode::CMP, {Register{dest}, Register{lhs}, Register{rhs}});
+    instr.primitive = PrimitiveKind::Integer;
+    instr.boolean_result = true;
+    instr.relation = relation;
+    return instr;
+}
+
+Instruction move(int dest, int src) { return Instruction(Opcode::MOV, {Register{dest}, Register{src}}); }
+Instruction label(int id) { return Instruction(Opcode::LABEL, {Label{id}}); }
+Instruction jump(Opcode opcode, int target, int cond) { return Instruction(opcode, {Label{target}, Register{cond}}); }
+
+std::vector<Instruction> run_pass(std::unique_ptr<Pass> pass, std::vector<Instruction> instrs) {
+    auto program = program_of(std::move(instrs));
+    PassContext context;
+    pass->run(program, context);
+    return program.instructions();
+}
+
+} // namespace
+
+int main() {
+    // Dominators of entry -> {1, 2} -> 3 -> back to 1.
+    {
+        const auto tree = DominatorTree::build({{1, 2}, {3}, {3}, {1}, {}});
+        assert(tree.idom(0) == 0 && tree.idom(1) == 0 && tree.idom(2) == 0 && tree.idom(3) == 0);
+        assert(!tree.reachable(4));
+        assert(tree.dominates(0, 3) && !tree.dominates(1, 3) && tree.dominates(3, 3));
+        assert(tree.reverse_postorder().front() == 0 && tree.reverse_postorder().size() == 4);
+        assert((tree.children(0) == std::vector<std::size_t>{1, 2, 3}));
+    }
+
+    // A variable set on both arms of a branch gets one phi at the join, and
+    // lowering merges both assignments back into one register.
+    {
+        const std::vector<Instruction> diamond = {
+            loadi(1, 5),
+            compare(ComparisonRelation::Less, 2, 1, 1),
+            jump(Opcode::JZ, 1, 2),
+            loadi(3, 1),
+            Instruction(Opcode::JMP, {Label{2}}),
+            label(1),
+            loadi(3, 2),
+            label(2),
+            move(0, 3),
+            Instruction(Opcode::HALT),
+        };
+        auto form = SsaForm::build(diamond);
+        assert(form.has_value());
+        assert(form->blocks().size() == 4);
+        assert(form->blocks()[3].phis.size() == 1 && form->blocks()[3].phis[0].args.size() == 2);
+        assert(form->blocks()[3].phis[0].primitive == PrimitiveKind::Integer);
+        assert(form->value_count() == 5);
+
+        SsaLoweringStats stats;
+        const auto lowered = form->lower(&stats);
+        assert(evaluate(lowered) == evaluate(diamond) && evaluate(diamond) == 2);
+        assert(stats.copies_inserted == 0 && stats.copies_coalesced == 2);
+        assert(lowered.size() == diamond.size());
+    }
+
+    // A register read before any write has no SSA value.
+    {
+        assert(!SsaForm::build({move(0, 7), Instruction(Opcode::HALT)}).has_value());
+    }
+
+    // Swapping two variables in a loop. Once GVN propagates the copies the
+    // loop phis read each other, and lowering needs a temporary to break
+    // the cycle of parallel moves.
+    {
+        const std::vector<Instruction> swap = {
+            loadi(1, 1),
+            loadi(2, 4),
+            loadi(3, 6),
+            loadi(5, 2),
+            label(0),
+            move(4, 1),
+            move(1, 2),
+            move(2, 4),
+            binary(Opcode::SUB, 3, 3, 5),
+            jump(Opcode::JNZ, 0, 3),
+            binary(Opcode::SUB, 0, 1, 2),
+            Instruction(Opcode::HALT),
+        };
+        assert(evaluate(swap) == 3);
+        assert(evaluate(run_pass(make_coalesce_copies_pass(), swap)) == 3);
+        const auto numbered = run_pass(make_gvn_pass(), swap);
+        assert(evaluate(numbered) == 3);
+        // The loop-back edge leaves a conditional jump, so it is split.
+        assert(count_of(numbered, Opcode::LABEL) == 2);
+        assert(count_of(numbered, Opcode::MOV) == 3);
+    }
+
+    // SCCP proves a loop-carried variable constant: every executable path
+    // keeps it at 1, so the compare, the store of 2 and the branch go.
+    {
+        const std::vector<Instruction> loop = {
+            loadi(1, 1),
+            loadi(2, 3),
+            loadi(5, 1),
+            label(0),
+            loadi(6, 1),
+            compare(ComparisonRelation::Equal, 3, 1, 6),
+            jump(Opcode::JNZ, 1, 3),
+            loadi(1, 2),
+            label(1),
+            binary(Opcode::SUB, 2, 2, 5),
+            jump(Opcode::JNZ, 0, 2),
+            move(0, 1),
+            Instruction(Opcode::HALT),
+        };
+        auto program = program_of(loop);
+        PassManager manager;
+        manager.add_pass(make_sccp_pass());
+        manager.run(program);
+        const auto& out = program.instructions();
+        assert(evaluate(out) == evaluate(loop) && evaluate(loop) == 1);
+        assert(count_of(out, Opcode::CMP) == 0);
+        assert(std::none_of(out.begin(), out.end(), [](const Instruction& instr) {
+            return instr.opcode == Opcode::LOADI && std::get<Immediate>(instr.operands[1]).value == 2;
+        }));
+        const PassTiming& timing = manager.timings().front();
+        assert(timing.changed && timing.counters[1].first == "values-folded" && timing.counters[1].second > 0);
+        assert(timing.counters[2].first == "branches-folded" && timing.counters[2].second == 1);
+        assert(timing.counters[3].first == "blocks-removed" && timing.counters[3].second == 1);
+    }
+
+    // GVN removes a recomputation in a dominated block, operands swapped,
+    // but keeps values read from r0 after separate calls apart.
+    {
+        const std::vector<Instruction> redundant = {
+            loadi(1, 4),
+            loadi(2, 5),
+            binary(Opcode::ADD, 3, 1, 2),
+            jump(Opcode::JZ, 1, 3),
+            label(1),
+            binary(Opcode::ADD, 4, 2, 1),
+            binary(Opcode::ADD, 0, 3, 4),
+            Instruction(Opcode::HALT),
+        };
+        const auto out = run_pass(make_gvn_pass(), redundant);
+        assert(count_of(out, Opcode::ADD) == 2);
+        assert(evaluate(out) == 18);
+
+        const std::vector<Instruction> calls = {
+            Instruction(Opcode::CALL, {Immediate{1}}),
+            move(1, 0),
+            Instruction(Opcode::CALL, {Immediate{1}}),
+            move(2, 0),
+            binary(Opcode::ADD, 0, 1, 2),
+            Instruction(Opcode::HALT),
+        };
+        const auto kept = run_pass(make_gvn_pass(), calls);
+        assert(kept.size() == calls.size() && count_of(kept, Opcode::MOV) == 2);
+    }
+
+    // The SSA passes run at -O2 only, ahead of the -O1 cleanup passes.
+    {
+        auto o1 = PassManager::for_level(OptLevel::O1);
+        auto o2 = PassManager::for_level(OptLevel::O2);
+        auto program = program_of({loadi(1, 2), move(0, 1), Instruction(Opcode::HALT)});
+        auto copy = program;
+        o1.run(program);
+        o2.run(copy);
+        auto ran = [](const PassManager& manager, std::string_view name) {
+            const auto& timings = manager.timings();
+            return std::any_of(timings.begin(), timings.end(), [&](const PassTiming& t) { return t.name == name; });
+        };
+        assert(!ran(o1, "sccp") && !ran(o1, "gvn") && !ran(o1, "coalesce-copies"));
+        assert(ran(o2, "sccp") && ran(o2, "gvn") && ran(o2, "coalesce-copies"));
+    }
+
+    std::cout << "TISC SSA tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "t81/frontend/lexer.hpp"
+#include "t81/frontend/module_interface.hpp"
+#include "t81/frontend/parser.hpp"
+#include "t81/frontend/semantic_analyzer.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace t81::frontend;
+
+namespace {
+
+std::span<const std::byte> as_bytes(const std::string& data) {
+    return {reinterpret_cast<const std::byte*>(data.data()), data.size()};
+}
+
+ModuleInterface interface_of(const std::string& source) {
+    const auto tokens = TokenStream::tokenize(source);
+    Parser parser(tokens, "iface.t81");
+    const SyntaxTree stmts = parser.parse();
+    SemanticAnalyzer analyzer(stmts, "iface.t81");
+    analyzer.analyze();
+    if (parser.had_error() || analyzer.had_error()) {
+        std::cerr << "Interface fixture failed to check" << std::endl;
+        std::exit(1);
+    }
+    return ModuleInterface::build(analyzer, stmts);
+}
+
+} // namespace
+
+int main() {
+    const std::string source = R"(
+        module app.shapes;
+        import app.base;
+
+        type Pair[T] = Result[T, T];
+        record Point { x: i32; y: i32; };
+        enum Shape { Circle(i32); Square; };
+
+        @effect
+        @tier(2)
+        fn log(p: Point, n: i32) -> i32 {
+            return n;
+        }
+
+        fn area(s: Shape) -> i32 {
+            record Local { v: i32; };
+            return match (s) { Circle(r) => r * r; Square => 1; };
+        }
+    )";
+    ModuleInterface iface = interface_of(source);
+    iface.compiler_stamp = "test";
+    iface.source_hash = "abc";
+    iface.source_size = 42;
+    iface.source_mtime = -7;
+    iface.imports[0].interface_hash = "def";
+
+    assert(iface.module_path == "app.shapes");
+    assert(iface.imports.size() == 1 && iface.imports[0].path == "app.base");
+    assert(iface.functions.size() == 2);
+    assert(iface.functions[0].name == "log" && iface.functions[0].is_effectful);
+    assert(iface.functions[0].tier == 2);
+    assert(iface.functions[0].params.size() == 2 && iface.functions[0].params[0].type == "Point");
+    assert(iface.functions[1].return_type == "i32" && !iface.functions[1].tier.has_value());
+    // Declarations inside bodies are local, not exported.
+    assert(iface.records.size() == 1 && iface.records[0].fields.size() == 2);
+    assert(iface.enums.size() == 1 && iface.enums[0].variants.size() == 2);
+    assert(iface.enums[0].variants[0].payload == "i32" && !iface.enums[0].variants[1].payload);
+    assert(iface.enums[0].variants[1].id == 1);
+    assert(iface.aliases.size() == 1 && iface.aliases[0].params.size() == 1);
+    assert(iface.aliases[0].target == "Result[T, T]");
+
+    const std::string bytes = iface.serialize();
+    auto view = ModuleInterfaceView::open(as_bytes(bytes));
+    assert(view.has_value());
+    assert(view->compiler_stamp() == "test" && view->source_hash() == "abc");
+    assert(view->source_size() == 42 && view->source_mtime() == -7);
+    assert(view->exports_hash() == iface.exports_hash());
+    assert(view->import_count() == 1 && view->import_interface_hash(0) == "def");
+    assert(view->materialize() == iface);
+
+    // Body edits keep the exports hash; signature edits change it.
+    std::string body_edit = source;
+    body_edit.replace(body_edit.find("return n;"), 9, "return n + 1;");
+    assert(interface_of(body_edit).exports_hash() == iface.exports_hash());
+    std::string signature_edit = source;
+    signature_edit.replace(signature_edit.find("@tier(2)"), 8, "@tier(3)");
+    assert(interface_of(signature_edit).exports_hash() != iface.exports_hash());
+
+    // Truncated or corrupted input is rejected rather than read out of bounds.
+    for (std::size_t size = 0; size < bytes.size(); size += 7) {
+        assert(!ModuleInterfaceView::open(as_bytes(bytes.substr(0, size))).has_value());
+    }
+    std::string bad_magic = bytes;
+    bad_magic[0] = 'X';
+    assert(!ModuleInterfaceView::open(as_bytes(bad_magic)).has_value());
+    std::string bad_string = bytes;
+    bad_string[44] = '\x7f';  // length of the compiler stamp
+    assert(!ModuleInterfaceView::open(as_bytes(bad_string)).has_value());
+
+    std::cout << "Module interface tests passed!" << std::endl;
+    return 0;
+}
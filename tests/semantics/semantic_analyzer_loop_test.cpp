@@ -44,10 +44,10 @@ void expect_semantic_failure(const std::string& source, const char* label = "<fa
 }
 
 struct AnalyzerFixture {
-    [[maybe_unused]] std::vector<std::unique_ptr<Stmt>> statements;
+    [[maybe_unused]] SyntaxTree statements;
     [[maybe_unused]] SemanticAnalyzer analyzer;
 
-    explicit AnalyzerFixture(std::vector<std::unique_ptr<Stmt>> stmts)
+    explicit AnalyzerFixture(SyntaxTree stmts)
         : statements(std::move(stmts)),
           analyzer(statements) {
         analyzer.analyze();
@@ -58,7 +58,7 @@ struct AnalyzerFixture {
     }
 };
 
-std::vector<std::unique_ptr<Stmt>> parse_statements(const std::string& source) {
+SyntaxTree parse_statements(const std::string& source) {
     Lexer lexer(source);
     Parser parser(lexer);
     [[maybe_unused]] auto stmts= parser.parse();
@@ -60,6 +60,37 @@ int main() {
     expect_semantic_failure(guard_non_bool_failure, "guard_non_bool_failure",
                             "Condition must be bool");
 
+    const std::string nested_variant_arms = R"(
+        enum Shape {
+            Circle(i32);
+            Dot;
+        };
+
+        fn main() -> i32 {
+            let shape: Option[Shape] = Some(Shape.Dot);
+            return match (shape) {
+                Some(Circle(r)) => r;
+                Some(Dot()) => 1;
+                Some(_) => 2;
+                None => 0;
+            };
+        }
+    )";
+    expect_semantic_success(nested_variant_arms, "nested_variant_arms");
+
+    const std::string duplicate_irrefutable_arm = R"(
+        fn main() -> i32 {
+            let maybe: Option[i32] = Some(1);
+            return match (maybe) {
+                Some(v) => v;
+                Some(w) => w;
+                None => 0;
+            };
+        }
+    )";
+    expect_semantic_failure(duplicate_irrefutable_arm, "duplicate_irrefutable_arm",
+                            "Duplicate match arm for 'Some'");
+
     std::cout << "Semantic analyzer match tests passed!" << std::endl;
     return 0;
 }
@@ -1,5 +1,6 @@
 #include "../common/test_utils.hpp"
 
+#include <cassert>
 #include <iostream>
 #include <string>
 
@@ -57,6 +58,110 @@ int main() {
     )";
     expect_semantic_success(effect_calls_effect, "effect_calls_effect");
 
+    const std::string tailrec_tail_calls = R"(
+        @tailrec
+        fn gcd(a: i32, b: i32) -> i32 {
+            if (b == 0) {
+                return a;
+            }
+            return gcd(b, a % b);
+        }
+
+        fn main() -> i32 {
+            return gcd(12, 18);
+        }
+    )";
+    expect_semantic_success(tailrec_tail_calls, "tailrec_tail_calls");
+
+    const std::string tailrec_not_tail = R"(
+        @tailrec
+        fn fact(n: i32) -> i32 {
+            if (n < 2) {
+                return 1;
+            }
+            return n * fact(n - 1);
+        }
+
+        fn main() -> i32 {
+            return fact(5);
+        }
+    )";
+    expect_semantic_failure(tailrec_not_tail, "tailrec_not_tail", "is not in tail position");
+
+    // The outer call is in tail position; the one computing its argument is not.
+    const std::string tailrec_nested = R"(
+        @tailrec
+        fn down(n: i32) -> i32 {
+            if (n < 1) {
+                return 0;
+            }
+            return down(down(n - 1));
+        }
+
+        fn main() -> i32 {
+            return down(3);
+        }
+    )";
+    expect_semantic_failure(tailrec_nested, "tailrec_nested", "Recursive call to 'down' is not in tail position");
+
+    // A function is total when nothing in it or in what it calls can trap
+    // or keep it from returning.
+    {
+        const std::string source = R"(
+            fn square(x: i32) -> i32 {
+                return x * x;
+            }
+
+            fn sum_squares(a: i32, b: i32) -> i32 {
+                return square(a) + square(b);
+            }
+
+            fn boom(x: i32) -> i32 {
+                let y: i32 = x + 1;
+                return 10 / x;
+            }
+
+            fn calls_boom(x: i32) -> i32 {
+                return boom(x) + 1;
+            }
+
+            fn spin(n: i32) -> i32 {
+                var i: i32 = 0;
+                while (i < n) {
+                    i = i + 1;
+                }
+                return i;
+            }
+
+            fn ping(n: i32) -> i32 {
+                if (n < 1) {
+                    return 0;
+                }
+                return pong(n - 1);
+            }
+
+            fn pong(n: i32) -> i32 {
+                return ping(n);
+            }
+
+            fn main() -> i32 {
+                return sum_squares(1, 2);
+            }
+        )";
+        Lexer lexer(source);
+        Parser parser(lexer);
+        auto stmts = parser.parse();
+        assert(!parser.had_error());
+        SemanticAnalyzer analyzer(stmts);
+        analyzer.analyze();
+        assert(!analyzer.had_error());
+        assert(analyzer.is_total("square") && analyzer.is_total("sum_squares") && analyzer.is_total("main"));
+        assert(!analyzer.is_total("boom") && !analyzer.is_total("calls_boom"));
+        assert(!analyzer.is_total("spin"));
+        assert(!analyzer.is_total("ping") && !analyzer.is_total("pong"));
+        assert(!analyzer.is_total("undefined"));
+    }
+
     std::cout << "Semantic analyzer module/import/effect tests passed!" << std::endl;
     return 0;
 }
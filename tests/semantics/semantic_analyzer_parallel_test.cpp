@@ -0,0 +1,125 @@
+#include "t81/frontend/lexer.hpp"
+#include "t81/frontend/parser.hpp"
+#include "t81/frontend/semantic_analyzer.hpp"
+#include "t81/support/work_stealing_pool.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace t81::frontend;
+
+namespace {
+
+SyntaxTree parse_statements(const std::string& source) {
+    const auto tokens = TokenStream::tokenize(source);
+    Parser parser(tokens, "parallel.t81");
+    auto stmts = parser.parse();
+    if (parser.had_error()) {
+        std::cerr << "Parser failed on parallel fixture" << std::endl;
+        std::exit(1);
+    }
+    return stmts;
+}
+
+std::vector<std::string> render(const SemanticAnalyzer& analyzer, const SyntaxTree& tree) {
+    std::vector<std::string> out;
+    for (const auto& diag : analyzer.diagnostics()) {
+        out.push_back(std::to_string(diag.line) + ":" + std::to_string(diag.column) + ": " + diag.message);
+    }
+    for (const auto& loop : analyzer.loop_metadata()) {
+        out.push_back("loop " + std::to_string(loop.id) + " line " + std::to_string(loop.keyword.line) +
+                      " depth " + std::to_string(loop.depth));
+    }
+    for (const auto& match : analyzer.match_metadata()) {
+        out.push_back("match " + std::to_string(match.expr->id) + " -> " + analyzer.type_name(match.result_type));
+    }
+    for (const auto& stmt : tree) {
+        if (stmt->kind != StmtKind::Function) continue;
+        const auto name = static_cast<const FunctionStmt&>(*stmt).name.lexeme;
+        out.push_back(std::string(name) + (analyzer.is_total(name) ? " total" : " partial"));
+    }
+    return out;
+}
+
+// Analyzes `source` serially and on a pool; both runs must agree exactly.
+void expect_same_as_serial(const std::string& source, const char* label) {
+    const SyntaxTree tree = parse_statements(source);
+
+    SemanticAnalyzer serial(tree, "parallel.t81");
+    serial.analyze();
+
+    t81::WorkStealingPool pool(4);
+    SemanticAnalyzer parallel(tree, "parallel.t81");
+    parallel.set_thread_pool(&pool);
+    parallel.analyze();
+
+    if (serial.had_error() != parallel.had_error() || render(serial, tree) != render(parallel, tree)) {
+        std::cerr << "Parallel analysis diverged from serial (" << label << ")" << std::endl;
+        for (const auto& line : render(serial, tree)) std::cerr << "  serial:   " << line << std::endl;
+        for (const auto& line : render(parallel, tree)) std::cerr << "  parallel: " << line << std::endl;
+        std::exit(1);
+    }
+    for (const auto& match : serial.match_metadata()) {
+        assert(parallel.match_metadata_for(*match.expr) != nullptr);
+    }
+}
+
+std::string many_functions(int count) {
+    std::string source = "enum Shape { Circle(i32); Square; };\n";
+    for (int i = 0; i < count; ++i) {
+        const std::string n = std::to_string(i);
+        source += "fn f" + n + "(x: i32) -> i32 {\n";
+        source += "    var total: i32 = x;\n";
+        source += "    @bounded(" + std::to_string(i % 5 + 1) + ")\n";
+        source += "    loop {\n";
+        source += "        total = total + " + n + ";\n";
+        source += "        @bounded(infinite)\n";
+        source += "        loop { return total; }\n";
+        source += "    }\n";
+        if (i % 3 == 0) {
+            source += "    let bad: bool = total;\n";  // diagnostic in every third body
+        }
+        source += "    return match (Some(total)) { Some(v) => v; None => f" + std::to_string((i + 1) % count) + "(0); };\n";
+        source += "}\n";
+        if (i % 10 == 9) {
+            // A top-level declaration splits the run of bodies.
+            source += "record R" + n + " { value: i32; };\n";
+        }
+    }
+    return source;
+}
+
+} // namespace
+
+int main() {
+    expect_same_as_serial(many_functions(40), "many_functions");
+
+    // Only the first use of an undeclared generic registers its arity, so
+    // the later bodies here must report the mismatch exactly as serially.
+    const std::string arity_conflict = R"(
+        fn a() -> i32 { let v: Box[i32] = 0; return 0; }
+        fn b() -> i32 { let v: Box[i32, i32] = 0; return 0; }
+        fn c() -> i32 { let v: Box[i32, i32, i32] = 0; return 0; }
+        fn d() -> i32 { let v: Box[i32] = 0; return 0; }
+        fn e() -> i32 { let v: Pair[i32, i32] = 0; return 0; }
+    )";
+    expect_same_as_serial(arity_conflict, "arity_conflict");
+
+    // Bodies that declare types are checked in order with the top level.
+    const std::string nested_decl = R"(
+        fn a() -> i32 { return 1; }
+        fn b() -> i32 { record Inner { x: i32; }; return 2; }
+        fn c() -> i32 { let r: Inner = Inner { x: 1 }; return r.x; }
+        fn d() -> i32 { return c(); }
+        fn e() -> i32 { return d(); }
+        fn f() -> i32 { return e(); }
+        fn g() -> bool { return f(); }
+    )";
+    expect_same_as_serial(nested_decl, "nested_decl");
+
+    std::cout << "Semantic analyzer parallel tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "../common/test_utils.hpp"
+#include "t81/frontend/type_interner.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using t81::frontend::Type;
+using t81::frontend::TypeInterner;
+
+static_assert(sizeof(Type) == sizeof(void*));
+static_assert(std::is_trivially_copyable_v<Type>);
+
+namespace {
+Type nested_generic() {
+    const Type vec{Type::Kind::Vector, {Type{Type::Kind::Float}}};
+    const Type result{Type::Kind::Result, {vec, Type{Type::Kind::Custom, {}, "Error"}}};
+    return Type{Type::Kind::Option, {result}};
+}
+} // namespace
+
+int main() {
+    // Structurally identical types share one node.
+    assert(Type{Type::Kind::I32}.node() == Type{Type::Kind::I32}.node());
+    assert(Type{}.kind() == Type::Kind::Unknown);
+    assert(nested_generic().node() == nested_generic().node());
+    assert(nested_generic().params()[0].params()[1].custom_name() == "Error");
+
+    // Equality keeps its semantics: by name for Custom/Constant, by
+    // parameters otherwise.
+    const Type foo_i32{Type::Kind::Custom, {Type{Type::Kind::I32}}, "Foo"};
+    const Type foo_bool{Type::Kind::Custom, {Type{Type::Kind::Bool}}, "Foo"};
+    assert(foo_i32.node() != foo_bool.node());
+    assert(foo_i32 == foo_bool);
+    assert(foo_i32 != (Type{Type::Kind::Custom, {}, "Bar"}));
+    assert((Type{Type::Kind::Option, {foo_i32}}) == (Type{Type::Kind::Option, {foo_bool}}));
+    assert((Type{Type::Kind::Option, {Type{Type::Kind::I32}}}) != (Type{Type::Kind::Option, {Type{Type::Kind::I8}}}));
+    assert(Type::constant("4") == Type::constant("4"));
+    assert(Type::constant("4") != Type::constant("8"));
+
+    // with_params derives a new handle and leaves the original untouched.
+    const Type bare_option{Type::Kind::Option};
+    const Type filled = bare_option.with_params({Type{Type::Kind::I32}});
+    assert(bare_option.params().empty());
+    assert(filled.params().size() == 1 && filled != bare_option);
+
+    // Concurrent interning of the same shapes converges on the same nodes.
+    const auto* expected = nested_generic().node();
+    std::vector<std::thread> workers;
+    std::vector<const t81::frontend::TypeNode*> seen(4, nullptr);
+    for (std::size_t t = 0; t < seen.size(); ++t) {
+        workers.emplace_back([&seen, t] {
+            for (int i = 0; i < 1000; ++i) {
+                Type{Type::Kind::Vector, {Type::constant(std::to_string(i % 16))}};
+                seen[t] = nested_generic().node();
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    for (const auto* node : seen) assert(node == expected);
+    const std::size_t size = TypeInterner::global().size();
+    Type{Type::Kind::Vector, {Type::constant("3")}};
+    assert(TypeInterner::global().size() == size);
+
+    // Generic-heavy programs still type-check end to end.
+    expect_semantic_success(R"(
+        fn wrap(v: Vector[T81Float]) -> Option[Result[Vector[T81Float], i32]] {
+            let inner: Result[Vector[T81Float], i32] = Ok(v);
+            return Some(inner);
+        }
+    )", "nested_generics");
+
+    std::cout << "Type interner tests passed!" << std::endl;
+    return 0;
+}
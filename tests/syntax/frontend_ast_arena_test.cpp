@@ -0,0 +1,62 @@
+#include "t81/frontend/ast.hpp"
+#include "t81/frontend/lexer.hpp"
+#include "t81/frontend/parser.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+using namespace t81::frontend;
+
+static_assert(std::is_trivially_destructible_v<BinaryExpr>);
+static_assert(std::is_trivially_destructible_v<MatchExpr>);
+static_assert(std::is_trivially_destructible_v<FunctionStmt>);
+static_assert(std::is_trivially_destructible_v<RecordDecl>);
+
+int main() {
+    // Bump allocation respects alignment and spills into new chunks.
+    {
+        AstArena arena(256);
+        for (int i = 0; i < 100; ++i) {
+            [[maybe_unused]] auto* value = arena.make<std::int64_t>(i);
+            assert(reinterpret_cast<std::uintptr_t>(value) % alignof(std::int64_t) == 0);
+            assert(*value == i);
+            arena.make<char>('x');
+        }
+        assert(arena.chunk_count() > 1);
+
+        // Oversized requests get a dedicated chunk.
+        const std::string big(1000, 'q');
+        [[maybe_unused]] std::string_view copy = arena.copy_string(big);
+        assert(copy == big);
+        assert(copy.data() != big.data());
+
+        std::vector<int> items{1, 2, 3};
+        [[maybe_unused]] AstList<int> list = arena.make_list(std::move(items));
+        assert(list.size() == 3 && list[0] == 1 && list.back() == 3);
+        assert(arena.make_list(std::vector<int>{}).empty());
+    }
+
+    // The tree outlives the parser, and a very deep left-leaning expression is
+    // released with the arena instead of through a recursive destructor chain.
+    SyntaxTree tree;
+    {
+        std::string source = "fn main() -> i32 { return 0";
+        for (int i = 0; i < 200000; ++i) source += " + 1";
+        source += "; }";
+        const TokenStream tokens = TokenStream::tokenize(source);
+        Parser parser(tokens);
+        tree = parser.parse();
+        assert(!parser.had_error());
+    }
+    assert(tree.size() == 1);
+    [[maybe_unused]] auto* fn = dynamic_cast<const FunctionStmt*>(tree[0].get());
+    assert(fn != nullptr && fn->body.size() == 1);
+    assert(tree.arena->bytes_used() > 200000 * sizeof(BinaryExpr));
+    tree = SyntaxTree{};
+
+    std::cout << "AstArena tests passed!" << std::endl;
+    return 0;
+}
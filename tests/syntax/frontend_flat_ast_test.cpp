@@ -0,0 +1,77 @@
+#include "t81/frontend/flat_ast.hpp"
+#include "t81/frontend/lexer.hpp"
+#include "t81/frontend/parser.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace t81::frontend;
+
+int main() {
+    // NodeMap grows on first write and distinguishes absent from default slots.
+    {
+        NodeMap<int> map;
+        assert(map.find(0) == nullptr);
+        map[5] = 7;
+        assert(map.find(5) != nullptr && *map.find(5) == 7);
+        assert(!map.contains(4));
+        map[4];
+        assert(map.contains(4) && *map.find(4) == 0);
+        assert(map.find(1000) == nullptr);
+    }
+
+    const TokenStream tokens = TokenStream::tokenize(
+        "fn add(a: i32, b: i32) -> i32 {\n"
+        "    let c: i32 = a + b * 2;\n"
+        "    return c;\n"
+        "}\n");
+    Parser parser(tokens);
+    SyntaxTree tree = parser.parse();
+    assert(!parser.had_error());
+    assert(tree.size() == 1);
+
+    // Ids are dense: every parsed node is numbered below node_count.
+    const auto& fn = static_cast<const FunctionStmt&>(*tree[0]);
+    assert(fn.id < tree.node_count);
+    const auto& let = static_cast<const LetStmt&>(*fn.body[0]);
+    const auto& sum = static_cast<const BinaryExpr&>(*let.initializer);
+    assert(let.id < tree.node_count && sum.id < tree.node_count && sum.id != let.id);
+
+    const FlatAst flat = FlatAst::lower(tree);
+    assert(flat.size() == tree.node_count);
+    assert(flat.roots.size() == 1 && flat.roots[0] == fn.id);
+    assert(flat.families[fn.id] == NodeFamily::Stmt);
+    assert(flat.stmt_kind(fn.id) == StmtKind::Function);
+    assert(flat.parents[fn.id] == kInvalidNodeId);
+
+    // Function children: two parameter types, the return type, then the body.
+    const auto fn_children = flat.children_of(fn.id);
+    assert(fn_children.size() == 5);
+    assert(flat.expr_kind(fn_children[0]) == ExprKind::SimpleType);
+    assert(fn_children[3] == let.id);
+    assert(flat.stmt_kind(fn_children[4]) == StmtKind::Return);
+
+    // `a + b * 2`: the addition anchors on its operator and owns both operands.
+    assert(flat.families[sum.id] == NodeFamily::Expr);
+    assert(flat.expr_kind(sum.id) == ExprKind::Binary);
+    assert(flat.parents[sum.id] == let.id);
+    assert(flat.lines[sum.id] == 2 && flat.columns[sum.id] == sum.op.column);
+    const auto operands = flat.children_of(sum.id);
+    assert(operands.size() == 2);
+    assert(operands[0] == sum.left->id && operands[1] == sum.right->id);
+    assert(flat.expr_kind(operands[1]) == ExprKind::Binary);
+    assert(flat.children_of(operands[1]).size() == 2);
+
+    // Every node reachable from the roots is recorded exactly once as a child.
+    std::vector<int> seen(flat.size(), 0);
+    for (NodeId child : flat.children) ++seen[child];
+    for (NodeId id = 0; id < flat.size(); ++id) {
+        if (flat.families[id] == NodeFamily::None) continue;
+        assert(seen[id] == (flat.parents[id] == kInvalidNodeId ? 0 : 1));
+    }
+
+    std::cout << "FlatAst tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include "t81/frontend/identifier_interner.hpp"
+#include "t81/frontend/lexer.hpp"
+#include "t81/frontend/symbol_table.hpp"
+#include <cassert>
+#include <iostream>
+#include <string>
+
+using namespace t81::frontend;
+
+static_assert(sizeof(Token) == 32, "SymbolId should fill Token's padding");
+
+int main() {
+    auto& interner = IdentifierInterner::global();
+
+    // Equal spellings share an id regardless of where they came from.
+    const std::string owned = "counter";
+    const SymbolId counter = interner.intern(owned);
+    assert(counter != kEmptySymbol);
+    assert(interner.intern("counter") == counter);
+    assert(interner.spelling(counter) == "counter");
+    assert(interner.intern("") == kEmptySymbol);
+
+    // find() never inserts.
+    const std::size_t size = interner.size();
+    assert(!interner.find("never_seen_identifier").has_value());
+    assert(interner.size() == size);
+    assert(interner.find("counter") == counter);
+
+    // The lexer stamps identifiers with their id; the token stream keeps it.
+    const std::string source = "let counter = counter + other; fn f() {}";
+    const TokenStream stream = TokenStream::tokenize(source);
+    int identifiers = 0;
+    for (std::size_t i = 0; i < stream.size(); ++i) {
+        const Token token = stream.token(i);
+        if (token.type == TokenType::Identifier) {
+            ++identifiers;
+            assert(token.symbol == interner.intern(token.lexeme));
+        } else {
+            assert(token.symbol == kEmptySymbol);
+        }
+    }
+    assert(identifiers == 4);
+
+    // Inner scopes shadow outer bindings and exit_scope restores them.
+    SymbolTable table;
+    table.define("x", Symbol{Symbol::Type::Variable, t81::tisc::ir::Register{1}});
+    table.enter_scope();
+    assert(table.lookup("x").has_value());
+    table.define("x", Symbol{Symbol::Type::Variable, t81::tisc::ir::Register{2}});
+    table.define("y", Symbol{Symbol::Type::Function, t81::tisc::ir::Label{7}});
+    assert(std::get<t81::tisc::ir::Register>(table.lookup("x")->location).index == 2);
+    table.exit_scope();
+    assert(std::get<t81::tisc::ir::Register>(table.lookup("x")->location).index == 1);
+    assert(!table.lookup("y").has_value());
+    assert(!table.lookup("never_seen_identifier").has_value());
+
+    ScopeStack<int> scopes;
+    const SymbolId a = interner.intern("a");
+    assert(scopes.define(a, 1) == nullptr);
+    scopes.enter_scope();
+    scopes.define(a, 1);
+    scopes.enter_scope();
+    assert(!scopes.defined_in_current_scope(a));
+    scopes.define(a, 2);
+    scopes.define(a, 3);
+    assert(scopes.defined_in_current_scope(a) && *scopes.lookup(a) == 3);
+    scopes.exit_scope();
+    assert(*scopes.lookup(a) == 1);
+    scopes.exit_scope();
+    assert(scopes.lookup(a) == nullptr);
+
+    std::cout << "Identifier interner tests passed!" << std::endl;
+    return 0;
+}
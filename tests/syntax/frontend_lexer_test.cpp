@@ -65,6 +65,85 @@ fn main() -> i32 {
     };
     test_sequence(source, expected);
 
+    // Every keyword resolves through the keyword table; near-misses stay identifiers.
+    const std::vector<std::pair<const char*, TokenType>> keywords = {
+        {"module", TokenType::Module}, {"import", TokenType::Import}, {"type", TokenType::Type},
+        {"const", TokenType::Const}, {"export", TokenType::Export}, {"fn", TokenType::Fn},
+        {"let", TokenType::Let}, {"var", TokenType::Var}, {"if", TokenType::If},
+        {"else", TokenType::Else}, {"for", TokenType::For}, {"in", TokenType::In},
+        {"while", TokenType::While}, {"loop", TokenType::Loop}, {"record", TokenType::Record},
+        {"enum", TokenType::Enum}, {"break", TokenType::Break}, {"continue", TokenType::Continue},
+        {"return", TokenType::Return}, {"match", TokenType::Match}, {"true", TokenType::True},
+        {"false", TokenType::False}, {"void", TokenType::Void}, {"bool", TokenType::Bool},
+        {"i32", TokenType::I32}, {"i16", TokenType::I16}, {"i8", TokenType::I8},
+        {"i2", TokenType::I2}, {"T81BigInt", TokenType::T81BigInt},
+        {"T81Float", TokenType::T81Float}, {"T81Fraction", TokenType::T81Fraction},
+        {"T81Vector", TokenType::Vector}, {"T81Matrix", TokenType::Matrix},
+        {"T81Tensor", TokenType::Tensor}, {"T81Graph", TokenType::Graph},
+        {"vector", TokenType::Vector}, {"matrix", TokenType::Matrix},
+        {"tensor", TokenType::Tensor}, {"graph", TokenType::Graph},
+    };
+    for (const auto& [text, type] : keywords) {
+        test_sequence(text, {{type, text, 1, 1}});
+    }
+    for (const char* text : {"i64", "f", "fns", "Module", "T81", "T81Tensors", "continues", "i", "vectors"}) {
+        test_sequence(text, {{TokenType::Identifier, text, 1, 1}});
+    }
+
+    // Runs longer than a vector width exercise the wide scanners and their tails;
+    // line/column tracking must stay exact across them.
+    const std::string long_ident(70, 'a');
+    const std::string long_source = "   \t\r\n" + std::string(40, ' ') + "\n" +
+                                    "/* block\n" + std::string(50, '*') + "\n  spans */ " + long_ident +
+                                    " 123456789012345678901234567890123.25\n" +
+                                    "// " + std::string(60, 'c') + "\n" + std::string(33, '\n') + "end";
+    test_sequence(long_source.c_str(), {
+        {TokenType::Identifier, long_ident.c_str(), 5, 12},
+        {TokenType::Float, "123456789012345678901234567890123.25", 5, 83},
+        {TokenType::Identifier, "end", 40, 1},
+    });
+    test_sequence("/* unterminated *", {});
+    test_sequence("a.b.c0 x..y", {
+        {TokenType::Identifier, "a.b.c0", 1, 1},
+        {TokenType::Identifier, "x", 1, 8},
+        {TokenType::DotDot, "..", 1, 9},
+        {TokenType::Identifier, "y", 1, 11},
+    });
+
+    // Bounded lookahead hands back the peeked tokens without re-scanning.
+    {
+        Lexer lexer("@effect fn f");
+        assert(lexer.peek_token(0).type == TokenType::At);
+        assert(lexer.peek_token(2).type == TokenType::Fn);
+        assert(lexer.peek_next_token().type == TokenType::At);
+        assert(lexer.next_token().type == TokenType::At);
+        assert(lexer.peek_next_token().lexeme == "effect");
+        assert(lexer.next_token().lexeme == "effect");
+        assert(lexer.next_token().type == TokenType::Fn);
+        assert(lexer.peek_token(1).type == TokenType::Eof);
+        [[maybe_unused]] Token f = lexer.next_token();
+        assert(f.type == TokenType::Identifier && f.lexeme == "f" && f.column == 12);
+        assert(lexer.next_token().type == TokenType::Eof);
+    }
+
+    // TokenStream matches the incremental lexer token for token, Illegal messages included.
+    {
+        const char* stream_source = "fn main() -> i32 {\n  let s = \"x\"; # \n  return 0; }";
+        Lexer lexer(stream_source);
+        const std::vector<Token> reference = lexer.all_tokens();
+        const TokenStream stream = TokenStream::tokenize(stream_source);
+        assert(stream.size() == reference.size());
+        for (std::size_t i = 0; i < reference.size(); ++i) {
+            [[maybe_unused]] const Token token = stream.token(i);
+            assert(token.type == reference[i].type);
+            assert(token.lexeme == reference[i].lexeme);
+            assert(token.line == reference[i].line);
+            assert(token.column == reference[i].column);
+        }
+        assert(stream.messages.size() == 1);
+        assert(stream.token(stream.size() + 3).type == TokenType::Eof);
+    }
+
     std::cout << "All lexer tests passed!" << std::endl;
 
     return 0;
@@ -0,0 +1,58 @@
+#include "../common/test_utils.hpp"
+#include "t81/frontend/parser.hpp"
+
+#include <cassert>
+#include <iostream>
+
+using namespace t81::frontend;
+
+int main() {
+    const std::string source = R"(
+        @tailrec
+        fn count(n: i32) -> i32 {
+            return count(n - 1);
+        }
+
+        @tier(3)
+        @tailrec
+        @effect
+        fn run() -> i32 {
+            return 0;
+        }
+
+        fn plain() -> i32 {
+            return 0;
+        }
+    )";
+
+    Lexer lexer(source);
+    Parser parser(lexer);
+    auto stmts = parser.parse();
+    assert(!parser.had_error());
+    assert(stmts.size() == 3);
+
+    const auto& count = static_cast<const FunctionStmt&>(*stmts[0]);
+    const auto& run = static_cast<const FunctionStmt&>(*stmts[1]);
+    const auto& plain = static_cast<const FunctionStmt&>(*stmts[2]);
+    assert(count.attributes.is_tailrec && !count.attributes.is_effectful);
+    assert(run.attributes.is_tailrec && run.attributes.is_effectful);
+    assert(!plain.attributes.is_tailrec);
+
+    // The printer lists the annotations in a fixed order, whatever order
+    // the source gives them in.
+    AstPrinter printer;
+    const std::string printed_count = printer.print(count);
+    const std::string printed_run = printer.print(run);
+    const std::string expected_count = "(fn @tailrec count (n: i32 ) -> i32 (block (return (call count (- n 1)))))";
+    const std::string expected_run = "(fn @effect @tailrec @tier(3) run ( ) -> i32 (block (return 0)))";
+
+    if (printed_count != expected_count || printed_run != expected_run) {
+        std::cerr << "Parser @tailrec test failed\n";
+        std::cerr << "count: " << printed_count << "\n";
+        std::cerr << "run:   " << printed_run << "\n";
+        return 1;
+    }
+
+    std::cout << "Parser @tailrec test passed!\n";
+    return 0;
+}
@@ -31,6 +31,13 @@ int main() {
 
     std::cout << "Parser test passed!" << std::endl;
 
+    const TokenStream fib_tokens = TokenStream::tokenize(source);
+    Parser stream_parser(fib_tokens);
+    [[maybe_unused]] auto stream_stmts = stream_parser.parse();
+    assert(!stream_parser.had_error());
+    assert(stream_stmts.size() == 1);
+    assert(printer.print(*stream_stmts[0]) == expected);
+
     std::string loop_source = R"(
         @bounded(10)
         loop {
@@ -0,0 +1,34 @@
+#include "t81/frontend/token_set.hpp"
+#include <cassert>
+#include <iostream>
+
+using namespace t81::frontend;
+
+constexpr TokenSet kOps{TokenType::Plus, TokenType::Minus};
+static_assert(kOps.contains(TokenType::Plus));
+static_assert(kOps.contains(TokenType::Minus));
+static_assert(!kOps.contains(TokenType::Star));
+static_assert(TokenSet{}.empty());
+static_assert((kOps | TokenSet{TokenType::Illegal}).contains(TokenType::Illegal));
+
+int main() {
+    // Exercise both words of the bitset at runtime.
+    TokenSet set;
+    assert(set.empty());
+    set.insert(TokenType::Module);
+    set.insert(TokenType::Eof);
+    assert(set.contains(TokenType::Module));
+    assert(set.contains(TokenType::Eof));
+    assert(!set.contains(TokenType::Import));
+    assert(!set.contains(TokenType::Illegal));
+
+    for (int t = 0; t <= static_cast<int>(TokenType::Illegal); ++t) {
+        const auto type = static_cast<TokenType>(t);
+        [[maybe_unused]] const TokenSet single{type};
+        assert(single.contains(type));
+        assert(!single.empty());
+    }
+
+    std::cout << "TokenSet tests passed!" << std::endl;
+    return 0;
+}
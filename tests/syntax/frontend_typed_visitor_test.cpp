@@ -0,0 +1,71 @@
+#include "t81/frontend/ast.hpp"
+#include "t81/frontend/ast_printer.hpp"
+#include "t81/frontend/lexer.hpp"
+#include "t81/frontend/parser.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <iostream>
+#include <string>
+
+using namespace t81::frontend;
+
+namespace {
+
+// Counts binary operators and measures expression depth through the typed
+// visitors; nodes it does not care about fall through to the catch-all.
+class DepthVisitor final : public ExprVisitorT<DepthVisitor, int>,
+                           public StmtVisitorT<DepthVisitor, void> {
+public:
+    int binary_count = 0;
+    int max_depth = 0;
+
+    template<std::derived_from<Expr> Node>
+    int visit(const Node&) { return 1; }
+    void visit(const Stmt&) {}
+
+    int visit(const BinaryExpr& expr) {
+        ++binary_count;
+        return 1 + std::max(visit_expr(*expr.left), visit_expr(*expr.right));
+    }
+
+    int visit(const GroupingExpr& expr) { return 1 + visit_expr(*expr.expression); }
+
+    void visit(const FunctionStmt& stmt) {
+        for (const auto& statement : stmt.body) visit_stmt(*statement);
+    }
+
+    void visit(const LetStmt& stmt) { record(visit_expr(*stmt.initializer)); }
+    void visit(const ReturnStmt& stmt) { record(visit_expr(*stmt.value)); }
+
+private:
+    void record(int depth) { max_depth = std::max(max_depth, depth); }
+};
+
+} // namespace
+
+int main() {
+    const TokenStream tokens = TokenStream::tokenize(
+        "fn main() -> i32 { let x: i32 = (1 + 2) * 3 - 4; return x; }");
+    Parser parser(tokens);
+    SyntaxTree tree = parser.parse();
+    assert(!parser.had_error());
+    assert(tree.size() == 1 && tree[0]->kind == StmtKind::Function);
+
+    DepthVisitor visitor;
+    visitor.visit_stmt(*tree[0]);
+    assert(visitor.binary_count == 3);
+    assert(visitor.max_depth == 5);
+
+    // The canonical printer goes through the same dispatch and returns its
+    // string directly.
+    const auto& fn = static_cast<const FunctionStmt&>(*tree[0]);
+    assert(fn.body[0]->kind == StmtKind::Let);
+    CanonicalAstPrinter printer;
+    [[maybe_unused]] const std::string printed = printer.print(*fn.body[0]);
+    assert(printed.find("(- (* (group (+ 1 2)) 3) 4)") != std::string::npos);
+
+    std::cout << "Typed visitor tests passed!" << std::endl;
+    return 0;
+}